@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+
+// --------------------------------------------------------
+// Timing helpers shared by the benchmark executables. Each
+// benchmark prints one line per measurement: the fastest
+// and median of several runs, so a single slow run (page
+// faults, another process) doesn't decide the result.
+// --------------------------------------------------------
+namespace Benchmark
+{
+	struct Timing
+	{
+		double fastest;	// Milliseconds
+		double median;
+	};
+
+	// Runs the function the given number of times and times each run
+	template<typename Function>
+	Timing Measure(unsigned int runs, Function&& function)
+	{
+		std::vector<double> times;
+		for (unsigned int i = 0; i < runs; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			function();
+			auto end = std::chrono::steady_clock::now();
+			times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+		}
+		std::sort(times.begin(), times.end());
+		return { times.front(), times[times.size() / 2] };
+	}
+
+	inline void Report(const char* name, const Timing& timing)
+	{
+		printf("%-48s %10.3f ms fastest %10.3f ms median\n", name, timing.fastest, timing.median);
+	}
+
+	inline void Report(const std::string& name, const Timing& timing)
+	{
+		Report(name.c_str(), timing);
+	}
+
+	// The value after a "--name" argument, or the fallback if it isn't there
+	inline unsigned int GetArgument(int argc, char* argv[], const char* name, unsigned int fallback)
+	{
+		for (int i = 1; i + 1 < argc; i++)
+			if (strncmp(argv[i], "--", 2) == 0 && strcmp(argv[i] + 2, name) == 0)
+				return (unsigned int)strtoul(argv[i + 1], 0, 10);
+		return fallback;
+	}
+
+	inline std::string GetAssetPath(const char* fileName)
+	{
+		return (std::filesystem::path(ASSET_DIRECTORY) / fileName).string();
+	}
+
+	// A folder under the build directory for generated files and caches
+	inline std::string GetOutputDirectory(const char* benchmarkName)
+	{
+		std::filesystem::path directory = std::filesystem::path(BENCHMARK_OUTPUT_DIRECTORY) / benchmarkName;
+		std::filesystem::create_directories(directory);
+		return directory.string();
+	}
+
+	// Keeps the compiler from optimizing away work whose result is unused
+	template<typename T>
+	void KeepAlive(const T& value)
+	{
+#if defined(__GNUC__)
+		asm volatile("" : : "r"(&value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "Benchmark.h"
+#include "Transform.h"
+#include "ConstantBuffer.h"
+
+#include <memory>
+#include <cstring>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// The CPU side of Game's per-entity drawing, without D3D:
+// the main pass fills both constant buffers for every
+// entity, and the shadow pass reads each world matrix
+// again. The mesh, material and camera are stand-ins that
+// hold just what DrawEntity reads, and the transforms are
+// real. Runs once the way the game draws now (entities by
+// reference, raw mesh and material pointers, matrices by
+// const reference) and once the way it used to (shared_ptr
+// copies and matrices returned by value).
+//
+//   DrawLoopBenchmark [--entities 100000] [--runs 9]
+// --------------------------------------------------------
+
+namespace
+{
+	struct MockMesh
+	{
+		XMFLOAT4X4 dequantize;
+
+		const XMFLOAT4X4& GetDequantizeMatrix() const { return dequantize; }
+		XMFLOAT4X4 CopyDequantizeMatrix() const { return dequantize; }
+	};
+
+	struct MockMaterial
+	{
+		XMFLOAT2 textureScale = XMFLOAT2(1, 1);
+		XMFLOAT2 textureOffset = XMFLOAT2(0, 0);
+		XMFLOAT4 tint = XMFLOAT4(1, 1, 1, 1);
+	};
+
+	struct MockCamera
+	{
+		Transform transform;
+		XMFLOAT4X4 view;
+		XMFLOAT4X4 projection;
+
+		explicit MockCamera(TransformStore& store) : transform(store) {}
+	};
+
+	struct MockEntity
+	{
+		Transform transform;
+		std::shared_ptr<MockMesh> mesh;
+		std::shared_ptr<MockMaterial> material;
+
+		MockEntity(TransformStore& store, std::shared_ptr<MockMesh> mesh, std::shared_ptr<MockMaterial> material)
+			: transform(store), mesh(mesh), material(material) {}
+
+		MockMesh* GetMesh() { return mesh.get(); }
+		MockMaterial* GetMaterial() { return material.get(); }
+		std::shared_ptr<MockMesh> ShareMesh() { return mesh; }
+		std::shared_ptr<MockMaterial> ShareMaterial() { return material; }
+	};
+
+	// Where the constant buffers would be filled, so the copies into
+	// them aren't optimized away
+	struct Frame
+	{
+		MockCamera* camera;
+		XMFLOAT4X4 lightView;
+		XMFLOAT4X4 lightProjection;
+		std::vector<uint8_t> buffer;
+		size_t written;
+
+		void Fill(const void* data, size_t size)
+		{
+			if (written + size > buffer.size())
+				written = 0;
+			memcpy(&buffer[written], data, size);
+			written += size;
+		}
+	};
+
+	void DrawEntity(Frame& frame, MockEntity& entity, float totalTime)
+	{
+		MockMesh* mesh = entity.GetMesh();
+		MockMaterial* material = entity.GetMaterial();
+
+		VertexShaderConstData vertexData = {};
+		Transform* transform = &entity.transform;
+		const XMFLOAT4X4& world = transform->GetWorldMatrix();
+		vertexData.world = world;
+		vertexData.dequantize = mesh->GetDequantizeMatrix();
+		vertexData.worldInvTranspose = transform->HasUniformScale() ? world : transform->GetWorldInverseTransposeMatrix();
+		vertexData.view = frame.camera->view;
+		vertexData.projection = frame.camera->projection;
+		vertexData.lightView = frame.lightView;
+		vertexData.lightProjection = frame.lightProjection;
+		frame.Fill(&vertexData, sizeof(vertexData));
+
+		PixelShaderConstData pixelData = {};
+		pixelData.textureScale = material->textureScale;
+		pixelData.textureOffset = material->textureOffset;
+		pixelData.tint = material->tint;
+		pixelData.cameraPosition = frame.camera->transform.GetPosition();
+		pixelData.time = totalTime;
+		frame.Fill(&pixelData, sizeof(pixelData));
+	}
+
+	void DrawShadow(Frame& frame, MockEntity& entity)
+	{
+		MockMesh* mesh = entity.GetMesh();
+		const XMFLOAT4X4& world = entity.transform.GetWorldMatrix();
+		XMFLOAT4X4 shadowWorld;
+		XMStoreFloat4x4(&shadowWorld, XMMatrixMultiply(XMLoadFloat4x4(&mesh->GetDequantizeMatrix()), XMLoadFloat4x4(&world)));
+		frame.Fill(&shadowWorld, sizeof(shadowWorld));
+	}
+
+	// The same work with the copies DrawEntity used to make: the
+	// entity's shared_ptr, the mesh once, the material five times and
+	// every matrix by value
+	void DrawEntityShared(Frame& frame, std::shared_ptr<MockEntity> entity, float totalTime)
+	{
+		std::shared_ptr<MockMesh> mesh = entity->ShareMesh();
+		Benchmark::KeepAlive(entity->ShareMaterial()); // Binding shaders
+
+		VertexShaderConstData vertexData = {};
+		XMFLOAT4X4 world = entity->transform.GetWorldMatrix();
+		vertexData.world = world;
+		vertexData.dequantize = mesh->CopyDequantizeMatrix();
+		vertexData.worldInvTranspose = entity->transform.HasUniformScale() ? world :
+			XMFLOAT4X4(entity->transform.GetWorldInverseTransposeMatrix());
+		XMFLOAT4X4 view = frame.camera->view;
+		XMFLOAT4X4 projection = frame.camera->projection;
+		vertexData.view = view;
+		vertexData.projection = projection;
+		vertexData.lightView = frame.lightView;
+		vertexData.lightProjection = frame.lightProjection;
+		frame.Fill(&vertexData, sizeof(vertexData));
+
+		PixelShaderConstData pixelData = {};
+		pixelData.textureScale = entity->ShareMaterial()->textureScale;
+		pixelData.textureOffset = entity->ShareMaterial()->textureOffset;
+		pixelData.tint = entity->ShareMaterial()->tint;
+		pixelData.cameraPosition = frame.camera->transform.GetPosition();
+		pixelData.time = totalTime;
+		frame.Fill(&pixelData, sizeof(pixelData));
+		Benchmark::KeepAlive(entity->ShareMaterial()); // Binding textures
+	}
+
+	void DrawShadowShared(Frame& frame, std::shared_ptr<MockEntity> entity)
+	{
+		std::shared_ptr<MockMesh> mesh = entity->ShareMesh();
+		XMFLOAT4X4 world = entity->transform.GetWorldMatrix();
+		XMFLOAT4X4 dequantize = mesh->CopyDequantizeMatrix();
+		XMFLOAT4X4 shadowWorld;
+		XMStoreFloat4x4(&shadowWorld, XMMatrixMultiply(XMLoadFloat4x4(&dequantize), XMLoadFloat4x4(&world)));
+		frame.Fill(&shadowWorld, sizeof(shadowWorld));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int count = Benchmark::GetArgument(argc, argv, "entities", 100000);
+	unsigned int runs = Benchmark::GetArgument(argc, argv, "runs", 9);
+
+	// A few meshes and materials shared between many entities, as in
+	// the game, with every other entity scaled unevenly
+	TransformStore store;
+	std::vector<std::shared_ptr<MockMesh>> meshes;
+	std::vector<std::shared_ptr<MockMaterial>> materials;
+	for (int i = 0; i < 8; i++)
+	{
+		meshes.push_back(std::make_shared<MockMesh>());
+		XMStoreFloat4x4(&meshes.back()->dequantize, XMMatrixScaling(1.0f + i, 2.0f, 3.0f));
+		materials.push_back(std::make_shared<MockMaterial>());
+	}
+	std::vector<std::shared_ptr<MockEntity>> entities;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		entities.push_back(std::make_shared<MockEntity>(store, meshes[i % meshes.size()], materials[i / 7 % materials.size()]));
+		Transform& transform = entities.back()->transform;
+		transform.SetPosition((float)(i % 100), 0.0f, (float)(i / 100));
+		transform.SetRotation(0.0f, 0.01f * i, 0.0f);
+		transform.SetScale(1.0f, i % 2 ? 2.0f : 1.0f, 1.0f);
+	}
+
+	MockCamera camera(store);
+	XMStoreFloat4x4(&camera.view, XMMatrixLookToLH(XMVectorSet(0, 5, -10, 1), XMVectorSet(0, 0, 1, 0), XMVectorSet(0, 1, 0, 0)));
+	XMStoreFloat4x4(&camera.projection, XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 100.0f));
+	Frame frame = { &camera, camera.view, camera.projection, std::vector<uint8_t>(1 << 20), 0 };
+	store.UpdateWorldMatrices();
+
+	Benchmark::Report("By reference, raw pointers", Benchmark::Measure(runs, [&]()
+		{
+			for (std::shared_ptr<MockEntity>& entity : entities)
+				DrawShadow(frame, *entity);
+			for (std::shared_ptr<MockEntity>& entity : entities)
+				DrawEntity(frame, *entity, 1.0f);
+			Benchmark::KeepAlive(frame.buffer);
+		}));
+
+	Benchmark::Report("By value, shared_ptr copies", Benchmark::Measure(runs, [&]()
+		{
+			for (std::shared_ptr<MockEntity>& entity : entities)
+				DrawShadowShared(frame, entity);
+			for (std::shared_ptr<MockEntity>& entity : entities)
+				DrawEntityShared(frame, entity, 1.0f);
+			Benchmark::KeepAlive(frame.buffer);
+		}));
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "Benchmark.h"
+#include "Tests/SyntheticObj.h"
+#include "MeshImporter.h"
+#include "MemoryMeshUploader.h"
+
+// --------------------------------------------------------
+// Imports the bundled meshes and a synthetic grid in every
+// vertex format, through MemoryMeshUploader: once from the
+// .obj (no cache) and once from the cooked file it leaves.
+//
+//   ImportBenchmark [--grid 300] [--runs 3]
+//
+// The default 300x300 grid is 180k triangles.
+// --------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	unsigned int grid = Benchmark::GetArgument(argc, argv, "grid", 300);
+	unsigned int runs = Benchmark::GetArgument(argc, argv, "runs", 3);
+
+	std::filesystem::path directory = Benchmark::GetOutputDirectory("ImportBenchmark");
+	std::vector<std::string> paths;
+	for (const char* name : { "cube.obj", "cylinder.obj", "helix.obj", "sphere.obj", "torus.obj" })
+	{
+		std::filesystem::path copy = directory / name;
+		std::filesystem::copy_file(Benchmark::GetAssetPath(name), copy, std::filesystem::copy_options::overwrite_existing);
+		paths.push_back(copy.string());
+	}
+	std::string gridPath = (directory / "grid.obj").string();
+	uint64_t gridTriangles = SyntheticObj::WriteGrid(gridPath, grid, grid);
+	paths.push_back(gridPath);
+	printf("Grid: %ux%u quads, %llu triangles\n", grid, grid, (unsigned long long)gridTriangles);
+
+	const char* formatNames[VertexFormatCount] = { "Full", "Compact", "Quantized" };
+	for (const std::string& path : paths)
+	{
+		std::string name = std::filesystem::path(path).filename().string();
+		for (unsigned int format = 0; format < VertexFormatCount; format++)
+		{
+			MeshImportSettings settings;
+			settings.vertexFormat = (VertexFormat)format;
+			std::string cachePath = MeshCache::GetCachePath(path.c_str(), MeshCache::GetImportFlags(settings));
+
+			MemoryMeshUploader uploader;
+			Benchmark::Timing uncached = Benchmark::Measure(runs, [&]()
+				{
+					std::filesystem::remove(cachePath);
+					uploader.Upload(MeshImporter::Import(path.c_str(), settings));
+				});
+			Benchmark::Timing cached = Benchmark::Measure(runs, [&]()
+				{
+					uploader.Upload(MeshImporter::Import(path.c_str(), settings));
+				});
+
+			Benchmark::Report(name + " " + formatNames[format] + " from .obj", uncached);
+			Benchmark::Report(name + " " + formatNames[format] + " from cache", cached);
+			uploader.Clear();
+		}
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "Benchmark.h"
+#include "Tests/SyntheticObj.h"
+#include "MeshLoader.h"
+
+#include <thread>
+
+// --------------------------------------------------------
+// Imports several copies of a grid (without caches) the
+// blocking way, one Mesh constructor after another, and
+// through MeshLoader with a frame loop on the main thread
+// that finalizes whatever is done each frame. Besides the
+// time until every mesh is ready, reports the longest the
+// main thread spent in one frame on loading, which is the
+// hitch a player would see.
+//
+//   LoaderBenchmark [--meshes 8] [--grid 200] [--threads 0] [--runs 3]
+//
+// A thread count of 0 uses MeshLoader's default.
+// --------------------------------------------------------
+
+namespace
+{
+	double Milliseconds(std::chrono::steady_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	void RemoveCaches(const std::vector<std::string>& paths)
+	{
+		for (const std::string& path : paths)
+			std::filesystem::remove(MeshCache::GetCachePath(path.c_str(), MeshCache::GetImportFlags(MeshImportSettings())));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int meshCount = Benchmark::GetArgument(argc, argv, "meshes", 8);
+	unsigned int grid = Benchmark::GetArgument(argc, argv, "grid", 200);
+	unsigned int threads = Benchmark::GetArgument(argc, argv, "threads", 0);
+	unsigned int runs = Benchmark::GetArgument(argc, argv, "runs", 3);
+
+	// Copies under different names, since a file can't be loading twice at once
+	std::filesystem::path directory = Benchmark::GetOutputDirectory("LoaderBenchmark");
+	std::string gridPath = (directory / "grid.obj").string();
+	uint64_t triangles = SyntheticObj::WriteGrid(gridPath, grid, grid);
+	std::vector<std::string> paths;
+	for (unsigned int i = 0; i < meshCount; i++)
+	{
+		std::filesystem::path copy = directory / ("grid" + std::to_string(i) + ".obj");
+		std::filesystem::copy_file(gridPath, copy, std::filesystem::copy_options::overwrite_existing);
+		paths.push_back(copy.string());
+	}
+	printf("%u meshes of %llu triangles, %u hardware threads\n", meshCount, (unsigned long long)triangles, std::thread::hardware_concurrency());
+
+	Benchmark::Report("blocking Mesh constructors (all on the main thread)", Benchmark::Measure(runs, [&]()
+		{
+			RemoveCaches(paths);
+			std::vector<std::unique_ptr<Mesh>> meshes;
+			for (const std::string& path : paths)
+				meshes.push_back(std::make_unique<Mesh>(path.c_str()));
+			Benchmark::KeepAlive(meshes);
+		}));
+
+	MeshLoader loader(threads);
+	double longestFrame = 0.0;
+	unsigned int frames = 0;
+	Benchmark::Timing timing = Benchmark::Measure(runs, [&]()
+		{
+			RemoveCaches(paths);
+			longestFrame = 0.0;
+			frames = 0;
+
+			// Queue everything in the first frame, then finalize what's done
+			// in each one after, with the rest of a 60 Hz frame left idle
+			std::vector<std::shared_ptr<Mesh>> meshes;
+			unsigned int finalized = 0;
+			while (finalized < meshCount)
+			{
+				auto start = std::chrono::steady_clock::now();
+				if (frames == 0)
+					for (const std::string& path : paths)
+						meshes.push_back(loader.Load(path));
+				finalized += loader.FinalizeReady();
+				auto end = std::chrono::steady_clock::now();
+
+				longestFrame = std::max(longestFrame, Milliseconds(end - start));
+				frames++;
+				std::this_thread::sleep_until(start + std::chrono::microseconds(16667));
+			}
+			Benchmark::KeepAlive(meshes);
+		});
+	Benchmark::Report("MeshLoader, " + std::to_string(loader.GetThreadCount()) + " threads, until all ready", timing);
+	printf("  longest main thread frame spent loading: %.3f ms, over %u frames\n", longestFrame, frames);
+
+	RemoveCaches(paths);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include "MeshletBuilder.h"
+#include "MeshletCuller.h"
+#include "MeshGenerator.h"
+#include "MeshOptimizer.h"
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Splits a finely tessellated sphere into meshlets, then
+// culls them from cameras circling it (half the sphere
+// faces away, and some views leave part of it off screen).
+// Reports how long each takes and how many triangles are
+// left to draw.
+//
+//   MeshletBenchmark [--slices 1024] [--runs 5]
+// --------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	unsigned int slices = Benchmark::GetArgument(argc, argv, "slices", 1024);
+	unsigned int runs = Benchmark::GetArgument(argc, argv, "runs", 5);
+
+	MeshGenerator::Size size = MeshGenerator::SphereSize(slices, slices / 2);
+	std::vector<Vertex> vertices(size.vertexCount);
+	std::vector<unsigned int> indices(size.indexCount);
+	MeshGenerator::Sphere(vertices, indices, slices, slices / 2);
+	std::vector<Submesh> submeshes = { { 0, size.indexCount, "", "" } };
+
+	// Meshlets follow the index order, so build them the way imports do:
+	// after the vertex cache optimization has grouped neighbors together
+	unsigned int vertexCount = MeshOptimizer::Optimize(vertices.data(), size.vertexCount, indices.data(), indices.size(), submeshes);
+	printf("sphere: %u triangles, %u vertices\n", size.indexCount / 3, vertexCount);
+
+	std::vector<Meshlet> meshlets;
+	Benchmark::Report("MeshletBuilder::Build", Benchmark::Measure(runs, [&]()
+		{
+			meshlets = MeshletBuilder::Build(vertices.data(), vertexCount, indices.data(), submeshes);
+		}));
+	printf("  %zu meshlets, %.1f triangles each\n", meshlets.size(), size.indexCount / 3.0 / meshlets.size());
+
+	// Eight cameras around the sphere, the closer ones seeing only part of it
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 100.0f);
+	std::vector<XMMATRIX> views;
+	for (int i = 0; i < 8; i++)
+	{
+		float angle = XM_2PI * i / 8;
+		float distance = i % 2 == 0 ? 4.0f : 1.6f;
+		XMVECTOR eye = XMVectorSet(std::sin(angle) * distance, 0.5f, std::cos(angle) * distance, 1.0f);
+		views.push_back(XMMatrixLookToLH(eye, XMVectorNegate(XMVectorSetW(eye, 0.0f)), XMVectorSet(0, 1, 0, 0)));
+	}
+
+	std::vector<IndexRange> ranges;
+	MeshletCuller::Stats total = {};
+	Benchmark::Timing timing = Benchmark::Measure(runs, [&]()
+		{
+			total = {};
+			for (const XMMATRIX& view : views)
+			{
+				MeshletCuller::Stats stats = MeshletCuller::Cull(meshlets, XMMatrixIdentity(), view, projection, true, ranges);
+				total.visibleTriangles += stats.visibleTriangles;
+				total.frustumCulled += stats.frustumCulled;
+				total.backfaceCulled += stats.backfaceCulled;
+				total.meshlets += stats.meshlets;
+			}
+			Benchmark::KeepAlive(ranges);
+		});
+	timing.fastest /= views.size();
+	timing.median /= views.size();
+	Benchmark::Report("MeshletCuller::Cull, per view", timing);
+	printf("  %.1f%% of triangles drawn, %.1f%% of meshlets frustum culled, %.1f%% back-face culled\n",
+		100.0 * total.visibleTriangles / (size.indexCount / 3.0 * views.size()),
+		100.0 * total.frustumCulled / total.meshlets,
+		100.0 * total.backfaceCulled / total.meshlets);
+	return 0;
+}
\ No newline at end of file
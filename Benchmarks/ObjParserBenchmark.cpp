@@ -0,0 +1,139 @@
+#include "Benchmark.h"
+#include "Tests/SyntheticObj.h"
+#include "ObjParser.h"
+#include "MappedFile.h"
+
+#include <cmath>
+#include <thread>
+#include <fstream>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Reads .obj text into positions, normals, uvs and face
+// corners three ways: the original getline + sscanf loop,
+// ObjParser::Parse on a mapped file, and ParseParallel.
+//
+//   ObjParserBenchmark [--faces 10000000] [--runs 3]
+//
+// The synthetic grid has about --faces quads (two triangles
+// each). Welding and everything after it is left out.
+// --------------------------------------------------------
+
+namespace
+{
+	// The loop Mesh(const char*) used before ObjParser, up to the point
+	// where it had built a vertex per corner (sscanf_s became sscanf).
+	// Its line buffer grew from 100 to 128 characters: a 10M-face grid
+	// has face lines longer than 100, and getline would give up on them.
+	size_t LoadWithSscanf(const char* filePath)
+	{
+		std::ifstream obj(filePath);
+		std::vector<XMFLOAT3> positions;
+		std::vector<XMFLOAT3> normals;
+		std::vector<XMFLOAT2> uvs;
+		std::vector<Vertex> vertsFromFile;
+		char chars[128];
+
+		while (obj.good())
+		{
+			obj.getline(chars, sizeof(chars));
+			if (chars[0] == 'v' && chars[1] == 'n')
+			{
+				XMFLOAT3 norm{};
+				sscanf(chars, "vn %f %f %f", &norm.x, &norm.y, &norm.z);
+				normals.push_back(norm);
+			}
+			else if (chars[0] == 'v' && chars[1] == 't')
+			{
+				XMFLOAT2 uv{};
+				sscanf(chars, "vt %f %f", &uv.x, &uv.y);
+				uvs.push_back(uv);
+			}
+			else if (chars[0] == 'v')
+			{
+				XMFLOAT3 pos{};
+				sscanf(chars, "v %f %f %f", &pos.x, &pos.y, &pos.z);
+				positions.push_back(pos);
+			}
+			else if (chars[0] == 'f')
+			{
+				int i[12]{};
+				int numbersRead = sscanf(chars,
+					"f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d",
+					&i[0], &i[1], &i[2], &i[3], &i[4], &i[5],
+					&i[6], &i[7], &i[8], &i[9], &i[10], &i[11]);
+
+				auto corner = [&](int first)
+				{
+					Vertex v{};
+					v.Position = positions[std::max(i[first] - 1, 0)];
+					v.UV = uvs[std::max(i[first + 1] - 1, 0)];
+					v.Normal = normals[std::max(i[first + 2] - 1, 0)];
+					v.UV.y = 1.0f - v.UV.y;
+					v.Position.z *= -1.0f;
+					v.Normal.z *= -1.0f;
+					return v;
+				};
+
+				Vertex v1 = corner(0);
+				Vertex v2 = corner(3);
+				Vertex v3 = corner(6);
+				vertsFromFile.push_back(v1);
+				vertsFromFile.push_back(v3);
+				vertsFromFile.push_back(v2);
+				if (numbersRead == 12)
+				{
+					Vertex v4 = corner(9);
+					vertsFromFile.push_back(v1);
+					vertsFromFile.push_back(v4);
+					vertsFromFile.push_back(v3);
+				}
+			}
+		}
+		Benchmark::KeepAlive(vertsFromFile);
+		return vertsFromFile.size() / 3;
+	}
+
+	size_t LoadWithObjParser(const char* filePath, unsigned int threadCount)
+	{
+		MappedFile file(filePath);
+		ObjParser::ObjData data;
+		if (threadCount == 1)
+			ObjParser::Parse(file.GetData(), file.GetEnd(), data);
+		else
+			ObjParser::ParseParallel(file.GetData(), file.GetEnd(), data, threadCount);
+		Benchmark::KeepAlive(data);
+		return data.triangles.size() / 3;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int faces = Benchmark::GetArgument(argc, argv, "faces", 10000000);
+	unsigned int runs = Benchmark::GetArgument(argc, argv, "runs", 3);
+
+	// As close to square as the requested face count allows
+	unsigned int columns = std::max(1u, (unsigned int)std::sqrt((double)faces));
+	unsigned int rows = std::max(1u, faces / columns);
+	std::string gridPath = (std::filesystem::path(Benchmark::GetOutputDirectory("ObjParserBenchmark")) / "grid.obj").string();
+	SyntheticObj::WriteGrid(gridPath, columns, rows);
+	printf("Grid: %ux%u quads, %.1f MB\n", columns, rows, std::filesystem::file_size(gridPath) / 1048576.0);
+
+	unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (const std::string& path : { Benchmark::GetAssetPath("helix.obj"), gridPath })
+	{
+		std::string name = std::filesystem::path(path).filename().string();
+
+		size_t oldTriangles = 0;
+		size_t newTriangles = 0;
+		Benchmark::Report(name + " getline + sscanf", Benchmark::Measure(runs, [&]() { oldTriangles = LoadWithSscanf(path.c_str()); }));
+		Benchmark::Report(name + " ObjParser::Parse", Benchmark::Measure(runs, [&]() { newTriangles = LoadWithObjParser(path.c_str(), 1); }));
+		Benchmark::Report(name + " ObjParser::ParseParallel, " + std::to_string(hardwareThreads) + " thread(s)",
+			Benchmark::Measure(runs, [&]() { LoadWithObjParser(path.c_str(), hardwareThreads); }));
+
+		if (oldTriangles != newTriangles)
+			printf("  Triangle counts differ: %zu vs %zu\n", oldTriangles, newTriangles);
+	}
+	return 0;
+}
\ No newline at end of file
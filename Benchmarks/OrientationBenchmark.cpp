@@ -0,0 +1,81 @@
+#include "Benchmark.h"
+#include "Transform.h"
+
+#include <memory>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// A camera-style frame for many transforms: turn a little,
+// read the three axes, move along them and read the world
+// matrix. Once through Transform, which keeps the axes from
+// the last rotation change, and once working each axis out
+// from pitch, yaw and roll whenever it's asked for, which is
+// what Transform did before it cached them.
+//
+//   OrientationBenchmark [--transforms 100000] [--runs 9]
+// --------------------------------------------------------
+
+namespace
+{
+	XMVECTOR AxisFromEuler(Transform& transform, float x, float y, float z)
+	{
+		XMFLOAT3 rotation = transform.GetRotation();
+		return XMVector3Rotate(XMVectorSet(x, y, z, 0.0f), XMQuaternionRotationRollPitchYaw(rotation.x, rotation.y, rotation.z));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int count = Benchmark::GetArgument(argc, argv, "transforms", 100000);
+	unsigned int runs = Benchmark::GetArgument(argc, argv, "runs", 9);
+
+	TransformStore store;
+	std::vector<std::unique_ptr<Transform>> transforms;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		transforms.push_back(std::make_unique<Transform>(store));
+		transforms.back()->SetRotation(0.001f * (i % 1000), 0.002f * i, 0.0f);
+	}
+	store.UpdateWorldMatrices();
+
+	Benchmark::Report("Cached axes", Benchmark::Measure(runs, [&]()
+		{
+			XMVECTOR sum = XMVectorZero();
+			for (std::unique_ptr<Transform>& transform : transforms)
+			{
+				transform->Rotate(0.0f, 0.001f, 0.0f);
+				XMFLOAT3 right = transform->GetRight();
+				XMFLOAT3 up = transform->GetUp();
+				XMFLOAT3 forward = transform->GetForward();
+				sum += XMLoadFloat3(&right) + XMLoadFloat3(&up) + XMLoadFloat3(&forward);
+				transform->MoveRelative(0.0f, 0.0f, 0.01f);
+				sum += XMLoadFloat4x4(&transform->GetWorldMatrix()).r[3];
+			}
+			Benchmark::KeepAlive(sum);
+		}));
+
+	Benchmark::Report("Axes from pitch, yaw and roll", Benchmark::Measure(runs, [&]()
+		{
+			XMVECTOR sum = XMVectorZero();
+			for (std::unique_ptr<Transform>& transform : transforms)
+			{
+				transform->Rotate(0.0f, 0.001f, 0.0f);
+				sum += AxisFromEuler(*transform, 1, 0, 0) + AxisFromEuler(*transform, 0, 1, 0) + AxisFromEuler(*transform, 0, 0, 1);
+				XMFLOAT3 position = transform->GetPosition();
+				XMStoreFloat3(&position, XMLoadFloat3(&position) + AxisFromEuler(*transform, 0.0f, 0.0f, 0.01f));
+				transform->SetPosition(position);
+				sum += XMLoadFloat4x4(&transform->GetWorldMatrix()).r[3];
+			}
+			Benchmark::KeepAlive(sum);
+		}));
+
+	// Turning alone: the trig now happens here, once per change
+	Benchmark::Report("Rotate and update only", Benchmark::Measure(runs, [&]()
+		{
+			for (std::unique_ptr<Transform>& transform : transforms)
+				transform->Rotate(0.0f, 0.001f, 0.0f);
+			store.UpdateWorldMatrices();
+		}));
+	return 0;
+}
\ No newline at end of file
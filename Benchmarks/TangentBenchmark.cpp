@@ -0,0 +1,128 @@
+#include "Benchmark.h"
+#include "TangentGenerator.h"
+
+#include <cmath>
+#include <thread>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Tangents for a grid mesh three ways: the scalar loop Mesh
+// used to run, TangentGenerator on one thread (the SIMD
+// kernel alone) and TangentGenerator on every hardware
+// thread.
+//
+//   TangentBenchmark [--faces 2000000] [--runs 5]
+// --------------------------------------------------------
+
+namespace
+{
+	// The old Mesh::CalculateTangents, scattering one triangle at a time
+	void CalculateTangentsScalar(Vertex* verts, unsigned int numVerts, const unsigned int* indices, size_t numIndices)
+	{
+		for (unsigned int i = 0; i < numVerts; i++)
+			verts[i].Tangent = XMFLOAT4(0, 0, 0, 0);
+
+		for (size_t i = 0; i < numIndices;)
+		{
+			Vertex* v1 = &verts[indices[i++]];
+			Vertex* v2 = &verts[indices[i++]];
+			Vertex* v3 = &verts[indices[i++]];
+
+			float x1 = v2->Position.x - v1->Position.x;
+			float y1 = v2->Position.y - v1->Position.y;
+			float z1 = v2->Position.z - v1->Position.z;
+			float x2 = v3->Position.x - v1->Position.x;
+			float y2 = v3->Position.y - v1->Position.y;
+			float z2 = v3->Position.z - v1->Position.z;
+
+			float s1 = v2->UV.x - v1->UV.x;
+			float t1 = v2->UV.y - v1->UV.y;
+			float s2 = v3->UV.x - v1->UV.x;
+			float t2 = v3->UV.y - v1->UV.y;
+
+			float r = 1.0f / (s1 * t2 - s2 * t1);
+			float tx = (t2 * x1 - t1 * x2) * r;
+			float ty = (t2 * y1 - t1 * y2) * r;
+			float tz = (t2 * z1 - t1 * z2) * r;
+
+			for (Vertex* v : { v1, v2, v3 })
+			{
+				v->Tangent.x += tx;
+				v->Tangent.y += ty;
+				v->Tangent.z += tz;
+			}
+		}
+
+		for (unsigned int i = 0; i < numVerts; i++)
+		{
+			XMVECTOR normal = XMLoadFloat3(&verts[i].Normal);
+			XMVECTOR tangent = XMLoadFloat4(&verts[i].Tangent);
+			tangent = XMVector3Normalize(tangent - normal * XMVector3Dot(normal, tangent));
+			XMStoreFloat4(&verts[i].Tangent, tangent);
+		}
+	}
+
+	// A wavy grid of columns x rows quads, two triangles each
+	void MakeGrid(unsigned int columns, unsigned int rows, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		vertices.clear();
+		indices.clear();
+		vertices.reserve((size_t)(columns + 1) * (rows + 1));
+		indices.reserve((size_t)columns * rows * 6);
+		for (unsigned int z = 0; z <= rows; z++)
+		{
+			for (unsigned int x = 0; x <= columns; x++)
+			{
+				Vertex vertex = {};
+				vertex.Position = XMFLOAT3(x * 0.1f, 0.2f * std::sin(x * 0.3f) * std::cos(z * 0.2f), z * 0.1f);
+				vertex.Normal = XMFLOAT3(0, 1, 0);
+				vertex.UV = XMFLOAT2((float)x / columns, 1.0f - (float)z / rows);
+				vertices.push_back(vertex);
+			}
+		}
+		for (unsigned int z = 0; z < rows; z++)
+		{
+			for (unsigned int x = 0; x < columns; x++)
+			{
+				unsigned int corner = z * (columns + 1) + x;
+				unsigned int quad[6] = { corner, corner + columns + 1, corner + 1, corner + 1, corner + columns + 1, corner + columns + 2 };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int faces = Benchmark::GetArgument(argc, argv, "faces", 2000000);
+	unsigned int runs = Benchmark::GetArgument(argc, argv, "runs", 5);
+
+	unsigned int quads = std::max(1u, faces / 2);
+	unsigned int columns = std::max(1u, (unsigned int)std::sqrt((double)quads));
+	unsigned int rows = std::max(1u, quads / columns);
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	MakeGrid(columns, rows, vertices, indices);
+	unsigned int vertexCount = (unsigned int)vertices.size();
+	unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+	printf("grid: %zu triangles, %u vertices, %u hardware threads\n", indices.size() / 3, vertexCount, threads);
+
+	Benchmark::Report("scalar loop", Benchmark::Measure(runs, [&]()
+		{
+			CalculateTangentsScalar(vertices.data(), vertexCount, indices.data(), indices.size());
+			Benchmark::KeepAlive(vertices[0]);
+		}));
+	Benchmark::Report("TangentGenerator, 1 thread", Benchmark::Measure(runs, [&]()
+		{
+			TangentGenerator::Generate(vertices.data(), vertexCount, indices.data(), indices.size(), 1);
+			Benchmark::KeepAlive(vertices[0]);
+		}));
+	Benchmark::Report("TangentGenerator, " + std::to_string(threads) + " threads", Benchmark::Measure(runs, [&]()
+		{
+			TangentGenerator::Generate(vertices.data(), vertexCount, indices.data(), indices.size(), threads);
+			Benchmark::KeepAlive(vertices[0]);
+		}));
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "Benchmark.h"
+#include "TransformStore.h"
+
+#include <random>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Batched world matrix updates over a million transforms,
+// in a wide tree and in long chains: everything changed,
+// nothing changed, and a few random transforms changed
+// (each taking its subtree along).
+//
+//   TransformBenchmark [--nodes 1000000] [--runs 5]
+// --------------------------------------------------------
+
+namespace
+{
+	// Each node gets ten children until there are enough, allocated
+	// depth first so every attach is already in place
+	void BuildWideTree(TransformStore& store, std::vector<unsigned int>& ids, unsigned int nodes)
+	{
+		ids.resize(nodes);
+		auto build = [&](auto& self, unsigned int node, unsigned int parent) -> void
+		{
+			ids[node] = store.Allocate();
+			store.SetParent(ids[node], parent);
+			store.SetPosition(ids[node], XMFLOAT3(1, 0, 0));
+			for (unsigned int child = node * 10 + 1; child <= node * 10 + 10 && child < nodes; child++)
+				self(self, child, ids[node]);
+		};
+		build(build, 0, TransformStore::None);
+	}
+
+	// A thousand transforms in each chain
+	void BuildChains(TransformStore& store, std::vector<unsigned int>& ids, unsigned int nodes)
+	{
+		ids.resize(nodes);
+		for (unsigned int node = 0; node < nodes; node++)
+		{
+			ids[node] = store.Allocate();
+			store.SetParent(ids[node], node % 1000 == 0 ? TransformStore::None : ids[node - 1]);
+			store.SetPosition(ids[node], XMFLOAT3(0, 0.01f, 0));
+		}
+	}
+
+	template<typename Build>
+	void Run(const char* shape, unsigned int nodes, unsigned int runs, Build&& build)
+	{
+		std::vector<unsigned int> ids;
+		TransformStore store;
+		Benchmark::Report(std::string(shape) + ": build", Benchmark::Measure(1, [&]()
+			{
+				build(store, ids, nodes);
+			}));
+
+		// Turning the roots dirties everything
+		std::vector<unsigned int> roots;
+		for (unsigned int id : ids)
+		{
+			if (store.GetParent(id) == TransformStore::None)
+				roots.push_back(id);
+		}
+		Benchmark::Report(std::string(shape) + ": update all", Benchmark::Measure(runs, [&]()
+			{
+				for (unsigned int id : roots)
+					store.SetRotation(id, XMFLOAT3(0, 0.5f, 0));
+				store.UpdateWorldMatrices();
+			}));
+
+		Benchmark::Report(std::string(shape) + ": update, nothing changed", Benchmark::Measure(runs, [&]()
+			{
+				store.UpdateWorldMatrices();
+			}));
+
+		std::mt19937 random(1);
+		for (unsigned int changes : { 1, 10, 100, 1000 })
+		{
+			unsigned int groups = 0;
+			Benchmark::Timing timing = Benchmark::Measure(runs, [&]()
+				{
+					for (unsigned int i = 0; i < changes; i++)
+						store.SetScale(ids[random() % nodes], XMFLOAT3(1, 1, 1));
+					groups = store.UpdateWorldMatrices();
+				});
+			Benchmark::Report(std::string(shape) + ": update, " + std::to_string(changes) + " changed", timing);
+			printf("  %u of %u groups rebuilt in the last run\n", groups, store.GetCapacity() / 4);
+		}
+		Benchmark::KeepAlive(store.GetWorldMatrix(ids.back()));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int nodes = Benchmark::GetArgument(argc, argv, "nodes", 1000000);
+	unsigned int runs = Benchmark::GetArgument(argc, argv, "runs", 5);
+
+	Run("wide tree", nodes, runs, BuildWideTree);
+	Run("chains", nodes, runs, BuildChains);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "Benchmark.h"
+#include "Tests/SyntheticObj.h"
+#include "ObjParser.h"
+#include "MappedFile.h"
+#include "VertexWelder.h"
+
+#include <cmath>
+#include <unordered_map>
+
+// --------------------------------------------------------
+// Welds every triangle corner of a mesh three ways: the
+// std::to_string keys in a std::unordered_map that Mesh
+// used to build, VertexWelder in exact mode, and
+// VertexWelder on the v/vt/vn index triples.
+//
+//   VertexWelderBenchmark [--faces 1000000] [--runs 3]
+// --------------------------------------------------------
+
+namespace
+{
+	// The old dedup loop from Mesh(const char*)
+	size_t WeldWithStringKeys(const std::vector<Vertex>& vertsFromFile, std::vector<unsigned int>& indices)
+	{
+		std::unordered_map<std::string, unsigned int> vertMap;
+		std::vector<Vertex> finalVertices;
+		indices.clear();
+		for (const Vertex& v : vertsFromFile)
+		{
+			std::string vStr =
+				std::to_string(v.Position.x) +
+				std::to_string(v.Position.y) +
+				std::to_string(v.Position.z) +
+				std::to_string(v.Normal.x) +
+				std::to_string(v.Normal.y) +
+				std::to_string(v.Normal.z) +
+				std::to_string(v.UV.x) +
+				std::to_string(v.UV.y);
+
+			unsigned int index;
+			auto pair = vertMap.find(vStr);
+			if (pair == vertMap.end())
+			{
+				index = (unsigned int)finalVertices.size();
+				finalVertices.push_back(v);
+				vertMap.insert({ vStr, index });
+			}
+			else
+			{
+				index = pair->second;
+			}
+			indices.push_back(index);
+		}
+		return finalVertices.size();
+	}
+
+	size_t WeldExact(const std::vector<Vertex>& vertsFromFile, std::vector<unsigned int>& indices)
+	{
+		VertexWelder welder(WeldMode::Exact, vertsFromFile.size() / 4);
+		std::vector<Vertex> finalVertices;
+		indices.clear();
+		indices.reserve(vertsFromFile.size());
+		for (const Vertex& v : vertsFromFile)
+		{
+			bool isNew;
+			indices.push_back(welder.Weld(v, &isNew));
+			if (isNew)
+				finalVertices.push_back(v);
+		}
+		return finalVertices.size();
+	}
+
+	size_t WeldIndexTriples(const ObjParser::ObjData& data, std::vector<unsigned int>& indices)
+	{
+		VertexWelder welder(WeldMode::IndexTriple, data.triangles.size() / 4);
+		std::vector<Vertex> finalVertices;
+		indices.clear();
+		indices.reserve(data.triangles.size());
+		for (const ObjParser::FaceCorner& corner : data.triangles)
+		{
+			bool isNew;
+			indices.push_back(welder.Weld(corner.position, corner.uv, corner.normal, &isNew));
+			if (isNew)
+				finalVertices.push_back(ObjParser::BuildVertex(data, corner));
+		}
+		return finalVertices.size();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int faces = Benchmark::GetArgument(argc, argv, "faces", 1000000);
+	unsigned int runs = Benchmark::GetArgument(argc, argv, "runs", 3);
+
+	unsigned int columns = std::max(1u, (unsigned int)std::sqrt((double)faces));
+	unsigned int rows = std::max(1u, faces / columns);
+	std::string gridPath = (std::filesystem::path(Benchmark::GetOutputDirectory("VertexWelderBenchmark")) / "grid.obj").string();
+	SyntheticObj::WriteGrid(gridPath, columns, rows);
+
+	for (const std::string& path : { Benchmark::GetAssetPath("helix.obj"), gridPath })
+	{
+		std::string name = std::filesystem::path(path).filename().string();
+
+		MappedFile file(path.c_str());
+		ObjParser::ObjData data;
+		ObjParser::Parse(file.GetData(), file.GetEnd(), data);
+		std::vector<Vertex> vertsFromFile;
+		vertsFromFile.reserve(data.triangles.size());
+		for (const ObjParser::FaceCorner& corner : data.triangles)
+			vertsFromFile.push_back(ObjParser::BuildVertex(data, corner));
+		printf("%s: %zu corners\n", name.c_str(), vertsFromFile.size());
+
+		std::vector<unsigned int> oldIndices, exactIndices, tripleIndices;
+		size_t oldCount = 0, exactCount = 0, tripleCount = 0;
+		Benchmark::Report(name + " to_string keys + unordered_map", Benchmark::Measure(runs, [&]() { oldCount = WeldWithStringKeys(vertsFromFile, oldIndices); }));
+		Benchmark::Report(name + " VertexWelder exact", Benchmark::Measure(runs, [&]() { exactCount = WeldExact(vertsFromFile, exactIndices); }));
+		Benchmark::Report(name + " VertexWelder index triples", Benchmark::Measure(runs, [&]() { tripleCount = WeldIndexTriples(data, tripleIndices); }));
+		printf("  unique vertices: %zu / %zu / %zu\n", oldCount, exactCount, tripleCount);
+
+		// to_string keeps six decimals, so it can merge vertices exact mode
+		// keeps apart; otherwise the two must number vertices identically
+		if (oldCount == exactCount && oldIndices != exactIndices)
+			printf("  Exact mode numbered the vertices differently from the string keys\n");
+	}
+	return 0;
+}
\ No newline at end of file
@@ -43,12 +43,12 @@ float Camera::GetFarPlane()
 	return farPlane;
 }
 
-XMFLOAT4X4 Camera::GetViewMatrix()
+const XMFLOAT4X4& Camera::GetViewMatrix()
 {
 	return view;
 }
 
-XMFLOAT4X4 Camera::GetProjectionMatrix()
+const XMFLOAT4X4& Camera::GetProjectionMatrix()
 {
 	return projection;
 }
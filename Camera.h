@@ -19,9 +19,9 @@ public:
 	float GetFarPlane();
 	
 	// Returns the calculated view matrix
-	DirectX::XMFLOAT4X4 GetViewMatrix();
+	const DirectX::XMFLOAT4X4& GetViewMatrix();
 	// Returns the calculated projection matrix
-	DirectX::XMFLOAT4X4 GetProjectionMatrix();
+	const DirectX::XMFLOAT4X4& GetProjectionMatrix();
 
 	void UpdateViewMatrix();
 	void UpdateProjectionMatrix(float aspectRatio);
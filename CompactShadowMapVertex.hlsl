@@ -0,0 +1,15 @@
+#include "ShaderIncludes.hlsli"
+
+cbuffer ExternalData : register(b0)
+{
+    matrix world;
+    matrix view;
+    matrix projection;
+}
+
+// Same as ShadowMapVertex, for meshes stored in either compact vertex format
+float4 main(CompactVertexInput input) : SV_POSITION
+{
+    matrix wvp = mul(projection, mul(view, world));
+    return mul(wvp, float4(input.localPosition.xyz, 1.0f));
+}
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "CompactVertex.h"
+
+#include <cfloat>
+
+using namespace DirectX;
+using namespace DirectX::PackedVector;
+
+namespace
+{
+	// Normal and UV are packed the same way for both compact formats (the
+	// tangent's handedness is stored differently, so each does its own)
+	template<typename CompressedVertex>
+	void PackAttributes(const Vertex& vertex, CompressedVertex& output)
+	{
+		XMStoreShortN2(&output.Normal, VertexCompression::EncodeOctahedral(XMLoadFloat3(&vertex.Normal)));
+		XMStoreHalf2(&output.UV, XMLoadFloat2(&vertex.UV));
+	}
+
+	template<typename CompressedVertex>
+	void UnpackAttributes(const CompressedVertex& vertex, Vertex& output)
+	{
+		XMStoreFloat3(&output.Normal, VertexCompression::DecodeOctahedral(XMLoadShortN2(&vertex.Normal)));
+		XMStoreFloat2(&output.UV, XMLoadHalf2(&vertex.UV));
+	}
+
+	// The decoded tangent in xyz, and w from the sign of whichever
+	// component of select held the handedness
+	XMVECTOR XM_CALLCONV UnpackTangent(FXMVECTOR encoded, FXMVECTOR select, float threshold)
+	{
+		XMVECTOR handedness = XMVectorSelect(
+			XMVectorSplatOne(),
+			XMVectorNegate(XMVectorSplatOne()),
+			XMVectorLess(select, XMVectorReplicate(threshold)));
+		return XMVectorSelect(
+			VertexCompression::DecodeOctahedral(encoded),
+			handedness,
+			XMVectorSelectControl(0, 0, 0, 1));
+	}
+
+	// Reciprocal of the bounds' size, with flat axes mapping everything to 0
+	XMVECTOR XM_CALLCONV GetQuantizeScale(FXMVECTOR boundsMin, FXMVECTOR boundsMax)
+	{
+		XMVECTOR size = XMVectorSubtract(boundsMax, boundsMin);
+		return XMVectorSelect(
+			XMVectorReciprocal(size),
+			XMVectorZero(),
+			XMVectorLess(size, XMVectorReplicate(FLT_MIN)));
+	}
+}
+
+unsigned int VertexCompression::GetStride(VertexFormat format)
+{
+	switch (format)
+	{
+	case VertexFormat::Compact: return sizeof(CompactVertex);
+	case VertexFormat::Quantized: return sizeof(QuantizedVertex);
+	default: return sizeof(Vertex);
+	}
+}
+
+// --------------------------------------------------------
+// Projects onto the octahedron |x| + |y| + |z| = 1, then
+// folds the lower half (z < 0) out over the diagonals of
+// the upper half so the whole sphere covers the square
+// --------------------------------------------------------
+XMVECTOR XM_CALLCONV VertexCompression::EncodeOctahedral(FXMVECTOR direction)
+{
+	XMVECTOR lengthL1 = XMVector3Dot(XMVectorAbs(direction), XMVectorSplatOne());
+	XMVECTOR projected = XMVectorDivide(direction, XMVectorMax(lengthL1, XMVectorReplicate(FLT_MIN)));
+
+	XMVECTOR signs = XMVectorSelect(
+		XMVectorReplicate(-1.0f),
+		XMVectorSplatOne(),
+		XMVectorGreaterOrEqual(projected, XMVectorZero()));
+	XMVECTOR folded = XMVectorMultiply(
+		XMVectorSubtract(XMVectorSplatOne(), XMVectorAbs(XMVectorSwizzle<1, 0, 2, 3>(projected))),
+		signs);
+
+	return XMVectorSelect(
+		projected,
+		folded,
+		XMVectorLess(XMVectorSplatZ(projected), XMVectorZero()));
+}
+
+// --------------------------------------------------------
+// Z is whatever length is left over. Where it's negative
+// the point was folded, and moving x and y back towards
+// the axes by that amount unfolds it.
+// --------------------------------------------------------
+XMVECTOR XM_CALLCONV VertexCompression::DecodeOctahedral(FXMVECTOR encoded)
+{
+	XMVECTOR absolute = XMVectorAbs(encoded);
+	XMVECTOR z = XMVectorSubtract(
+		XMVectorSubtract(XMVectorSplatOne(), XMVectorSplatX(absolute)),
+		XMVectorSplatY(absolute));
+
+	XMVECTOR unfold = XMVectorSaturate(XMVectorNegate(z));
+	XMVECTOR xy = XMVectorSelect(
+		XMVectorAdd(encoded, unfold),
+		XMVectorSubtract(encoded, unfold),
+		XMVectorGreaterOrEqual(encoded, XMVectorZero()));
+
+	return XMVector3Normalize(XMVectorSelect(z, xy, XMVectorSelectControl(1, 1, 0, 0)));
+}
+
+XMMATRIX XM_CALLCONV VertexCompression::GetDequantizeMatrix(const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax)
+{
+	XMVECTOR minimum = XMLoadFloat3(&boundsMin);
+	XMVECTOR size = XMVectorSubtract(XMLoadFloat3(&boundsMax), minimum);
+	return XMMatrixMultiply(XMMatrixScalingFromVector(size), XMMatrixTranslationFromVector(minimum));
+}
+
+void VertexCompression::Compress(const Vertex* vertices, size_t count, CompactVertex* output)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		output[i].Position = vertices[i].Position;
+		PackAttributes(vertices[i], output[i]);
+
+		// Handedness moves into z, and w is cleared
+		XMVECTOR tangent = XMLoadFloat4(&vertices[i].Tangent);
+		XMVECTOR handedness = XMVectorAndInt(XMVectorSplatW(tangent), XMVectorSelectControl(0, 0, 1, 0));
+		XMStoreShortN4(&output[i].Tangent, XMVectorSelect(
+			EncodeOctahedral(tangent),
+			handedness,
+			XMVectorSelectControl(0, 0, 1, 1)));
+	}
+}
+
+void VertexCompression::Compress(const Vertex* vertices, size_t count, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax, QuantizedVertex* output)
+{
+	XMVECTOR minimum = XMLoadFloat3(&boundsMin);
+	XMVECTOR scale = GetQuantizeScale(minimum, XMLoadFloat3(&boundsMax));
+	for (size_t i = 0; i < count; i++)
+	{
+		// Handedness goes into w as 0 or 1
+		XMVECTOR position = XMLoadFloat3(&vertices[i].Position);
+		XMVECTOR tangent = XMLoadFloat4(&vertices[i].Tangent);
+		XMVECTOR handedness = XMVectorSelect(XMVectorSplatOne(), XMVectorZero(), XMVectorLess(XMVectorSplatW(tangent), XMVectorZero()));
+		XMStoreUShortN4(&output[i].Position, XMVectorSelect(
+			XMVectorMultiply(XMVectorSubtract(position, minimum), scale),
+			handedness,
+			XMVectorSelectControl(0, 0, 0, 1)));
+		XMStoreShortN2(&output[i].Tangent, EncodeOctahedral(tangent));
+		PackAttributes(vertices[i], output[i]);
+	}
+}
+
+Vertex VertexCompression::Decompress(const CompactVertex& vertex)
+{
+	Vertex output = {};
+	output.Position = vertex.Position;
+	UnpackAttributes(vertex, output);
+	XMVECTOR tangent = XMLoadShortN4(&vertex.Tangent);
+	XMStoreFloat4(&output.Tangent, UnpackTangent(tangent, XMVectorSplatZ(tangent), 0.0f));
+	return output;
+}
+
+Vertex VertexCompression::Decompress(const QuantizedVertex& vertex, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax)
+{
+	Vertex output = {};
+	XMVECTOR fraction = XMLoadUShortN4(&vertex.Position);
+	XMVECTOR position = XMVector3Transform(fraction, GetDequantizeMatrix(boundsMin, boundsMax));
+	XMStoreFloat3(&output.Position, position);
+	UnpackAttributes(vertex, output);
+	XMStoreFloat4(&output.Tangent, UnpackTangent(XMLoadShortN2(&vertex.Tangent), XMVectorSplatW(fraction), 0.5f));
+	return output;
+}
\ No newline at end of file
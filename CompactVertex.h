@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <DirectXMath.h>
+#include <DirectXPackedVector.h>
+#include "Vertex.h"
+
+// How a mesh's vertices are stored in its vertex buffer
+enum class VertexFormat
+{
+	Full,		// Vertex (48 bytes)
+	Compact,	// CompactVertex (28 bytes)
+	Quantized	// QuantizedVertex (20 bytes)
+};
+const unsigned int VertexFormatCount = 3;
+
+// --------------------------------------------------------
+// Vertex with every direction octahedral encoded into two
+// 16-bit normalized values and half-float UVs
+//
+// - Members are in the same order as Vertex, so the input
+//    layouts line up element for element
+// - Octahedral encoding keeps the error under 0.05 degrees
+//    across the whole sphere at 16 bits per component
+// - The tangent's handedness rides along in z of the encoded
+//    tangent (exactly -1 or 1), with w unused
+// --------------------------------------------------------
+struct CompactVertex
+{
+	DirectX::XMFLOAT3 Position;
+	DirectX::PackedVector::XMSHORTN2 Normal;
+	DirectX::PackedVector::XMHALF2 UV;
+	DirectX::PackedVector::XMSHORTN4 Tangent;
+};
+
+// Same as CompactVertex, but with the position stored as a 16-bit
+// normalized fraction of the way across the mesh's bounds
+// - The tangent's handedness takes the position's otherwise unused w
+//    (0 for -1, 1 for 1), so the tangent itself needs only two shorts
+// - Every member stays 4-byte aligned, as input layouts require
+struct QuantizedVertex
+{
+	DirectX::PackedVector::XMUSHORTN4 Position;
+	DirectX::PackedVector::XMSHORTN2 Normal;
+	DirectX::PackedVector::XMHALF2 UV;
+	DirectX::PackedVector::XMSHORTN2 Tangent;
+};
+
+// Converting to and from the compact formats. Everything is done with
+// DirectXMath vector operations, with no per-component branches.
+namespace VertexCompression
+{
+	// Size in bytes of one vertex of the given format
+	unsigned int GetStride(VertexFormat format);
+
+	// Maps a direction onto an octahedron unfolded into the [-1, 1] square
+	// (only x and y of the result are used). Zero length maps to +Z.
+	DirectX::XMVECTOR XM_CALLCONV EncodeOctahedral(DirectX::FXMVECTOR direction);
+	// Back to a unit length direction from x and y of the encoded value
+	DirectX::XMVECTOR XM_CALLCONV DecodeOctahedral(DirectX::FXMVECTOR encoded);
+
+	// Matrix taking a quantized position (0 - 1 on every axis) back into
+	// the mesh's local space, meant to be applied before the world matrix
+	DirectX::XMMATRIX XM_CALLCONV GetDequantizeMatrix(const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax);
+
+	void Compress(const Vertex* vertices, size_t count, CompactVertex* output);
+	void Compress(const Vertex* vertices, size_t count, const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax, QuantizedVertex* output);
+
+	Vertex Decompress(const CompactVertex& vertex);
+	Vertex Decompress(const QuantizedVertex& vertex, const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax);
+}
\ No newline at end of file
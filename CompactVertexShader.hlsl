@@ -0,0 +1,8 @@
+#include "ShaderIncludes.hlsli"
+#include "VertexTransform.hlsli"
+
+// Entry point for meshes stored in either compact vertex format
+VertexToPixel main(CompactVertexInput input)
+{
+    return TransformVertex(DecodeCompactVertex(input));
+}
\ No newline at end of file
@@ -15,6 +15,10 @@ struct VertexShaderConstData
 
 	DirectX::XMFLOAT4X4 lightView;
 	DirectX::XMFLOAT4X4 lightProjection;
+
+	// Takes quantized positions back into local space (identity for
+	// other formats), kept apart from world so tangents aren't skewed
+	DirectX::XMFLOAT4X4 dequantize;
 };
 
 // --------------------------------------------------------
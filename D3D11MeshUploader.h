@@ -0,0 +1,20 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include "MeshUploader.h"
+
+// Creates immutable Direct3D 11 vertex and index buffers for each upload
+class D3D11MeshUploader : public MeshUploader
+{
+public:
+	bool Upload(const MeshData& data) override;
+
+	// The buffers from the last successful upload
+	Microsoft::WRL::ComPtr<ID3D11Buffer> GetVertexBuffer() const;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> GetIndexBuffer() const;
+
+private:
+	Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer;
+};
\ No newline at end of file
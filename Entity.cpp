@@ -1,5 +1,7 @@
 #include "Entity.h"
 
+using namespace DirectX;
+
 Entity::Entity(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material)
 {
 	transform = Transform();
@@ -14,12 +16,62 @@ Transform* Entity::GetTransform()
 	return &transform;
 }
 
-std::shared_ptr<Mesh> Entity::GetMesh()
+Mesh* Entity::GetMesh()
 {
-	return mesh;
+	return mesh.get();
 }
 
-std::shared_ptr<Material> Entity::GetMaterial()
+Material* Entity::GetMaterial()
 {
-	return material;
+	return material.get();
 }
+
+
+BoundingBox Entity::GetWorldBoundingBox()
+{
+	const XMFLOAT4X4& world = transform.GetWorldMatrix();
+	BoundingBox worldBox;
+	mesh->GetBoundingBox().Transform(worldBox, XMLoadFloat4x4(&world));
+	return worldBox;
+}
+
+BoundingSphere Entity::GetWorldBoundingSphere()
+{
+	const XMFLOAT4X4& world = transform.GetWorldMatrix();
+	BoundingSphere worldSphere;
+	mesh->GetBoundingSphere().Transform(worldSphere, XMLoadFloat4x4(&world));
+	return worldSphere;
+}
+
+unsigned int Entity::SelectLod(Camera* camera, float screenHeight, float maxPixelError)
+{
+	// Meshes that are still loading have no levels at all
+	const std::vector<MeshLod>& lods = mesh->GetLods();
+	if (lods.size() <= 1)
+		return 0;
+
+	// Errors are in the mesh's units, so scale them along with the mesh
+	BoundingSphere sphere = GetWorldBoundingSphere();
+	float localRadius = mesh->GetBoundingSphere().Radius;
+	float scale = localRadius > 0.0f ? sphere.Radius / localRadius : 1.0f;
+
+	// The projection's y scale turns a size into a fraction of half the
+	// screen's height. An orthographic projection (w isn't taken from z,
+	// so _34 is 0) does that the same at any distance. A perspective one's
+	// y scale is 1 / tan(fov / 2), for sizes at a distance of 1.
+	const XMFLOAT4X4& projection = camera->GetProjectionMatrix();
+	float pixelsPerUnit = projection._22 * screenHeight * 0.5f;
+	if (projection._34 != 0.0f)
+	{
+		XMFLOAT3 cameraPosition = camera->GetTransform()->GetPosition();
+		float distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&sphere.Center) - XMLoadFloat3(&cameraPosition))) - sphere.Radius;
+		if (distance <= camera->GetNearPlane())
+			return 0;
+		pixelsPerUnit /= distance;
+	}
+
+	unsigned int lod = 0;
+	while (lod + 1 < lods.size() && lods[lod + 1].error * scale * pixelsPerUnit <= maxPixelError)
+		lod++;
+	return lod;
+}
\ No newline at end of file
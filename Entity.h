@@ -1,9 +1,11 @@
 #pragma once
 
 #include <memory>
+#include <DirectXCollision.h>
 #include "Transform.h"
 #include "Mesh.h"
 #include "Material.h"
+#include "Camera.h"
 
 // Stores and manipulates data for each entity
 class Entity
@@ -16,8 +18,21 @@ public:
 
 	Transform* GetTransform();
 
-	std::shared_ptr<Mesh> GetMesh();
-	std::shared_ptr<Material> GetMaterial();
+	// The entity keeps these alive, so there's no need to share ownership
+	// just to use them
+	Mesh* GetMesh();
+	Material* GetMaterial();
+
+	// The mesh's bounds moved into world space by the transform. The box
+	// still lines up with the world axes, so it grows when rotated.
+	DirectX::BoundingBox GetWorldBoundingBox();
+	DirectX::BoundingSphere GetWorldBoundingSphere();
+
+	// Picks the coarsest level of detail whose simplification error stays
+	// under maxPixelError pixels on a screen of the given height, using the
+	// camera's projection and the distance to the nearest point of the
+	// entity's bounding sphere
+	unsigned int SelectLod(Camera* camera, float screenHeight, float maxPixelError);
 
 private:
 	Transform transform;
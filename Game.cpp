@@ -5,10 +5,13 @@
 #include "PathHelpers.h"
 #include "Window.h"
 #include "ConstantBuffer.h"
+#include "MeshletBuilder.h"
+#include "MeshGenerator.h"
 
 #include <iostream>
 #include <cmath>
 #include <format>
+#include <span>
 #include <DirectXMath.h>
 #include <WICTextureLoader.h>
 
@@ -50,9 +53,9 @@ Game::Game()
 		Graphics::Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 		// Ensure the pipeline knows how to interpret all the numbers stored in
-		// the vertex buffer. For this course, all of your vertices will probably
-		// have the same layout, so we can just set this once at startup.
-		Graphics::Context->IASetInputLayout(inputLayout.Get());
+		// the vertex buffer. Entities set the layout matching their mesh's
+		// vertex format as they're drawn, so this is just the default.
+		Graphics::Context->IASetInputLayout(inputLayouts[(int)VertexFormat::Full].Get());
 	}
 
 	// Initialize ImGui itself & platform/renderer backends
@@ -82,19 +85,46 @@ Game::~Game()
 #pragma region Loading
 
 
+// --------------------------------------------------------
+// Runs one of MeshGenerator's shapes into arrays sized for it
+// and uploads the result right away (it's quick enough that
+// there's no need to involve the loader's threads)
+// --------------------------------------------------------
+template<typename Generator>
+static std::shared_ptr<Mesh> GenerateMesh(const char* name, MeshGenerator::Size size, const MeshImportSettings& settings, Generator generate)
+{
+	std::vector<Vertex> vertices(size.vertexCount);
+	std::vector<unsigned int> indices(size.indexCount);
+	generate(std::span<Vertex>(vertices), std::span<unsigned int>(indices));
+
+	MeshData data = MeshImporter::FromGenerated(std::move(vertices), std::move(indices), settings);
+	data.report.name = name;
+	return std::make_shared<Mesh>(data);
+}
+
 // --------------------------------------------------------
 // Loads the geometry we're going to draw
 // --------------------------------------------------------
 void Game::LoadMeshes()
 {
+	// The cube is also used by the sky, whose shader expects full vertices
+	MeshImportSettings compact;
+	compact.vertexFormat = VertexFormat::Quantized;
+
+	// Flat shapes have nothing to simplify
+	MeshImportSettings flat = compact;
+	flat.generateLods = false;
+
+	// Every basic shape is generated (at the detail of its .obj in
+	// Assets/Meshes), so none of them waits on a file
 	meshes = {
-		std::make_shared<Mesh>(FixPath("../../Assets/Meshes/Cube.obj").c_str()),
-		std::make_shared<Mesh>(FixPath("../../Assets/Meshes/Cylinder.obj").c_str()),
-		std::make_shared<Mesh>(FixPath("../../Assets/Meshes/Helix.obj").c_str()),
-		std::make_shared<Mesh>(FixPath("../../Assets/Meshes/Sphere.obj").c_str()),
-		std::make_shared<Mesh>(FixPath("../../Assets/Meshes/Torus.obj").c_str()),
-		std::make_shared<Mesh>(FixPath("../../Assets/Meshes/Quad.obj").c_str()),
-		std::make_shared<Mesh>(FixPath("../../Assets/Meshes/QuadDoubleSided.obj").c_str())
+		GenerateMesh("Cube", MeshGenerator::CubeSize(), MeshImportSettings(), [](auto v, auto i) { MeshGenerator::Cube(v, i); }),
+		GenerateMesh("Cylinder", MeshGenerator::CylinderSize(), compact, [](auto v, auto i) { MeshGenerator::Cylinder(v, i); }),
+		GenerateMesh("Helix", MeshGenerator::HelixSize(), compact, [](auto v, auto i) { MeshGenerator::Helix(v, i); }),
+		GenerateMesh("Sphere", MeshGenerator::SphereSize(), compact, [](auto v, auto i) { MeshGenerator::Sphere(v, i); }),
+		GenerateMesh("Torus", MeshGenerator::TorusSize(), compact, [](auto v, auto i) { MeshGenerator::Torus(v, i); }),
+		GenerateMesh("Quad", MeshGenerator::QuadSize(), flat, [](auto v, auto i) { MeshGenerator::Quad(v, i); }),
+		GenerateMesh("QuadDoubleSided", MeshGenerator::DoubleSidedQuadSize(), flat, [](auto v, auto i) { MeshGenerator::DoubleSidedQuad(v, i); })
 	};
 }
 
@@ -292,6 +322,9 @@ void Game::LoadMaterials()
 	ID3DBlob* pixelShaderBlob = LoadShaderBlob(L"PixelShader.cso");
 	Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader = LoadPixelShader(pixelShaderBlob);
 
+	ID3DBlob* compactVertexShaderBlob = LoadShaderBlob(L"CompactVertexShader.cso");
+	compactVertexShader = LoadVertexShader(compactVertexShaderBlob);
+
 	// Create an input layout 
 	//  - This describes the layout of data sent to a vertex shader
 	//  - In other words, it describes how to interpret data (numbers) in a vertex buffer
@@ -315,8 +348,8 @@ void Game::LoadMaterials()
 		inputElements[2].SemanticName = "TEXCOORD";
 		inputElements[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
 
-		// FLOAT3 Tangent
-		inputElements[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		// FLOAT4 Tangent (w is the handedness)
+		inputElements[3].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
 		inputElements[3].SemanticName = "TANGENT";
 		inputElements[3].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
 
@@ -326,7 +359,56 @@ void Game::LoadMaterials()
 			4,										// How many elements in that array?
 			vertexShaderBlob->GetBufferPointer(),	// Pointer to the code of a shader that uses this layout
 			vertexShaderBlob->GetBufferSize(),		// Size of the shader code that uses this layout
-			inputLayout.GetAddressOf());			// Address of the resulting ID3D11InputLayout pointer
+			inputLayouts[(int)VertexFormat::Full].GetAddressOf()); // Address of the resulting ID3D11InputLayout pointer
+	}
+
+	// Input layouts for the compact vertex formats (see CompactVertex.h)
+	//  - Same elements in the same order, just in smaller formats
+	//  - Both are read by the same vertex shader, which decodes them
+	//  - Quantized vertices keep the tangent's handedness in the
+	//     position's w, so their tangent is only two components
+	{
+		D3D11_INPUT_ELEMENT_DESC inputElements[4] = {};
+
+		// FLOAT3 Position (changed below for quantized positions)
+		inputElements[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		inputElements[0].SemanticName = "POSITION";
+		inputElements[0].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+
+		// SHORTN2 Octahedral normal
+		inputElements[1].Format = DXGI_FORMAT_R16G16_SNORM;
+		inputElements[1].SemanticName = "NORMAL";
+		inputElements[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+
+		// HALF2 UV
+		inputElements[2].Format = DXGI_FORMAT_R16G16_FLOAT;
+		inputElements[2].SemanticName = "TEXCOORD";
+		inputElements[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+
+		// SHORTN4 Octahedral tangent, with the handedness in z
+		inputElements[3].Format = DXGI_FORMAT_R16G16B16A16_SNORM;
+		inputElements[3].SemanticName = "TANGENT";
+		inputElements[3].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+
+		Graphics::Device->CreateInputLayout(
+			inputElements,
+			4,
+			compactVertexShaderBlob->GetBufferPointer(),
+			compactVertexShaderBlob->GetBufferSize(),
+			inputLayouts[(int)VertexFormat::Compact].GetAddressOf());
+
+		// USHORTN4 Position, as a fraction of the mesh's bounds (w is the handedness)
+		inputElements[0].Format = DXGI_FORMAT_R16G16B16A16_UNORM;
+
+		// SHORTN2 Octahedral tangent
+		inputElements[3].Format = DXGI_FORMAT_R16G16_SNORM;
+
+		Graphics::Device->CreateInputLayout(
+			inputElements,
+			4,
+			compactVertexShaderBlob->GetBufferPointer(),
+			compactVertexShaderBlob->GetBufferSize(),
+			inputLayouts[(int)VertexFormat::Quantized].GetAddressOf());
 	}
 
 	// Describe the sampler state used for textures
@@ -450,6 +532,9 @@ void Game::CreateCameras()
 		std::make_shared<Camera>(aspectRatio, XMFLOAT3(0.0f, 8.0f, -8.0f), XMFLOAT3(XM_PIDIV4, 0.0f, 0.0f), XM_PI * 0.35f)
 	};
 	activeCameraIndex = 0;
+	lodPixelError = 1.0f;
+	meshletCulling = true;
+	meshletStats = {};
 }
 
 
@@ -610,9 +695,11 @@ void Game::CreateShadows()
 		128.0f);
 	XMStoreFloat4x4(&shadows.lightProjectionMatrix, lightProjection);
 
-	// Load the simplified vertex shader
+	// Load the simplified vertex shaders
 	ID3DBlob* vertexShaderBlob = LoadShaderBlob(L"ShadowMapVertex.cso");
 	shadows.vertexShader = LoadVertexShader(vertexShaderBlob);
+	vertexShaderBlob = LoadShaderBlob(L"CompactShadowMapVertex.cso");
+	shadows.compactVertexShader = LoadVertexShader(vertexShaderBlob);
 }
 
 
@@ -768,6 +855,11 @@ void Game::OnResize()
 // --------------------------------------------------------
 void Game::Update(float deltaTime, float totalTime)
 {
+	// Create the buffers of any meshes that finished importing since last
+	// frame, then release unused ones if that went over the memory budget
+	meshLoader.FinalizeReady();
+	meshRegistry.Update();
+
 	UpdateImGui(deltaTime, totalTime);
 	BuildUI();
 
@@ -780,6 +872,10 @@ void Game::Update(float deltaTime, float totalTime)
 		entities[i]->GetTransform()->Rotate(deltaTime * 0.02f, deltaTime * 0.5f, 0.0f);
 	}
 
+	// Rebuild the world matrices of everything that moved this frame in
+	// one batch, so drawing only ever reads them
+	TransformStore::GetDefault().UpdateWorldMatrices();
+
 	// Example input checking: Quit if the escape key is pressed
 	if (Input::KeyDown(VK_ESCAPE))
 		Window::Quit();
@@ -821,13 +917,15 @@ void Game::Draw(float deltaTime, float totalTime)
 	// DRAW geometry
 	// - These steps are generally repeated for EACH object you draw
 	{
+		meshletStats = {};
 		for (unsigned int i = 0; i < entities.size(); i++)
 		{
-			DrawEntity(entities[i], totalTime);
+			DrawEntity(*entities[i], totalTime);
 		}
 	}
 
 	// Draw the sky after geometry to avoid overdraw
+	Graphics::Context->IASetInputLayout(inputLayouts[(int)VertexFormat::Full].Get());
 	sky->Draw(cameras[activeCameraIndex].get());
 
 	// Post scene render
@@ -862,17 +960,36 @@ void Game::Draw(float deltaTime, float totalTime)
 // --------------------------------------------------------
 // Helper function called for each entity during Draw()
 // --------------------------------------------------------
-void Game::DrawEntity(std::shared_ptr<Entity> entity, float totalTime)
+void Game::DrawEntity(Entity& entity, float totalTime)
 {
+	// Nothing to draw until the mesh has loaded
+	Mesh* mesh = entity.GetMesh();
+	Material* material = entity.GetMaterial();
+	if (!mesh->IsReady())
+		return;
+
 	// Bind the current shaders based on the entity's materials
-	entity->GetMaterial()->BindShaders();
+	material->BindShaders();
+
+	// Compact meshes need their own input layout and a vertex shader that decodes them
+	VertexFormat format = mesh->GetVertexFormat();
+	Graphics::Context->IASetInputLayout(inputLayouts[(int)format].Get());
+	if (format != VertexFormat::Full)
+		Graphics::Context->VSSetShader(compactVertexShader.Get(), 0, 0);
 
 	// Update vertex shader constant buffer values
 	{
 		// Set up the buffer data struct
+		// - Quantized positions are mapped back into place by their own
+		//    matrix, so neither the normals' nor the tangents' is touched
+		// - With uniform scale the world matrix turns normals correctly
+		//    too (the pixel shader renormalizes them)
 		VertexShaderConstData externalData = {};
-		externalData.world = entity->GetTransform()->GetWorldMatrix();
-		externalData.worldInvTranspose = entity->GetTransform()->GetWorldInverseTransposeMatrix();
+		Transform* transform = entity.GetTransform();
+		const XMFLOAT4X4& world = transform->GetWorldMatrix();
+		externalData.world = world;
+		externalData.dequantize = mesh->GetDequantizeMatrix();
+		externalData.worldInvTranspose = transform->HasUniformScale() ? world : transform->GetWorldInverseTransposeMatrix();
 		externalData.view = cameras[activeCameraIndex]->GetViewMatrix();
 		externalData.projection = cameras[activeCameraIndex]->GetProjectionMatrix();
 
@@ -890,9 +1007,9 @@ void Game::DrawEntity(std::shared_ptr<Entity> entity, float totalTime)
 	{
 		// Set up the buffer data struct
 		PixelShaderConstData externalData = {};
-		externalData.textureScale = entity->GetMaterial()->GetTextureScale();
-		externalData.textureOffset = entity->GetMaterial()->GetTextureOffset();
-		externalData.tint = entity->GetMaterial()->GetTint();
+		externalData.textureScale = material->GetTextureScale();
+		externalData.textureOffset = material->GetTextureOffset();
+		externalData.tint = material->GetTint();
 		externalData.cameraPosition = cameras[activeCameraIndex]->GetTransform()->GetPosition();
 		externalData.time = totalTime;
 		externalData.lightAmbient = lightAmbient;
@@ -910,14 +1027,41 @@ void Game::DrawEntity(std::shared_ptr<Entity> entity, float totalTime)
 			0);
 	}
 
-	entity->GetMaterial()->BindTexturesAndSamplers();
+	material->BindTexturesAndSamplers();
 
 	// Bind shadow map resources
 	Graphics::Context->PSSetShaderResources(4, 1, shadows.texture.GetAddressOf());
 	Graphics::Context->PSSetSamplers(1, 1, shadows.sampler.GetAddressOf());
 
-	// Perform the draw call on the entity's mesh
-	entity->GetMesh()->Draw();
+	// Perform the draw call on the entity's mesh, at the detail its size on screen needs
+	unsigned int lod = entity.SelectLod(cameras[activeCameraIndex].get(), (float)Window::Height(), lodPixelError);
+	if (lod == 0 && meshletCulling && !mesh->GetMeshlets().empty())
+	{
+		// Only the meshlets that can be seen (entities are drawn with back face culling)
+		const XMFLOAT4X4& world = entity.GetTransform()->GetWorldMatrix();
+		const XMFLOAT4X4& view = cameras[activeCameraIndex]->GetViewMatrix();
+		const XMFLOAT4X4& projection = cameras[activeCameraIndex]->GetProjectionMatrix();
+		MeshletCuller::Stats stats = MeshletCuller::Cull(
+			mesh->GetMeshlets(),
+			XMLoadFloat4x4(&world),
+			XMLoadFloat4x4(&view),
+			XMLoadFloat4x4(&projection),
+			true,
+			meshletRanges);
+
+		meshletStats.meshlets += stats.meshlets;
+		meshletStats.visibleMeshlets += stats.visibleMeshlets;
+		meshletStats.frustumCulled += stats.frustumCulled;
+		meshletStats.backfaceCulled += stats.backfaceCulled;
+		meshletStats.triangles += stats.triangles;
+		meshletStats.visibleTriangles += stats.visibleTriangles;
+
+		mesh->DrawRanges(meshletRanges);
+	}
+	else
+	{
+		mesh->DrawLod(lod);
+	}
 }
 
 
@@ -937,8 +1081,7 @@ void Game::DrawShadowMap()
 	viewport.MaxDepth = 1.0f;
 	Graphics::Context->RSSetViewports(1, &viewport);
 
-	// Set vertex shader
-	Graphics::Context->VSSetShader(shadows.vertexShader.Get(), 0, 0);
+	// Vertex shader is set per entity below
 	// Set empty pixel shader
 	Graphics::Context->PSSetShader(0, 0, 0);
 
@@ -958,11 +1101,25 @@ void Game::DrawShadowMap()
 	// Draw all entities from the "camera" position of the shadow light
 	for (unsigned int i = 0; i < entities.size(); i++)
 	{
-		externalData.world = entities[i]->GetTransform()->GetWorldMatrix();
+		// Match the vertex format of the mesh, as in DrawEntity()
+		Mesh* mesh = entities[i]->GetMesh();
+		if (!mesh->IsReady())
+			continue;
+
+		VertexFormat format = mesh->GetVertexFormat();
+		Graphics::Context->IASetInputLayout(inputLayouts[(int)format].Get());
+		Graphics::Context->VSSetShader(
+			format == VertexFormat::Full ? shadows.vertexShader.Get() : shadows.compactVertexShader.Get(), 0, 0);
+
+		// Only positions are transformed here, so dequantizing can fold into world
+		const XMFLOAT4X4& world = entities[i]->GetTransform()->GetWorldMatrix();
+		const XMFLOAT4X4& dequantize = mesh->GetDequantizeMatrix();
+		XMStoreFloat4x4(&externalData.world, XMMatrixMultiply(XMLoadFloat4x4(&dequantize), XMLoadFloat4x4(&world)));
 		Graphics::FillAndBindNextConstantBuffer(&externalData, sizeof(externalData), D3D11_VERTEX_SHADER, 0);
 
-		// Perform the draw call on the entity's mesh
-		entities[i]->GetMesh()->Draw();
+		// Perform the draw call on the entity's mesh, matching the detail
+		// seen from the camera so surfaces don't shadow themselves
+		mesh->DrawLod(entities[i]->SelectLod(cameras[activeCameraIndex].get(), (float)Window::Height(), lodPixelError));
 	}
 
 	// Reset API state
@@ -1079,6 +1236,10 @@ void Game::BuildUI()
 	// Display the current window size (%d replaced in order)
 	ImGui::Text("Window client size: %dx%d", Window::Width(), Window::Height());
 
+	unsigned int loading = meshLoader.GetPendingCount();
+	if (loading > 0)
+		ImGui::Text("Loading %u meshes (%u threads)", loading, meshLoader.GetThreadCount());
+
 	// Show camera data and swapping
 	if (ImGui::TreeNode("Cameras"))
 	{
@@ -1090,6 +1251,19 @@ void Game::BuildUI()
 		ImGui::Text("Rotation: %f, %f, %f", rotation.x, rotation.y, rotation.z);
 		ImGui::Text("Aspect Ratio: %f", active->GetAspectRatio());
 		ImGui::Text("FOV: %f", active->GetFOV());
+		ImGui::DragFloat("LOD Pixel Error", &lodPixelError, 0.1f, 0.0f, 50.0f);
+
+		// Totals over every full detail entity drawn last frame
+		ImGui::Checkbox("Meshlet Culling", &meshletCulling);
+		if (meshletCulling && meshletStats.triangles > 0)
+		{
+			ImGui::Text("Meshlets: %u of %u drawn (%u outside the view, %u facing away)",
+				meshletStats.visibleMeshlets, meshletStats.meshlets,
+				meshletStats.frustumCulled, meshletStats.backfaceCulled);
+			ImGui::Text("Triangles: %u of %u drawn (%.1f%% rejected)",
+				meshletStats.visibleTriangles, meshletStats.triangles,
+				100.0f * (meshletStats.triangles - meshletStats.visibleTriangles) / meshletStats.triangles);
+		}
 
 		ImGui::Text("Swap Active Camera:");
 		// Create inputs for swapping the current camera
@@ -1104,6 +1278,43 @@ void Game::BuildUI()
 	// Show a panel for displaying debug information on the meshes
 	if (ImGui::TreeNode("Meshes"))
 	{
+		// GPU memory of every mesh, compared to full vertices and 32-bit indices
+		size_t vertexBytes = 0;
+		size_t fullVertexBytes = 0;
+		size_t indexBytes = 0;
+		size_t fullIndexBytes = 0;
+		for (auto& mesh : meshes)
+		{
+			vertexBytes += (size_t)VertexCompression::GetStride(mesh->GetVertexFormat()) * mesh->GetVertexBufferCount();
+			fullVertexBytes += sizeof(Vertex) * mesh->GetVertexBufferCount();
+			indexBytes += (size_t)mesh->GetIndexStride() * mesh->GetIndexBufferCount();
+			fullIndexBytes += sizeof(unsigned int) * mesh->GetIndexBufferCount();
+		}
+		ImGui::Text("Vertex Memory: %zu bytes (%zu saved)", vertexBytes, fullVertexBytes - vertexBytes);
+		ImGui::Text("Index Memory: %zu bytes (%zu saved)", indexBytes, fullIndexBytes - indexBytes);
+
+		// Everything the registry holds, including meshes no entity uses
+		MeshRegistry::Stats registry = meshRegistry.GetStats();
+		ImGui::Text("Registry: %u meshes (%u loading, %u unused), %zu KB CPU, %zu KB GPU",
+			registry.meshes, registry.loading, registry.unreferenced,
+			registry.cpuBytes / 1024, registry.gpuBytes / 1024);
+		ImGui::Text("Shared requests: %u, duplicates: %u, evictions: %u", registry.sharedRequests, registry.duplicates, registry.evictions);
+		int budget = (int)(meshRegistry.GetMemoryBudget() / (1024 * 1024));
+		if (ImGui::DragInt("Memory Budget (MB)", &budget, 1.0f, 0, 4096))
+			meshRegistry.SetMemoryBudget((size_t)budget * 1024 * 1024);
+
+		// Every ready mesh's import report, for the asset dashboards
+		if (ImGui::Button("Export Import Reports"))
+		{
+			std::vector<const ImportReport*> reports;
+			for (auto& mesh : meshes)
+			{
+				if (mesh->IsReady())
+					reports.push_back(&mesh->GetImportReport());
+			}
+			ImportReport::WriteJson(FixPath("ImportReports.json").c_str(), reports);
+		}
+
 		for (unsigned int i = 0; i < meshes.size(); i++)
 		{
 			BuildMeshUI(meshes[i].get(), i);
@@ -1169,13 +1380,99 @@ void Game::BuildUI()
 // Build a UI to display debug information about a mesh
 void Game::BuildMeshUI(Mesh* mesh, int index)
 {
+	if (!mesh->IsReady())
+	{
+		ImGui::Text("Mesh %d (loading)", index);
+		return;
+	}
+
 	if (!ImGui::TreeNode(std::format("Mesh {}", index).c_str()))
 		return;
 
-	ImGui::Text("Triangles: %d", mesh->GetIndexBufferCount() / 3);
+	const std::vector<MeshLod>& lods = mesh->GetLods();
+	ImGui::Text("Triangles: %u", lods[0].indexCount / 3);
 	ImGui::Text("Vertices: %d", mesh->GetVertexBufferCount());
 	ImGui::Text("Indices: %d", mesh->GetIndexBufferCount());
 
+	const DirectX::BoundingBox& box = mesh->GetBoundingBox();
+	const DirectX::BoundingSphere& sphere = mesh->GetBoundingSphere();
+	ImGui::Text("Bounding Box: center (%.2f, %.2f, %.2f), extents (%.2f, %.2f, %.2f)",
+		box.Center.x, box.Center.y, box.Center.z, box.Extents.x, box.Extents.y, box.Extents.z);
+	ImGui::Text("Bounding Sphere: center (%.2f, %.2f, %.2f), radius %.2f",
+		sphere.Center.x, sphere.Center.y, sphere.Center.z, sphere.Radius);
+
+	const char* formatNames[VertexFormatCount] = { "Full", "Compact", "Quantized" };
+	unsigned int stride = VertexCompression::GetStride(mesh->GetVertexFormat());
+	ImGui::Text("Vertex Format: %s (%u bytes, %u bytes for full vertices)",
+		formatNames[(int)mesh->GetVertexFormat()],
+		stride * mesh->GetVertexBufferCount(),
+		(unsigned int)sizeof(Vertex) * mesh->GetVertexBufferCount());
+
+	ImGui::Text("Index Format: %u-bit (%u bytes)",
+		mesh->GetIndexStride() * 8,
+		mesh->GetIndexStride() * mesh->GetIndexBufferCount());
+	if (!mesh->GetMeshlets().empty())
+	{
+		ImGui::Text("Meshlets: %u (up to %u vertices and %u triangles each)",
+			(unsigned int)mesh->GetMeshlets().size(), MeshletBuilder::MaxVertices, MeshletBuilder::MaxTriangles);
+	}
+
+	// Simulated post-transform vertex cache (lower is better for both)
+	const MeshOptimizer::CacheStats& cache = mesh->GetVertexCacheStats();
+	const MeshOptimizer::CacheStats& original = mesh->GetOriginalVertexCacheStats();
+	ImGui::Text("ACMR: %.3f, ATVR: %.3f", cache.acmr, cache.atvr);
+	if (original.acmr > 0.0f)
+		ImGui::Text("Before optimizing - ACMR: %.3f, ATVR: %.3f", original.acmr, original.atvr);
+
+	// Problems in the source (kept in the cache, so always known)
+	const ImportReport& report = mesh->GetImportReport();
+	const ObjParser::SourceStats& parsed = report.source.parsed;
+	ImGui::Text("Import: %.2f ms%s, %llu vertices before welding, %llu after",
+		report.importMilliseconds, report.fromCache ? " (cached)" : "",
+		parsed.triangleCount * 3, report.source.weldedVertexCount);
+	if (parsed.invalidIndexCount > 0 || parsed.unusedPositionCount > 0 || parsed.nonFiniteValueCount > 0 || report.degenerateTriangleCount > 0)
+	{
+		ImGui::Text("Warnings: %llu invalid indices, %llu unused positions, %llu non-finite values, %u degenerate triangles",
+			parsed.invalidIndexCount, parsed.unusedPositionCount, parsed.nonFiniteValueCount, report.degenerateTriangleCount);
+	}
+
+	// Only known if the tangents were generated on this load
+	const TangentGenerator::Stats& tangents = mesh->GetTangentStats();
+	if (tangents.degenerateTriangles > 0 || tangents.fallbackTangents > 0 || tangents.mirrorSplits > 0)
+	{
+		ImGui::Text("Tangents: %u degenerate triangles, %u fallback tangents, %u mirror seam splits",
+			tangents.degenerateTriangles, tangents.fallbackTangents, tangents.mirrorSplits);
+	}
+
+	// Triangle count versus error for each level of detail
+	if (ImGui::TreeNode(std::format("Levels of Detail ({})", lods.size()).c_str()))
+	{
+		float radius = mesh->GetBoundingSphere().Radius;
+		for (unsigned int i = 0; i < lods.size(); i++)
+		{
+			ImGui::Text("LOD %u: %u triangles (%.1f%%), error %.4f (%.2f%% of radius)",
+				i,
+				lods[i].indexCount / 3,
+				100.0f * lods[i].indexCount / lods[0].indexCount,
+				lods[i].error,
+				radius > 0.0f ? 100.0f * lods[i].error / radius : 0.0f);
+		}
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode(std::format("Submeshes ({})", mesh->GetSubmeshCount()).c_str()))
+	{
+		for (const Submesh& submesh : mesh->GetSubmeshes())
+		{
+			ImGui::Text("%s [%s]: %u triangles from index %u",
+				submesh.name.empty() ? "(unnamed)" : submesh.name.c_str(),
+				submesh.materialName.empty() ? "no material" : submesh.materialName.c_str(),
+				submesh.indexCount / 3,
+				submesh.indexStart);
+		}
+		ImGui::TreePop();
+	}
+
 	ImGui::TreePop();
 }
 
@@ -1233,6 +1530,13 @@ void Game::BuildEntityUI(Entity* entity, int index)
 
 	// Add label for debug information
 	ImGui::Text("Mesh Index Count: %d", entity->GetMesh()->GetIndexBufferCount());
+	ImGui::Text("Level of Detail: %u (%u available)",
+		entity->SelectLod(cameras[activeCameraIndex].get(), (float)Window::Height(), lodPixelError),
+		entity->GetMesh()->GetLodCount());
+
+	DirectX::BoundingSphere sphere = entity->GetWorldBoundingSphere();
+	ImGui::Text("World Bounding Sphere: (%.2f, %.2f, %.2f), radius %.2f",
+		sphere.Center.x, sphere.Center.y, sphere.Center.z, sphere.Radius);
 
 	ImGui::TreePop();
 }
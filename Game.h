@@ -13,6 +13,9 @@
 #include "TextureSetResources.h"
 #include "ShadowSettings.h"
 #include "PostProcessSettings.h"
+#include "MeshletCuller.h"
+#include "MeshLoader.h"
+#include "MeshRegistry.h"
 
 class Game
 {
@@ -46,14 +49,21 @@ private:
 	void RecreatePPBuffer();
 
 	// Drawing helper methods
-	void DrawEntity(std::shared_ptr<Entity> entity, float totalTime);
-
-	// Loaded asset data
+	void DrawEntity(Entity& entity, float totalTime);
+
+	// Loaded asset data. Meshes are imported in the background and
+	// finalized at the start of each Update(), so they may not be ready.
+	// The registry shares meshes between requests and releases the ones
+	// nothing uses anymore when over its memory budget.
+	MeshLoader meshLoader;
+	MeshRegistry meshRegistry{ meshLoader };
 	std::vector<std::shared_ptr<Mesh>> meshes;
 	TextureSetResources textures;
 
-	// Shared input layout for shaders
-	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout;
+	// Input layouts for each VertexFormat, and the vertex shader used
+	// instead of the material's for meshes in a compact format
+	Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayouts[VertexFormatCount];
+	Microsoft::WRL::ComPtr<ID3D11VertexShader> compactVertexShader;
 
 	// Loaded material data
 	std::vector<std::shared_ptr<Material>> materials;
@@ -65,6 +75,17 @@ private:
 	std::vector<std::shared_ptr<Camera>> cameras;
 	int activeCameraIndex;
 
+	// Entities draw the coarsest level of detail whose simplification
+	// error stays under this many pixels from the active camera
+	float lodPixelError;
+
+	// Full detail meshes skip meshlets the active camera can't see. The
+	// stats are summed over every entity drawn in the last frame, and the
+	// ranges are reused between entities to avoid reallocating.
+	bool meshletCulling;
+	MeshletCuller::Stats meshletStats;
+	std::vector<IndexRange> meshletRanges;
+
 	// Lighting data
 	DirectX::XMFLOAT4 lightAmbient;
 	std::vector<Light> lights; // All active lights in the scene
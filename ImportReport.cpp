@@ -0,0 +1,136 @@
+#include "ImportReport.h"
+
+#include <cmath>
+#include <cstdio>
+#include <charconv>
+#include <fstream>
+
+using namespace DirectX;
+
+namespace
+{
+	// Quotes a string, escaping whatever JSON doesn't allow as-is
+	// (Windows paths are full of backslashes)
+	std::string Quote(const std::string& text)
+	{
+		std::string quoted = "\"";
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+			{
+				quoted += '\\';
+				quoted += c;
+			}
+			else if ((unsigned char)c < 0x20)
+			{
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)c);
+				quoted += escaped;
+			}
+			else
+			{
+				quoted += c;
+			}
+		}
+		return quoted + "\"";
+	}
+
+	// The shortest text that reads back as the same float. JSON has no
+	// NaN or infinity.
+	std::string Number(float value)
+	{
+		if (!std::isfinite(value))
+			return "null";
+
+		char text[32];
+		return std::string(text, std::to_chars(text, text + sizeof(text), value).ptr);
+	}
+
+	std::string Integer(uint64_t value)
+	{
+		return std::to_string(value);
+	}
+
+	std::string Bool(bool value)
+	{
+		return value ? "true" : "false";
+	}
+
+	// One "name": value line, indented to the given depth
+	std::string Field(int depth, const char* name, const std::string& value, bool last = false)
+	{
+		return std::string(depth, '\t') + "\"" + name + "\": " + value + (last ? "\n" : ",\n");
+	}
+
+	std::string Vector(const XMFLOAT3& value)
+	{
+		return "[" + Number(value.x) + ", " + Number(value.y) + ", " + Number(value.z) + "]";
+	}
+}
+
+std::string ImportReport::ToJson() const
+{
+	const char* formatNames[VertexFormatCount] = { "Full", "Compact", "Quantized" };
+	const ObjParser::SourceStats& parsed = source.parsed;
+
+	char milliseconds[32];
+	snprintf(milliseconds, sizeof(milliseconds), "%.3f", importMilliseconds);
+
+	char hash[17];
+	snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)sourceHash);
+
+	std::string json = "{\n";
+	json += Field(1, "name", Quote(name));
+	json += Field(1, "sourceHash", Quote(hash));
+	json += Field(1, "fromCache", Bool(fromCache));
+	json += Field(1, "importMilliseconds", milliseconds);
+
+	json += "\t\"source\": {\n";
+	json += Field(2, "positionCount", Integer(parsed.positionCount));
+	json += Field(2, "normalCount", Integer(parsed.normalCount));
+	json += Field(2, "uvCount", Integer(parsed.uvCount));
+	json += Field(2, "triangleCount", Integer(parsed.triangleCount));
+	json += Field(2, "vertexCountBeforeWeld", Integer(parsed.triangleCount * 3));
+	json += Field(2, "vertexCountAfterWeld", Integer(source.weldedVertexCount));
+	json += Field(2, "invalidIndexCount", Integer(parsed.invalidIndexCount));
+	json += Field(2, "unusedPositionCount", Integer(parsed.unusedPositionCount));
+	json += Field(2, "nonFiniteValueCount", Integer(parsed.nonFiniteValueCount));
+	json += Field(2, "originalAcmr", Number(source.originalAcmr), true);
+	json += "\t},\n";
+
+	json += Field(1, "vertexFormat", Quote(formatNames[(int)vertexFormat]));
+	json += Field(1, "vertexCount", Integer(vertexCount));
+	json += Field(1, "triangleCount", Integer(triangleCount));
+	json += Field(1, "degenerateTriangleCount", Integer(degenerateTriangleCount));
+	json += Field(1, "submeshCount", Integer(submeshCount));
+	json += Field(1, "lodCount", Integer(lodCount));
+	json += Field(1, "meshletCount", Integer(meshletCount));
+	json += Field(1, "boundsCenter", Vector(boundingBox.Center));
+	json += Field(1, "boundsExtents", Vector(boundingBox.Extents));
+	json += Field(1, "acmr", Number(acmr));
+	json += Field(1, "atvr", Number(atvr));
+	json += Field(1, "vertexBytes", Integer(vertexBytes));
+	json += Field(1, "indexBytes", Integer(indexBytes));
+	json += Field(1, "tableBytes", Integer(tableBytes), true);
+	json += "}";
+	return json;
+}
+
+bool ImportReport::WriteJson(const char* filePath, const std::vector<const ImportReport*>& reports)
+{
+	std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+	if (!out.is_open())
+		return false;
+
+	out << "[";
+	for (size_t i = 0; i < reports.size(); i++)
+	{
+		// Indent each object one level inside the array
+		std::string json = reports[i]->ToJson();
+		for (size_t at = json.find('\n'); at != std::string::npos; at = json.find('\n', at + 2))
+			json.insert(at + 1, "\t");
+		out << (i == 0 ? "\n\t" : ",\n\t") << json;
+	}
+	out << "\n]\n";
+	return out.good();
+}
\ No newline at end of file
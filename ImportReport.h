@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <DirectXCollision.h>
+#include "CompactVertex.h"
+#include "ObjParser.h"
+
+// What importing a mesh found in its source and what it produced, to
+// catch assets that quietly waste memory or GPU time. MeshImporter fills
+// it in alongside the work it's already doing, rather than in a separate
+// validation pass.
+struct ImportReport
+{
+	// Found while reading and welding the source. Cooked files keep a
+	// copy, so this is the same whether or not the cache was used.
+	struct Source
+	{
+		ObjParser::SourceStats parsed;
+		uint64_t weldedVertexCount;	// Unique vertices left after welding the corners
+		float originalAcmr;			// Before the vertex cache optimization (0 if it didn't run)
+		uint32_t reserved;
+	};
+
+	// Measured on the full detail triangles as they are uploaded. Cooked
+	// files keep a copy of this too, so a cache hit doesn't have to walk
+	// the vertices and indices again to report it.
+	struct Measured
+	{
+		uint32_t degenerateTriangleCount;
+		float acmr;
+		float atvr;
+		uint32_t reserved;
+	};
+
+	std::string name;			// Source file path, or a name given to a mesh built in code
+	uint64_t sourceHash = 0;	// Of the source file's bytes (see MeshCache::HashBytes), 0 for meshes built in code
+	bool fromCache = false;
+	double importMilliseconds = 0.0;
+	Source source = {};
+
+	// The full detail triangles as uploaded
+	VertexFormat vertexFormat = VertexFormat::Full;
+	unsigned int vertexCount = 0;
+	unsigned int triangleCount = 0;
+	unsigned int degenerateTriangleCount = 0;	// Repeated indices or no area
+	unsigned int submeshCount = 0;
+	unsigned int lodCount = 0;
+	unsigned int meshletCount = 0;
+	DirectX::BoundingBox boundingBox;
+	float acmr = 0.0f;
+	float atvr = 0.0f;
+
+	// Memory footprint in bytes. Indices include every level of detail,
+	// and tables are the submeshes, levels of detail and meshlets kept on
+	// the CPU.
+	size_t vertexBytes = 0;
+	size_t indexBytes = 0;
+	size_t tableBytes = 0;
+
+	// A single JSON object, with names matching the members above
+	std::string ToJson() const;
+
+	// Writes a JSON array of reports (for asset dashboards). Returns
+	// false if the file couldn't be written.
+	static bool WriteJson(const char* filePath, const std::vector<const ImportReport*>& reports);
+};
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// 16-bit indices can address vertices 0 through 65535
+const unsigned int MaxShortIndexVertexCount = 65536;
+
+// Smallest index size (in bytes) able to address every vertex of a mesh
+inline unsigned int GetIndexStride(unsigned int vertexCount)
+{
+	return vertexCount <= MaxShortIndexVertexCount ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+// Copies 32-bit indices into 16 bits (every index must fit)
+inline std::vector<uint16_t> NarrowIndices(const unsigned int* indices, size_t indexCount)
+{
+	std::vector<uint16_t> narrowed(indexCount);
+	for (size_t i = 0; i < indexCount; i++)
+		narrowed[i] = (uint16_t)indices[i];
+	return narrowed;
+}
\ No newline at end of file
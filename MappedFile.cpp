@@ -0,0 +1,127 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+
+#include <Windows.h>
+
+MappedFile::MappedFile(const char* filePath)
+{
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = 0;
+	data = 0;
+	size = 0;
+
+	// Open for reading only, and hint that it will be read front to back
+	HANDLE file = CreateFileA(
+		filePath,
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		0,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		0);
+	if (file == INVALID_HANDLE_VALUE)
+		throw std::invalid_argument("Error opening file: Invalid file path or file is inaccessible");
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize = {};
+	GetFileSizeEx(file, &fileSize);
+	size = (size_t)fileSize.QuadPart;
+
+	// Empty files can't be mapped, but are still valid (just no data)
+	if (size == 0)
+		return;
+
+	HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		throw std::runtime_error("Error mapping file into memory");
+	}
+	mappingHandle = mapping;
+
+	data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		throw std::runtime_error("Error mapping file into memory");
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if (data)
+		UnmapViewOfFile(data);
+	if (mappingHandle)
+		CloseHandle((HANDLE)mappingHandle);
+	if (fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle((HANDLE)fileHandle);
+}
+
+#else
+
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Same as above with POSIX calls, storing the file descriptor in
+// fileHandle (there's no separate mapping object to keep)
+MappedFile::MappedFile(const char* filePath)
+{
+	fileHandle = (void*)(intptr_t)-1;
+	mappingHandle = 0;
+	data = 0;
+	size = 0;
+
+	int file = open(filePath, O_RDONLY);
+	if (file == -1)
+		throw std::invalid_argument("Error opening file: Invalid file path or file is inaccessible");
+	fileHandle = (void*)(intptr_t)file;
+
+	struct stat status = {};
+	fstat(file, &status);
+	size = (size_t)status.st_size;
+
+	// Empty files can't be mapped, but are still valid (just no data)
+	if (size == 0)
+		return;
+
+	void* view = mmap(0, size, PROT_READ, MAP_PRIVATE, file, 0);
+	if (view == MAP_FAILED)
+	{
+		close(file);
+		throw std::runtime_error("Error mapping file into memory");
+	}
+	madvise(view, size, MADV_SEQUENTIAL);
+	data = (const char*)view;
+}
+
+MappedFile::~MappedFile()
+{
+	if (data)
+		munmap((void*)data, size);
+	if ((intptr_t)fileHandle != -1)
+		close((int)(intptr_t)fileHandle);
+}
+
+#endif
+
+const char* MappedFile::GetData() const
+{
+	return data;
+}
+
+const char* MappedFile::GetEnd() const
+{
+	return data + size;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return size;
+}
\ No newline at end of file
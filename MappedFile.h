@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+// Read-only view of an entire file, mapped into memory so it can be
+// parsed in place without copying it into a buffer first
+class MappedFile
+{
+public:
+	MappedFile(const char* filePath);
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// First byte of the file (null if the file is empty)
+	const char* GetData() const;
+	// One past the last byte of the file
+	const char* GetEnd() const;
+	size_t GetSize() const;
+
+private:
+	// OS handles, kept as void* so the header doesn't need Windows.h
+	// (a file descriptor and nothing, on other platforms)
+	void* fileHandle;
+	void* mappingHandle;
+
+	const char* data;
+	size_t size;
+};
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "MemoryMeshUploader.h"
+
+bool MemoryMeshUploader::Upload(const MeshData& data)
+{
+	Record record = {};
+	record.vertexFormat = data.vertexFormat;
+	record.vertexStride = VertexCompression::GetStride(data.vertexFormat);
+	record.vertexCount = data.vertexCount;
+	record.indexStride = data.indexStride;
+	record.indexCount = data.indexCount;
+
+	const uint8_t* vertices = (const uint8_t*)data.vertexData;
+	const uint8_t* indices = (const uint8_t*)data.indexData;
+	record.vertices.assign(vertices, vertices + (size_t)record.vertexStride * data.vertexCount);
+	record.indices.assign(indices, indices + (size_t)data.indexStride * data.indexCount);
+
+	records.push_back(std::move(record));
+	return true;
+}
+
+const std::vector<MemoryMeshUploader::Record>& MemoryMeshUploader::GetRecords() const
+{
+	return records;
+}
+
+size_t MemoryMeshUploader::GetTotalBytes() const
+{
+	size_t bytes = 0;
+	for (const Record& record : records)
+		bytes += record.vertices.size() + record.indices.size();
+	return bytes;
+}
+
+void MemoryMeshUploader::Clear()
+{
+	records.clear();
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "MeshUploader.h"
+
+// Keeps a copy of everything uploaded instead of creating GPU buffers,
+// for running and checking the import pipeline without a graphics device
+class MemoryMeshUploader : public MeshUploader
+{
+public:
+	// What one call to Upload() was given
+	struct Record
+	{
+		VertexFormat vertexFormat;
+		unsigned int vertexStride;
+		unsigned int vertexCount;
+		unsigned int indexStride;
+		unsigned int indexCount;
+		std::vector<uint8_t> vertices;	// Exactly the bytes a vertex buffer would get
+		std::vector<uint8_t> indices;	// Exactly the bytes an index buffer would get
+	};
+
+	bool Upload(const MeshData& data) override;
+
+	const std::vector<Record>& GetRecords() const;
+	// Vertex and index bytes across every upload
+	size_t GetTotalBytes() const;
+	void Clear();
+
+private:
+	std::vector<Record> records;
+};
\ No newline at end of file
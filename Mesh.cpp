@@ -1,88 +1,106 @@
 #include "Mesh.h"
-#include "Graphics.h"
-#include <fstream>
+#include "TangentGenerator.h"
 #include <vector>
-#include <stdexcept>
-#include <unordered_map>
+#include <algorithm>
+
+// What Finalize() uploads to on this platform
+#ifdef _WIN32
+#include "Graphics.h"
+#include "D3D11MeshUploader.h"
+using MeshBuffers = D3D11MeshUploader;
+#else
+#include "MemoryMeshUploader.h"
+using MeshBuffers = MemoryMeshUploader;
+#endif
 
 // For the DirectX Math library
 using namespace DirectX;
 
 Mesh::Mesh(Vertex* vertices, unsigned int* indices, unsigned int vertexCount, unsigned int indexCount)
+	: Mesh()
+{
+	Finalize(MeshImporter::FromArrays(vertices, indices, vertexCount, indexCount));
+}
+
+Mesh::Mesh(const char* filePath, const MeshImportSettings& settings)
+	: Mesh()
 {
-	CalculateTangents(vertices, vertexCount, indices, indexCount);
-	CreateBuffers(vertices, indices, vertexCount, indexCount);
+	Finalize(MeshImporter::Import(filePath, settings));
 }
 
-void Mesh::CreateBuffers(Vertex* vertices, unsigned int* indices, unsigned int vertexCount, unsigned int indexCount)
+Mesh::Mesh(const MeshData& data)
+	: Mesh()
 {
-	// Create a VERTEX BUFFER
-	// - This holds the vertex data of triangles for a single object
-	// - This buffer is created on the GPU, which is where the data needs to
-	//    be if we want the GPU to act on it (as in: draw it to the screen)
-	{
-		// First, we need to describe the buffer we want Direct3D to make on the GPU
-		//  - Note that this variable is created on the stack since we only need it once
-		//  - After the buffer is created, this description variable is unnecessary
-		D3D11_BUFFER_DESC vbd = {};
-		vbd.Usage = D3D11_USAGE_IMMUTABLE;	// Will NEVER change
-		vbd.ByteWidth = sizeof(Vertex) * vertexCount;       // Number of vertices in the buffer
-		vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER; // Tells Direct3D this is a vertex buffer
-		vbd.CPUAccessFlags = 0;	// Note: We cannot access the data from C++ (this is good)
-		vbd.MiscFlags = 0;
-		vbd.StructureByteStride = 0;
-
-		// Create the proper struct to hold the initial vertex data
-		// - This is how we initially fill the buffer with data
-		// - Essentially, we're specifying a pointer to the data to copy
-		D3D11_SUBRESOURCE_DATA initialVertexData = {};
-		initialVertexData.pSysMem = vertices; // pSysMem = Pointer to System Memory
-
-		// Actually create the buffer on the GPU with the initial data
-		// - Once we do this, we'll NEVER CHANGE DATA IN THE BUFFER AGAIN
-		Graphics::Device->CreateBuffer(&vbd, &initialVertexData, vertexBuffer.GetAddressOf());
-	}
-
-	// Create an INDEX BUFFER
-	// - This holds indices to elements in the vertex buffer
-	// - This is most useful when vertices are shared among neighboring triangles
-	// - This buffer is created on the GPU, which is where the data needs to
-	//    be if we want the GPU to act on it (as in: draw it to the screen)
-	{
-		// Describe the buffer, as we did above, with two major differences
-		//  - Byte Width (unsigned integers vs. whole vertices)
-		//  - Bind Flag (used as an index buffer instead of a vertex buffer) 
-		D3D11_BUFFER_DESC ibd = {};
-		ibd.Usage = D3D11_USAGE_IMMUTABLE;	// Will NEVER change
-		ibd.ByteWidth = sizeof(unsigned int) * indexCount;	// Number of indices in the buffer
-		ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;	// Tells Direct3D this is an index buffer
-		ibd.CPUAccessFlags = 0;	// Note: We cannot access the data from C++ (this is good)
-		ibd.MiscFlags = 0;
-		ibd.StructureByteStride = 0;
-
-		// Specify the initial data for this buffer, similar to above
-		D3D11_SUBRESOURCE_DATA initialIndexData = {};
-		initialIndexData.pSysMem = indices; // pSysMem = Pointer to System Memory
-
-		// Actually create the buffer with the initial data
-		// - Once we do this, we'll NEVER CHANGE THE BUFFER AGAIN
-		Graphics::Device->CreateBuffer(&ibd, &initialIndexData, indexBuffer.GetAddressOf());
-	}
-
-	vertexBufferCount = vertexCount;
-	indexBufferCount = indexCount;
+	Finalize(data);
+}
+
+Mesh::Mesh()
+{
+	ready = false;
+	vertexBufferCount = 0;
+	indexBufferCount = 0;
+	indexStride = sizeof(unsigned int);
+	vertexFormat = VertexFormat::Full;
+	XMStoreFloat4x4(&dequantizeMatrix, XMMatrixIdentity());
+	boundingBox = {};
+	boundingSphere = {};
+	streamStats = {};
+	vertexCacheStats = {};
+	originalVertexCacheStats = {};
+	tangentStats = {};
+}
+
+// Everything but the buffers was prepared by MeshImporter, possibly on another thread
+void Mesh::Finalize(const MeshData& data)
+{
+	vertexFormat = data.vertexFormat;
+	dequantizeMatrix = data.dequantizeMatrix;
+	boundingBox = data.boundingBox;
+	boundingSphere = data.boundingSphere;
+	submeshes = data.submeshes;
+	lods = data.lods;
+	meshlets = data.meshlets;
+	streamStats = data.streamStats;
+	vertexCacheStats = data.vertexCacheStats;
+	originalVertexCacheStats = data.originalVertexCacheStats;
+	tangentStats = data.tangentStats;
+	importReport = data.report;
+
+	// Create the buffers on the GPU
+	buffers = std::make_unique<MeshBuffers>();
+	buffers->Upload(data);
+
+	vertexBufferCount = data.vertexCount;
+	indexBufferCount = data.indexCount;
+	indexStride = data.indexStride;
+	ready = true;
 }
 
 Mesh::~Mesh() {}
 
-Microsoft::WRL::ComPtr<ID3D11Buffer> Mesh::GetVertexBuffer()
+bool Mesh::IsReady() const
 {
-	return vertexBuffer;
+	return ready;
 }
 
-Microsoft::WRL::ComPtr<ID3D11Buffer> Mesh::GetIndexBuffer()
+size_t Mesh::GetGpuBytes() const
 {
-	return indexBuffer;
+	return (size_t)VertexCompression::GetStride(vertexFormat) * vertexBufferCount + (size_t)indexStride * indexBufferCount;
+}
+
+size_t Mesh::GetCpuBytes() const
+{
+	if (!ready)
+		return 0;
+
+	size_t bytes = sizeof(Mesh) +
+		submeshes.capacity() * sizeof(Submesh) +
+		lods.capacity() * sizeof(MeshLod) +
+		meshlets.capacity() * sizeof(Meshlet) +
+		importReport.name.capacity();
+	for (const Submesh& submesh : submeshes)
+		bytes += submesh.name.capacity() + submesh.materialName.capacity();
+	return bytes;
 }
 
 unsigned int Mesh::GetVertexBufferCount() const
@@ -95,14 +113,113 @@ unsigned int Mesh::GetIndexBufferCount() const
 	return indexBufferCount;
 }
 
-// Sets the buffers and draws the correct number of vertices
-void Mesh::Draw()
+unsigned int Mesh::GetIndexStride() const
+{
+	return indexStride;
+}
+
+VertexFormat Mesh::GetVertexFormat() const
+{
+	return vertexFormat;
+}
+
+const XMFLOAT4X4& Mesh::GetDequantizeMatrix() const
+{
+	return dequantizeMatrix;
+}
+
+const ObjParser::StreamStats& Mesh::GetStreamStats() const
 {
-	// Set buffers in the input assembler (IA) stage
-	UINT stride = sizeof(Vertex);
+	return streamStats;
+}
+
+const MeshOptimizer::CacheStats& Mesh::GetVertexCacheStats() const
+{
+	return vertexCacheStats;
+}
+
+const MeshOptimizer::CacheStats& Mesh::GetOriginalVertexCacheStats() const
+{
+	return originalVertexCacheStats;
+}
+
+const TangentGenerator::Stats& Mesh::GetTangentStats() const
+{
+	return tangentStats;
+}
+
+const ImportReport& Mesh::GetImportReport() const
+{
+	return importReport;
+}
+
+const BoundingBox& Mesh::GetBoundingBox() const
+{
+	return boundingBox;
+}
+
+const BoundingSphere& Mesh::GetBoundingSphere() const
+{
+	return boundingSphere;
+}
+
+const std::vector<MeshLod>& Mesh::GetLods() const
+{
+	return lods;
+}
+
+unsigned int Mesh::GetLodCount() const
+{
+	return (unsigned int)lods.size();
+}
+
+const std::vector<Meshlet>& Mesh::GetMeshlets() const
+{
+	return meshlets;
+}
+
+const std::vector<Submesh>& Mesh::GetSubmeshes() const
+{
+	return submeshes;
+}
+
+unsigned int Mesh::GetSubmeshCount() const
+{
+	return (unsigned int)submeshes.size();
+}
+
+#ifdef _WIN32
+
+// Set buffers in the input assembler (IA) stage
+void Mesh::SetBuffers()
+{
+	const MeshBuffers* d3dBuffers = static_cast<const MeshBuffers*>(buffers.get());
+	ID3D11Buffer* vertexBuffer = d3dBuffers->GetVertexBuffer().Get();
+	ID3D11Buffer* indexBuffer = d3dBuffers->GetIndexBuffer().Get();
+
+	UINT stride = VertexCompression::GetStride(vertexFormat);
 	UINT offset = 0;
-	Graphics::Context->IASetVertexBuffers(0, 1, vertexBuffer.GetAddressOf(), &stride, &offset);
-	Graphics::Context->IASetIndexBuffer(indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+	Graphics::Context->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	Graphics::Context->IASetIndexBuffer(
+		indexBuffer,
+		indexStride == sizeof(uint16_t) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT,
+		0);
+}
+
+// Sets the buffers and draws the full detail triangles
+void Mesh::Draw()
+{
+	DrawLod(0);
+}
+
+// Sets the buffers and draws one level of detail (clamped to the last one)
+void Mesh::DrawLod(unsigned int lod)
+{
+	if (!ready)
+		return;
+
+	SetBuffers();
+	const MeshLod& range = lods[std::min(lod, (unsigned int)lods.size() - 1)];
 
 	// Tell Direct3D to draw
 	//  - Begins the rendering pipeline on the GPU
@@ -110,330 +227,54 @@ void Mesh::Draw()
 	//  - DrawIndexed() uses the currently set INDEX BUFFER to look up corresponding
 	//     vertices in the currently set VERTEX BUFFER
 	Graphics::Context->DrawIndexed(
-		indexBufferCount,     // The number of indices to use (we could draw a subset if we wanted)
-		0,     // Offset to the first index we want to use
+		range.indexCount,     // The number of indices to use (just this level's range)
+		range.indexStart,     // Offset to the first index we want to use
 		0);    // Offset to add to each index when looking up vertices
 }
 
-Mesh::Mesh(const char* filePath)
+// Sets the buffers and draws a single submesh
+void Mesh::DrawSubmesh(unsigned int index)
+{
+	if (!ready)
+		return;
+
+	SetBuffers();
+
+	const Submesh& submesh = submeshes[index];
+	Graphics::Context->DrawIndexed(submesh.indexCount, submesh.indexStart, 0);
+}
+
+// Sets the buffers and draws several ranges of the index buffer
+void Mesh::DrawRanges(const std::vector<IndexRange>& ranges)
 {
-	// Author: Chris Cascioli
-	// Latest Revision: 02/2026
-	// Purpose: Basic .OBJ 3D model loading, supporting positions, uvs and normals
-
-	// File input object
-	std::ifstream obj(filePath);
-
-	// Check for successful open
-	if (!obj.is_open())
-		throw std::invalid_argument("Error opening file: Invalid file path or file is inaccessible");
-
-	// Variables used while reading the file
-	std::vector<XMFLOAT3> positions;	// Positions from the file
-	std::vector<XMFLOAT3> normals;		// Normals from the file
-	std::vector<XMFLOAT2> uvs;		// UVs from the file
-	std::vector<Vertex> vertsFromFile;	// Verts from file (including duplicates)
-	std::vector<Vertex> finalVertices;	// Final, de-duplicated verts
-	std::vector<UINT> finalIndices;		// Indices for final verts
-	char chars[100];			// String for line reading
-
-	// Still have data left?
-	while (obj.good())
-	{
-		// Get the line (100 characters should be more than enough)
-		obj.getline(chars, 100);
-
-		// Check the type of line
-		if (chars[0] == 'v' && chars[1] == 'n')
-		{
-			// Read the 3 numbers directly into an XMFLOAT3
-			XMFLOAT3 norm{};
-			sscanf_s(
-				chars,
-				"vn %f %f %f",
-				&norm.x, &norm.y, &norm.z);
-
-			// Add to the list of normals
-			normals.push_back(norm);
-		}
-		else if (chars[0] == 'v' && chars[1] == 't')
-		{
-			// Read the 2 numbers directly into an XMFLOAT2
-			XMFLOAT2 uv{};
-			sscanf_s(
-				chars,
-				"vt %f %f",
-				&uv.x, &uv.y);
-
-			// Add to the list of uv's
-			uvs.push_back(uv);
-		}
-		else if (chars[0] == 'v')
-		{
-			// Read the 3 numbers directly into an XMFLOAT3
-			XMFLOAT3 pos{};
-			sscanf_s(
-				chars,
-				"v %f %f %f",
-				&pos.x, &pos.y, &pos.z);
-
-			// Add to the positions
-			positions.push_back(pos);
-		}
-		else if (chars[0] == 'f')
-		{
-			// Read the face indices into an array
-			// NOTE: This assumes the given obj file contains
-			//  vertex positions, uv coordinates AND normals.
-			unsigned int i[12]{};
-			int numbersRead = sscanf_s(
-				chars,
-				"f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d",
-				&i[0], &i[1], &i[2],
-				&i[3], &i[4], &i[5],
-				&i[6], &i[7], &i[8],
-				&i[9], &i[10], &i[11]);
-
-			// If we only got the first number, chances are the OBJ
-			// file has no UV coordinates.  This isn't great, but we
-			// still want to load the model without crashing, so we
-			// need to re-read a different pattern (in which we assume
-			// there are no UVs denoted for any of the vertices)
-			if (numbersRead == 1)
-			{
-				// Re-read with a different pattern
-				numbersRead = sscanf_s(
-					chars,
-					"f %d//%d %d//%d %d//%d %d//%d",
-					&i[0], &i[2],
-					&i[3], &i[5],
-					&i[6], &i[8],
-					&i[9], &i[11]);
-
-				// The following indices are where the UVs should 
-				// have been, so give them a valid value
-				i[1] = 1;
-				i[4] = 1;
-				i[7] = 1;
-				i[10] = 1;
-
-				// If we have no UVs, create a single UV coordinate
-				// that will be used for all vertices
-				if (uvs.size() == 0)
-					uvs.push_back(XMFLOAT2(0, 0));
-			}
-
-			// - Create the verts by looking up
-			//    corresponding data from vectors
-			// - OBJ File indices are 1-based, so
-			//    they need to be adusted
-			Vertex v1{};
-			v1.Position = positions[max(i[0] - 1, 0)];
-			v1.UV = uvs[max(i[1] - 1, 0)];
-			v1.Normal = normals[max(i[2] - 1, 0)];
-
-			Vertex v2{};
-			v2.Position = positions[max(i[3] - 1, 0)];
-			v2.UV = uvs[max(i[4] - 1, 0)];
-			v2.Normal = normals[max(i[5] - 1, 0)];
-
-			Vertex v3{};
-			v3.Position = positions[max(i[6] - 1, 0)];
-			v3.UV = uvs[max(i[7] - 1, 0)];
-			v3.Normal = normals[max(i[8] - 1, 0)];
-
-			// The model is most likely in a right-handed space,
-			// especially if it came from Maya.  We probably want 
-			// to convert to a left-handed space.  This means we 
-			// need to:
-			//  - Invert the Z position
-			//  - Invert the normal's Z
-			//  - Flip the winding order
-			// We also need to flip the UV coordinate since Direct3D
-			// defines (0,0) as the top left of the texture, and many
-			// 3D modeling packages use the bottom left as (0,0)
-
-			// Flip the UV's since they're probably "upside down"
-			v1.UV.y = 1.0f - v1.UV.y;
-			v2.UV.y = 1.0f - v2.UV.y;
-			v3.UV.y = 1.0f - v3.UV.y;
-
-			// Flip Z (LH vs. RH)
-			v1.Position.z *= -1.0f;
-			v2.Position.z *= -1.0f;
-			v3.Position.z *= -1.0f;
-
-			// Flip normal's Z
-			v1.Normal.z *= -1.0f;
-			v2.Normal.z *= -1.0f;
-			v3.Normal.z *= -1.0f;
-
-			// Add the verts to the vector (flipping the winding order)
-			vertsFromFile.push_back(v1);
-			vertsFromFile.push_back(v3);
-			vertsFromFile.push_back(v2);
-
-			// Was there a 4th face?
-			// - 12 numbers read means 4 faces WITH uv's
-			// - 8 numbers read means 4 faces WITHOUT uv's
-			if (numbersRead == 12 || numbersRead == 8)
-			{
-				// Make the last vertex
-				Vertex v4{};
-				v4.Position = positions[max(i[9] - 1, 0)];
-				v4.UV = uvs[max(i[10] - 1, 0)];
-				v4.Normal = normals[max(i[11] - 1, 0)];
-
-				// Flip the UV, Z pos and normal's Z
-				v4.UV.y = 1.0f - v4.UV.y;
-				v4.Position.z *= -1.0f;
-				v4.Normal.z *= -1.0f;
-
-				// Add a whole triangle (flipping the winding order)
-				vertsFromFile.push_back(v1);
-				vertsFromFile.push_back(v4);
-				vertsFromFile.push_back(v3);
-			}
-		}
-	}
-
-	// We'll use a hash table (unordered_map) to determine
-	// if any of the vertices are duplicates
-	std::unordered_map<std::string, unsigned int> vertMap;
-	for (auto& v : vertsFromFile)
-	{
-		// Create a "unique" representation of the vertex (its key)
-		// Note: This isn't a super efficient method, but since strings
-		//       inherently work with unordered_maps, this saves
-		//       us from having to write our own custom hash function
-		std::string vStr =
-			std::to_string(v.Position.x) +
-			std::to_string(v.Position.y) +
-			std::to_string(v.Position.z) +
-			std::to_string(v.Normal.x) +
-			std::to_string(v.Normal.y) +
-			std::to_string(v.Normal.z) +
-			std::to_string(v.UV.x) +
-			std::to_string(v.UV.y);
-
-		// Prepare the index for this vertex and
-		// search for the vertex in the hash table
-		unsigned int index = -1;
-		auto pair = vertMap.find(vStr);
-		if (pair == vertMap.end())
-		{
-			// Vertex not found, so this
-			// is the first time we've seen it
-			index = (unsigned int)finalVertices.size();
-			finalVertices.push_back(v);
-			vertMap.insert({ vStr, index });
-		}
-		else
-		{
-			// Vert already exists, just
-			// grab its index
-			index = pair->second;
-		}
-
-		// Either way, save the index
-		finalIndices.push_back(index);
-	}
-
-	// Close the file
-	obj.close();
-
-	CalculateTangents(&finalVertices[0], (unsigned int)finalVertices.size(), &finalIndices[0], (unsigned int)finalIndices.size());
-
-	// Create the actual buffers!
-	CreateBuffers(&finalVertices[0], &finalIndices[0], (unsigned int)finalVertices.size(), (unsigned int)finalIndices.size());
+	if (!ready)
+		return;
+
+	SetBuffers();
+
+	for (const IndexRange& range : ranges)
+		Graphics::Context->DrawIndexed(range.indexCount, range.indexStart, 0);
 }
 
+#else
+
+// There's nothing to draw with outside Windows (the buffers are only
+// kept in memory), so drawing is always skipped
+void Mesh::SetBuffers() {}
+void Mesh::Draw() {}
+void Mesh::DrawLod(unsigned int /*lod*/) {}
+void Mesh::DrawSubmesh(unsigned int /*index*/) {}
+void Mesh::DrawRanges(const std::vector<IndexRange>& /*ranges*/) {}
+
+#endif
+
 // --------------------------------------------------------
-// Author: Chris Cascioli
-// Purpose: Calculates the tangents of the vertices in a mesh
-// 
-// - You are allowed to directly copy/paste this into your code base
-//   for assignments, given that you clearly cite that this is not
-//   code of your own design.
-//
-// - Code originally adapted from: http://www.terathon.com/code/tangent.html
-//   - Updated version now found here: http://foundationsofgameenginedev.com/FGED2-sample.pdf
-//   - See listing 7.4 in section 7.5 (page 9 of the PDF)
-//
-// - Note: For this code to work, your Vertex format must
-//         contain an XMFLOAT3 called Tangent
+// Calculates the tangents of the vertices in a mesh
+// (see TangentGenerator for the details)
 //
 // - Be sure to call this BEFORE creating your D3D vertex/index buffers
 // --------------------------------------------------------
 void Mesh::CalculateTangents(Vertex* verts, int numVerts, unsigned int* indices, int numIndices)
 {
-	// Reset tangents
-	for (int i = 0; i < numVerts; i++)
-	{
-		verts[i].Tangent = XMFLOAT3(0, 0, 0);
-	}
-
-	// Calculate tangents one whole triangle at a time
-	for (int i = 0; i < numIndices;)
-	{
-		// Grab indices and vertices of first triangle
-		unsigned int i1 = indices[i++];
-		unsigned int i2 = indices[i++];
-		unsigned int i3 = indices[i++];
-		Vertex* v1 = &verts[i1];
-		Vertex* v2 = &verts[i2];
-		Vertex* v3 = &verts[i3];
-
-		// Calculate vectors relative to triangle positions
-		float x1 = v2->Position.x - v1->Position.x;
-		float y1 = v2->Position.y - v1->Position.y;
-		float z1 = v2->Position.z - v1->Position.z;
-
-		float x2 = v3->Position.x - v1->Position.x;
-		float y2 = v3->Position.y - v1->Position.y;
-		float z2 = v3->Position.z - v1->Position.z;
-
-		// Do the same for vectors relative to triangle uv's
-		float s1 = v2->UV.x - v1->UV.x;
-		float t1 = v2->UV.y - v1->UV.y;
-
-		float s2 = v3->UV.x - v1->UV.x;
-		float t2 = v3->UV.y - v1->UV.y;
-
-		// Create vectors for tangent calculation
-		float r = 1.0f / (s1 * t2 - s2 * t1);
-
-		float tx = (t2 * x1 - t1 * x2) * r;
-		float ty = (t2 * y1 - t1 * y2) * r;
-		float tz = (t2 * z1 - t1 * z2) * r;
-
-		// Adjust tangents of each vert of the triangle
-		v1->Tangent.x += tx;
-		v1->Tangent.y += ty;
-		v1->Tangent.z += tz;
-
-		v2->Tangent.x += tx;
-		v2->Tangent.y += ty;
-		v2->Tangent.z += tz;
-
-		v3->Tangent.x += tx;
-		v3->Tangent.y += ty;
-		v3->Tangent.z += tz;
-	}
-
-	// Ensure all of the tangents are orthogonal to the normals
-	for (int i = 0; i < numVerts; i++)
-	{
-		// Grab the two vectors
-		XMVECTOR normal = XMLoadFloat3(&verts[i].Normal);
-		XMVECTOR tangent = XMLoadFloat3(&verts[i].Tangent);
-
-		// Use Gram-Schmidt orthonormalize to ensure
-		// the normal and tangent are exactly 90 degrees apart
-		tangent = XMVector3Normalize(
-			tangent - normal * XMVector3Dot(normal, tangent));
-
-		// Store the tangent
-		XMStoreFloat3(&verts[i].Tangent, tangent);
-	}
+	tangentStats = TangentGenerator::Generate(verts, (unsigned int)numVerts, indices, (size_t)numIndices);
 }
\ No newline at end of file
@@ -1,35 +1,124 @@
 #pragma once
 
-#include <d3d11.h>
-#include <wrl/client.h>
+#include <vector>
+#include <memory>
 #include "Vertex.h"
+#include "Submesh.h"
+#include "MeshLod.h"
+#include "Meshlet.h"
+#include "ObjParser.h"
+#include "MeshOptimizer.h"
+#include "TangentGenerator.h"
+#include "CompactVertex.h"
+#include "MeshImportSettings.h"
+#include "MeshBounds.h"
+#include "MeshImporter.h"
+#include "MeshUploader.h"
 
-// Is able to create and store buffers for mesh data
+// Is able to create and store buffers for mesh data. The buffers are
+// Direct3D 11 buffers on Windows. Other platforms have no renderer, so
+// they keep a copy in memory instead and drawing does nothing, which is
+// enough to load and manage meshes headless (see MeshUploader).
 class Mesh
 {
 public:
 	Mesh(Vertex* vertices, unsigned int* indices, unsigned int vertexCount, unsigned int indexCount);
-	Mesh(const char* filePath);
+	Mesh(const char* filePath, const MeshImportSettings& settings = MeshImportSettings());
+	// Uploads data prepared elsewhere (like MeshImporter::FromGenerated)
+	explicit Mesh(const MeshData& data);
+	// An empty mesh that isn't ready until Finalize() is called (see MeshLoader)
+	Mesh();
 	~Mesh();
 	Mesh(const Mesh&) = delete;
 	Mesh& operator=(const Mesh&) = delete;
 
 	void CalculateTangents(Vertex* verts, int numVerts, unsigned int* indices, int numIndices);
 
-	Microsoft::WRL::ComPtr<ID3D11Buffer> GetVertexBuffer();
-	Microsoft::WRL::ComPtr<ID3D11Buffer> GetIndexBuffer();
+	// Creates the buffers from imported data (see MeshImporter) and takes
+	// everything else it describes. Must be called on the thread that owns
+	// the graphics context.
+	void Finalize(const MeshData& data);
+	// False until the buffers exist. Nothing else about the mesh is
+	// meaningful before then, and it must not be drawn.
+	bool IsReady() const;
+
 	unsigned int GetVertexBufferCount() const;
+	// Every level of detail together (see GetLods() for each one's range)
 	unsigned int GetIndexBufferCount() const;
+	// Bytes per index: 2 whenever the vertex count allows it, otherwise 4
+	unsigned int GetIndexStride() const;
+	VertexFormat GetVertexFormat() const;
+	// Maps vertex buffer positions into the mesh's local space. Identity
+	// except for quantized meshes, and meant to go before the world matrix.
+	const DirectX::XMFLOAT4X4& GetDequantizeMatrix() const;
+	// Memory this mesh holds right now: its vertex and index buffers, and
+	// what it keeps on the CPU (itself and its submesh, level of detail
+	// and meshlet tables). Both are 0 until it's ready.
+	size_t GetGpuBytes() const;
+	size_t GetCpuBytes() const;
+	// Memory used while importing (only filled in for streaming imports)
+	const ObjParser::StreamStats& GetStreamStats() const;
+	// Simulated vertex cache efficiency of the index buffer, and of the
+	// file's original order (only known if it was optimized on this load)
+	const MeshOptimizer::CacheStats& GetVertexCacheStats() const;
+	const MeshOptimizer::CacheStats& GetOriginalVertexCacheStats() const;
+	// What the tangent pass had to fix up (empty when loaded from the cache)
+	const TangentGenerator::Stats& GetTangentStats() const;
+	// What the import found and produced (see ImportReport)
+	const ImportReport& GetImportReport() const;
+
+	// Around every vertex position, in the mesh's local space (before
+	// the dequantize matrix, so the same for every vertex format)
+	const DirectX::BoundingBox& GetBoundingBox() const;
+	const DirectX::BoundingSphere& GetBoundingSphere() const;
+
+	// Full detail first, then each simplified level (always at least one).
+	// Submeshes only cover the full detail level.
+	const std::vector<MeshLod>& GetLods() const;
+	unsigned int GetLodCount() const;
+
+	// Clusters of the full detail triangles, in index buffer order, for
+	// culling (empty unless built on import, see MeshletCuller)
+	const std::vector<Meshlet>& GetMeshlets() const;
 
-	// Sets the buffers and draws the correct number of vertices
+	// One entry per object/material run in the file (always at least one)
+	const std::vector<Submesh>& GetSubmeshes() const;
+	unsigned int GetSubmeshCount() const;
+
+	// Sets the buffers and draws the full detail triangles (every draw
+	// function does nothing until the mesh is ready)
 	void Draw();
+	// Sets the buffers and draws a level of detail (clamped to the last one)
+	void DrawLod(unsigned int lod);
+	// Sets the buffers and draws only the given submesh's range of indices
+	void DrawSubmesh(unsigned int index);
+	// Sets the buffers once and draws each range of indices (such as the
+	// meshlets that survived culling)
+	void DrawRanges(const std::vector<IndexRange>& ranges);
 
 private:
-	void CreateBuffers(Vertex* vertices, unsigned int* indices, unsigned int vertexCount, unsigned int indexCount);
+	void SetBuffers();
+
+	bool ready;
 
-	// Vertex/index buffers specific to this mesh
-	Microsoft::WRL::ComPtr<ID3D11Buffer> vertexBuffer;
-	Microsoft::WRL::ComPtr<ID3D11Buffer> indexBuffer;
+	// Holds the vertex/index buffers specific to this mesh
+	std::unique_ptr<MeshUploader> buffers;
 	unsigned int vertexBufferCount;
 	unsigned int indexBufferCount;
+	unsigned int indexStride;
+	VertexFormat vertexFormat;
+	DirectX::XMFLOAT4X4 dequantizeMatrix;
+	DirectX::BoundingBox boundingBox;
+	DirectX::BoundingSphere boundingSphere;
+
+	// Ranges of the index buffer, all sharing the single vertex buffer
+	std::vector<Submesh> submeshes;
+	std::vector<MeshLod> lods;
+	std::vector<Meshlet> meshlets;
+
+	ObjParser::StreamStats streamStats;
+	MeshOptimizer::CacheStats vertexCacheStats;
+	MeshOptimizer::CacheStats originalVertexCacheStats;
+	TangentGenerator::Stats tangentStats;
+	ImportReport importReport;
 };
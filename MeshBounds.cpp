@@ -0,0 +1,87 @@
+#include "MeshBounds.h"
+
+#include <cfloat>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Both passes keep four independent running results and only
+// combine them at the end, so consecutive min/max operations
+// don't have to wait on each other and the loop is limited by
+// loads instead of by the latency of a single chain.
+// --------------------------------------------------------
+void MeshBounds::Compute(const Vertex* vertices, unsigned int vertexCount, BoundingBox& box, BoundingSphere& sphere)
+{
+	if (vertexCount == 0)
+	{
+		box = BoundingBox(XMFLOAT3(0, 0, 0), XMFLOAT3(0, 0, 0));
+		sphere = BoundingSphere(XMFLOAT3(0, 0, 0), 0.0f);
+		return;
+	}
+
+	// Box: per-component min and max of every position
+	XMVECTOR minimum[4], maximum[4];
+	for (int lane = 0; lane < 4; lane++)
+	{
+		minimum[lane] = XMVectorReplicate(FLT_MAX);
+		maximum[lane] = XMVectorReplicate(-FLT_MAX);
+	}
+
+	unsigned int i = 0;
+	for (; i + 4 <= vertexCount; i += 4)
+	{
+		for (int lane = 0; lane < 4; lane++)
+		{
+			XMVECTOR position = XMLoadFloat3(&vertices[i + lane].Position);
+			minimum[lane] = XMVectorMin(minimum[lane], position);
+			maximum[lane] = XMVectorMax(maximum[lane], position);
+		}
+	}
+	for (; i < vertexCount; i++)
+	{
+		XMVECTOR position = XMLoadFloat3(&vertices[i].Position);
+		minimum[0] = XMVectorMin(minimum[0], position);
+		maximum[0] = XMVectorMax(maximum[0], position);
+	}
+
+	XMVECTOR boxMin = XMVectorMin(XMVectorMin(minimum[0], minimum[1]), XMVectorMin(minimum[2], minimum[3]));
+	XMVECTOR boxMax = XMVectorMax(XMVectorMax(maximum[0], maximum[1]), XMVectorMax(maximum[2], maximum[3]));
+	XMVECTOR center = XMVectorScale(XMVectorAdd(boxMin, boxMax), 0.5f);
+	XMStoreFloat3(&box.Center, center);
+	XMStoreFloat3(&box.Extents, XMVectorScale(XMVectorSubtract(boxMax, boxMin), 0.5f));
+
+	// Sphere: largest squared distance from the box's center
+	XMVECTOR furthest[4] = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero() };
+	i = 0;
+	for (; i + 4 <= vertexCount; i += 4)
+	{
+		for (int lane = 0; lane < 4; lane++)
+		{
+			XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&vertices[i + lane].Position), center);
+			furthest[lane] = XMVectorMax(furthest[lane], XMVector3LengthSq(offset));
+		}
+	}
+	for (; i < vertexCount; i++)
+	{
+		XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&vertices[i].Position), center);
+		furthest[0] = XMVectorMax(furthest[0], XMVector3LengthSq(offset));
+	}
+
+	XMVECTOR radiusSquared = XMVectorMax(XMVectorMax(furthest[0], furthest[1]), XMVectorMax(furthest[2], furthest[3]));
+	sphere.Center = box.Center;
+	sphere.Radius = XMVectorGetX(XMVectorSqrt(radiusSquared));
+}
+
+XMFLOAT3 MeshBounds::GetMin(const BoundingBox& box)
+{
+	XMFLOAT3 min;
+	XMStoreFloat3(&min, XMVectorSubtract(XMLoadFloat3(&box.Center), XMLoadFloat3(&box.Extents)));
+	return min;
+}
+
+XMFLOAT3 MeshBounds::GetMax(const BoundingBox& box)
+{
+	XMFLOAT3 max;
+	XMStoreFloat3(&max, XMVectorAdd(XMLoadFloat3(&box.Center), XMLoadFloat3(&box.Extents)));
+	return max;
+}
\ No newline at end of file
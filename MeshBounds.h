@@ -0,0 +1,18 @@
+#pragma once
+
+#include <DirectXCollision.h>
+#include "Vertex.h"
+
+// Bounding volumes around a mesh's vertex positions
+namespace MeshBounds
+{
+	// Fills in the smallest axis-aligned box around every position, and a
+	// sphere centered on that box reaching the furthest position (which is
+	// usually tighter than the sphere around the box itself). Both are
+	// zero-sized at the origin if there are no vertices.
+	void Compute(const Vertex* vertices, unsigned int vertexCount, DirectX::BoundingBox& box, DirectX::BoundingSphere& sphere);
+
+	// Corners of a box, for code that works on min/max instead of center/extents
+	DirectX::XMFLOAT3 GetMin(const DirectX::BoundingBox& box);
+	DirectX::XMFLOAT3 GetMax(const DirectX::BoundingBox& box);
+}
\ No newline at end of file
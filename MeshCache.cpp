@@ -0,0 +1,284 @@
+#include "MeshCache.h"
+#include "IndexFormat.h"
+
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <charconv>
+
+using namespace DirectX;
+
+namespace
+{
+	// An odd number of 16-bit indices (or of vertices with an odd number
+	// of 16-bit values) would otherwise leave the tables after them only
+	// 2-byte aligned
+	size_t PaddedSize(size_t size)
+	{
+		return (size + MeshCache::BlockAlignment - 1) / MeshCache::BlockAlignment * MeshCache::BlockAlignment;
+	}
+}
+
+MeshCache::CookedMesh::CookedMesh()
+{
+	source = {};
+	measured = {};
+	header = 0;
+	vertices = 0;
+	indices = 0;
+}
+
+MeshCache::CookedMesh::~CookedMesh() {}
+
+bool MeshCache::CookedMesh::Open(const std::string& cachePath, uint64_t sourceHash, uint32_t importFlags)
+{
+	// A missing cache is the normal first-run case, so check before mapping
+	std::error_code error;
+	if (!std::filesystem::is_regular_file(cachePath, error))
+		return false;
+
+	file = std::make_unique<MappedFile>(cachePath.c_str());
+	if (file->GetSize() < sizeof(Header))
+	{
+		file.reset();
+		return false;
+	}
+
+	// Reject anything written by another version, for another vertex
+	// layout or from a source file that has since changed
+	const Header* candidate = (const Header*)file->GetData();
+	size_t indicesOffset = sizeof(Header) + PaddedSize((size_t)candidate->vertexCount * candidate->vertexStride);
+	size_t tableOffset = indicesOffset + PaddedSize((size_t)candidate->indexCount * candidate->indexStride);
+	size_t lodsOffset = tableOffset + (size_t)candidate->submeshCount * sizeof(SubmeshEntry);
+	size_t meshletsOffset = lodsOffset + (size_t)candidate->lodCount * sizeof(MeshLod);
+	size_t sourceOffset = meshletsOffset + (size_t)candidate->meshletCount * sizeof(Meshlet);
+	size_t measuredOffset = sourceOffset + sizeof(ImportReport::Source);
+	size_t namesOffset = measuredOffset + sizeof(ImportReport::Measured);
+	if (candidate->magic != FormatMagic ||
+		candidate->version != FormatVersion ||
+		candidate->vertexStride != VertexCompression::GetStride(GetVertexFormat(importFlags)) ||
+		candidate->sourceHash != sourceHash ||
+		candidate->importFlags != importFlags ||
+		candidate->indexStride != GetIndexStride(candidate->vertexCount) ||
+		candidate->lodCount == 0 ||
+		file->GetSize() < namesOffset)
+	{
+		file.reset();
+		return false;
+	}
+
+	// The names are the only variable-sized part, so the table has to
+	// be walked before the total size can be checked
+	const SubmeshEntry* table = (const SubmeshEntry*)(file->GetData() + tableOffset);
+	size_t namesSize = 0;
+	bool rangesValid = true;
+	for (uint32_t i = 0; i < candidate->submeshCount; i++)
+	{
+		namesSize += (size_t)table[i].nameLength + table[i].materialNameLength;
+		rangesValid = rangesValid && (size_t)table[i].indexStart + table[i].indexCount <= candidate->indexCount;
+	}
+	const MeshLod* lodTable = (const MeshLod*)(file->GetData() + lodsOffset);
+	for (uint32_t i = 0; i < candidate->lodCount; i++)
+		rangesValid = rangesValid && (size_t)lodTable[i].indexStart + lodTable[i].indexCount <= candidate->indexCount;
+	const Meshlet* meshletTable = (const Meshlet*)(file->GetData() + meshletsOffset);
+	for (uint32_t i = 0; i < candidate->meshletCount; i++)
+		rangesValid = rangesValid && (size_t)meshletTable[i].indexStart + meshletTable[i].indexCount <= candidate->indexCount;
+	if (!rangesValid || file->GetSize() != namesOffset + namesSize)
+	{
+		file.reset();
+		return false;
+	}
+
+	header = candidate;
+	vertices = file->GetData() + sizeof(Header);
+	indices = file->GetData() + indicesOffset;
+
+	lods.assign(lodTable, lodTable + header->lodCount);
+	meshlets.assign(meshletTable, meshletTable + header->meshletCount);
+	memcpy(&source, file->GetData() + sourceOffset, sizeof(source)); // May not be 8-byte aligned
+	memcpy(&measured, file->GetData() + measuredOffset, sizeof(measured));
+
+	const char* name = file->GetData() + namesOffset;
+	submeshes.resize(header->submeshCount);
+	for (uint32_t i = 0; i < header->submeshCount; i++)
+	{
+		submeshes[i].indexStart = table[i].indexStart;
+		submeshes[i].indexCount = table[i].indexCount;
+		submeshes[i].name.assign(name, table[i].nameLength);
+		name += table[i].nameLength;
+		submeshes[i].materialName.assign(name, table[i].materialNameLength);
+		name += table[i].materialNameLength;
+	}
+	return true;
+}
+
+const MeshCache::Header& MeshCache::CookedMesh::GetHeader() const
+{
+	return *header;
+}
+
+const void* MeshCache::CookedMesh::GetVertices() const
+{
+	return vertices;
+}
+
+const void* MeshCache::CookedMesh::GetIndices() const
+{
+	return indices;
+}
+
+const std::vector<Submesh>& MeshCache::CookedMesh::GetSubmeshes() const
+{
+	return submeshes;
+}
+
+const std::vector<MeshLod>& MeshCache::CookedMesh::GetLods() const
+{
+	return lods;
+}
+
+const std::vector<Meshlet>& MeshCache::CookedMesh::GetMeshlets() const
+{
+	return meshlets;
+}
+
+const ImportReport::Source& MeshCache::CookedMesh::GetSource() const
+{
+	return source;
+}
+
+const ImportReport::Measured& MeshCache::CookedMesh::GetMeasured() const
+{
+	return measured;
+}
+
+uint32_t MeshCache::GetImportFlags(const MeshImportSettings& settings)
+{
+	return
+		(settings.streaming ? 1u : 0u) |
+		(settings.optimize ? 2u : 0u) |
+		(settings.splitTangentMirrors ? 4u : 0u) |
+		(settings.generateLods ? 8u : 0u) |
+		(settings.buildMeshlets ? 16u : 0u) |
+		((uint32_t)settings.vertexFormat << 16);
+}
+
+VertexFormat MeshCache::GetVertexFormat(uint32_t importFlags)
+{
+	return (VertexFormat)(importFlags >> 16);
+}
+
+std::string MeshCache::GetCachePath(const char* sourcePath, uint32_t importFlags)
+{
+	char flags[16];
+	std::to_chars_result result = std::to_chars(flags, flags + sizeof(flags), importFlags, 16);
+	return std::string(sourcePath) + "." + std::string(flags, result.ptr) + ".cmesh";
+}
+
+// --------------------------------------------------------
+// Hashes 8 bytes per step (multiply + xor-shift), which is
+// fast enough to run over large source files on every load
+// --------------------------------------------------------
+uint64_t MeshCache::HashBytes(const char* data, size_t size)
+{
+	const uint64_t prime = 0x100000001B3ull;
+	uint64_t hash = 0xCBF29CE484222325ull ^ size;
+
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ word) * prime;
+		hash ^= hash >> 29;
+	}
+
+	// Remaining bytes one at a time
+	for (; i < size; i++)
+	{
+		hash = (hash ^ (unsigned char)data[i]) * prime;
+	}
+
+	return hash;
+}
+
+bool MeshCache::Write(
+	const std::string& cachePath,
+	uint64_t sourceHash,
+	uint32_t importFlags,
+	const void* vertices,
+	unsigned int vertexStride,
+	unsigned int vertexCount,
+	const void* indices,
+	unsigned int indexStride,
+	unsigned int indexCount,
+	const std::vector<Submesh>& submeshes,
+	const std::vector<MeshLod>& lods,
+	const std::vector<Meshlet>& meshlets,
+	const ImportReport::Source& source,
+	const ImportReport::Measured& measured,
+	const BoundingBox& boundingBox,
+	const BoundingSphere& boundingSphere)
+{
+	Header header = {};
+	header.magic = FormatMagic;
+	header.version = FormatVersion;
+	header.sourceHash = sourceHash;
+	header.importFlags = importFlags;
+	header.vertexStride = vertexStride;
+	header.vertexCount = vertexCount;
+	header.indexCount = indexCount;
+	header.submeshCount = (uint32_t)submeshes.size();
+	header.lodCount = (uint32_t)lods.size();
+	header.meshletCount = (uint32_t)meshlets.size();
+	header.indexStride = indexStride;
+	header.boundingBox = boundingBox;
+	header.boundingSphere = boundingSphere;
+
+	// Write to a temporary file first, so a partially written cache
+	// can never be mistaken for a complete one
+	std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		if (!out.is_open())
+			return false;
+
+		const char padding[BlockAlignment] = {};
+		size_t vertexBytes = (size_t)vertexCount * vertexStride;
+		size_t indexBytes = (size_t)indexCount * indexStride;
+		out.write((const char*)&header, sizeof(header));
+		out.write((const char*)vertices, (std::streamsize)vertexBytes);
+		out.write(padding, (std::streamsize)(PaddedSize(vertexBytes) - vertexBytes));
+		out.write((const char*)indices, (std::streamsize)indexBytes);
+		out.write(padding, (std::streamsize)(PaddedSize(indexBytes) - indexBytes));
+		for (const Submesh& submesh : submeshes)
+		{
+			SubmeshEntry entry = {};
+			entry.indexStart = submesh.indexStart;
+			entry.indexCount = submesh.indexCount;
+			entry.nameLength = (uint32_t)submesh.name.size();
+			entry.materialNameLength = (uint32_t)submesh.materialName.size();
+			out.write((const char*)&entry, sizeof(entry));
+		}
+		out.write((const char*)lods.data(), (std::streamsize)lods.size() * sizeof(MeshLod));
+		out.write((const char*)meshlets.data(), (std::streamsize)meshlets.size() * sizeof(Meshlet));
+		out.write((const char*)&source, sizeof(source));
+		out.write((const char*)&measured, sizeof(measured));
+		for (const Submesh& submesh : submeshes)
+		{
+			out.write(submesh.name.data(), (std::streamsize)submesh.name.size());
+			out.write(submesh.materialName.data(), (std::streamsize)submesh.materialName.size());
+		}
+		if (!out.good())
+			return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, cachePath, error);
+	if (error)
+	{
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include "Vertex.h"
+#include "MappedFile.h"
+#include "Submesh.h"
+#include "MeshLod.h"
+#include "Meshlet.h"
+#include "MeshImportSettings.h"
+#include "ImportReport.h"
+
+// Cooked (pre-processed) meshes, stored next to their source file so the
+// final vertices and indices can be mapped straight back into memory
+// instead of being parsed again
+namespace MeshCache
+{
+	// Bump whenever the layout of the file or of a vertex format changes
+	const uint32_t FormatVersion = 13;
+	const uint32_t FormatMagic = 0x48534D43; // "CMSH"
+	const size_t BlockAlignment = 8;
+
+	// Found at the very start of every cooked file. The vertex array, in
+	// the vertex format the import flags ask for, follows directly after
+	// it, then the index array (every level of
+	// detail), the submesh table, the MeshLod table, the Meshlet table, the
+	// ImportReport::Source and ImportReport::Measured of the import and
+	// finally the submesh names back to back (not terminated). The vertex
+	// and index arrays are each padded to a multiple of BlockAlignment
+	// bytes, so the tables after them can be read in place.
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t sourceHash;	// Hash of the source file's bytes
+		uint32_t vertexStride;	// Size of the vertex format's struct when the file was written
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t submeshCount;
+		uint32_t lodCount;		// Always at least one
+		uint32_t meshletCount;	// Zero unless they were built on import
+		DirectX::BoundingBox boundingBox;		// See MeshBounds
+		DirectX::BoundingSphere boundingSphere;
+		uint32_t importFlags;	// See GetImportFlags()
+		uint32_t indexStride;	// 2 or 4 bytes, see GetIndexStride()
+	};
+
+	// One entry of the submesh table
+	struct SubmeshEntry
+	{
+		uint32_t indexStart;
+		uint32_t indexCount;
+		uint32_t nameLength;
+		uint32_t materialNameLength;
+	};
+
+	// A cooked file mapped into memory. Vertex and index pointers point
+	// directly into the mapping, ready to upload, and stay valid for its
+	// lifetime.
+	class CookedMesh
+	{
+	public:
+		CookedMesh();
+		~CookedMesh();
+		CookedMesh(const CookedMesh&) = delete;
+		CookedMesh& operator=(const CookedMesh&) = delete;
+
+		// Maps the file and validates it against the expected source hash
+		// and import flags. Returns false if it is missing, stale, imported
+		// with other settings or from an older format.
+		bool Open(const std::string& cachePath, uint64_t sourceHash, uint32_t importFlags);
+
+		const Header& GetHeader() const;
+		// In the vertex format of the import flags it was opened with
+		const void* GetVertices() const;
+		// 16 or 32-bit, depending on the header's index stride
+		const void* GetIndices() const;
+		// Copied out of the file when it is opened
+		const std::vector<Submesh>& GetSubmeshes() const;
+		const std::vector<MeshLod>& GetLods() const;
+		const std::vector<Meshlet>& GetMeshlets() const;
+		const ImportReport::Source& GetSource() const;
+		const ImportReport::Measured& GetMeasured() const;
+
+	private:
+		std::unique_ptr<MappedFile> file;
+		std::vector<Submesh> submeshes;
+		std::vector<MeshLod> lods;
+		std::vector<Meshlet> meshlets;
+		ImportReport::Source source;
+		ImportReport::Measured measured;
+		const Header* header;
+		const void* vertices;
+		const void* indices;
+	};
+
+	// Where the cooked version of a source file lives for the given import
+	// flags: "<source>.<flags in hex>.cmesh". Each combination of settings
+	// gets its own file, so switching between them doesn't keep
+	// overwriting one cook with another.
+	std::string GetCachePath(const char* sourcePath, uint32_t importFlags);
+
+	// Packs the import settings that change the cooked output into bits,
+	// with the vertex format from bit 16 up
+	uint32_t GetImportFlags(const MeshImportSettings& settings);
+
+	// The vertex format packed into a set of import flags
+	VertexFormat GetVertexFormat(uint32_t importFlags);
+
+	// Fast 64-bit hash of a block of bytes, used to detect source changes
+	uint64_t HashBytes(const char* data, size_t size);
+
+	// Writes a cooked file. The vertices must already be in the import
+	// flags' vertex format and the indices narrowed to 16 bits whenever
+	// the vertex count allows it (see GetIndexStride()), so they can be
+	// uploaded straight from the file later. The bounds are stored as
+	// given, so they don't have to be recalculated on load. Returns false
+	// if it couldn't be written (a missing cache is not an error, it just
+	// means parsing next time)
+	bool Write(
+		const std::string& cachePath,
+		uint64_t sourceHash,
+		uint32_t importFlags,
+		const void* vertices,
+		unsigned int vertexStride,
+		unsigned int vertexCount,
+		const void* indices,
+		unsigned int indexStride,
+		unsigned int indexCount,
+		const std::vector<Submesh>& submeshes,
+		const std::vector<MeshLod>& lods,
+		const std::vector<Meshlet>& meshlets,
+		const ImportReport::Source& source,
+		const ImportReport::Measured& measured,
+		const DirectX::BoundingBox& boundingBox,
+		const DirectX::BoundingSphere& boundingSphere);
+}
\ No newline at end of file
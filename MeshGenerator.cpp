@@ -0,0 +1,385 @@
+#include "MeshGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+namespace
+{
+	// Everything a generator knows about one point on its surface. The
+	// tangent and bitangent come from the directions U and V increase in,
+	// which only need to be roughly right (they're orthonormalized later).
+	struct SurfacePoint
+	{
+		XMVECTOR position;
+		XMVECTOR normal;
+		XMFLOAT2 uv;
+		XMVECTOR alongU;
+		XMVECTOR alongV;
+	};
+
+	// Fills the output spans in order, checking they're big enough up front
+	class Writer
+	{
+	public:
+		Writer(std::span<Vertex> vertices, std::span<unsigned int> indices, MeshGenerator::Size size)
+			: vertices(vertices), indices(indices)
+		{
+			if (vertices.size() < size.vertexCount || indices.size() < size.indexCount)
+				throw std::invalid_argument("MeshGenerator: output spans are smaller than the shape's Size");
+		}
+
+		// Same tangent frame TangentGenerator would build from these directions
+		unsigned int AddVertex(const SurfacePoint& point)
+		{
+			Vertex& vertex = vertices[vertexCount];
+			XMVECTOR normal = XMVector3Normalize(point.normal);
+			XMVECTOR tangent = XMVector3Normalize(point.alongU - normal * XMVector3Dot(normal, point.alongU));
+			float handedness = XMVectorGetX(XMVector3Dot(XMVector3Cross(normal, tangent), point.alongV));
+
+			XMStoreFloat3(&vertex.Position, point.position);
+			XMStoreFloat3(&vertex.Normal, normal);
+			vertex.UV = point.uv;
+			XMStoreFloat4(&vertex.Tangent, XMVectorSetW(tangent, handedness < 0.0f ? -1.0f : 1.0f));
+			return vertexCount++;
+		}
+
+		unsigned int GetVertexCount() const
+		{
+			return vertexCount;
+		}
+
+		// Flips the corners if needed so the triangle is clockwise when
+		// seen from the side its vertex normals point to
+		void AddTriangle(unsigned int a, unsigned int b, unsigned int c)
+		{
+			XMVECTOR p0 = XMLoadFloat3(&vertices[a].Position);
+			XMVECTOR p1 = XMLoadFloat3(&vertices[b].Position);
+			XMVECTOR p2 = XMLoadFloat3(&vertices[c].Position);
+			XMVECTOR normal = XMLoadFloat3(&vertices[a].Normal) + XMLoadFloat3(&vertices[b].Normal) + XMLoadFloat3(&vertices[c].Normal);
+			if (XMVectorGetX(XMVector3Dot(XMVector3Cross(p1 - p0, p2 - p0), normal)) < 0.0f)
+				std::swap(b, c);
+
+			indices[indexCount++] = a;
+			indices[indexCount++] = b;
+			indices[indexCount++] = c;
+		}
+
+	private:
+		std::span<Vertex> vertices;
+		std::span<unsigned int> indices;
+		unsigned int vertexCount = 0;
+		size_t indexCount = 0;
+	};
+
+	// --------------------------------------------------------
+	// A surface sampled on a (columns + 1) x (rows + 1) grid of
+	// points, with u and v going from 0 to 1 across it. Rows that
+	// collapse to a single position (like a sphere's poles) only
+	// get the one triangle per square that isn't degenerate, and
+	// one point per square (at the middle of its u range) for it.
+	// --------------------------------------------------------
+	MeshGenerator::Size GridSize(unsigned int columns, unsigned int rows, unsigned int collapsedRows = 0)
+	{
+		return { (columns + 1) * (rows + 1) - collapsedRows, columns * (rows * 6 - collapsedRows * 3) };
+	}
+
+	template<typename Surface>
+	void Grid(Writer& writer, unsigned int columns, unsigned int rows, bool collapseFirstRow, bool collapseLastRow, Surface surface)
+	{
+		unsigned int first = writer.GetVertexCount();
+		for (unsigned int r = 0; r <= rows; r++)
+		{
+			if ((collapseFirstRow && r == 0) || (collapseLastRow && r == rows))
+			{
+				for (unsigned int c = 0; c < columns; c++)
+					writer.AddVertex(surface((c + 0.5f) / columns, (float)r / rows));
+			}
+			else
+			{
+				for (unsigned int c = 0; c <= columns; c++)
+					writer.AddVertex(surface((float)c / columns, (float)r / rows));
+			}
+		}
+
+		// Every row after a collapsed first row starts one point earlier
+		auto rowStart = [&](unsigned int r) { return first + r * (columns + 1) - (collapseFirstRow && r > 0 ? 1 : 0); };
+		for (unsigned int r = 0; r < rows; r++)
+		{
+			for (unsigned int c = 0; c < columns; c++)
+			{
+				unsigned int topLeft = rowStart(r) + c;
+				unsigned int bottomLeft = rowStart(r + 1) + c;
+				if (collapseFirstRow && r == 0)
+					writer.AddTriangle(topLeft, bottomLeft + 1, bottomLeft);
+				else if (collapseLastRow && r == rows - 1)
+					writer.AddTriangle(topLeft, topLeft + 1, bottomLeft);
+				else
+				{
+					writer.AddTriangle(topLeft, topLeft + 1, bottomLeft);
+					writer.AddTriangle(topLeft + 1, bottomLeft + 1, bottomLeft);
+				}
+			}
+		}
+	}
+
+	// A flat cap: the center plus a ring of count points, fanned together
+	MeshGenerator::Size FanSize(unsigned int count)
+	{
+		return { count + 1, count * 3 };
+	}
+
+	template<typename Ring>
+	void Fan(Writer& writer, const SurfacePoint& center, unsigned int count, Ring ring)
+	{
+		unsigned int centerIndex = writer.AddVertex(center);
+		for (unsigned int i = 0; i < count; i++)
+			writer.AddVertex(ring(i));
+		for (unsigned int i = 0; i < count; i++)
+			writer.AddTriangle(centerIndex, centerIndex + 1 + i, centerIndex + 1 + (i + 1) % count);
+	}
+
+	// A flat square facing along normal, with the top of the texture towards up
+	void Face(Writer& writer, XMVECTOR center, XMVECTOR normal, XMVECTOR up, unsigned int segments, float halfSize)
+	{
+		// Right as seen from in front of the face (left-handed)
+		XMVECTOR right = XMVector3Cross(up, -normal);
+		Grid(writer, segments, segments, false, false, [&](float u, float v)
+			{
+				XMVECTOR position = center + right * ((u * 2.0f - 1.0f) * halfSize) + up * ((1.0f - v * 2.0f) * halfSize);
+				return SurfacePoint{ position, normal, XMFLOAT2(u, v), right, -up };
+			});
+	}
+
+	MeshGenerator::Size operator+(MeshGenerator::Size a, MeshGenerator::Size b)
+	{
+		return { a.vertexCount + b.vertexCount, a.indexCount + b.indexCount };
+	}
+}
+
+MeshGenerator::Size MeshGenerator::CubeSize(unsigned int segments)
+{
+	segments = std::max(segments, 1u);
+	Size face = GridSize(segments, segments);
+	return { face.vertexCount * 6, face.indexCount * 6 };
+}
+
+void MeshGenerator::Cube(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int segments, float halfSize)
+{
+	Writer writer(vertices, indices, CubeSize(segments));
+	segments = std::max(segments, 1u);
+
+	// +X, -X, +Y, -Y, +Z, -Z like a cube map. The sides keep +Y up and
+	// the top and bottom keep +Z and -Z away from the viewer.
+	const XMVECTOR faces[6][2] = {
+		{ XMVectorSet(1, 0, 0, 0), XMVectorSet(0, 1, 0, 0) },
+		{ XMVectorSet(-1, 0, 0, 0), XMVectorSet(0, 1, 0, 0) },
+		{ XMVectorSet(0, 1, 0, 0), XMVectorSet(0, 0, 1, 0) },
+		{ XMVectorSet(0, -1, 0, 0), XMVectorSet(0, 0, -1, 0) },
+		{ XMVectorSet(0, 0, 1, 0), XMVectorSet(0, 1, 0, 0) },
+		{ XMVectorSet(0, 0, -1, 0), XMVectorSet(0, 1, 0, 0) },
+	};
+	for (const auto& face : faces)
+		Face(writer, face[0] * halfSize, face[0], face[1], segments, halfSize);
+}
+
+MeshGenerator::Size MeshGenerator::SphereSize(unsigned int slices, unsigned int stacks)
+{
+	return GridSize(std::max(slices, 3u), std::max(stacks, 2u), 2);
+}
+
+void MeshGenerator::Sphere(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int slices, unsigned int stacks, float radius)
+{
+	Writer writer(vertices, indices, SphereSize(slices, stacks));
+	slices = std::max(slices, 3u);
+	stacks = std::max(stacks, 2u);
+
+	Grid(writer, slices, stacks, true, true, [&](float u, float v)
+		{
+			float phi = u * XM_2PI;
+			float theta = v * XM_PI;
+			float sinPhi = std::sin(phi), cosPhi = std::cos(phi);
+
+			// Exactly zero at the poles, so their vertices share a position
+			float sinTheta = (v == 0.0f || v == 1.0f) ? 0.0f : std::sin(theta);
+			float cosTheta = std::cos(theta);
+
+			XMVECTOR normal = XMVectorSet(sinTheta * cosPhi, cosTheta, sinTheta * sinPhi, 0);
+			return SurfacePoint{
+				normal * radius,
+				normal,
+				XMFLOAT2(u, v),
+				XMVectorSet(-sinPhi, 0, cosPhi, 0),
+				XMVectorSet(cosTheta * cosPhi, -sinTheta, cosTheta * sinPhi, 0) };
+		});
+}
+
+MeshGenerator::Size MeshGenerator::CylinderSize(unsigned int slices, unsigned int stacks)
+{
+	slices = std::max(slices, 3u);
+	return GridSize(slices, std::max(stacks, 1u)) + FanSize(slices) + FanSize(slices);
+}
+
+void MeshGenerator::Cylinder(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int slices, unsigned int stacks, float radius, float height)
+{
+	Writer writer(vertices, indices, CylinderSize(slices, stacks));
+	slices = std::max(slices, 3u);
+	stacks = std::max(stacks, 1u);
+	float top = height * 0.5f;
+
+	Grid(writer, slices, stacks, false, false, [&](float u, float v)
+		{
+			float phi = u * XM_2PI;
+			XMVECTOR normal = XMVectorSet(std::cos(phi), 0, std::sin(phi), 0);
+			return SurfacePoint{
+				normal * radius + XMVectorSet(0, top - v * height, 0, 0),
+				normal,
+				XMFLOAT2(u, v),
+				XMVectorSet(-std::sin(phi), 0, std::cos(phi), 0),
+				XMVectorSet(0, -1, 0, 0) };
+		});
+
+	// Caps are textured like a quad seen from above and below
+	for (float side : { 1.0f, -1.0f })
+	{
+		XMVECTOR normal = XMVectorSet(0, side, 0, 0);
+		XMVECTOR right = XMVectorSet(1, 0, 0, 0);
+		XMVECTOR down = XMVectorSet(0, 0, -side, 0);
+		SurfacePoint center = { normal * top, normal, XMFLOAT2(0.5f, 0.5f), right, down };
+		Fan(writer, center, slices, [&](unsigned int i)
+			{
+				float phi = (float)i / slices * XM_2PI;
+				float x = std::cos(phi), z = std::sin(phi);
+				return SurfacePoint{
+					XMVectorSet(x * radius, side * top, z * radius, 0),
+					normal,
+					XMFLOAT2(0.5f + x * 0.5f, 0.5f - z * side * 0.5f),
+					right,
+					down };
+			});
+	}
+}
+
+MeshGenerator::Size MeshGenerator::TorusSize(unsigned int rings, unsigned int sides)
+{
+	return GridSize(std::max(rings, 3u), std::max(sides, 3u));
+}
+
+void MeshGenerator::Torus(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int rings, unsigned int sides, float majorRadius, float minorRadius)
+{
+	Writer writer(vertices, indices, TorusSize(rings, sides));
+	rings = std::max(rings, 3u);
+	sides = std::max(sides, 3u);
+
+	Grid(writer, rings, sides, false, false, [&](float u, float v)
+		{
+			float alpha = u * XM_2PI;
+			float beta = v * XM_2PI;
+			float sinAlpha = std::sin(alpha), cosAlpha = std::cos(alpha);
+			float sinBeta = std::sin(beta), cosBeta = std::cos(beta);
+
+			// Out from the middle of the tube
+			XMVECTOR normal = XMVectorSet(cosBeta * cosAlpha, sinBeta, cosBeta * sinAlpha, 0);
+			XMVECTOR middle = XMVectorSet(cosAlpha, 0, sinAlpha, 0) * majorRadius;
+			return SurfacePoint{
+				middle + normal * minorRadius,
+				normal,
+				XMFLOAT2(u, v),
+				XMVectorSet(-sinAlpha, 0, cosAlpha, 0),
+				XMVectorSet(-sinBeta * cosAlpha, cosBeta, -sinBeta * sinAlpha, 0) };
+		});
+}
+
+MeshGenerator::Size MeshGenerator::HelixSize(unsigned int segments, unsigned int sides)
+{
+	sides = std::max(sides, 3u);
+	return GridSize(std::max(segments, 1u), sides) + FanSize(sides) + FanSize(sides);
+}
+
+void MeshGenerator::Helix(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int segments, unsigned int sides,
+	float turns, float radius, float tubeRadius, float height)
+{
+	Writer writer(vertices, indices, HelixSize(segments, sides));
+	segments = std::max(segments, 1u);
+	sides = std::max(sides, 3u);
+
+	// The tube's frame at t (0 to 1 along its length): the middle of the
+	// tube, the direction it's heading, and two directions across it
+	// (towards the Y axis and perpendicular to both)
+	struct Frame { XMVECTOR middle, forward, inward, across; };
+	auto frameAt = [&](float t)
+		{
+			float angle = t * turns * XM_2PI;
+			float sinAngle = std::sin(angle), cosAngle = std::cos(angle);
+			float spin = turns * XM_2PI * radius;
+
+			Frame frame;
+			frame.middle = XMVectorSet(cosAngle * radius, (t - 0.5f) * height, sinAngle * radius, 0);
+			frame.forward = XMVector3Normalize(XMVectorSet(-sinAngle * spin, height, cosAngle * spin, 0));
+			frame.inward = XMVectorSet(-cosAngle, 0, -sinAngle, 0);
+			frame.across = XMVector3Cross(frame.forward, frame.inward);
+			return frame;
+		};
+
+	Grid(writer, segments, sides, false, false, [&](float u, float v)
+		{
+			Frame frame = frameAt(u);
+			float beta = v * XM_2PI;
+			XMVECTOR normal = frame.inward * std::cos(beta) + frame.across * std::sin(beta);
+			return SurfacePoint{
+				frame.middle + normal * tubeRadius,
+				normal,
+				XMFLOAT2(u * turns, v),
+				frame.forward,
+				frame.across * std::cos(beta) - frame.inward * std::sin(beta) };
+		});
+
+	// Close off both ends, facing away from the tube
+	for (float t : { 0.0f, 1.0f })
+	{
+		Frame frame = frameAt(t);
+		XMVECTOR normal = t == 0.0f ? -frame.forward : frame.forward;
+		SurfacePoint center = { frame.middle, normal, XMFLOAT2(0.5f, 0.5f), frame.inward, frame.across };
+		Fan(writer, center, sides, [&](unsigned int i)
+			{
+				float beta = (float)i / sides * XM_2PI;
+				float x = std::cos(beta), y = std::sin(beta);
+				return SurfacePoint{
+					frame.middle + (frame.inward * x + frame.across * y) * tubeRadius,
+					normal,
+					XMFLOAT2(0.5f + x * 0.5f, 0.5f + y * 0.5f),
+					frame.inward,
+					frame.across };
+			});
+	}
+}
+
+MeshGenerator::Size MeshGenerator::QuadSize(unsigned int segments)
+{
+	segments = std::max(segments, 1u);
+	return GridSize(segments, segments);
+}
+
+void MeshGenerator::Quad(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int segments, float halfSize)
+{
+	Writer writer(vertices, indices, QuadSize(segments));
+	Face(writer, XMVectorZero(), XMVectorSet(0, 1, 0, 0), XMVectorSet(0, 0, 1, 0), std::max(segments, 1u), halfSize);
+}
+
+MeshGenerator::Size MeshGenerator::DoubleSidedQuadSize(unsigned int segments)
+{
+	return QuadSize(segments) + QuadSize(segments);
+}
+
+void MeshGenerator::DoubleSidedQuad(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int segments, float halfSize)
+{
+	Writer writer(vertices, indices, DoubleSidedQuadSize(segments));
+	segments = std::max(segments, 1u);
+
+	// Both keep the top of the texture towards +Z
+	Face(writer, XMVectorZero(), XMVectorSet(0, 1, 0, 0), XMVectorSet(0, 0, 1, 0), segments, halfSize);
+	Face(writer, XMVectorZero(), XMVectorSet(0, -1, 0, 0), XMVectorSet(0, 0, 1, 0), segments, halfSize);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <span>
+#include "Vertex.h"
+
+// Builds the basic shapes in code instead of loading them from files.
+// Positions, normals, uvs and tangents are all calculated from the shape
+// itself (no TangentGenerator pass needed), and triangles are clockwise
+// from outside like everything else the renderer draws.
+//
+// Each shape has a Size function giving the vertex and index counts for
+// some tessellation, and a generator writing exactly that many into the
+// given spans (throwing std::invalid_argument if either is too small),
+// so callers can allocate once however they like. Tessellation below a
+// shape's minimum is raised to it, the same way in both functions.
+//
+// Default sizes match the .obj files in Assets/Meshes.
+namespace MeshGenerator
+{
+	struct Size
+	{
+		unsigned int vertexCount;
+		unsigned int indexCount;
+	};
+
+	// Six faces from -halfSize to +halfSize on each axis, each split into
+	// segments x segments squares with the whole texture across them
+	Size CubeSize(unsigned int segments = 1);
+	void Cube(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int segments = 1, float halfSize = 1.0f);
+
+	// Latitude/longitude sphere with the poles on the Y axis. U wraps once
+	// around (with a duplicated seam column) and V runs from the top pole
+	// down. Each pole has a vertex per slice, at the middle of its U range.
+	// At least 3 slices and 2 stacks.
+	Size SphereSize(unsigned int slices = 32, unsigned int stacks = 16);
+	void Sphere(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int slices = 32, unsigned int stacks = 16, float radius = 1.0f);
+
+	// Capped cylinder along the Y axis, centered on the origin. The caps
+	// are fans with the texture mapped straight down onto them. At least
+	// 3 slices and 1 stack.
+	Size CylinderSize(unsigned int slices = 32, unsigned int stacks = 1);
+	void Cylinder(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int slices = 32, unsigned int stacks = 1, float radius = 1.0f, float height = 2.0f);
+
+	// Ring in the XZ plane. Rings go around the Y axis and sides go around
+	// the tube. At least 3 of each.
+	Size TorusSize(unsigned int rings = 40, unsigned int sides = 20);
+	void Torus(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int rings = 40, unsigned int sides = 20, float majorRadius = 0.7143f, float minorRadius = 0.2857f);
+
+	// Capped tube winding around the Y axis from bottom to top. Segments
+	// run along its length (U repeats once per turn) and sides go around
+	// it. At least 1 segment and 3 sides.
+	Size HelixSize(unsigned int segments = 128, unsigned int sides = 16);
+	void Helix(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int segments = 128, unsigned int sides = 16,
+		float turns = 2.0f, float radius = 0.8f, float tubeRadius = 0.2f, float height = 2.0f);
+
+	// Square in the XZ plane facing +Y, with the top of the texture at +Z
+	Size QuadSize(unsigned int segments = 1);
+	void Quad(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int segments = 1, float halfSize = 1.0f);
+
+	// The same square plus a copy facing -Y, textured so neither side is mirrored
+	Size DoubleSidedQuadSize(unsigned int segments = 1);
+	void DoubleSidedQuad(std::span<Vertex> vertices, std::span<unsigned int> indices, unsigned int segments = 1, float halfSize = 1.0f);
+}
\ No newline at end of file
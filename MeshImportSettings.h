@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CompactVertex.h"
+
+// Options controlling how a mesh file is imported
+struct MeshImportSettings
+{
+	/* Streams welded vertices and indices out while reading the file
+	 * instead of building every face first. Peak memory stays close to
+	 * the final mesh size, but it runs on a single thread and welds on
+	 * OBJ index triples (duplicated values under different indices are
+	 * kept as separate vertices) */
+	bool streaming = false;
+
+	/* Reorders triangles (per submesh) so recently transformed vertices
+	 * are reused from the GPU's post-transform cache, then reorders the
+	 * vertices themselves into the order they are first used */
+	bool optimize = true;
+
+	/* Gives vertices on a UV mirror seam (shared by triangles whose uvs
+	 * are flipped relative to each other) a separate copy per side, so
+	 * each side gets its own tangent and handedness instead of an
+	 * average that fits neither */
+	bool splitTangentMirrors = true;
+
+	/* Builds simplified levels of detail (see MeshSimplifier) after the
+	 * full detail triangles in the same index buffer, which entities
+	 * switch between based on their size on screen */
+	bool generateLods = true;
+
+	/* Splits the full detail triangles into meshlets (see MeshletBuilder)
+	 * with their own bounds, so parts of a mesh that are off screen or
+	 * facing away can be skipped on the CPU before drawing */
+	bool buildMeshlets = true;
+
+	/* How vertices are stored on the GPU. The compact formats trade a
+	 * little precision (see CompactVertex.h) for roughly half the memory
+	 * and bandwidth, and need their own input layout and vertex shader */
+	VertexFormat vertexFormat = VertexFormat::Full;
+};
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include "MeshImporter.h"
+#include "MappedFile.h"
+#include "VertexWelder.h"
+#include "MeshSink.h"
+#include "IndexFormat.h"
+#include "MeshBounds.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+
+#include <string>
+#include <chrono>
+#include <cfloat>
+
+using namespace DirectX;
+
+namespace
+{
+	// Parses, welds and calculates tangents for the contents of an .obj file
+	void ImportObj(const char* begin, const char* end, const MeshImportSettings& settings, MeshData& data)
+	{
+		// Author: Chris Cascioli
+		// Latest Revision: 02/2026
+		// Purpose: Basic .OBJ 3D model loading, supporting positions, uvs and normals
+		// - The text is tokenized in place, so lines of any length are fine
+
+		std::vector<Vertex>& finalVertices = data.vertices;	// Final, de-duplicated verts
+		std::vector<unsigned int>& finalIndices = data.indices;	// Indices for final verts
+		if (settings.streaming)
+		{
+			// Single pass with bounded memory, welding as faces are read
+			VectorMeshSink sink;
+			std::vector<ObjParser::Marker> markers;
+			data.streamStats = ObjParser::ParseStreaming(begin, end, sink, markers, data.report.source.parsed);
+			finalVertices = std::move(sink.vertices);
+			finalIndices = std::move(sink.indices);
+			data.submeshes = ObjParser::BuildSubmeshes(markers, finalIndices.size());
+		}
+		else
+		{
+			// Raw positions, normals, uvs and face corners from the file
+			ObjParser::ObjData obj;
+			ObjParser::ParseParallel(begin, end, obj);
+
+			// Weld bitwise-identical vertices together with a flat hash
+			// table, sized up front so it never has to grow for this file.
+			// Vertices are built per corner and welded right away, so the
+			// full list of duplicated vertices never exists in memory.
+			VertexWelder welder(WeldMode::Exact, obj.triangles.size());
+			ObjParser::SourceCounter counter;
+			finalIndices.reserve(obj.triangles.size());
+			for (size_t t = 0; t < obj.triangles.size(); t += 3)
+			{
+				// Walk the corners with the winding order flipped (LH vs. RH)
+				const size_t cornerOrder[3] = { t, t + 2, t + 1 };
+				for (size_t c : cornerOrder)
+				{
+					counter.AddCorner(obj, obj.triangles[c]);
+					Vertex v = ObjParser::BuildVertex(obj, obj.triangles[c]);
+
+					// Either finds the earlier copy of this vertex, or
+					// hands out the next index if it hasn't been seen
+					bool isNew = false;
+					unsigned int index = welder.Weld(v, &isNew);
+					if (isNew)
+						finalVertices.push_back(v);
+
+					// Either way, save the index
+					finalIndices.push_back(index);
+				}
+			}
+
+			// Triangles keep their file order, so corners map 1:1 to indices
+			data.submeshes = ObjParser::BuildSubmeshes(obj.markers, finalIndices.size());
+			data.report.source.parsed = counter.Finish(obj);
+		}
+		data.report.source.weldedVertexCount = finalVertices.size();
+
+		// Mirror seam copies are appended, so submesh ranges are unaffected
+		data.tangentStats = TangentGenerator::Generate(finalVertices, finalIndices, settings.splitTangentMirrors);
+	}
+
+	// --------------------------------------------------------
+	// Builds the levels of detail, optimizes, and calculates the
+	// bounds and meshlets of welded vertices and indices (with
+	// tangents and submeshes already set), per the settings
+	// --------------------------------------------------------
+	void Process(MeshData& data, const MeshImportSettings& settings)
+	{
+		std::vector<Vertex>& finalVertices = data.vertices;
+		std::vector<unsigned int>& finalIndices = data.indices;
+
+		// Simplified copies go after the full detail indices
+		if (settings.generateLods)
+			data.lods = MeshSimplifier::BuildLods(finalVertices.data(), (unsigned int)finalVertices.size(), finalIndices, data.submeshes);
+		else
+			data.lods.push_back({ 0, (unsigned int)finalIndices.size(), 0.0f });
+
+		// Reorder for the GPU's vertex cache and memory fetches (imports
+		// cache the results, so this only happens once per file)
+		if (settings.optimize)
+		{
+			data.originalVertexCacheStats = MeshOptimizer::SimulateVertexCache(
+				finalIndices.data(), data.lods[0].indexCount, (unsigned int)finalVertices.size());
+			data.report.source.originalAcmr = data.originalVertexCacheStats.acmr;
+
+			// Every level of detail is a range of its own, just like a submesh
+			std::vector<Submesh> ranges = data.submeshes;
+			for (size_t i = 1; i < data.lods.size(); i++)
+				ranges.push_back({ data.lods[i].indexStart, data.lods[i].indexCount, "", "" });
+
+			unsigned int vertexCount = MeshOptimizer::Optimize(
+				finalVertices.data(), (unsigned int)finalVertices.size(),
+				finalIndices.data(), finalIndices.size(),
+				ranges);
+			finalVertices.resize(vertexCount);
+		}
+
+		MeshBounds::Compute(finalVertices.data(), (unsigned int)finalVertices.size(), data.boundingBox, data.boundingSphere);
+
+		// Clusters follow the final triangle order, so this has to come last
+		if (settings.buildMeshlets)
+			data.meshlets = MeshletBuilder::Build(finalVertices.data(), (unsigned int)finalVertices.size(), finalIndices.data(), data.submeshes);
+	}
+
+	// Triangles that can't produce any pixels: a repeated index, or
+	// positions on a line (relative to the triangle's own size)
+	template<typename Index>
+	unsigned int CountDegenerateTriangles(const Vertex* vertices, const Index* indices, size_t indexCount)
+	{
+		unsigned int count = 0;
+		for (size_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			Index a = indices[i], b = indices[i + 1], c = indices[i + 2];
+			if (a == b || b == c || a == c)
+			{
+				count++;
+				continue;
+			}
+
+			XMVECTOR p0 = XMLoadFloat3(&vertices[a].Position);
+			XMVECTOR edge1 = XMLoadFloat3(&vertices[b].Position) - p0;
+			XMVECTOR edge2 = XMLoadFloat3(&vertices[c].Position) - p0;
+			float area = XMVectorGetX(XMVector3LengthSq(XMVector3Cross(edge1, edge2)));
+			float scale = XMVectorGetX(XMVector3LengthSq(edge1)) * XMVectorGetX(XMVector3LengthSq(edge2));
+			count += !(area > scale * FLT_EPSILON * FLT_EPSILON);
+		}
+		return count;
+	}
+
+	// Checks the full detail triangles (LOD 0 is always first) for
+	// degenerates and runs them through the vertex cache simulator
+	ImportReport::Measured MeasureUpload(const MeshData& data, const Vertex* vertices)
+	{
+		ImportReport::Measured measured = {};
+		unsigned int fullIndexCount = data.lods[0].indexCount;
+		MeshOptimizer::CacheStats cache;
+		if (data.indexStride == sizeof(uint16_t))
+		{
+			const uint16_t* indices = (const uint16_t*)data.indexData;
+			measured.degenerateTriangleCount = CountDegenerateTriangles(vertices, indices, fullIndexCount);
+			cache = MeshOptimizer::SimulateVertexCache(indices, fullIndexCount, data.vertexCount);
+		}
+		else
+		{
+			const unsigned int* indices = (const unsigned int*)data.indexData;
+			measured.degenerateTriangleCount = CountDegenerateTriangles(vertices, indices, fullIndexCount);
+			cache = MeshOptimizer::SimulateVertexCache(indices, fullIndexCount, data.vertexCount);
+		}
+		measured.acmr = cache.acmr;
+		measured.atvr = cache.atvr;
+		return measured;
+	}
+
+	// Fills in the parts of the report that describe what gets uploaded
+	void ReportUpload(MeshData& data, const ImportReport::Measured& measured)
+	{
+		data.vertexCacheStats = { measured.acmr, measured.atvr };
+
+		ImportReport& report = data.report;
+		report.vertexFormat = data.vertexFormat;
+		report.vertexCount = data.vertexCount;
+		report.triangleCount = data.lods[0].indexCount / 3;
+		report.degenerateTriangleCount = measured.degenerateTriangleCount;
+		report.submeshCount = (unsigned int)data.submeshes.size();
+		report.lodCount = (unsigned int)data.lods.size();
+		report.meshletCount = (unsigned int)data.meshlets.size();
+		report.boundingBox = data.boundingBox;
+		report.acmr = data.vertexCacheStats.acmr;
+		report.atvr = data.vertexCacheStats.atvr;
+		report.vertexBytes = (size_t)VertexCompression::GetStride(data.vertexFormat) * data.vertexCount;
+		report.indexBytes = (size_t)data.indexStride * data.indexCount;
+		report.tableBytes =
+			data.submeshes.size() * sizeof(Submesh) +
+			data.lods.size() * sizeof(MeshLod) +
+			data.meshlets.size() * sizeof(Meshlet);
+	}
+
+	// Arrays from code have nothing to parse or weld, so they describe themselves
+	void ReportArrays(MeshData& data)
+	{
+		ObjParser::SourceStats& parsed = data.report.source.parsed;
+		parsed.positionCount = data.vertices.size();
+		parsed.triangleCount = data.indices.size() / 3;
+		data.report.source.weldedVertexCount = data.vertices.size();
+	}
+
+	// --------------------------------------------------------
+	// Points the data at vertices already in its vertex format
+	// and at indices already in their final width, exactly as
+	// they get uploaded. The bounds must be set.
+	// --------------------------------------------------------
+	void SetUpload(MeshData& data, const void* vertices, unsigned int vertexCount, const void* indices, unsigned int indexStride, unsigned int indexCount)
+	{
+		data.vertexData = vertices;
+		data.indexData = indices;
+		data.indexStride = indexStride;
+		data.vertexCount = vertexCount;
+		data.indexCount = indexCount;
+
+		// Quantized positions are fractions of the mesh's bounds
+		if (data.vertexFormat == VertexFormat::Quantized)
+			XMStoreFloat4x4(&data.dequantizeMatrix, VertexCompression::GetDequantizeMatrix(
+				MeshBounds::GetMin(data.boundingBox), MeshBounds::GetMax(data.boundingBox)));
+		else
+			XMStoreFloat4x4(&data.dequantizeMatrix, XMMatrixIdentity());
+	}
+
+	// --------------------------------------------------------
+	// Converts the final vertices into the mesh's vertex format
+	// (if needed), narrows the indices to 16 bits when the
+	// vertex count allows it and points the data at the
+	// result. The bounds, submeshes and levels of detail must
+	// be set. Returns what was measured on the result.
+	// --------------------------------------------------------
+	ImportReport::Measured PrepareForUpload(MeshData& data)
+	{
+		unsigned int vertexCount = (unsigned int)data.vertices.size();
+		unsigned int indexCount = (unsigned int)data.indices.size();
+
+		const void* vertices = data.vertices.data();
+		if (data.vertexFormat == VertexFormat::Compact)
+		{
+			data.compactVertices.resize(vertexCount);
+			VertexCompression::Compress(data.vertices.data(), vertexCount, data.compactVertices.data());
+			vertices = data.compactVertices.data();
+		}
+		else if (data.vertexFormat == VertexFormat::Quantized)
+		{
+			data.quantizedVertices.resize(vertexCount);
+			VertexCompression::Compress(data.vertices.data(), vertexCount,
+				MeshBounds::GetMin(data.boundingBox), MeshBounds::GetMax(data.boundingBox), data.quantizedVertices.data());
+			vertices = data.quantizedVertices.data();
+		}
+
+		if (GetIndexStride(vertexCount) == sizeof(uint16_t))
+		{
+			data.shortIndices = NarrowIndices(data.indices.data(), indexCount);
+			SetUpload(data, vertices, vertexCount, data.shortIndices.data(), sizeof(uint16_t), indexCount);
+		}
+		else
+		{
+			SetUpload(data, vertices, vertexCount, data.indices.data(), sizeof(unsigned int), indexCount);
+		}
+
+		ImportReport::Measured measured = MeasureUpload(data, data.vertices.data());
+		ReportUpload(data, measured);
+		return measured;
+	}
+}
+
+MeshData MeshImporter::Import(const char* filePath, const MeshImportSettings& settings)
+{
+	auto start = std::chrono::steady_clock::now();
+	auto elapsedMilliseconds = [&]()
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		};
+
+	MeshData data;
+	data.vertexFormat = settings.vertexFormat;
+	data.report.name = filePath;
+
+	// Map the whole source file into memory (throws if it can't be opened)
+	MappedFile obj(filePath);
+
+	// If a cooked copy of this exact source exists, keep it mapped and
+	// upload its vertices and indices straight from the mapping. It was
+	// cooked in this vertex format (which is part of the import flags),
+	// so there is nothing left to convert.
+	uint64_t sourceHash = MeshCache::HashBytes(obj.GetData(), obj.GetSize());
+	data.report.sourceHash = sourceHash;
+	uint32_t importFlags = MeshCache::GetImportFlags(settings);
+	std::string cachePath = MeshCache::GetCachePath(filePath, importFlags);
+	{
+		std::unique_ptr<MeshCache::CookedMesh> cooked = std::make_unique<MeshCache::CookedMesh>();
+		if (cooked->Open(cachePath, sourceHash, importFlags))
+		{
+			const MeshCache::Header& header = cooked->GetHeader();
+			data.submeshes = cooked->GetSubmeshes();
+			data.lods = cooked->GetLods();
+			data.meshlets = cooked->GetMeshlets();
+			data.boundingBox = header.boundingBox;
+			data.boundingSphere = header.boundingSphere;
+			data.report.source = cooked->GetSource();
+			data.report.fromCache = true;
+			SetUpload(data, cooked->GetVertices(), header.vertexCount, cooked->GetIndices(), header.indexStride, header.indexCount);
+			ReportUpload(data, cooked->GetMeasured());
+			data.cooked = std::move(cooked);
+			data.report.importMilliseconds = elapsedMilliseconds();
+			return data;
+		}
+	}
+
+	// No valid cache, so do the full import
+	ImportObj(obj.GetData(), obj.GetEnd(), settings, data);
+	Process(data, settings);
+	ImportReport::Measured measured = PrepareForUpload(data);
+
+	// Save exactly what gets uploaded for next time (failing to is not an error)
+	MeshCache::Write(cachePath, sourceHash, importFlags,
+		data.vertexData, VertexCompression::GetStride(data.vertexFormat), data.vertexCount,
+		data.indexData, data.indexStride, data.indexCount,
+		data.submeshes, data.lods, data.meshlets, data.report.source, measured, data.boundingBox, data.boundingSphere);
+
+	data.report.importMilliseconds = elapsedMilliseconds();
+	return data;
+}
+
+MeshData MeshImporter::FromArrays(const Vertex* vertices, const unsigned int* indices, unsigned int vertexCount, unsigned int indexCount)
+{
+	MeshData data;
+	data.vertices.assign(vertices, vertices + vertexCount);
+	data.indices.assign(indices, indices + indexCount);
+	data.submeshes.push_back({ 0, indexCount, "", "" });
+	data.lods.push_back({ 0, indexCount, 0.0f });
+
+	data.tangentStats = TangentGenerator::Generate(data.vertices.data(), vertexCount, data.indices.data(), indexCount);
+	MeshBounds::Compute(data.vertices.data(), vertexCount, data.boundingBox, data.boundingSphere);
+	ReportArrays(data);
+	PrepareForUpload(data);
+	return data;
+}
+
+MeshData MeshImporter::FromGenerated(std::vector<Vertex> vertices, std::vector<unsigned int> indices, const MeshImportSettings& settings)
+{
+	MeshData data;
+	data.vertexFormat = settings.vertexFormat;
+	data.vertices = std::move(vertices);
+	data.indices = std::move(indices);
+	data.submeshes.push_back({ 0, (unsigned int)data.indices.size(), "", "" });
+
+	ReportArrays(data);
+	Process(data, settings);
+	PrepareForUpload(data);
+	return data;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include "Vertex.h"
+#include "CompactVertex.h"
+#include "Submesh.h"
+#include "MeshLod.h"
+#include "Meshlet.h"
+#include "MeshCache.h"
+#include "ObjParser.h"
+#include "MeshOptimizer.h"
+#include "TangentGenerator.h"
+#include "MeshImportSettings.h"
+#include "ImportReport.h"
+
+// Everything a Mesh needs, prepared without touching the graphics API so
+// it can happen on any thread. Only creating the buffers is left.
+struct MeshData
+{
+	MeshData() = default;
+	MeshData(MeshData&&) = default;
+	MeshData& operator=(MeshData&&) = default;
+	MeshData(const MeshData&) = delete;
+	MeshData& operator=(const MeshData&) = delete;
+
+	// Ready to upload as they are: vertices already in vertexFormat and
+	// indices already indexStride bytes each. They point into the storage
+	// below or into a mapped cache file, so they survive moves (but not copies).
+	const void* vertexData = nullptr;
+	const void* indexData = nullptr;
+	unsigned int vertexCount = 0;
+	unsigned int indexCount = 0;
+	unsigned int indexStride = sizeof(unsigned int);
+	VertexFormat vertexFormat = VertexFormat::Full;
+	DirectX::XMFLOAT4X4 dequantizeMatrix = {};
+
+	DirectX::BoundingBox boundingBox;
+	DirectX::BoundingSphere boundingSphere;
+	std::vector<Submesh> submeshes;
+	std::vector<MeshLod> lods;
+	std::vector<Meshlet> meshlets;
+
+	ObjParser::StreamStats streamStats = {};
+	MeshOptimizer::CacheStats vertexCacheStats = {};
+	MeshOptimizer::CacheStats originalVertexCacheStats = {};
+	TangentGenerator::Stats tangentStats = {};
+	ImportReport report;
+
+	// Whichever of these the pointers above use
+	std::vector<Vertex> vertices;
+	std::vector<CompactVertex> compactVertices;
+	std::vector<QuantizedVertex> quantizedVertices;
+	std::vector<unsigned int> indices;
+	std::vector<uint16_t> shortIndices;
+	std::unique_ptr<MeshCache::CookedMesh> cooked;
+};
+
+// The CPU half of loading a mesh: reading, processing and converting the
+// data into its GPU formats. Safe to call from any thread, as long as two
+// threads aren't importing the same file at once (they'd both write its
+// cache).
+namespace MeshImporter
+{
+	// Loads a mesh from its cooked cache if it's up to date, otherwise
+	// imports the .obj file and writes the cache for next time. Throws if
+	// the file can't be opened.
+	MeshData Import(const char* filePath, const MeshImportSettings& settings = MeshImportSettings());
+
+	// Wraps vertices and indices built in code (copied, so the originals
+	// are untouched) as a single submesh and level of detail, with
+	// tangents generated
+	MeshData FromArrays(const Vertex* vertices, const unsigned int* indices, unsigned int vertexCount, unsigned int indexCount);
+
+	// Takes over vertices and indices that already have tangents (like
+	// MeshGenerator's shapes) as a single submesh, then processes them the
+	// same way as an imported file: levels of detail, optimization,
+	// meshlets and vertex format. Nothing is cached.
+	MeshData FromGenerated(std::vector<Vertex> vertices, std::vector<unsigned int> indices, const MeshImportSettings& settings = MeshImportSettings());
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "MeshLoader.h"
+
+#include <algorithm>
+
+MeshLoader::MeshLoader(unsigned int threadCount)
+{
+	importing = 0;
+	stopping = false;
+
+	if (threadCount == 0)
+		threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+	workers.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; i++)
+		workers.emplace_back(&MeshLoader::RunWorker, this);
+}
+
+MeshLoader::~MeshLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		jobs.clear();
+	}
+	jobQueued.notify_all();
+
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+std::shared_ptr<Mesh> MeshLoader::Load(const std::string& filePath, const MeshImportSettings& settings)
+{
+	std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back({ mesh, filePath, settings });
+	}
+	jobQueued.notify_one();
+	return mesh;
+}
+
+unsigned int MeshLoader::FinalizeReady(unsigned int maxCount)
+{
+	unsigned int finalized = 0;
+	while (finalized < maxCount)
+	{
+		// Only hold the lock long enough to take one result, so the
+		// workers aren't kept waiting while buffers are created
+		Result result;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (results.empty())
+				break;
+			result = std::move(results.front());
+			results.pop_front();
+		}
+
+		if (result.error)
+			std::rethrow_exception(result.error);
+
+		result.mesh->Finalize(result.data);
+		finalized++;
+	}
+	return finalized;
+}
+
+void MeshLoader::FinalizeAll()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		jobFinished.wait(lock, [&]() { return jobs.empty() && importing == 0; });
+	}
+	FinalizeReady();
+}
+
+unsigned int MeshLoader::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return (unsigned int)(jobs.size() + results.size()) + importing;
+}
+
+unsigned int MeshLoader::GetThreadCount() const
+{
+	return (unsigned int)workers.size();
+}
+
+// --------------------------------------------------------
+// Takes jobs in the order they were queued until the loader
+// is destroyed. Imports run without the lock held, and any
+// exception is stored with the result so it can be rethrown
+// on the main thread.
+// --------------------------------------------------------
+void MeshLoader::RunWorker()
+{
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobQueued.wait(lock, [&]() { return stopping || !jobs.empty(); });
+			if (stopping)
+				return;
+
+			job = std::move(jobs.front());
+			jobs.pop_front();
+			importing++;
+		}
+
+		Result result;
+		result.mesh = std::move(job.mesh);
+		try
+		{
+			result.data = MeshImporter::Import(job.filePath.c_str(), job.settings);
+		}
+		catch (...)
+		{
+			result.error = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			results.push_back(std::move(result));
+			importing--;
+		}
+		jobFinished.notify_all();
+	}
+}
\ No newline at end of file
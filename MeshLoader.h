@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <climits>
+#include "Mesh.h"
+#include "MeshImporter.h"
+#include "MeshImportSettings.h"
+
+// Imports meshes on a pool of worker threads, handing out meshes that
+// become ready later instead of blocking until each one is loaded. The
+// CPU work (see MeshImporter) happens on the workers, and only creating
+// the buffers is left for the main thread, in FinalizeReady().
+class MeshLoader
+{
+public:
+	// A thread count of 0 leaves one hardware thread for the main thread
+	MeshLoader(unsigned int threadCount = 0);
+	// Waits for imports already running and drops any still queued
+	~MeshLoader();
+	MeshLoader(const MeshLoader&) = delete;
+	MeshLoader& operator=(const MeshLoader&) = delete;
+
+	// Queues an import and returns its mesh right away. The mesh isn't
+	// ready (see Mesh::IsReady()) until a later FinalizeReady() call
+	// after the import finishes. Loading a file that's still loading
+	// isn't supported, since both imports would write its cache.
+	std::shared_ptr<Mesh> Load(const std::string& filePath, const MeshImportSettings& settings = MeshImportSettings());
+
+	// Creates the buffers of up to maxCount meshes whose imports have
+	// finished, returning how many were finalized. Main thread only.
+	// Rethrows the exception of an import that failed (like a missing
+	// file), as the blocking Mesh constructor would have.
+	unsigned int FinalizeReady(unsigned int maxCount = UINT_MAX);
+
+	// Blocks until every queued import has finished, then finalizes them all
+	void FinalizeAll();
+
+	// Meshes queued, importing or waiting to be finalized
+	unsigned int GetPendingCount() const;
+	unsigned int GetThreadCount() const;
+
+private:
+	struct Job
+	{
+		std::shared_ptr<Mesh> mesh;
+		std::string filePath;
+		MeshImportSettings settings;
+	};
+
+	struct Result
+	{
+		std::shared_ptr<Mesh> mesh;
+		MeshData data;
+		std::exception_ptr error;
+	};
+
+	void RunWorker();
+
+	std::vector<std::thread> workers;
+
+	// Everything below is shared with the workers
+	mutable std::mutex mutex;
+	std::condition_variable jobQueued;
+	std::condition_variable jobFinished;
+	std::deque<Job> jobs;
+	std::deque<Result> results;
+	unsigned int importing;
+	bool stopping;
+};
\ No newline at end of file
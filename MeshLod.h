@@ -0,0 +1,11 @@
+#pragma once
+
+// A level of detail: a contiguous range of a mesh's index buffer that
+// draws a simplified copy of the whole mesh (every submesh, in order)
+// using the same vertex buffer as the full detail triangles
+struct MeshLod
+{
+	unsigned int indexStart;
+	unsigned int indexCount;
+	float error;	// Distance the surface moved, in the mesh's local units (0 for LOD 0)
+};
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "MeshOptimizer.h"
+
+#include <cstdint>
+#include <algorithm>
+
+namespace
+{
+	template<typename Index>
+	MeshOptimizer::CacheStats SimulateFifo(const Index* indices, size_t indexCount, unsigned int vertexCount, unsigned int cacheSize)
+	{
+		MeshOptimizer::CacheStats stats = {};
+		if (indexCount == 0 || vertexCount == 0)
+			return stats;
+
+		// A vertex is still in a FIFO cache if fewer than cacheSize other
+		// vertices have been added since it was, which a timestamp per vertex
+		// answers without modeling the queue itself
+		std::vector<unsigned int> cachedAt(vertexCount, 0);
+		std::vector<bool> used(vertexCount, false);
+		unsigned int timestamp = cacheSize + 1;
+		size_t misses = 0;
+		unsigned int usedCount = 0;
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			unsigned int v = indices[i];
+			if (timestamp - cachedAt[v] > cacheSize)
+			{
+				cachedAt[v] = timestamp++;
+				misses++;
+			}
+			if (!used[v])
+			{
+				used[v] = true;
+				usedCount++;
+			}
+		}
+
+		stats.acmr = (float)misses / (float)(indexCount / 3);
+		stats.atvr = (float)misses / (float)usedCount;
+		return stats;
+	}
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::SimulateVertexCache(const unsigned int* indices, size_t indexCount, unsigned int vertexCount, unsigned int cacheSize)
+{
+	return SimulateFifo(indices, indexCount, vertexCount, cacheSize);
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::SimulateVertexCache(const uint16_t* indices, size_t indexCount, unsigned int vertexCount, unsigned int cacheSize)
+{
+	return SimulateFifo(indices, indexCount, vertexCount, cacheSize);
+}
+
+// --------------------------------------------------------
+// Tipsify: triangles are emitted as fans around a "fanning"
+// vertex, and the next fanning vertex is picked from the
+// ones just emitted, preferring ones that will still be in
+// the cache once their remaining triangles are drawn.
+// When no candidate is left, it falls back to recently
+// used vertices (the dead-end stack) and then to a scan
+// through every vertex in order. Runs in linear time.
+// --------------------------------------------------------
+void MeshOptimizer::OptimizeVertexCache(unsigned int* indices, size_t indexCount, unsigned int vertexCount, unsigned int cacheSize)
+{
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	// Triangles using each vertex, stored back to back (offset + count)
+	std::vector<unsigned int> liveCount(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+		liveCount[indices[i]]++;
+
+	std::vector<unsigned int> adjacencyStart(vertexCount + 1, 0);
+	for (unsigned int v = 0; v < vertexCount; v++)
+		adjacencyStart[v + 1] = adjacencyStart[v] + liveCount[v];
+
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	{
+		std::vector<unsigned int> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+		for (size_t i = 0; i < triangleCount * 3; i++)
+			adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+	}
+
+	std::vector<unsigned int> cachedAt(vertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<unsigned int> deadEnds;
+	std::vector<unsigned int> candidates;
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+	unsigned int timestamp = cacheSize + 1;
+	unsigned int scanCursor = 0;
+
+	// Next vertex that still has triangles, once the candidates run out
+	auto skipDeadEnd = [&]() -> int
+	{
+		while (!deadEnds.empty())
+		{
+			unsigned int v = deadEnds.back();
+			deadEnds.pop_back();
+			if (liveCount[v] > 0)
+				return (int)v;
+		}
+		for (; scanCursor < vertexCount; scanCursor++)
+		{
+			if (liveCount[scanCursor] > 0)
+				return (int)scanCursor;
+		}
+		return -1;
+	};
+
+	int fanning = skipDeadEnd();
+	while (fanning >= 0)
+	{
+		// Emit every remaining triangle around the fanning vertex
+		candidates.clear();
+		for (unsigned int a = adjacencyStart[fanning]; a < adjacencyStart[fanning + 1]; a++)
+		{
+			unsigned int t = adjacency[a];
+			if (emitted[t])
+				continue;
+
+			for (unsigned int c = 0; c < 3; c++)
+			{
+				unsigned int v = indices[t * 3 + c];
+				output.push_back(v);
+				deadEnds.push_back(v);
+				candidates.push_back(v);
+				liveCount[v]--;
+				if (timestamp - cachedAt[v] > cacheSize)
+					cachedAt[v] = timestamp++;
+			}
+			emitted[t] = true;
+		}
+
+		// Choose the candidate that has been in the cache the longest,
+		// as long as it will still be there after its fan is emitted
+		int next = -1;
+		int bestPriority = -1;
+		for (unsigned int v : candidates)
+		{
+			if (liveCount[v] == 0)
+				continue;
+
+			int priority = 0;
+			if (timestamp - cachedAt[v] + 2 * liveCount[v] <= cacheSize)
+				priority = (int)(timestamp - cachedAt[v]);
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = (int)v;
+			}
+		}
+
+		fanning = next >= 0 ? next : skipDeadEnd();
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+unsigned int MeshOptimizer::OptimizeVertexFetch(Vertex* vertices, unsigned int vertexCount, unsigned int* indices, size_t indexCount)
+{
+	const unsigned int unassigned = UINT32_MAX;
+	std::vector<unsigned int> remap(vertexCount, unassigned);
+	std::vector<Vertex> reordered;
+	reordered.reserve(vertexCount);
+
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		unsigned int& newIndex = remap[indices[i]];
+		if (newIndex == unassigned)
+		{
+			newIndex = (unsigned int)reordered.size();
+			reordered.push_back(vertices[indices[i]]);
+		}
+		indices[i] = newIndex;
+	}
+
+	std::copy(reordered.begin(), reordered.end(), vertices);
+	return (unsigned int)reordered.size();
+}
+
+// --------------------------------------------------------
+// Runs the vertex cache pass on one submesh at a time,
+// renumbering the submesh's vertices to 0..n first so the
+// per-vertex tables only cover what the submesh uses
+// --------------------------------------------------------
+unsigned int MeshOptimizer::Optimize(Vertex* vertices, unsigned int vertexCount, unsigned int* indices, size_t indexCount, const std::vector<Submesh>& submeshes)
+{
+	const unsigned int unassigned = UINT32_MAX;
+	std::vector<unsigned int> localIndex(vertexCount, unassigned);
+	std::vector<unsigned int> globalIndex;
+
+	for (const Submesh& submesh : submeshes)
+	{
+		unsigned int* range = indices + submesh.indexStart;
+
+		globalIndex.clear();
+		for (unsigned int i = 0; i < submesh.indexCount; i++)
+		{
+			unsigned int& local = localIndex[range[i]];
+			if (local == unassigned)
+			{
+				local = (unsigned int)globalIndex.size();
+				globalIndex.push_back(range[i]);
+			}
+			range[i] = local;
+		}
+
+		OptimizeVertexCache(range, submesh.indexCount, (unsigned int)globalIndex.size());
+
+		// Back to mesh-wide indices, leaving the lookup clear for the next submesh
+		for (unsigned int i = 0; i < submesh.indexCount; i++)
+			range[i] = globalIndex[range[i]];
+		for (unsigned int v : globalIndex)
+			localIndex[v] = unassigned;
+	}
+
+	return OptimizeVertexFetch(vertices, vertexCount, indices, indexCount);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Vertex.h"
+#include "Submesh.h"
+
+// Reorders mesh data so the GPU does less repeated work while drawing it.
+// Only the order changes: the triangles drawn are exactly the same.
+namespace MeshOptimizer
+{
+	// Size of the post-transform vertex cache that is optimized for and
+	// simulated. Small on purpose, since an order that works for a small
+	// cache also works for a bigger one.
+	const unsigned int DefaultCacheSize = 16;
+
+	// How well an index order reuses already transformed vertices
+	struct CacheStats
+	{
+		float acmr;	// Average cache miss ratio: transformed vertices per triangle (0.5 - 3)
+		float atvr;	// Average transform to vertex ratio: transformed vertices per used vertex (1+)
+	};
+
+	// Runs the indices through a simulated FIFO vertex cache
+	CacheStats SimulateVertexCache(const unsigned int* indices, size_t indexCount, unsigned int vertexCount, unsigned int cacheSize = DefaultCacheSize);
+	CacheStats SimulateVertexCache(const uint16_t* indices, size_t indexCount, unsigned int vertexCount, unsigned int cacheSize = DefaultCacheSize);
+
+	// Reorders the triangles within a range of indices for vertex cache
+	// locality (Tipsify, from "Fast Triangle Reordering for Vertex Locality
+	// and Reduced Overdraw", Sander et al. 2007)
+	void OptimizeVertexCache(unsigned int* indices, size_t indexCount, unsigned int vertexCount, unsigned int cacheSize = DefaultCacheSize);
+
+	// Renumbers vertices in the order the indices first use them, so they
+	// are fetched from memory mostly front to back. Vertices that aren't
+	// referenced are dropped, and the new vertex count is returned.
+	unsigned int OptimizeVertexFetch(Vertex* vertices, unsigned int vertexCount, unsigned int* indices, size_t indexCount);
+
+	// Both passes above: the vertex cache pass runs on every submesh on
+	// its own (so ranges stay intact) and then vertices are reordered for
+	// the whole mesh. Returns the new vertex count.
+	unsigned int Optimize(Vertex* vertices, unsigned int vertexCount, unsigned int* indices, size_t indexCount, const std::vector<Submesh>& submeshes);
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "MeshRegistry.h"
+#include "MeshCache.h"
+
+#include <filesystem>
+#include <algorithm>
+
+MeshRegistry::MeshRegistry(MeshLoader& loader, size_t memoryBudget)
+	: loader(loader)
+{
+	this->memoryBudget = memoryBudget;
+	frame = 0;
+	sharedRequests = 0;
+	duplicates = 0;
+	evictions = 0;
+	nextId = 0;
+}
+
+// Different spellings of the same file (relative, "..", links) all
+// resolve to one path, even if part of it doesn't exist yet
+std::string MeshRegistry::GetPathKey(const std::string& filePath, uint32_t importFlags)
+{
+	std::error_code error;
+	std::filesystem::path canonical = std::filesystem::weakly_canonical(filePath, error);
+	if (error)
+		canonical = std::filesystem::absolute(filePath, error).lexically_normal();
+	return canonical.string() + "|" + std::to_string(importFlags);
+}
+
+std::shared_ptr<Mesh> MeshRegistry::Get(const std::string& filePath, const MeshImportSettings& settings)
+{
+	uint32_t importFlags = MeshCache::GetImportFlags(settings);
+	std::string pathKey = GetPathKey(filePath, importFlags);
+
+	// Seen this file before
+	auto path = paths.find(pathKey);
+	if (path != paths.end())
+	{
+		Entry& entry = entries.at(path->second);
+		entry.lastUsed = frame;
+		sharedRequests++;
+		return entry.mesh;
+	}
+
+	// A new path. Whether its contents match a mesh that's already here
+	// is only known once the import has hashed the file, see Update().
+	uint64_t id = nextId++;
+	Entry& entry = entries[id];
+	entry.mesh = loader.Load(filePath, settings);
+	entry.pathKeys.push_back(pathKey);
+	entry.lastUsed = frame;
+	entry.importFlags = importFlags;
+	entry.hashed = false;
+	paths[pathKey] = id;
+	return entry.mesh;
+}
+
+void MeshRegistry::MergeInto(uint64_t original, Entry& duplicate)
+{
+	Entry& target = entries.at(original);
+	for (std::string& pathKey : duplicate.pathKeys)
+	{
+		paths[pathKey] = original;
+		target.pathKeys.push_back(std::move(pathKey));
+	}
+	duplicate.pathKeys.clear();
+	target.lastUsed = std::max(target.lastUsed, duplicate.lastUsed);
+	duplicates++;
+}
+
+// --------------------------------------------------------
+// Anything referenced outside the registry (or still held by
+// the loader) has a use count above 1. Those are marked as
+// used this frame, so an unreferenced mesh's last use is the
+// last frame something still held it.
+// --------------------------------------------------------
+void MeshRegistry::Update()
+{
+	frame++;
+
+	// Imports that finished since the last update now know what they
+	// contain. The first mesh with a given content stays the one handed
+	// out; later ones only live on while something still holds them.
+	for (auto& [id, entry] : entries)
+	{
+		if (entry.hashed || !entry.mesh->IsReady())
+			continue;
+
+		entry.hashed = true;
+		ContentKey contentKey(entry.mesh->GetImportReport().sourceHash, entry.importFlags);
+		auto [content, added] = contents.emplace(contentKey, id);
+		if (!added)
+			MergeInto(content->second, entry);
+	}
+
+	size_t totalBytes = 0;
+	std::vector<std::map<uint64_t, Entry>::iterator> candidates;
+	for (auto i = entries.begin(); i != entries.end();)
+	{
+		Entry& entry = i->second;
+		if (entry.mesh.use_count() > 1)
+		{
+			entry.lastUsed = frame;
+		}
+		else if (entry.pathKeys.empty())
+		{
+			// A duplicate nobody holds anymore can never be handed out again
+			i = entries.erase(i);
+			continue;
+		}
+		else
+		{
+			candidates.push_back(i);
+		}
+		totalBytes += entry.mesh->GetCpuBytes() + entry.mesh->GetGpuBytes();
+		i++;
+	}
+	if (totalBytes <= memoryBudget)
+		return;
+
+	std::sort(candidates.begin(), candidates.end(),
+		[](const auto& a, const auto& b) { return a->second.lastUsed < b->second.lastUsed; });
+	for (auto& candidate : candidates)
+	{
+		if (totalBytes <= memoryBudget)
+			break;
+
+		Entry& entry = candidate->second;
+		totalBytes -= entry.mesh->GetCpuBytes() + entry.mesh->GetGpuBytes();
+		for (const std::string& pathKey : entry.pathKeys)
+			paths.erase(pathKey);
+		if (entry.hashed)
+			contents.erase(ContentKey(entry.mesh->GetImportReport().sourceHash, entry.importFlags));
+		entries.erase(candidate);
+		evictions++;
+	}
+}
+
+void MeshRegistry::SetMemoryBudget(size_t bytes)
+{
+	memoryBudget = bytes;
+}
+
+size_t MeshRegistry::GetMemoryBudget() const
+{
+	return memoryBudget;
+}
+
+MeshRegistry::Stats MeshRegistry::GetStats() const
+{
+	Stats stats = {};
+	stats.sharedRequests = sharedRequests;
+	stats.duplicates = duplicates;
+	stats.evictions = evictions;
+	for (const auto& [key, entry] : entries)
+	{
+		stats.meshes++;
+		stats.loading += entry.mesh->IsReady() ? 0 : 1;
+		stats.unreferenced += entry.mesh.use_count() > 1 ? 0 : 1;
+		stats.cpuBytes += entry.mesh->GetCpuBytes();
+		stats.gpuBytes += entry.mesh->GetGpuBytes();
+	}
+	return stats;
+}
\ No newline at end of file
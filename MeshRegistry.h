@@ -0,0 +1,93 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <unordered_map>
+#include "Mesh.h"
+#include "MeshLoader.h"
+#include "MeshImportSettings.h"
+
+// Hands out shared meshes, so every request for the same file (by
+// any path) gets the same mesh, imported once. Files with the same
+// contents are recognized once the import has hashed them, after which
+// requests for either get the same mesh too. Meshes nothing else
+// references stay resident for reuse until the total memory goes over
+// budget, then the least recently used of them are released.
+class MeshRegistry
+{
+public:
+	// 256MB of CPU and GPU memory together
+	static const size_t DefaultMemoryBudget = 256ull * 1024 * 1024;
+
+	struct Stats
+	{
+		unsigned int meshes;			// Resident or loading
+		unsigned int loading;
+		unsigned int unreferenced;		// Only kept alive by the registry
+		size_t cpuBytes;
+		size_t gpuBytes;
+		unsigned int sharedRequests;	// Get() calls answered by an existing mesh
+		unsigned int duplicates;		// Paths found to have the same contents as an earlier one
+		unsigned int evictions;
+	};
+
+	// Loads through the given loader, which must outlive the registry
+	MeshRegistry(MeshLoader& loader, size_t memoryBudget = DefaultMemoryBudget);
+	MeshRegistry(const MeshRegistry&) = delete;
+	MeshRegistry& operator=(const MeshRegistry&) = delete;
+
+	// Returns the mesh for a file with these import settings, queueing an
+	// import if this path hasn't been requested yet. The file isn't touched
+	// here: the import hashes it on a loader thread, and a missing file is
+	// reported by MeshLoader::FinalizeReady().
+	std::shared_ptr<Mesh> Get(const std::string& filePath, const MeshImportSettings& settings = MeshImportSettings());
+
+	// Points the paths of finished imports whose contents match an earlier
+	// mesh at that mesh (the duplicate is dropped once nothing references
+	// it), marks every referenced mesh as used this frame, then releases
+	// unreferenced meshes, least recently used first, until the total is
+	// back under budget. Call once per frame, after finalizing meshes.
+	void Update();
+
+	void SetMemoryBudget(size_t bytes);
+	size_t GetMemoryBudget() const;
+	Stats GetStats() const;
+
+private:
+	// Contents hash and import flags (which include the vertex format),
+	// which between them decide what the mesh ends up as
+	using ContentKey = std::pair<uint64_t, uint32_t>;
+
+	struct Entry
+	{
+		std::shared_ptr<Mesh> mesh;
+		std::vector<std::string> pathKeys;	// Every path that leads to it (none once it's a duplicate)
+		uint64_t lastUsed;					// Frame it was last referenced
+		uint32_t importFlags;
+		bool hashed;						// Import finished and its contents are in the content map
+	};
+
+	// Moves the paths of a mesh that turned out to be a copy of another
+	// over to the original
+	void MergeInto(uint64_t original, Entry& duplicate);
+
+	// Canonical path and packed settings, as a single map key
+	static std::string GetPathKey(const std::string& filePath, uint32_t importFlags);
+
+	MeshLoader& loader;
+	size_t memoryBudget;
+	uint64_t frame;
+	unsigned int sharedRequests;
+	unsigned int duplicates;
+	unsigned int evictions;
+
+	// Entries by the order they were created in, and the ways to find them
+	uint64_t nextId;
+	std::map<uint64_t, Entry> entries;
+	std::unordered_map<std::string, uint64_t> paths;
+	std::map<ContentKey, uint64_t> contents;
+};
\ No newline at end of file
@@ -0,0 +1,481 @@
+#include "MeshSimplifier.h"
+#include "MeshBounds.h"
+
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+namespace
+{
+	// Symmetric 4x4 matrix summing squared distances to a set of planes,
+	// weighted by the area of the triangle each plane came from. Doubles,
+	// since the sums cancel heavily when evaluated near the planes.
+	struct Quadric
+	{
+		double a2, ab, ac, ad;
+		double b2, bc, bd;
+		double c2, cd;
+		double d2;
+		double weight;
+
+		void Add(const Quadric& other)
+		{
+			a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+			b2 += other.b2; bc += other.bc; bd += other.bd;
+			c2 += other.c2; cd += other.cd;
+			d2 += other.d2;
+			weight += other.weight;
+		}
+
+		// Weighted sum of squared distances from a point to every plane
+		double Evaluate(const XMFLOAT3& p) const
+		{
+			double x = p.x, y = p.y, z = p.z;
+			double result =
+				a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x +
+				b2 * y * y + 2 * bc * y * z + 2 * bd * y +
+				c2 * z * z + 2 * cd * z +
+				d2;
+			return std::max(result, 0.0);
+		}
+	};
+
+	Quadric PlaneQuadric(double a, double b, double c, double d, double weight)
+	{
+		return Quadric{
+			weight * a * a, weight * a * b, weight * a * c, weight * a * d,
+			weight * b * b, weight * b * c, weight * b * d,
+			weight * c * c, weight * c * d,
+			weight * d * d,
+			weight };
+	}
+
+	// Root mean squared distance the surface moves, given the combined
+	// quadric of both ends of an edge
+	float CollapseError(const Quadric& quadric, const XMFLOAT3& position)
+	{
+		if (quadric.weight <= 0.0)
+			return 0.0f;
+		return (float)std::sqrt(quadric.Evaluate(position) / quadric.weight);
+	}
+
+	// Vertices sharing an exact position (uv or normal seams, after
+	// welding) form a group, linked in a circle through next. Each group
+	// is identified by its lowest vertex index.
+	struct PositionGroups
+	{
+		std::vector<unsigned int> group;
+		std::vector<unsigned int> next;
+	};
+
+	PositionGroups FindPositionGroups(const XMFLOAT3* positions, unsigned int vertexCount)
+	{
+		auto less = [&](unsigned int a, unsigned int b)
+		{
+			const XMFLOAT3& p = positions[a];
+			const XMFLOAT3& q = positions[b];
+			if (p.x != q.x) return p.x < q.x;
+			if (p.y != q.y) return p.y < q.y;
+			if (p.z != q.z) return p.z < q.z;
+			return a < b;
+		};
+
+		std::vector<unsigned int> order(vertexCount);
+		for (unsigned int i = 0; i < vertexCount; i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), less);
+
+		PositionGroups groups;
+		groups.group.resize(vertexCount);
+		groups.next.resize(vertexCount);
+		for (unsigned int i = 0; i < vertexCount; )
+		{
+			const XMFLOAT3& first = positions[order[i]];
+			unsigned int end = i + 1;
+			while (end < vertexCount && memcmp(&positions[order[end]], &first, sizeof(XMFLOAT3)) == 0)
+				end++;
+			for (unsigned int j = i; j < end; j++)
+			{
+				groups.group[order[j]] = order[i];
+				groups.next[order[j]] = order[j + 1 < end ? j + 1 : i];
+			}
+			i = end;
+		}
+		return groups;
+	}
+
+	// --------------------------------------------------------
+	// One range of triangles with its vertices renumbered to
+	// 0..n in the order they're first used (like
+	// MeshOptimizer::Optimize does per submesh), so every
+	// per-vertex table only covers what the range uses instead
+	// of the whole mesh. Position groups only link vertices of
+	// the range, since nothing else can move with them anyway.
+	// --------------------------------------------------------
+	struct Range
+	{
+		std::vector<unsigned int> indices;		// Local, whole triangles only
+		std::vector<unsigned int> globalIndex;	// Mesh-wide index of each local vertex
+		std::vector<XMFLOAT3> positions;		// Of each local vertex
+		PositionGroups groups;
+	};
+
+	const unsigned int unassigned = UINT32_MAX;
+
+	// The lookup must be all unassigned, and is left that way
+	Range MakeRange(const Vertex* vertices, const unsigned int* indices, size_t indexCount, std::vector<unsigned int>& localIndex)
+	{
+		Range range;
+		range.indices.resize(indexCount - indexCount % 3);
+		for (size_t i = 0; i < range.indices.size(); i++)
+		{
+			unsigned int& local = localIndex[indices[i]];
+			if (local == unassigned)
+			{
+				local = (unsigned int)range.globalIndex.size();
+				range.globalIndex.push_back(indices[i]);
+				range.positions.push_back(vertices[indices[i]].Position);
+			}
+			range.indices[i] = local;
+		}
+
+		for (unsigned int v : range.globalIndex)
+			localIndex[v] = unassigned;
+		range.groups = FindPositionGroups(range.positions.data(), (unsigned int)range.positions.size());
+		return range;
+	}
+
+	// A possible collapse of one vertex onto the other end of an edge
+	struct Collapse
+	{
+		unsigned int from;
+		unsigned int to;
+		float error;
+	};
+
+	// Working memory for SimplifyRange, kept between ranges and levels so
+	// building a whole chain only allocates for the largest range
+	struct Scratch
+	{
+		std::vector<unsigned int> current;
+		std::vector<Quadric> quadrics;
+		std::vector<bool> locked;
+		std::vector<std::pair<unsigned int, unsigned int>> edges;
+		std::vector<unsigned int> remap;
+		std::vector<bool> touched;
+		std::vector<unsigned int> adjacencyStart;
+		std::vector<unsigned int> adjacency;
+		std::vector<unsigned int> fill;
+		std::vector<Collapse> collapses;
+		std::vector<std::pair<unsigned int, unsigned int>> moves;
+	};
+
+	XMVECTOR XM_CALLCONV TriangleNormal(FXMVECTOR a, FXMVECTOR b, FXMVECTOR c)
+	{
+		return XMVector3Cross(XMVectorSubtract(b, a), XMVectorSubtract(c, a));
+	}
+
+	// --------------------------------------------------------
+	// Works in passes. Each pass finds every allowed collapse,
+	// sorts them by error and makes as many as it can, cheapest
+	// first, as long as no two of them touch the same triangles
+	// (so every check within a pass sees up to date geometry).
+	// Indices are then rewritten and collapsed triangles removed
+	// before the next pass.
+	//
+	// Collapses move whole position groups, so seams stay closed:
+	// every vertex of the moving group goes to the vertex of the
+	// target group it shares a triangle with. If one of them has
+	// no such neighbor (the collapse would cross a seam rather
+	// than run along it) the collapse isn't allowed.
+	// --------------------------------------------------------
+	float SimplifyRange(
+		const Range& range,
+		size_t targetIndexCount,
+		float maxError,
+		Scratch& scratch,
+		std::vector<unsigned int>& output)
+	{
+		unsigned int vertexCount = (unsigned int)range.positions.size();
+		const XMFLOAT3* positions = range.positions.data();
+		const PositionGroups& groups = range.groups;
+		const std::vector<unsigned int>& group = groups.group;
+		std::vector<unsigned int>& current = scratch.current;
+		current.assign(range.indices.begin(), range.indices.end());
+
+		// Every position starts with the planes of the triangles around it
+		std::vector<Quadric>& quadrics = scratch.quadrics;
+		quadrics.assign(vertexCount, Quadric{});
+		for (size_t i = 0; i < current.size(); i += 3)
+		{
+			XMVECTOR p0 = XMLoadFloat3(&positions[current[i]]);
+			XMVECTOR p1 = XMLoadFloat3(&positions[current[i + 1]]);
+			XMVECTOR p2 = XMLoadFloat3(&positions[current[i + 2]]);
+			XMVECTOR normal = TriangleNormal(p0, p1, p2);
+			float length = XMVectorGetX(XMVector3Length(normal));
+			if (length <= 0.0f)
+				continue;
+
+			XMFLOAT3 n;
+			XMStoreFloat3(&n, XMVectorScale(normal, 1.0f / length));
+			double d = -XMVectorGetX(XMVector3Dot(XMLoadFloat3(&n), p0));
+			Quadric plane = PlaneQuadric(n.x, n.y, n.z, d, length * 0.5);
+			for (int c = 0; c < 3; c++)
+				quadrics[group[current[i + c]]].Add(plane);
+		}
+
+		// Open edges (between positions) only appear in one direction. Their
+		// ends are locked, so the outline of the range never changes.
+		std::vector<bool>& locked = scratch.locked;
+		locked.assign(vertexCount, false);
+		{
+			std::vector<std::pair<unsigned int, unsigned int>>& edges = scratch.edges;
+			edges.clear();
+			for (size_t i = 0; i < current.size(); i += 3)
+				for (int c = 0; c < 3; c++)
+					edges.push_back({ group[current[i + c]], group[current[i + (c + 1) % 3]] });
+			std::sort(edges.begin(), edges.end());
+			for (const std::pair<unsigned int, unsigned int>& edge : edges)
+			{
+				if (!std::binary_search(edges.begin(), edges.end(), std::make_pair(edge.second, edge.first)))
+				{
+					locked[edge.first] = true;
+					locked[edge.second] = true;
+				}
+			}
+		}
+
+		std::vector<unsigned int>& remap = scratch.remap;
+		std::vector<bool>& touched = scratch.touched;
+		std::vector<unsigned int>& adjacencyStart = scratch.adjacencyStart;
+		std::vector<unsigned int>& adjacency = scratch.adjacency;
+		std::vector<Collapse>& collapses = scratch.collapses;
+		std::vector<std::pair<unsigned int, unsigned int>>& moves = scratch.moves;
+		remap.resize(vertexCount);
+		touched.resize(vertexCount);
+		adjacencyStart.resize((size_t)vertexCount + 1);
+		float largestError = 0.0f;
+
+		while (current.size() > targetIndexCount)
+		{
+			// Triangles around every vertex, to check collapses against
+			std::fill(adjacencyStart.begin(), adjacencyStart.end(), 0);
+			for (unsigned int index : current)
+				adjacencyStart[index + 1]++;
+			for (unsigned int i = 0; i < vertexCount; i++)
+				adjacencyStart[i + 1] += adjacencyStart[i];
+			adjacency.resize(current.size());
+			{
+				std::vector<unsigned int>& fill = scratch.fill;
+				fill.assign(adjacencyStart.begin(), adjacencyStart.end() - 1);
+				for (size_t i = 0; i < current.size(); i++)
+					adjacency[fill[current[i]]++] = (unsigned int)(i / 3);
+			}
+
+			// Every directed edge is one possible collapse (an interior edge
+			// shows up once in each direction, from its two triangles)
+			collapses.clear();
+			for (size_t i = 0; i < current.size(); i += 3)
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					unsigned int from = group[current[i + c]];
+					unsigned int to = group[current[i + (c + 1) % 3]];
+					if (locked[from] || from == to)
+						continue;
+
+					Quadric combined = quadrics[from];
+					combined.Add(quadrics[to]);
+					collapses.push_back({ from, to, CollapseError(combined, positions[to]) });
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(),
+				[](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+			// Each collapse removes about two triangles, so don't make more
+			// than it takes to reach the target this pass
+			size_t collapseBudget = (current.size() - targetIndexCount) / 6 + 1;
+			size_t collapsed = 0;
+			for (unsigned int i = 0; i < vertexCount; i++)
+				remap[i] = i;
+			std::fill(touched.begin(), touched.end(), false);
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.error > maxError || collapsed >= collapseBudget)
+					break;
+				if (touched[collapse.from] || touched[collapse.to])
+					continue;
+
+				// Pair every vertex at the moving position with a neighbor at
+				// the target, and make sure no remaining triangle around them
+				// would flip over or shrink to nothing
+				XMVECTOR target = XMLoadFloat3(&positions[collapse.to]);
+				bool valid = true;
+				moves.clear();
+				unsigned int variant = collapse.from;
+				do
+				{
+					unsigned int partner = vertexCount;
+					for (unsigned int a = adjacencyStart[variant]; a < adjacencyStart[variant + 1] && valid; a++)
+					{
+						const unsigned int* triangle = &current[(size_t)adjacency[a] * 3];
+						bool collapsing = false;
+						for (int c = 0; c < 3; c++)
+						{
+							if (group[triangle[c]] == collapse.to)
+							{
+								collapsing = true;
+								if (partner == vertexCount)
+									partner = triangle[c];
+							}
+						}
+						if (collapsing)
+							continue;
+
+						XMVECTOR before[3], after[3];
+						for (int c = 0; c < 3; c++)
+						{
+							before[c] = XMLoadFloat3(&positions[triangle[c]]);
+							after[c] = group[triangle[c]] == collapse.from ? target : before[c];
+						}
+						XMVECTOR oldNormal = TriangleNormal(before[0], before[1], before[2]);
+						XMVECTOR newNormal = TriangleNormal(after[0], after[1], after[2]);
+						float alignment = XMVectorGetX(XMVector3Dot(oldNormal, newNormal));
+						float scale = XMVectorGetX(XMVector3Length(oldNormal)) * XMVectorGetX(XMVector3Length(newNormal));
+						valid = alignment > 0.25f * scale && scale > 0.0f;
+					}
+
+					// Vertices earlier passes collapsed away don't need a partner
+					if (adjacencyStart[variant] != adjacencyStart[variant + 1])
+					{
+						valid = valid && partner != vertexCount;
+						moves.push_back({ variant, partner });
+					}
+					variant = groups.next[variant];
+				} while (variant != collapse.from && valid);
+				if (!valid)
+					continue;
+
+				// Nothing sharing a triangle with either position changes again this pass
+				for (unsigned int end : { collapse.from, collapse.to })
+				{
+					variant = end;
+					do
+					{
+						for (unsigned int a = adjacencyStart[variant]; a < adjacencyStart[variant + 1]; a++)
+						{
+							const unsigned int* triangle = &current[(size_t)adjacency[a] * 3];
+							for (int c = 0; c < 3; c++)
+								touched[group[triangle[c]]] = true;
+						}
+						variant = groups.next[variant];
+					} while (variant != end);
+				}
+
+				for (const std::pair<unsigned int, unsigned int>& move : moves)
+					remap[move.first] = move.second;
+				quadrics[collapse.to].Add(quadrics[collapse.from]);
+				largestError = std::max(largestError, collapse.error);
+				collapsed++;
+			}
+
+			if (collapsed == 0)
+				break;
+
+			// Triangles that lost a corner to a collapse are dropped
+			size_t write = 0;
+			for (size_t i = 0; i < current.size(); i += 3)
+			{
+				unsigned int a = remap[current[i]];
+				unsigned int b = remap[current[i + 1]];
+				unsigned int c = remap[current[i + 2]];
+				if (group[a] == group[b] || group[b] == group[c] || group[a] == group[c])
+					continue;
+				current[write++] = a;
+				current[write++] = b;
+				current[write++] = c;
+			}
+			current.resize(write);
+		}
+
+		// Back to mesh-wide indices
+		for (unsigned int index : current)
+			output.push_back(range.globalIndex[index]);
+		return largestError;
+	}
+}
+
+float MeshSimplifier::Simplify(
+	const Vertex* vertices,
+	unsigned int vertexCount,
+	const unsigned int* indices,
+	size_t indexCount,
+	size_t targetIndexCount,
+	float maxError,
+	std::vector<unsigned int>& output)
+{
+	output.clear();
+	std::vector<unsigned int> localIndex(vertexCount, unassigned);
+	Scratch scratch;
+	return SimplifyRange(MakeRange(vertices, indices, indexCount, localIndex), targetIndexCount, maxError, scratch, output);
+}
+
+std::vector<MeshLod> MeshSimplifier::BuildLods(
+	const Vertex* vertices,
+	unsigned int vertexCount,
+	std::vector<unsigned int>& indices,
+	const std::vector<Submesh>& submeshes,
+	unsigned int maxLodCount,
+	float reduction,
+	float maxRelativeError)
+{
+	std::vector<MeshLod> lods;
+	lods.push_back({ 0, (unsigned int)indices.size(), 0.0f });
+
+	BoundingBox box;
+	BoundingSphere sphere;
+	MeshBounds::Compute(vertices, vertexCount, box, sphere);
+	float maxError = sphere.Radius * maxRelativeError;
+
+	// Every level starts again from the same full detail submeshes
+	std::vector<Range> ranges;
+	ranges.reserve(submeshes.size());
+	{
+		std::vector<unsigned int> localIndex(vertexCount, unassigned);
+		for (const Submesh& submesh : submeshes)
+			ranges.push_back(MakeRange(vertices, indices.data() + submesh.indexStart, submesh.indexCount, localIndex));
+	}
+
+	Scratch scratch;
+	std::vector<unsigned int> lodIndices;
+	float target = 1.0f;
+	for (unsigned int level = 1; level <= maxLodCount; level++)
+	{
+		target *= reduction;
+		lodIndices.clear();
+
+		float error = 0.0f;
+		for (size_t i = 0; i < submeshes.size(); i++)
+		{
+			size_t targetIndexCount = (size_t)(submeshes[i].indexCount * target) / 3 * 3;
+			error = std::max(error, SimplifyRange(ranges[i], targetIndexCount, maxError, scratch, lodIndices));
+		}
+
+		// Not worth another level unless it removes a good share of the
+		// previous one's triangles (seams, borders or the error limit can
+		// stop simplification well short of the target)
+		const MeshLod& previous = lods.back();
+		if (lodIndices.empty() || lodIndices.size() > previous.indexCount * 0.8f)
+			break;
+
+		lods.push_back({ (unsigned int)indices.size(), (unsigned int)lodIndices.size(), error });
+		indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+	}
+
+	return lods;
+}
\ No newline at end of file
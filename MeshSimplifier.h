@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include "Vertex.h"
+#include "Submesh.h"
+#include "MeshLod.h"
+
+// Reduces triangle counts by collapsing edges, cheapest first, using
+// quadric error metrics ("Surface Simplification Using Quadric Error
+// Metrics", Garland and Heckbert 1997)
+namespace MeshSimplifier
+{
+	// Each level aims for this fraction of the previous level's triangles
+	const float DefaultLodReduction = 0.5f;
+	// Levels after the full detail one, at most
+	const unsigned int DefaultMaxLodCount = 4;
+	// Largest error allowed in any level, as a fraction of the mesh's
+	// bounding sphere radius (levels stop early once they'd need more)
+	const float DefaultMaxRelativeError = 0.1f;
+
+	// Collapses edges until there are at most targetIndexCount indices left
+	// or the next collapse would move the surface by more than maxError.
+	// Vertices only ever collapse onto other existing vertices, so the
+	// result still indexes the same vertex buffer. Vertices on open edges
+	// (including where a range meets the rest of the mesh) never move, and
+	// vertices sharing a position (uv or normal seams) only move together,
+	// so borders and seams stay closed. Returns the largest error of any
+	// collapse that was made (0 if none were).
+	float Simplify(
+		const Vertex* vertices,
+		unsigned int vertexCount,
+		const unsigned int* indices,
+		size_t indexCount,
+		size_t targetIndexCount,
+		float maxError,
+		std::vector<unsigned int>& output);
+
+	// Builds a chain of levels of detail and appends their indices to the
+	// end of the given indices. Every level is simplified from the full
+	// detail triangles (so errors don't accumulate), one submesh at a time
+	// so triangles never cross between materials. The chain stops early when
+	// a level wouldn't remove enough triangles to be worth drawing. Always
+	// returns at least one level: the full detail triangles themselves.
+	std::vector<MeshLod> BuildLods(
+		const Vertex* vertices,
+		unsigned int vertexCount,
+		std::vector<unsigned int>& indices,
+		const std::vector<Submesh>& submeshes,
+		unsigned int maxLodCount = DefaultMaxLodCount,
+		float reduction = DefaultLodReduction,
+		float maxRelativeError = DefaultMaxRelativeError);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include "Vertex.h"
+
+// Receives the output of a streaming mesh import as it is produced,
+// so the caller decides where (and how compactly) the data is stored
+class MeshSink
+{
+public:
+	virtual ~MeshSink() {}
+
+	// Called once for every new unique vertex, in index order
+	virtual void AddVertex(const Vertex& vertex) = 0;
+	// Called three times per triangle
+	virtual void AddIndex(unsigned int index) = 0;
+
+	// Bytes currently held by the sink, used for memory reporting
+	virtual size_t GetMemoryUsage() const = 0;
+
+	// Hint for roughly how much is coming (counts may end up higher)
+	virtual void Reserve(size_t /*vertexCount*/, size_t /*indexCount*/) {}
+};
+
+// Simplest sink, which collects everything into two vectors
+class VectorMeshSink : public MeshSink
+{
+public:
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+
+	void AddVertex(const Vertex& vertex) override
+	{
+		vertices.push_back(vertex);
+	}
+
+	void AddIndex(unsigned int index) override
+	{
+		indices.push_back(index);
+	}
+
+	void Reserve(size_t vertexCount, size_t indexCount) override
+	{
+		vertices.reserve(vertexCount);
+		indices.reserve(indexCount);
+	}
+
+	size_t GetMemoryUsage() const override
+	{
+		return vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(unsigned int);
+	}
+};
\ No newline at end of file
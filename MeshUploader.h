@@ -0,0 +1,17 @@
+#pragma once
+
+#include "MeshImporter.h"
+
+// The last step of loading a mesh: handing its final vertices and indices
+// (already in their GPU formats, see MeshData) to whatever they'll be
+// drawn from. Everything before this step is plain C++ with no graphics
+// API, so it can be built and run anywhere.
+class MeshUploader
+{
+public:
+	virtual ~MeshUploader() {}
+
+	// Called on the thread that owns the backend, once per mesh. Returns
+	// false if the backend couldn't store the data.
+	virtual bool Upload(const MeshData& data) = 0;
+};
\ No newline at end of file
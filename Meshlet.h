@@ -0,0 +1,28 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+// A small cluster of neighboring triangles (see MeshletBuilder): a
+// contiguous range of a mesh's full detail indices, with the bounds
+// needed to skip the whole range when none of it can be seen
+struct Meshlet
+{
+	unsigned int indexStart;
+	unsigned int indexCount;
+	DirectX::BoundingSphere bounds;		// Around the cluster's positions, in the mesh's local space
+
+	// Every triangle's normal lies in a cone around this axis. The whole
+	// cluster faces away from a viewer at p when
+	// dot(center - p, coneAxis) >= coneCutoff * length(center - p) + radius
+	// (a cutoff of 1 means it never can be sure of that)
+	DirectX::XMFLOAT3 coneAxis;
+	float coneCutoff;
+};
+
+// A run of consecutive indices to draw in one call
+struct IndexRange
+{
+	unsigned int indexStart;
+	unsigned int indexCount;
+};
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+namespace
+{
+	// --------------------------------------------------------
+	// Fills in the bounds of a finished meshlet:
+	// - A sphere centered on the box around its positions,
+	//    reaching the furthest one (as in MeshBounds)
+	// - The average of its triangles' unit normals as the cone
+	//    axis, with the cutoff from the normal furthest from it.
+	//    The cone can't be trusted once any normal is 90 degrees
+	//    or more from the axis, so the cutoff stays at 1 then.
+	// --------------------------------------------------------
+	void ComputeBounds(const Vertex* vertices, const unsigned int* indices, Meshlet& meshlet)
+	{
+		const unsigned int* begin = indices + meshlet.indexStart;
+		const unsigned int* end = begin + meshlet.indexCount;
+
+		XMVECTOR min = XMLoadFloat3(&vertices[*begin].Position);
+		XMVECTOR max = min;
+		for (const unsigned int* i = begin; i != end; i++)
+		{
+			XMVECTOR position = XMLoadFloat3(&vertices[*i].Position);
+			min = XMVectorMin(min, position);
+			max = XMVectorMax(max, position);
+		}
+
+		XMVECTOR center = XMVectorScale(XMVectorAdd(min, max), 0.5f);
+		XMVECTOR radiusSquared = XMVectorZero();
+		for (const unsigned int* i = begin; i != end; i++)
+		{
+			XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&vertices[*i].Position), center);
+			radiusSquared = XMVectorMax(radiusSquared, XMVector3LengthSq(offset));
+		}
+		XMStoreFloat3(&meshlet.bounds.Center, center);
+		meshlet.bounds.Radius = XMVectorGetX(XMVectorSqrt(radiusSquared));
+
+		// Same winding as the rasterizer's front faces (clockwise), and
+		// zero for triangles with no area
+		auto triangleNormal = [&](const unsigned int* triangle)
+		{
+			XMVECTOR p0 = XMLoadFloat3(&vertices[triangle[0]].Position);
+			XMVECTOR p1 = XMLoadFloat3(&vertices[triangle[1]].Position);
+			XMVECTOR p2 = XMLoadFloat3(&vertices[triangle[2]].Position);
+			XMVECTOR normal = XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+			float length = XMVectorGetX(XMVector3Length(normal));
+			return length > 0.0f ? XMVectorScale(normal, 1.0f / length) : XMVectorZero();
+		};
+
+		XMVECTOR sum = XMVectorZero();
+		for (const unsigned int* i = begin; i != end; i += 3)
+			sum = XMVectorAdd(sum, triangleNormal(i));
+
+		meshlet.coneAxis = XMFLOAT3(0.0f, 0.0f, 0.0f);
+		meshlet.coneCutoff = 1.0f;
+		float sumLength = XMVectorGetX(XMVector3Length(sum));
+		if (!(sumLength > 0.0f))
+			return;
+
+		XMVECTOR axis = XMVectorScale(sum, 1.0f / sumLength);
+		float smallestDot = 1.0f;
+		for (const unsigned int* i = begin; i != end; i += 3)
+		{
+			XMVECTOR normal = triangleNormal(i);
+			if (XMVector3Equal(normal, XMVectorZero()))
+				continue;
+			smallestDot = std::min(smallestDot, XMVectorGetX(XMVector3Dot(normal, axis)));
+		}
+
+		XMStoreFloat3(&meshlet.coneAxis, axis);
+		if (smallestDot > 0.0f)
+			meshlet.coneCutoff = std::sqrt(1.0f - smallestDot * smallestDot);
+	}
+}
+
+// --------------------------------------------------------
+// Membership of the meshlet being filled is tracked with one
+// entry per vertex holding the meshlet it was last added to,
+// so nothing has to be cleared between meshlets
+// --------------------------------------------------------
+std::vector<Meshlet> MeshletBuilder::Build(
+	const Vertex* vertices,
+	unsigned int vertexCount,
+	const unsigned int* indices,
+	const std::vector<Submesh>& submeshes,
+	unsigned int maxVertices,
+	unsigned int maxTriangles)
+{
+	maxVertices = std::max(3u, maxVertices);
+	maxTriangles = std::max(1u, maxTriangles);
+
+	std::vector<Meshlet> meshlets;
+	std::vector<unsigned int> lastMeshlet(vertexCount, UINT_MAX);
+	for (const Submesh& submesh : submeshes)
+	{
+		unsigned int end = submesh.indexStart + submesh.indexCount / 3 * 3;
+		unsigned int meshletVertices = 0;
+		for (unsigned int i = submesh.indexStart; i < end; i += 3)
+		{
+			// Start a new meshlet at the start of every submesh, and
+			// whenever this triangle would go over either limit
+			unsigned int current = (unsigned int)meshlets.size() - 1;
+			bool fits = i != submesh.indexStart;
+			if (fits)
+			{
+				unsigned int newVertices = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					unsigned int index = indices[i + c];
+					bool repeated = (c > 0 && index == indices[i]) || (c > 1 && index == indices[i + 1]);
+					if (lastMeshlet[index] != current && !repeated)
+						newVertices++;
+				}
+				fits = meshletVertices + newVertices <= maxVertices &&
+					meshlets.back().indexCount / 3 < maxTriangles;
+			}
+			if (!fits)
+			{
+				// Bounds and cone are filled in once the meshlet is complete
+				Meshlet meshlet = {};
+				meshlet.indexStart = i;
+				meshlets.push_back(meshlet);
+				meshletVertices = 0;
+				current++;
+			}
+
+			for (int c = 0; c < 3; c++)
+			{
+				unsigned int index = indices[i + c];
+				if (lastMeshlet[index] != current)
+				{
+					lastMeshlet[index] = current;
+					meshletVertices++;
+				}
+			}
+			meshlets.back().indexCount += 3;
+		}
+	}
+
+	for (Meshlet& meshlet : meshlets)
+		ComputeBounds(vertices, indices, meshlet);
+	return meshlets;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+#include "Vertex.h"
+#include "Submesh.h"
+#include "Meshlet.h"
+
+// Splits index buffers into meshlets: clusters of triangles small enough
+// to be culled one at a time (see MeshletCuller)
+namespace MeshletBuilder
+{
+	// Limits per meshlet, matching common mesh shader sizes
+	const unsigned int MaxVertices = 64;
+	const unsigned int MaxTriangles = 124;
+
+	// Walks each submesh's triangles in order, starting a new meshlet
+	// whenever the next triangle would go over either limit. The triangles
+	// aren't moved, so every meshlet is a range of the given indices and
+	// neighbors in the index buffer (which the vertex cache optimization
+	// already keeps close together) end up in the same meshlet. Meshlets
+	// never cross submeshes.
+	std::vector<Meshlet> Build(
+		const Vertex* vertices,
+		unsigned int vertexCount,
+		const unsigned int* indices,
+		const std::vector<Submesh>& submeshes,
+		unsigned int maxVertices = MaxVertices,
+		unsigned int maxTriangles = MaxTriangles);
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "MeshletCuller.h"
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// The frustum planes come straight from the columns of the
+// combined world-view-projection matrix (Gribb and Hartmann,
+// "Fast Extraction of Viewing Frustum Planes"), which puts
+// them in the mesh's local space. They're normalized, so a
+// plane's dot product with a point is a true distance even
+// when the world matrix scales unevenly.
+//
+// The camera's position is moved into local space the same
+// way. Whether a triangle faces a point survives any affine
+// transform, so the cone test gives the same answer there.
+// --------------------------------------------------------
+MeshletCuller::Stats MeshletCuller::Cull(
+	const std::vector<Meshlet>& meshlets,
+	FXMMATRIX world,
+	CXMMATRIX view,
+	CXMMATRIX projection,
+	bool backfaceCulling,
+	std::vector<IndexRange>& ranges)
+{
+	Stats stats = {};
+	ranges.clear();
+
+	// Row vectors, so clip space coordinates are dot products with columns
+	XMMATRIX columns = XMMatrixTranspose(XMMatrixMultiply(XMMatrixMultiply(world, view), projection));
+	XMVECTOR planes[6] =
+	{
+		XMVectorAdd(columns.r[3], columns.r[0]),		// Left
+		XMVectorSubtract(columns.r[3], columns.r[0]),	// Right
+		XMVectorAdd(columns.r[3], columns.r[1]),		// Bottom
+		XMVectorSubtract(columns.r[3], columns.r[1]),	// Top
+		columns.r[2],									// Near (depth starts at 0)
+		XMVectorSubtract(columns.r[3], columns.r[2])	// Far
+	};
+	for (XMVECTOR& plane : planes)
+		plane = XMPlaneNormalize(plane);
+
+	// Mirroring flips which way the rasterizer sees every triangle
+	XMVECTOR determinant;
+	XMMATRIX localFromWorld = XMMatrixInverse(&determinant, XMMatrixMultiply(world, view));
+	backfaceCulling = backfaceCulling && XMVectorGetX(determinant) > 0.0f;
+	XMVECTOR cameraPosition = XMVector3TransformCoord(XMVectorZero(), localFromWorld);
+
+	for (const Meshlet& meshlet : meshlets)
+	{
+		stats.meshlets++;
+		stats.triangles += meshlet.indexCount / 3;
+
+		XMVECTOR center = XMLoadFloat3(&meshlet.bounds.Center);
+		bool outside = false;
+		for (const XMVECTOR& plane : planes)
+			outside = outside || XMVectorGetX(XMPlaneDotCoord(plane, center)) < -meshlet.bounds.Radius;
+		if (outside)
+		{
+			stats.frustumCulled++;
+			continue;
+		}
+
+		if (backfaceCulling && meshlet.coneCutoff < 1.0f)
+		{
+			XMVECTOR toCenter = XMVectorSubtract(center, cameraPosition);
+			float along = XMVectorGetX(XMVector3Dot(toCenter, XMLoadFloat3(&meshlet.coneAxis)));
+			float distance = XMVectorGetX(XMVector3Length(toCenter));
+			if (along >= meshlet.coneCutoff * distance + meshlet.bounds.Radius)
+			{
+				stats.backfaceCulled++;
+				continue;
+			}
+		}
+
+		stats.visibleMeshlets++;
+		stats.visibleTriangles += meshlet.indexCount / 3;
+
+		// Meshlets are in index buffer order, so survivors next to each
+		// other can share one draw
+		if (!ranges.empty() && ranges.back().indexStart + ranges.back().indexCount == meshlet.indexStart)
+			ranges.back().indexCount += meshlet.indexCount;
+		else
+			ranges.push_back({ meshlet.indexStart, meshlet.indexCount });
+	}
+
+	return stats;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include <DirectXMath.h>
+#include "Meshlet.h"
+
+// Skips meshlets that can't be seen from a camera, on the CPU
+namespace MeshletCuller
+{
+	// What was kept and rejected by one call to Cull()
+	struct Stats
+	{
+		unsigned int meshlets;
+		unsigned int visibleMeshlets;
+		unsigned int frustumCulled;		// Meshlets entirely outside the view
+		unsigned int backfaceCulled;	// Meshlets entirely facing away
+		unsigned int triangles;
+		unsigned int visibleTriangles;
+	};
+
+	// Tests every meshlet's sphere against the view frustum, then its
+	// normal cone against the camera position, and fills ranges with the
+	// index ranges of the survivors (neighbors merged, ready for
+	// DrawIndexed). Everything happens in the mesh's local space, so the
+	// bounds never have to be transformed. Back-face tests are skipped
+	// when backfaceCulling is false (e.g. for meshes drawn without back
+	// face culling) and when the world matrix mirrors the mesh.
+	Stats Cull(
+		const std::vector<Meshlet>& meshlets,
+		DirectX::FXMMATRIX world,
+		DirectX::CXMMATRIX view,
+		DirectX::CXMMATRIX projection,
+		bool backfaceCulling,
+		std::vector<IndexRange>& ranges);
+}
\ No newline at end of file
@@ -8,12 +8,13 @@ float3 UnpackNormal(float3 sampled)
 }
 
 // Transforms the normal using TBN matrix for use in lighting calculations
-float3 TransformNormal(float3 unpacked, float3 surfaceNormal, float3 surfaceTangent)
+// - The tangent's w is the handedness, flipping the bitangent on mirrored uvs
+float3 TransformNormal(float3 unpacked, float3 surfaceNormal, float4 surfaceTangent)
 {
     // Create TBN matrix
     float3 N = normalize(surfaceNormal);
-    float3 T = normalize(surfaceTangent - dot(surfaceTangent, N) * N); // GramSchmidt orthonormalization
-    float3 B = cross(T, N);
+    float3 T = normalize(surfaceTangent.xyz - dot(surfaceTangent.xyz, N) * N); // GramSchmidt orthonormalization
+    float3 B = cross(T, N) * surfaceTangent.w;
     float3x3 TBN = float3x3(T, B, N);
     
     // Perform transformation and return
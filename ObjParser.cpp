@@ -0,0 +1,707 @@
+#include "ObjParser.h"
+#include "VertexWelder.h"
+
+#include <cmath>
+#include <climits>
+#include <thread>
+#include <algorithm>
+
+using namespace DirectX;
+
+namespace
+{
+	// Chunks smaller than this aren't worth the cost of a thread
+	const size_t minBytesPerChunk = 1 << 20;
+
+	// Offset applied to chunk-local relative indices (see ResolveIndex)
+	const int chunkRelativeBias = 1 << 30;
+
+	// Every power of ten that can be represented exactly as a double
+	const double exactPowersOfTen[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+		1e21, 1e22
+	};
+
+	bool IsDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t';
+	}
+
+	void SkipSpaces(const char*& cursor, const char* end)
+	{
+		while (cursor < end && IsSpace(*cursor))
+			cursor++;
+	}
+
+	// Moves the cursor to the first character of the next line
+	void SkipLine(const char*& cursor, const char* end)
+	{
+		while (cursor < end && *cursor != '\n')
+			cursor++;
+		if (cursor < end)
+			cursor++;
+	}
+
+	double PowerOfTen(int exponent)
+	{
+		if (exponent < 23)
+			return exactPowersOfTen[exponent];
+		return std::pow(10.0, exponent);
+	}
+
+	// Turns a negative (relative) OBJ index into an absolute 1-based one,
+	// where -1 is the most recent element. Chunks of a parallel parse don't
+	// know how many elements came before them, so they instead store the
+	// chunk-local index shifted down by the bias, which marks it for fixing
+	// up during the merge. Absolute indices in the file are left alone.
+	int ResolveIndex(int index, size_t count, bool chunked)
+	{
+		if (index >= 0)
+			return index;
+
+		// Nothing can be this far back, and the bias below must not
+		// overflow, so saturated indices stay out of range
+		index = std::max(index, -chunkRelativeBias);
+		int resolved = (int)count + index + 1;
+		return chunked ? resolved - chunkRelativeBias : resolved;
+	}
+
+	// Reads a single "v", "v/vt", "v//vn" or "v/vt/vn" face corner.
+	// Returns false (without moving past the line) if there isn't one.
+	bool ScanCorner(const char*& cursor, const char* end, const ObjParser::ObjData& data, bool chunked, ObjParser::FaceCorner& corner)
+	{
+		SkipSpaces(cursor, end);
+		if (cursor >= end || !(IsDigit(*cursor) || *cursor == '-' || *cursor == '+'))
+			return false;
+
+		corner = {};
+		corner.position = ResolveIndex(ObjParser::ScanInt(cursor, end), data.positions.size(), chunked);
+
+		if (cursor < end && *cursor == '/')
+		{
+			cursor++;
+
+			// UV index is optional ("v//vn")
+			if (cursor < end && *cursor != '/')
+				corner.uv = ResolveIndex(ObjParser::ScanInt(cursor, end), data.uvs.size(), chunked);
+
+			if (cursor < end && *cursor == '/')
+			{
+				cursor++;
+				corner.normal = ResolveIndex(ObjParser::ScanInt(cursor, end), data.normals.size(), chunked);
+			}
+		}
+
+		return true;
+	}
+
+	// Shifts a chunk-local relative index (see ResolveIndex) to its place
+	// in the merged arrays, given how many elements came before the chunk
+	void FixChunkIndex(int& index, size_t offset)
+	{
+		if (index < 0)
+			index += chunkRelativeBias + (int)offset;
+	}
+
+	template<typename List>
+	typename List::value_type Lookup(const List& list, int index)
+	{
+		if (list.empty())
+			return typename List::value_type{};
+		if (index < 1 || index > (int)list.size())
+			return list[0];
+		return list[index - 1];
+	}
+
+	// Whether a 1-based index is within a list, allowing 0 (not given)
+	// for the optional attributes
+	bool IsIndexValid(int index, size_t count, bool optional)
+	{
+		return (optional && index == 0) || (index >= 1 && (size_t)index <= count);
+	}
+
+	template<typename Value>
+	uint64_t CountNonFinite(const std::vector<Value>& values)
+	{
+		const size_t components = sizeof(Value) / sizeof(float);
+		uint64_t count = 0;
+		for (const Value& value : values)
+		{
+			const float* floats = (const float*)&value;
+			for (size_t i = 0; i < components; i++)
+				count += !std::isfinite(floats[i]);
+		}
+		return count;
+	}
+
+	// Checks for a keyword followed by whitespace (or the end of the line)
+	bool StartsWithKeyword(const char* cursor, const char* end, const char* keyword)
+	{
+		for (; *keyword; keyword++, cursor++)
+		{
+			if (cursor >= end || *cursor != *keyword)
+				return false;
+		}
+		return cursor >= end || IsSpace(*cursor) || *cursor == '\r' || *cursor == '\n';
+	}
+
+	// Reads the rest of the line as a name, without surrounding whitespace
+	std::string ScanName(const char*& cursor, const char* end)
+	{
+		SkipSpaces(cursor, end);
+		const char* nameEnd = cursor;
+		while (nameEnd < end && *nameEnd != '\n')
+			nameEnd++;
+		while (nameEnd > cursor && (IsSpace(nameEnd[-1]) || nameEnd[-1] == '\r'))
+			nameEnd--;
+		return std::string(cursor, nameEnd);
+	}
+
+	// --------------------------------------------------------
+	// Walks the text line by line, dispatching on the first
+	// token. Lines can be any length, and anything that isn't
+	// geometry or a name change (comments, smoothing groups,
+	// material libraries) is skipped.
+	// Attributes and markers are appended to the data, while
+	// each triangle is handed to onTriangle in the file's
+	// winding order. Marker corners count from the start of
+	// this block of text.
+	// --------------------------------------------------------
+	template<typename TriangleCallback>
+	void ParseLines(const char* begin, const char* end, bool chunked, ObjParser::ObjData& data, TriangleCallback onTriangle)
+	{
+		size_t emittedCorners = 0;
+		const char* cursor = begin;
+		while (cursor < end)
+		{
+			SkipSpaces(cursor, end);
+			if (cursor >= end)
+				break;
+
+			if (cursor[0] == 'v' && cursor + 1 < end)
+			{
+				if (cursor[1] == 'n')
+				{
+					cursor += 2;
+					XMFLOAT3 norm{};
+					norm.x = ObjParser::ScanFloat(cursor, end);
+					norm.y = ObjParser::ScanFloat(cursor, end);
+					norm.z = ObjParser::ScanFloat(cursor, end);
+					data.normals.push_back(norm);
+				}
+				else if (cursor[1] == 't')
+				{
+					cursor += 2;
+					XMFLOAT2 uv{};
+					uv.x = ObjParser::ScanFloat(cursor, end);
+					uv.y = ObjParser::ScanFloat(cursor, end);
+					data.uvs.push_back(uv);
+				}
+				else if (IsSpace(cursor[1]))
+				{
+					cursor += 1;
+					XMFLOAT3 pos{};
+					pos.x = ObjParser::ScanFloat(cursor, end);
+					pos.y = ObjParser::ScanFloat(cursor, end);
+					pos.z = ObjParser::ScanFloat(cursor, end);
+					data.positions.push_back(pos);
+				}
+			}
+			else if (cursor[0] == 'f' && cursor + 1 < end && IsSpace(cursor[1]))
+			{
+				cursor += 1;
+
+				// Polygons of any size are fan-triangulated around their first
+				// corner as they're read, so only three corners are ever kept
+				ObjParser::FaceCorner first{};
+				ObjParser::FaceCorner previous{};
+				ObjParser::FaceCorner current{};
+				int cornerCount = 0;
+				while (ScanCorner(cursor, end, data, chunked, current))
+				{
+					if (cornerCount == 0)
+						first = current;
+					else if (cornerCount >= 2)
+					{
+						onTriangle(first, previous, current);
+						emittedCorners += 3;
+					}
+
+					previous = current;
+					cornerCount++;
+				}
+			}
+			else if (StartsWithKeyword(cursor, end, "o") || StartsWithKeyword(cursor, end, "g"))
+			{
+				cursor += 1;
+				data.markers.push_back({ emittedCorners, ObjParser::MarkerType::Object, ScanName(cursor, end) });
+			}
+			else if (StartsWithKeyword(cursor, end, "usemtl"))
+			{
+				cursor += 6;
+				data.markers.push_back({ emittedCorners, ObjParser::MarkerType::Material, ScanName(cursor, end) });
+			}
+
+			SkipLine(cursor, end);
+		}
+	}
+}
+
+// --------------------------------------------------------
+// Reads a decimal number (with optional sign, fraction and
+// exponent) without going through the C runtime's locale
+// and format handling
+// --------------------------------------------------------
+float ObjParser::ScanFloat(const char*& cursor, const char* end)
+{
+	SkipSpaces(cursor, end);
+
+	bool negative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+'))
+	{
+		negative = *cursor == '-';
+		cursor++;
+	}
+
+	// Accumulate up to 19 significant digits as an integer, tracking
+	// where the decimal point should end up as a power of ten
+	unsigned long long mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+
+	while (cursor < end && IsDigit(*cursor))
+	{
+		if (significantDigits < 19)
+		{
+			mantissa = mantissa * 10 + (*cursor - '0');
+			if (mantissa != 0)
+				significantDigits++;
+		}
+		else
+		{
+			exponent++;
+		}
+		cursor++;
+	}
+
+	if (cursor < end && *cursor == '.')
+	{
+		cursor++;
+		while (cursor < end && IsDigit(*cursor))
+		{
+			if (significantDigits < 19)
+			{
+				mantissa = mantissa * 10 + (*cursor - '0');
+				if (mantissa != 0)
+					significantDigits++;
+				exponent--;
+			}
+			cursor++;
+		}
+	}
+
+	if (cursor < end && (*cursor == 'e' || *cursor == 'E'))
+	{
+		cursor++;
+		bool negativeExponent = false;
+		if (cursor < end && (*cursor == '-' || *cursor == '+'))
+		{
+			negativeExponent = *cursor == '-';
+			cursor++;
+		}
+
+		int writtenExponent = 0;
+		while (cursor < end && IsDigit(*cursor))
+		{
+			if (writtenExponent < 10000)
+				writtenExponent = writtenExponent * 10 + (*cursor - '0');
+			cursor++;
+		}
+		exponent += negativeExponent ? -writtenExponent : writtenExponent;
+	}
+
+	// Zero stays zero whatever the exponent says ("0e999" would
+	// otherwise be 0 * infinity, which is NaN)
+	if (mantissa == 0)
+		return negative ? -0.0f : 0.0f;
+
+	// Dividing by an exact power of ten keeps common values like
+	// "0.500000" exact, unlike multiplying by an inexact 0.1 step
+	double value = (double)mantissa;
+	if (exponent < 0)
+		value /= PowerOfTen(-exponent);
+	else if (exponent > 0)
+		value *= PowerOfTen(exponent);
+
+	return (float)(negative ? -value : value);
+}
+
+// --------------------------------------------------------
+// Reads a whole number with an optional sign. Numbers too
+// large for an int saturate to +/-INT_MAX, which no index
+// can reach, so they are reported as out of range later.
+// --------------------------------------------------------
+int ObjParser::ScanInt(const char*& cursor, const char* end)
+{
+	SkipSpaces(cursor, end);
+
+	bool negative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+'))
+	{
+		negative = *cursor == '-';
+		cursor++;
+	}
+
+	long long value = 0;
+	while (cursor < end && IsDigit(*cursor))
+	{
+		if (value <= INT_MAX)
+			value = value * 10 + (*cursor - '0');
+		cursor++;
+	}
+
+	int clamped = (int)std::min<long long>(value, INT_MAX);
+	return negative ? -clamped : clamped;
+}
+
+// --------------------------------------------------------
+// Looks up an attribute by its 1-based OBJ index. Indices
+// that were left out of the face, or are out of range, fall
+// back to the first element (or zero if there are none).
+//
+// The model is most likely in a right-handed space,
+// especially if it came from Maya.  We probably want 
+// to convert to a left-handed space.  This means we 
+// need to:
+//  - Invert the Z position
+//  - Invert the normal's Z
+//  - Flip the winding order (done by whoever emits triangles)
+// We also need to flip the UV coordinate since Direct3D
+// defines (0,0) as the top left of the texture, and many
+// 3D modeling packages use the bottom left as (0,0)
+// --------------------------------------------------------
+Vertex ObjParser::BuildVertex(const ObjData& data, const FaceCorner& corner)
+{
+	Vertex vertex = {};
+	vertex.Position = Lookup(data.positions, corner.position);
+	vertex.UV = Lookup(data.uvs, corner.uv);
+	vertex.Normal = Lookup(data.normals, corner.normal);
+
+	vertex.UV.y = 1.0f - vertex.UV.y;
+	vertex.Position.z *= -1.0f;
+	vertex.Normal.z *= -1.0f;
+	return vertex;
+}
+
+void ObjParser::SourceCounter::AddCorner(const ObjData& data, const FaceCorner& corner)
+{
+	cornerCount++;
+	invalidIndexCount +=
+		!IsIndexValid(corner.uv, data.uvs.size(), true) +
+		!IsIndexValid(corner.normal, data.normals.size(), true);
+
+	if (!IsIndexValid(corner.position, data.positions.size(), false))
+	{
+		invalidIndexCount++;
+		return;
+	}
+
+	// Positions may still be arriving while streaming
+	size_t index = (size_t)corner.position - 1;
+	if (index >= usedPositions.size())
+		usedPositions.resize(data.positions.size());
+	if (!usedPositions[index])
+	{
+		usedPositions[index] = true;
+		usedPositionCount++;
+	}
+}
+
+ObjParser::SourceStats ObjParser::SourceCounter::Finish(const ObjData& data) const
+{
+	SourceStats stats = {};
+	stats.positionCount = data.positions.size();
+	stats.normalCount = data.normals.size();
+	stats.uvCount = data.uvs.size();
+	stats.triangleCount = cornerCount / 3;
+	stats.invalidIndexCount = invalidIndexCount;
+	stats.unusedPositionCount = data.positions.size() - usedPositionCount;
+	stats.nonFiniteValueCount = CountNonFinite(data.positions) + CountNonFinite(data.normals) + CountNonFinite(data.uvs);
+	return stats;
+}
+
+void ObjParser::Parse(const char* begin, const char* end, ObjData& data)
+{
+	ParseLines(begin, end, false, data,
+		[&](const FaceCorner& c0, const FaceCorner& c1, const FaceCorner& c2)
+		{
+			data.triangles.push_back(c0);
+			data.triangles.push_back(c1);
+			data.triangles.push_back(c2);
+		});
+}
+
+// --------------------------------------------------------
+// Streams the file into a sink with bounded memory
+//
+// - Only the attribute arrays and the welder's keys (12 bytes
+//    per unique vertex) are kept besides what the sink stores
+// - Peak memory is sampled every few thousand triangles, which
+//    keeps the virtual call out of the per-triangle path
+// --------------------------------------------------------
+ObjParser::StreamStats ObjParser::ParseStreaming(const char* begin, const char* end, MeshSink& sink, std::vector<Marker>& markers, SourceStats& source)
+{
+	StreamStats stats = {};
+	ObjData data;
+	SourceCounter counter;
+
+	// A quick pre-pass over the line starts lets every array be sized
+	// once, instead of doubling (and briefly holding two copies) as it grows
+	size_t positionCount = 0;
+	size_t normalCount = 0;
+	size_t uvCount = 0;
+	size_t indexCount = 0;
+	for (const char* cursor = begin; cursor < end; SkipLine(cursor, end))
+	{
+		SkipSpaces(cursor, end);
+		if (cursor + 1 >= end)
+			break;
+		if (cursor[0] == 'v')
+		{
+			if (cursor[1] == 'n') normalCount++;
+			else if (cursor[1] == 't') uvCount++;
+			else if (IsSpace(cursor[1])) positionCount++;
+		}
+		else if (cursor[0] == 'f' && IsSpace(cursor[1]))
+		{
+			// Count the corners (whitespace separated tokens) of the face
+			int corners = 0;
+			for (const char* c = cursor + 1; c < end && *c != '\n'; c++)
+			{
+				if (!IsSpace(*c) && *c != '\r' && IsSpace(c[-1]))
+					corners++;
+			}
+			if (corners >= 3)
+				indexCount += (size_t)(corners - 2) * 3;
+		}
+	}
+	data.positions.reserve(positionCount);
+	data.normals.reserve(normalCount);
+	data.uvs.reserve(uvCount);
+
+	// Every attribute is used by at least one vertex, so the largest
+	// attribute count is a lower bound on the number of unique vertices
+	size_t vertexGuess = std::max(positionCount, std::max(normalCount, uvCount));
+	VertexWelder welder(WeldMode::IndexTriple, vertexGuess);
+	sink.Reserve(vertexGuess, indexCount);
+
+	auto sampleMemory = [&]()
+	{
+		stats.attributeBytes =
+			data.positions.capacity() * sizeof(XMFLOAT3) +
+			data.normals.capacity() * sizeof(XMFLOAT3) +
+			data.uvs.capacity() * sizeof(XMFLOAT2);
+		stats.welderBytes = welder.GetMemoryUsage();
+		stats.sinkBytes = sink.GetMemoryUsage();
+
+		size_t total = stats.attributeBytes + stats.welderBytes + stats.sinkBytes;
+		if (total > stats.peakBytes)
+			stats.peakBytes = total;
+	};
+
+	const FaceCorner* corners[3] = {};
+	ParseLines(begin, end, false, data,
+		[&](const FaceCorner& c0, const FaceCorner& c1, const FaceCorner& c2)
+		{
+			// Emit with the winding order flipped (LH vs. RH)
+			corners[0] = &c0;
+			corners[1] = &c2;
+			corners[2] = &c1;
+			for (const FaceCorner* corner : corners)
+			{
+				counter.AddCorner(data, *corner);
+
+				bool isNew = false;
+				unsigned int index = welder.Weld(corner->position, corner->uv, corner->normal, &isNew);
+				if (isNew)
+				{
+					sink.AddVertex(BuildVertex(data, *corner));
+					stats.vertexCount++;
+				}
+				sink.AddIndex(index);
+			}
+
+			stats.indexCount += 3;
+			if (stats.indexCount % 12288 == 0)
+				sampleMemory();
+		});
+
+	sampleMemory();
+	source = counter.Finish(data);
+	markers = std::move(data.markers);
+	return stats;
+}
+
+// --------------------------------------------------------
+// Walks the markers in order, closing the current submesh
+// whenever a name changes. Runs with no triangles (e.g. a
+// "g" line directly followed by "usemtl") are dropped.
+// --------------------------------------------------------
+std::vector<Submesh> ObjParser::BuildSubmeshes(const std::vector<Marker>& markers, size_t cornerCount)
+{
+	std::vector<Submesh> submeshes;
+	Submesh current = {};
+	for (const Marker& marker : markers)
+	{
+		if (marker.corner > current.indexStart)
+		{
+			current.indexCount = (unsigned int)(marker.corner - current.indexStart);
+			submeshes.push_back(current);
+			current.indexStart = (unsigned int)marker.corner;
+		}
+
+		if (marker.type == MarkerType::Object)
+			current.name = marker.name;
+		else
+			current.materialName = marker.name;
+	}
+
+	if (cornerCount > current.indexStart || submeshes.empty())
+	{
+		current.indexCount = (unsigned int)(cornerCount - current.indexStart);
+		submeshes.push_back(current);
+	}
+	return submeshes;
+}
+
+// --------------------------------------------------------
+// Parses large files on multiple threads
+//
+// - Chunk boundaries are moved forward to the next newline,
+//    so no line is ever split between two chunks
+// - Absolute face indices in the file are global and 1-based,
+//    so they stay valid when the chunks are appended in order
+// - Relative (negative) indices are stored chunk-local and
+//    shifted into place while copying, see ResolveIndex
+// - Each chunk copies its own results into the merged arrays,
+//    so the merge is also spread across the threads
+// - Markers only record name changes, so they can be appended
+//    in chunk order once their corners are shifted into place
+// --------------------------------------------------------
+void ObjParser::ParseParallel(const char* begin, const char* end, ObjData& data, unsigned int threadCount)
+{
+	size_t size = (size_t)(end - begin);
+	if (threadCount == 0)
+	{
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+		threadCount = (unsigned int)std::min<size_t>(threadCount, size / minBytesPerChunk);
+	}
+
+	if (threadCount <= 1)
+	{
+		Parse(begin, end, data);
+		return;
+	}
+
+	// Find the chunk boundaries, each one starting at the beginning of a line
+	std::vector<const char*> bounds(threadCount + 1);
+	bounds[0] = begin;
+	bounds[threadCount] = end;
+	for (unsigned int i = 1; i < threadCount; i++)
+	{
+		const char* split = std::max(bounds[i - 1], begin + size / threadCount * i);
+		while (split > begin && split < end && split[-1] != '\n')
+			split++;
+		bounds[i] = split;
+	}
+
+	// Parse every chunk into its own local arrays
+	std::vector<ObjData> chunks(threadCount);
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		workers.emplace_back([&, i]()
+			{
+				ObjData& chunk = chunks[i];
+				ParseLines(bounds[i], bounds[i + 1], true, chunk,
+					[&](const FaceCorner& c0, const FaceCorner& c1, const FaceCorner& c2)
+					{
+						chunk.triangles.push_back(c0);
+						chunk.triangles.push_back(c1);
+						chunk.triangles.push_back(c2);
+					});
+			});
+	}
+	for (std::thread& worker : workers)
+		worker.join();
+	workers.clear();
+
+	// Markers are few, so they are merged here rather than on the workers
+	size_t markerCorner = data.triangles.size();
+	for (ObjData& chunk : chunks)
+	{
+		for (Marker& marker : chunk.markers)
+		{
+			marker.corner += markerCorner;
+			data.markers.push_back(std::move(marker));
+		}
+		chunk.markers.clear();
+		markerCorner += chunk.triangles.size();
+	}
+
+	// Work out where each chunk lands in the merged arrays
+	struct ChunkOffsets
+	{
+		size_t positions;
+		size_t normals;
+		size_t uvs;
+		size_t triangles;
+	};
+	std::vector<ChunkOffsets> offsets(threadCount);
+	ChunkOffsets total = { data.positions.size(), data.normals.size(), data.uvs.size(), data.triangles.size() };
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		offsets[i] = total;
+		total.positions += chunks[i].positions.size();
+		total.normals += chunks[i].normals.size();
+		total.uvs += chunks[i].uvs.size();
+		total.triangles += chunks[i].triangles.size();
+	}
+
+	data.positions.resize(total.positions);
+	data.normals.resize(total.normals);
+	data.uvs.resize(total.uvs);
+	data.triangles.resize(total.triangles);
+
+	// Copy every chunk into place in parallel
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		workers.emplace_back([&, i]()
+			{
+				ObjData& chunk = chunks[i];
+				std::copy(chunk.positions.begin(), chunk.positions.end(), data.positions.begin() + offsets[i].positions);
+				std::copy(chunk.normals.begin(), chunk.normals.end(), data.normals.begin() + offsets[i].normals);
+				std::copy(chunk.uvs.begin(), chunk.uvs.end(), data.uvs.begin() + offsets[i].uvs);
+				std::copy(chunk.triangles.begin(), chunk.triangles.end(), data.triangles.begin() + offsets[i].triangles);
+
+				// Relative indices now know how much came before their chunk
+				FaceCorner* corners = data.triangles.data() + offsets[i].triangles;
+				for (size_t c = 0; c < chunk.triangles.size(); c++)
+				{
+					FixChunkIndex(corners[c].position, offsets[i].positions);
+					FixChunkIndex(corners[c].uv, offsets[i].uvs);
+					FixChunkIndex(corners[c].normal, offsets[i].normals);
+				}
+				chunk = ObjData(); // Release as soon as possible
+			});
+	}
+	for (std::thread& worker : workers)
+		worker.join();
+}
\ No newline at end of file
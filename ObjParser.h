@@ -0,0 +1,125 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <DirectXMath.h>
+#include "Vertex.h"
+#include "MeshSink.h"
+#include "Submesh.h"
+
+// Tokenizes .obj text in place (no per-line copies or format strings)
+namespace ObjParser
+{
+	// One corner of a triangle, using the 1-based indices written in the
+	// file (relative negative indices are resolved to absolute ones).
+	// An index of 0 means it was not given for that corner.
+	struct FaceCorner
+	{
+		int position;
+		int uv;
+		int normal;
+	};
+
+	// Which name a marker line changes
+	enum class MarkerType
+	{
+		Object,		// "o" or "g"
+		Material	// "usemtl"
+	};
+
+	// A name change found in the file, recorded at the triangle corner
+	// where it takes effect (every corner after it uses the new name)
+	struct Marker
+	{
+		size_t corner;
+		MarkerType type;
+		std::string name;
+	};
+
+	// Raw data read from the file, before any vertices are built
+	struct ObjData
+	{
+		std::vector<DirectX::XMFLOAT3> positions;
+		std::vector<DirectX::XMFLOAT3> normals;
+		std::vector<DirectX::XMFLOAT2> uvs;
+
+		// Three corners per triangle, in the winding order written in the file
+		std::vector<FaceCorner> triangles;
+
+		// Object, group and material changes, in file order
+		std::vector<Marker> markers;
+	};
+
+	// Memory used by a streaming import, in bytes
+	struct StreamStats
+	{
+		size_t vertexCount;
+		size_t indexCount;
+		size_t attributeBytes;	// Positions, normals and uvs read from the file
+		size_t welderBytes;		// Hash table and keys used for welding
+		size_t sinkBytes;		// Reported by the sink at the end
+		size_t peakBytes;		// Largest total seen while importing
+	};
+
+	// What the file contained, and what BuildVertex() had to paper over.
+	// Fixed-size fields, since cooked files keep a copy (see ImportReport).
+	struct SourceStats
+	{
+		uint64_t positionCount;
+		uint64_t normalCount;
+		uint64_t uvCount;
+		uint64_t triangleCount;			// After splitting polygons, so three corners each
+		uint64_t invalidIndexCount;		// Corner indices outside the data read (the first element is used instead)
+		uint64_t unusedPositionCount;	// Positions no face refers to
+		uint64_t nonFiniteValueCount;	// NaN or infinite position, normal and uv components
+	};
+
+	// Tallies SourceStats one corner at a time, so it can ride along with
+	// whatever loop already visits every corner. Corners are checked
+	// against the data read so far, which is exactly what BuildVertex()
+	// would see for them.
+	class SourceCounter
+	{
+	public:
+		void AddCorner(const ObjData& data, const FaceCorner& corner);
+		SourceStats Finish(const ObjData& data) const;
+
+	private:
+		std::vector<bool> usedPositions;
+		uint64_t cornerCount = 0;
+		uint64_t invalidIndexCount = 0;
+		uint64_t usedPositionCount = 0;
+	};
+
+	// Parses every line between begin and end, appending to the given data
+	void Parse(const char* begin, const char* end, ObjData& data);
+
+	// Splits the text into chunks at line boundaries and parses each one on
+	// its own thread, then merges them in file order. The result is exactly
+	// what Parse() would produce. A thread count of 0 picks one based on the
+	// hardware and the amount of text (small files stay single-threaded).
+	void ParseParallel(const char* begin, const char* end, ObjData& data, unsigned int threadCount = 0);
+
+	// Parses the text in a single pass without storing any faces. Each
+	// triangle is welded (on its v/vt/vn indices) as soon as it is read,
+	// and new vertices and all indices go straight into the sink.
+	// Markers are still collected into the given list, and every corner
+	// is counted into the source stats.
+	StreamStats ParseStreaming(const char* begin, const char* end, MeshSink& sink, std::vector<Marker>& markers, SourceStats& source);
+
+	// Splits a mesh into one submesh per run of triangles sharing the same
+	// object and material. Triangles are never reordered, so corner offsets
+	// are also offsets into the final index buffer. Always returns at least
+	// one submesh.
+	std::vector<Submesh> BuildSubmeshes(const std::vector<Marker>& markers, size_t cornerCount);
+
+	// Creates the final vertex for a face corner, converting from the
+	// file's right-handed space to a left-handed one along the way
+	Vertex BuildVertex(const ObjData& data, const FaceCorner& corner);
+
+	// Low-level scanners. Each skips leading spaces/tabs, reads a single
+	// number and advances the cursor past it without passing the end.
+	float ScanFloat(const char*& cursor, const char* end);
+	int ScanInt(const char*& cursor, const char* end);
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+// The bounding volumes from DirectXCollision.h that meshes store, for
+// builds without the real headers (see DirectXMath.h in this folder).
+// Only the data, constructors and Transform (for world space bounds);
+// nothing in the portable build tests intersections.
+
+#include <cfloat>
+#include "DirectXMath.h"
+
+namespace DirectX
+{
+	struct BoundingSphere
+	{
+		XMFLOAT3 Center;
+		float Radius;
+
+		BoundingSphere() : Center(0, 0, 0), Radius(1.0f) {}
+		constexpr BoundingSphere(const XMFLOAT3& center, float radius) : Center(center), Radius(radius) {}
+
+		// The center through m, and the radius scaled by m's longest axis
+		void XM_CALLCONV Transform(BoundingSphere& out, FXMMATRIX m) const
+		{
+			XMStoreFloat3(&out.Center, XMVector3Transform(XMLoadFloat3(&Center), m));
+			XMVECTOR scaleSquared = XMVectorMax(
+				XMVector3LengthSq(m.r[0]),
+				XMVectorMax(XMVector3LengthSq(m.r[1]), XMVector3LengthSq(m.r[2])));
+			out.Radius = Radius * XMVectorGetX(XMVectorSqrt(scaleSquared));
+		}
+	};
+
+	struct BoundingBox
+	{
+		XMFLOAT3 Center;
+		XMFLOAT3 Extents;	// Distance from the center to each side
+
+		BoundingBox() : Center(0, 0, 0), Extents(1.0f, 1.0f, 1.0f) {}
+		constexpr BoundingBox(const XMFLOAT3& center, const XMFLOAT3& extents) : Center(center), Extents(extents) {}
+
+		// The box around all eight corners once they've gone through m
+		void XM_CALLCONV Transform(BoundingBox& out, FXMMATRIX m) const
+		{
+			XMVECTOR center = XMLoadFloat3(&Center);
+			XMVECTOR extents = XMLoadFloat3(&Extents);
+			XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+			XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+			for (int corner = 0; corner < 8; corner++)
+			{
+				XMVECTOR offset = XMVectorSet(corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : -1.0f, 0.0f);
+				XMVECTOR transformed = XMVector3Transform(XMVectorMultiplyAdd(extents, offset, center), m);
+				minimum = XMVectorMin(minimum, transformed);
+				maximum = XMVectorMax(maximum, transformed);
+			}
+			XMStoreFloat3(&out.Center, XMVectorScale(XMVectorAdd(minimum, maximum), 0.5f));
+			XMStoreFloat3(&out.Extents, XMVectorScale(XMVectorSubtract(maximum, minimum), 0.5f));
+		}
+	};
+}
\ No newline at end of file
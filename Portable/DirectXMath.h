@@ -0,0 +1,662 @@
+#pragma once
+
+// --------------------------------------------------------
+// Plain C++ stand-in for the parts of DirectXMath that the
+// CPU mesh pipeline and TransformStore use, for building them
+// where the real headers aren't installed (see CMakeLists.txt,
+// which prefers the real DirectXMath whenever it finds it).
+//
+// Everything follows DirectXMath's own no-intrinsics path:
+// same names, row vectors, left-handed matrices and bitwise
+// lane masks, one float at a time. Nothing here is tuned, so
+// benchmark numbers from a build that uses it only compare
+// against other numbers from the same build.
+// --------------------------------------------------------
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#define XM_CALLCONV
+
+namespace DirectX
+{
+	constexpr float XM_PI = 3.141592654f;
+	constexpr float XM_2PI = 6.283185307f;
+	constexpr float XM_1DIVPI = 0.318309886f;
+	constexpr float XM_PIDIV2 = 1.570796327f;
+	constexpr float XM_PIDIV4 = 0.785398163f;
+
+	constexpr uint32_t XM_SELECT_0 = 0x00000000;
+	constexpr uint32_t XM_SELECT_1 = 0xFFFFFFFF;
+
+	constexpr float XMConvertToRadians(float degrees) { return degrees * (XM_PI / 180.0f); }
+	constexpr float XMConvertToDegrees(float radians) { return radians * (180.0f / XM_PI); }
+
+	// Four lanes, read as floats or as bit masks
+	struct XMVECTOR
+	{
+		union
+		{
+			float vector4_f32[4];
+			uint32_t vector4_u32[4];
+		};
+	};
+
+	using FXMVECTOR = const XMVECTOR;
+	using GXMVECTOR = const XMVECTOR;
+	using HXMVECTOR = const XMVECTOR;
+	using CXMVECTOR = const XMVECTOR&;
+
+	// Four rows
+	struct XMMATRIX
+	{
+		XMVECTOR r[4];
+	};
+
+	using FXMMATRIX = const XMMATRIX;
+	using CXMMATRIX = const XMMATRIX&;
+
+	struct XMFLOAT2
+	{
+		float x;
+		float y;
+
+		XMFLOAT2() = default;
+		constexpr XMFLOAT2(float x, float y) : x(x), y(y) {}
+	};
+
+	struct XMFLOAT3
+	{
+		float x;
+		float y;
+		float z;
+
+		XMFLOAT3() = default;
+		constexpr XMFLOAT3(float x, float y, float z) : x(x), y(y), z(z) {}
+	};
+
+	struct XMFLOAT4
+	{
+		float x;
+		float y;
+		float z;
+		float w;
+
+		XMFLOAT4() = default;
+		constexpr XMFLOAT4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+	};
+
+	struct XMFLOAT4X4
+	{
+		union
+		{
+			struct
+			{
+				float _11, _12, _13, _14;
+				float _21, _22, _23, _24;
+				float _31, _32, _33, _34;
+				float _41, _42, _43, _44;
+			};
+			float m[4][4];
+		};
+
+		XMFLOAT4X4() = default;
+		constexpr XMFLOAT4X4(
+			float m00, float m01, float m02, float m03,
+			float m10, float m11, float m12, float m13,
+			float m20, float m21, float m22, float m23,
+			float m30, float m31, float m32, float m33)
+			: _11(m00), _12(m01), _13(m02), _14(m03),
+			_21(m10), _22(m11), _23(m12), _24(m13),
+			_31(m20), _32(m21), _33(m22), _34(m23),
+			_41(m30), _42(m31), _43(m32), _44(m33) {}
+
+		float operator()(size_t row, size_t column) const { return m[row][column]; }
+		float& operator()(size_t row, size_t column) { return m[row][column]; }
+	};
+
+	// --------------------------------------------------------
+	// Setting, loading and storing
+	// --------------------------------------------------------
+	inline XMVECTOR XMVectorSet(float x, float y, float z, float w)
+	{
+		XMVECTOR v;
+		v.vector4_f32[0] = x;
+		v.vector4_f32[1] = y;
+		v.vector4_f32[2] = z;
+		v.vector4_f32[3] = w;
+		return v;
+	}
+
+	inline XMVECTOR XMVectorSetInt(uint32_t x, uint32_t y, uint32_t z, uint32_t w)
+	{
+		XMVECTOR v;
+		v.vector4_u32[0] = x;
+		v.vector4_u32[1] = y;
+		v.vector4_u32[2] = z;
+		v.vector4_u32[3] = w;
+		return v;
+	}
+
+	inline XMVECTOR XMVectorZero() { return XMVectorSet(0, 0, 0, 0); }
+	inline XMVECTOR XMVectorSplatOne() { return XMVectorSet(1, 1, 1, 1); }
+	inline XMVECTOR XMVectorReplicate(float value) { return XMVectorSet(value, value, value, value); }
+
+	inline float XMVectorGetX(FXMVECTOR v) { return v.vector4_f32[0]; }
+	inline float XMVectorGetY(FXMVECTOR v) { return v.vector4_f32[1]; }
+	inline float XMVectorGetZ(FXMVECTOR v) { return v.vector4_f32[2]; }
+	inline float XMVectorGetW(FXMVECTOR v) { return v.vector4_f32[3]; }
+
+	inline XMVECTOR XMVectorSetX(FXMVECTOR v, float x) { XMVECTOR r = v; r.vector4_f32[0] = x; return r; }
+	inline XMVECTOR XMVectorSetY(FXMVECTOR v, float y) { XMVECTOR r = v; r.vector4_f32[1] = y; return r; }
+	inline XMVECTOR XMVectorSetZ(FXMVECTOR v, float z) { XMVECTOR r = v; r.vector4_f32[2] = z; return r; }
+	inline XMVECTOR XMVectorSetW(FXMVECTOR v, float w) { XMVECTOR r = v; r.vector4_f32[3] = w; return r; }
+
+	inline XMVECTOR XMVectorSplatX(FXMVECTOR v) { return XMVectorReplicate(v.vector4_f32[0]); }
+	inline XMVECTOR XMVectorSplatY(FXMVECTOR v) { return XMVectorReplicate(v.vector4_f32[1]); }
+	inline XMVECTOR XMVectorSplatZ(FXMVECTOR v) { return XMVectorReplicate(v.vector4_f32[2]); }
+	inline XMVECTOR XMVectorSplatW(FXMVECTOR v) { return XMVectorReplicate(v.vector4_f32[3]); }
+
+	inline XMVECTOR XMLoadFloat2(const XMFLOAT2* source) { return XMVectorSet(source->x, source->y, 0, 0); }
+	inline XMVECTOR XMLoadFloat3(const XMFLOAT3* source) { return XMVectorSet(source->x, source->y, source->z, 0); }
+	inline XMVECTOR XMLoadFloat4(const XMFLOAT4* source) { return XMVectorSet(source->x, source->y, source->z, source->w); }
+
+	inline void XMStoreFloat2(XMFLOAT2* destination, FXMVECTOR v)
+	{
+		destination->x = v.vector4_f32[0];
+		destination->y = v.vector4_f32[1];
+	}
+
+	inline void XMStoreFloat3(XMFLOAT3* destination, FXMVECTOR v)
+	{
+		destination->x = v.vector4_f32[0];
+		destination->y = v.vector4_f32[1];
+		destination->z = v.vector4_f32[2];
+	}
+
+	inline void XMStoreFloat4(XMFLOAT4* destination, FXMVECTOR v)
+	{
+		destination->x = v.vector4_f32[0];
+		destination->y = v.vector4_f32[1];
+		destination->z = v.vector4_f32[2];
+		destination->w = v.vector4_f32[3];
+	}
+
+	inline XMMATRIX XMLoadFloat4x4(const XMFLOAT4X4* source)
+	{
+		XMMATRIX m;
+		for (int row = 0; row < 4; row++)
+			m.r[row] = XMVectorSet(source->m[row][0], source->m[row][1], source->m[row][2], source->m[row][3]);
+		return m;
+	}
+
+	inline void XMStoreFloat4x4(XMFLOAT4X4* destination, FXMMATRIX m)
+	{
+		for (int row = 0; row < 4; row++)
+			for (int column = 0; column < 4; column++)
+				destination->m[row][column] = m.r[row].vector4_f32[column];
+	}
+
+	// --------------------------------------------------------
+	// Lane-wise math
+	// --------------------------------------------------------
+	namespace Internal
+	{
+		template<typename Op>
+		inline XMVECTOR EachLane(FXMVECTOR a, FXMVECTOR b, Op op)
+		{
+			XMVECTOR r;
+			for (int i = 0; i < 4; i++)
+				r.vector4_f32[i] = op(a.vector4_f32[i], b.vector4_f32[i]);
+			return r;
+		}
+
+		template<typename Op>
+		inline XMVECTOR EachLane(FXMVECTOR a, Op op)
+		{
+			XMVECTOR r;
+			for (int i = 0; i < 4; i++)
+				r.vector4_f32[i] = op(a.vector4_f32[i]);
+			return r;
+		}
+
+		// All bits set where the comparison holds
+		template<typename Op>
+		inline XMVECTOR EachMask(FXMVECTOR a, FXMVECTOR b, Op op)
+		{
+			XMVECTOR r;
+			for (int i = 0; i < 4; i++)
+				r.vector4_u32[i] = op(a.vector4_f32[i], b.vector4_f32[i]) ? XM_SELECT_1 : XM_SELECT_0;
+			return r;
+		}
+	}
+
+	inline XMVECTOR XMVectorAdd(FXMVECTOR a, FXMVECTOR b) { return Internal::EachLane(a, b, [](float x, float y) { return x + y; }); }
+	inline XMVECTOR XMVectorSubtract(FXMVECTOR a, FXMVECTOR b) { return Internal::EachLane(a, b, [](float x, float y) { return x - y; }); }
+	inline XMVECTOR XMVectorMultiply(FXMVECTOR a, FXMVECTOR b) { return Internal::EachLane(a, b, [](float x, float y) { return x * y; }); }
+	inline XMVECTOR XMVectorDivide(FXMVECTOR a, FXMVECTOR b) { return Internal::EachLane(a, b, [](float x, float y) { return x / y; }); }
+	inline XMVECTOR XMVectorMin(FXMVECTOR a, FXMVECTOR b) { return Internal::EachLane(a, b, [](float x, float y) { return x < y ? x : y; }); }
+	inline XMVECTOR XMVectorMax(FXMVECTOR a, FXMVECTOR b) { return Internal::EachLane(a, b, [](float x, float y) { return x > y ? x : y; }); }
+
+	inline XMVECTOR XMVectorMultiplyAdd(FXMVECTOR a, FXMVECTOR b, FXMVECTOR c) { return XMVectorAdd(XMVectorMultiply(a, b), c); }
+	inline XMVECTOR XMVectorScale(FXMVECTOR v, float scale) { return XMVectorMultiply(v, XMVectorReplicate(scale)); }
+
+	inline XMVECTOR XMVectorNegate(FXMVECTOR v) { return Internal::EachLane(v, [](float x) { return -x; }); }
+	inline XMVECTOR XMVectorAbs(FXMVECTOR v) { return Internal::EachLane(v, [](float x) { return std::fabs(x); }); }
+	inline XMVECTOR XMVectorSqrt(FXMVECTOR v) { return Internal::EachLane(v, [](float x) { return std::sqrt(x); }); }
+	inline XMVECTOR XMVectorReciprocal(FXMVECTOR v) { return Internal::EachLane(v, [](float x) { return 1.0f / x; }); }
+	// Halfway cases go to the even neighbor
+	inline XMVECTOR XMVectorRound(FXMVECTOR v) { return Internal::EachLane(v, [](float x) { return std::nearbyint(x); }); }
+	inline XMVECTOR XMVectorClamp(FXMVECTOR v, FXMVECTOR min, FXMVECTOR max) { return XMVectorMin(XMVectorMax(v, min), max); }
+	inline XMVECTOR XMVectorSaturate(FXMVECTOR v) { return XMVectorClamp(v, XMVectorZero(), XMVectorSplatOne()); }
+
+	inline void XMVectorSinCos(XMVECTOR* sin, XMVECTOR* cos, FXMVECTOR v)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			sin->vector4_f32[i] = std::sin(v.vector4_f32[i]);
+			cos->vector4_f32[i] = std::cos(v.vector4_f32[i]);
+		}
+	}
+
+	inline void XMScalarSinCos(float* sin, float* cos, float value)
+	{
+		*sin = std::sin(value);
+		*cos = std::cos(value);
+	}
+
+	// --------------------------------------------------------
+	// Comparisons, masks and selects
+	// --------------------------------------------------------
+	inline XMVECTOR XMVectorEqual(FXMVECTOR a, FXMVECTOR b) { return Internal::EachMask(a, b, [](float x, float y) { return x == y; }); }
+	inline XMVECTOR XMVectorLess(FXMVECTOR a, FXMVECTOR b) { return Internal::EachMask(a, b, [](float x, float y) { return x < y; }); }
+	inline XMVECTOR XMVectorLessOrEqual(FXMVECTOR a, FXMVECTOR b) { return Internal::EachMask(a, b, [](float x, float y) { return x <= y; }); }
+	inline XMVECTOR XMVectorGreater(FXMVECTOR a, FXMVECTOR b) { return Internal::EachMask(a, b, [](float x, float y) { return x > y; }); }
+	inline XMVECTOR XMVectorGreaterOrEqual(FXMVECTOR a, FXMVECTOR b) { return Internal::EachMask(a, b, [](float x, float y) { return x >= y; }); }
+
+	inline XMVECTOR XMVectorSelectControl(uint32_t index0, uint32_t index1, uint32_t index2, uint32_t index3)
+	{
+		return XMVectorSetInt(
+			index0 ? XM_SELECT_1 : XM_SELECT_0,
+			index1 ? XM_SELECT_1 : XM_SELECT_0,
+			index2 ? XM_SELECT_1 : XM_SELECT_0,
+			index3 ? XM_SELECT_1 : XM_SELECT_0);
+	}
+
+	// Bits of b where control is set, bits of a elsewhere
+	inline XMVECTOR XMVectorSelect(FXMVECTOR a, FXMVECTOR b, FXMVECTOR control)
+	{
+		XMVECTOR r;
+		for (int i = 0; i < 4; i++)
+			r.vector4_u32[i] = (a.vector4_u32[i] & ~control.vector4_u32[i]) | (b.vector4_u32[i] & control.vector4_u32[i]);
+		return r;
+	}
+
+	inline XMVECTOR XMVectorAndInt(FXMVECTOR a, FXMVECTOR b)
+	{
+		XMVECTOR r;
+		for (int i = 0; i < 4; i++)
+			r.vector4_u32[i] = a.vector4_u32[i] & b.vector4_u32[i];
+		return r;
+	}
+
+	inline XMVECTOR XMVectorOrInt(FXMVECTOR a, FXMVECTOR b)
+	{
+		XMVECTOR r;
+		for (int i = 0; i < 4; i++)
+			r.vector4_u32[i] = a.vector4_u32[i] | b.vector4_u32[i];
+		return r;
+	}
+
+	inline XMVECTOR XMVectorSwizzle(FXMVECTOR v, uint32_t e0, uint32_t e1, uint32_t e2, uint32_t e3)
+	{
+		return XMVectorSet(v.vector4_f32[e0], v.vector4_f32[e1], v.vector4_f32[e2], v.vector4_f32[e3]);
+	}
+
+	template<uint32_t E0, uint32_t E1, uint32_t E2, uint32_t E3>
+	inline XMVECTOR XMVectorSwizzle(FXMVECTOR v)
+	{
+		static_assert(E0 < 4 && E1 < 4 && E2 < 4 && E3 < 4, "Swizzle indices must be 0 to 3");
+		return XMVectorSwizzle(v, E0, E1, E2, E3);
+	}
+
+	// --------------------------------------------------------
+	// 3D and 4D vectors
+	// --------------------------------------------------------
+	inline XMVECTOR XMVector3Dot(FXMVECTOR a, FXMVECTOR b)
+	{
+		return XMVectorReplicate(
+			a.vector4_f32[0] * b.vector4_f32[0] +
+			a.vector4_f32[1] * b.vector4_f32[1] +
+			a.vector4_f32[2] * b.vector4_f32[2]);
+	}
+
+	inline XMVECTOR XMVector4Dot(FXMVECTOR a, FXMVECTOR b)
+	{
+		return XMVectorReplicate(
+			a.vector4_f32[0] * b.vector4_f32[0] +
+			a.vector4_f32[1] * b.vector4_f32[1] +
+			a.vector4_f32[2] * b.vector4_f32[2] +
+			a.vector4_f32[3] * b.vector4_f32[3]);
+	}
+
+	inline XMVECTOR XMVector3Cross(FXMVECTOR a, FXMVECTOR b)
+	{
+		return XMVectorSet(
+			a.vector4_f32[1] * b.vector4_f32[2] - a.vector4_f32[2] * b.vector4_f32[1],
+			a.vector4_f32[2] * b.vector4_f32[0] - a.vector4_f32[0] * b.vector4_f32[2],
+			a.vector4_f32[0] * b.vector4_f32[1] - a.vector4_f32[1] * b.vector4_f32[0],
+			0);
+	}
+
+	inline XMVECTOR XMVector3LengthSq(FXMVECTOR v) { return XMVector3Dot(v, v); }
+	inline XMVECTOR XMVector3Length(FXMVECTOR v) { return XMVectorSqrt(XMVector3LengthSq(v)); }
+	inline XMVECTOR XMVector4Length(FXMVECTOR v) { return XMVectorSqrt(XMVector4Dot(v, v)); }
+
+	// Zero length vectors stay zero
+	inline XMVECTOR XMVector3Normalize(FXMVECTOR v)
+	{
+		float length = XMVectorGetX(XMVector3Length(v));
+		if (length > 0)
+			length = 1.0f / length;
+		return XMVectorScale(v, length);
+	}
+
+	inline XMVECTOR XMVector4Normalize(FXMVECTOR v)
+	{
+		float length = XMVectorGetX(XMVector4Length(v));
+		if (length > 0)
+			length = 1.0f / length;
+		return XMVectorScale(v, length);
+	}
+
+	inline bool XMVector3Equal(FXMVECTOR a, FXMVECTOR b)
+	{
+		return a.vector4_f32[0] == b.vector4_f32[0] && a.vector4_f32[1] == b.vector4_f32[1] && a.vector4_f32[2] == b.vector4_f32[2];
+	}
+
+	inline bool XMVector3LessOrEqual(FXMVECTOR a, FXMVECTOR b)
+	{
+		return a.vector4_f32[0] <= b.vector4_f32[0] && a.vector4_f32[1] <= b.vector4_f32[1] && a.vector4_f32[2] <= b.vector4_f32[2];
+	}
+
+	// Rows of m times (v.x, v.y, v.z, 1)
+	inline XMVECTOR XMVector3Transform(FXMVECTOR v, FXMMATRIX m)
+	{
+		XMVECTOR r = m.r[3];
+		r = XMVectorMultiplyAdd(XMVectorSplatZ(v), m.r[2], r);
+		r = XMVectorMultiplyAdd(XMVectorSplatY(v), m.r[1], r);
+		return XMVectorMultiplyAdd(XMVectorSplatX(v), m.r[0], r);
+	}
+
+	// Same, divided by the resulting w
+	inline XMVECTOR XMVector3TransformCoord(FXMVECTOR v, FXMMATRIX m)
+	{
+		XMVECTOR r = XMVector3Transform(v, m);
+		return XMVectorDivide(r, XMVectorSplatW(r));
+	}
+
+	// Same, ignoring the translation row
+	inline XMVECTOR XMVector3TransformNormal(FXMVECTOR v, FXMMATRIX m)
+	{
+		XMVECTOR r = XMVectorMultiply(XMVectorSplatZ(v), m.r[2]);
+		r = XMVectorMultiplyAdd(XMVectorSplatY(v), m.r[1], r);
+		return XMVectorMultiplyAdd(XMVectorSplatX(v), m.r[0], r);
+	}
+
+	inline XMVECTOR XMVector4Transform(FXMVECTOR v, FXMMATRIX m)
+	{
+		XMVECTOR r = XMVectorMultiply(XMVectorSplatW(v), m.r[3]);
+		r = XMVectorMultiplyAdd(XMVectorSplatZ(v), m.r[2], r);
+		r = XMVectorMultiplyAdd(XMVectorSplatY(v), m.r[1], r);
+		return XMVectorMultiplyAdd(XMVectorSplatX(v), m.r[0], r);
+	}
+
+	// --------------------------------------------------------
+	// Planes (a, b, c, d for ax + by + cz + d = 0)
+	// --------------------------------------------------------
+	inline XMVECTOR XMPlaneDotCoord(FXMVECTOR plane, FXMVECTOR point)
+	{
+		return XMVector4Dot(plane, XMVectorSetW(point, 1.0f));
+	}
+
+	// Scales the plane so (a, b, c) has unit length
+	inline XMVECTOR XMPlaneNormalize(FXMVECTOR plane)
+	{
+		float length = XMVectorGetX(XMVector3Length(plane));
+		if (length > 0)
+			length = 1.0f / length;
+		return XMVectorScale(plane, length);
+	}
+
+	// --------------------------------------------------------
+	// Quaternions (x, y, z, w with w the scalar part)
+	// --------------------------------------------------------
+	inline XMVECTOR XMQuaternionIdentity() { return XMVectorSet(0, 0, 0, 1); }
+	inline XMVECTOR XMQuaternionNormalize(FXMVECTOR q) { return XMVector4Normalize(q); }
+	inline XMVECTOR XMQuaternionConjugate(FXMVECTOR q) { return XMVectorSet(-q.vector4_f32[0], -q.vector4_f32[1], -q.vector4_f32[2], q.vector4_f32[3]); }
+
+	// The rotation of a followed by the rotation of b (the product b * a)
+	inline XMVECTOR XMQuaternionMultiply(FXMVECTOR a, FXMVECTOR b)
+	{
+		float ax = a.vector4_f32[0], ay = a.vector4_f32[1], az = a.vector4_f32[2], aw = a.vector4_f32[3];
+		float bx = b.vector4_f32[0], by = b.vector4_f32[1], bz = b.vector4_f32[2], bw = b.vector4_f32[3];
+		return XMVectorSet(
+			bw * ax + bx * aw + by * az - bz * ay,
+			bw * ay - bx * az + by * aw + bz * ax,
+			bw * az + bx * ay - by * ax + bz * aw,
+			bw * aw - bx * ax - by * ay - bz * az);
+	}
+
+	// Roll around z, then pitch around x, then yaw around y
+	inline XMVECTOR XMQuaternionRotationRollPitchYaw(float pitch, float yaw, float roll)
+	{
+		float sp = std::sin(pitch * 0.5f), cp = std::cos(pitch * 0.5f);
+		float sy = std::sin(yaw * 0.5f), cy = std::cos(yaw * 0.5f);
+		float sr = std::sin(roll * 0.5f), cr = std::cos(roll * 0.5f);
+		return XMVectorSet(
+			cr * sp * cy + sr * cp * sy,
+			cr * cp * sy - sr * sp * cy,
+			sr * cp * cy - cr * sp * sy,
+			cr * cp * cy + sr * sp * sy);
+	}
+
+	inline XMVECTOR XMVector3Rotate(FXMVECTOR v, FXMVECTOR q)
+	{
+		XMVECTOR a = XMVectorSetW(v, 0.0f);
+		return XMQuaternionMultiply(XMQuaternionMultiply(XMQuaternionConjugate(q), a), q);
+	}
+
+	// --------------------------------------------------------
+	// Matrices
+	// --------------------------------------------------------
+	inline XMMATRIX XMMatrixSet(
+		float m00, float m01, float m02, float m03,
+		float m10, float m11, float m12, float m13,
+		float m20, float m21, float m22, float m23,
+		float m30, float m31, float m32, float m33)
+	{
+		XMMATRIX m;
+		m.r[0] = XMVectorSet(m00, m01, m02, m03);
+		m.r[1] = XMVectorSet(m10, m11, m12, m13);
+		m.r[2] = XMVectorSet(m20, m21, m22, m23);
+		m.r[3] = XMVectorSet(m30, m31, m32, m33);
+		return m;
+	}
+
+	inline XMMATRIX XMMatrixIdentity()
+	{
+		return XMMatrixSet(
+			1, 0, 0, 0,
+			0, 1, 0, 0,
+			0, 0, 1, 0,
+			0, 0, 0, 1);
+	}
+
+	inline XMMATRIX XMMatrixMultiply(FXMMATRIX a, CXMMATRIX b)
+	{
+		XMMATRIX r;
+		for (int row = 0; row < 4; row++)
+			r.r[row] = XMVector4Transform(a.r[row], b);
+		return r;
+	}
+
+	inline XMMATRIX XMMatrixTranspose(FXMMATRIX m)
+	{
+		XMMATRIX r;
+		for (int row = 0; row < 4; row++)
+			for (int column = 0; column < 4; column++)
+				r.r[row].vector4_f32[column] = m.r[column].vector4_f32[row];
+		return r;
+	}
+
+	// Cofactors over the determinant, in float like DirectXMath. The
+	// determinant is written to every lane of determinant, if given.
+	inline XMMATRIX XMMatrixInverse(XMVECTOR* determinant, FXMMATRIX m)
+	{
+		float a[16];
+		for (int i = 0; i < 16; i++)
+			a[i] = m.r[i / 4].vector4_f32[i % 4];
+
+		float c[16];
+		c[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+		c[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+		c[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+		c[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+		c[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+		c[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+		c[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+		c[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+		c[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+		c[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+		c[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+		c[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+		c[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+		c[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+		c[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+		c[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+		float det = a[0] * c[0] + a[1] * c[4] + a[2] * c[8] + a[3] * c[12];
+		if (determinant)
+			*determinant = XMVectorReplicate(det);
+
+		float reciprocal = 1.0f / det;
+		XMMATRIX r;
+		for (int i = 0; i < 16; i++)
+			r.r[i / 4].vector4_f32[i % 4] = c[i] * reciprocal;
+		return r;
+	}
+
+	inline XMMATRIX XMMatrixScaling(float x, float y, float z)
+	{
+		return XMMatrixSet(
+			x, 0, 0, 0,
+			0, y, 0, 0,
+			0, 0, z, 0,
+			0, 0, 0, 1);
+	}
+
+	inline XMMATRIX XMMatrixScalingFromVector(FXMVECTOR scale)
+	{
+		return XMMatrixScaling(XMVectorGetX(scale), XMVectorGetY(scale), XMVectorGetZ(scale));
+	}
+
+	inline XMMATRIX XMMatrixTranslation(float x, float y, float z)
+	{
+		return XMMatrixSet(
+			1, 0, 0, 0,
+			0, 1, 0, 0,
+			0, 0, 1, 0,
+			x, y, z, 1);
+	}
+
+	inline XMMATRIX XMMatrixTranslationFromVector(FXMVECTOR offset)
+	{
+		return XMMatrixTranslation(XMVectorGetX(offset), XMVectorGetY(offset), XMVectorGetZ(offset));
+	}
+
+	inline XMMATRIX XMMatrixRotationQuaternion(FXMVECTOR q)
+	{
+		float x = q.vector4_f32[0], y = q.vector4_f32[1], z = q.vector4_f32[2], w = q.vector4_f32[3];
+		return XMMatrixSet(
+			1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w), 0,
+			2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w), 0,
+			2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y), 0,
+			0, 0, 0, 1);
+	}
+
+	// Same order as XMQuaternionRotationRollPitchYaw
+	inline XMMATRIX XMMatrixRotationRollPitchYaw(float pitch, float yaw, float roll)
+	{
+		float sp = std::sin(pitch), cp = std::cos(pitch);
+		float sy = std::sin(yaw), cy = std::cos(yaw);
+		float sr = std::sin(roll), cr = std::cos(roll);
+		return XMMatrixSet(
+			cr * cy + sr * sp * sy, sr * cp, sr * sp * cy - cr * sy, 0,
+			cr * sp * sy - sr * cy, cr * cp, sr * sy + cr * sp * cy, 0,
+			cp * sy, -sp, cp * cy, 0,
+			0, 0, 0, 1);
+	}
+
+	inline XMMATRIX XMMatrixLookToLH(FXMVECTOR eyePosition, FXMVECTOR eyeDirection, FXMVECTOR upDirection)
+	{
+		XMVECTOR zAxis = XMVector3Normalize(eyeDirection);
+		XMVECTOR xAxis = XMVector3Normalize(XMVector3Cross(upDirection, zAxis));
+		XMVECTOR yAxis = XMVector3Cross(zAxis, xAxis);
+		XMVECTOR negativeEye = XMVectorNegate(eyePosition);
+		return XMMatrixSet(
+			XMVectorGetX(xAxis), XMVectorGetX(yAxis), XMVectorGetX(zAxis), 0,
+			XMVectorGetY(xAxis), XMVectorGetY(yAxis), XMVectorGetY(zAxis), 0,
+			XMVectorGetZ(xAxis), XMVectorGetZ(yAxis), XMVectorGetZ(zAxis), 0,
+			XMVectorGetX(XMVector3Dot(xAxis, negativeEye)),
+			XMVectorGetX(XMVector3Dot(yAxis, negativeEye)),
+			XMVectorGetX(XMVector3Dot(zAxis, negativeEye)),
+			1);
+	}
+
+	inline XMMATRIX XMMatrixPerspectiveFovLH(float fovAngleY, float aspectRatio, float nearZ, float farZ)
+	{
+		float height = 1.0f / std::tan(fovAngleY * 0.5f);
+		float width = height / aspectRatio;
+		float range = farZ / (farZ - nearZ);
+		return XMMatrixSet(
+			width, 0, 0, 0,
+			0, height, 0, 0,
+			0, 0, range, 1,
+			0, 0, -range * nearZ, 0);
+	}
+
+	inline XMMATRIX XMMatrixOrthographicLH(float viewWidth, float viewHeight, float nearZ, float farZ)
+	{
+		float range = 1.0f / (farZ - nearZ);
+		return XMMatrixSet(
+			2.0f / viewWidth, 0, 0, 0,
+			0, 2.0f / viewHeight, 0, 0,
+			0, 0, range, 0,
+			0, 0, -range * nearZ, 1);
+	}
+
+	// --------------------------------------------------------
+	// Operators (as DirectXMath defines them for XMVECTOR and
+	// XMMATRIX)
+	// --------------------------------------------------------
+	inline XMVECTOR operator+(FXMVECTOR v) { return v; }
+	inline XMVECTOR operator-(FXMVECTOR v) { return XMVectorNegate(v); }
+	inline XMVECTOR operator+(FXMVECTOR a, FXMVECTOR b) { return XMVectorAdd(a, b); }
+	inline XMVECTOR operator-(FXMVECTOR a, FXMVECTOR b) { return XMVectorSubtract(a, b); }
+	inline XMVECTOR operator*(FXMVECTOR a, FXMVECTOR b) { return XMVectorMultiply(a, b); }
+	inline XMVECTOR operator/(FXMVECTOR a, FXMVECTOR b) { return XMVectorDivide(a, b); }
+	inline XMVECTOR operator*(FXMVECTOR v, float s) { return XMVectorScale(v, s); }
+	inline XMVECTOR operator*(float s, FXMVECTOR v) { return XMVectorScale(v, s); }
+	inline XMVECTOR operator/(FXMVECTOR v, float s) { return XMVectorScale(v, 1.0f / s); }
+	inline XMVECTOR& operator+=(XMVECTOR& a, FXMVECTOR b) { a = XMVectorAdd(a, b); return a; }
+	inline XMVECTOR& operator-=(XMVECTOR& a, FXMVECTOR b) { a = XMVectorSubtract(a, b); return a; }
+	inline XMVECTOR& operator*=(XMVECTOR& a, FXMVECTOR b) { a = XMVectorMultiply(a, b); return a; }
+	inline XMVECTOR& operator/=(XMVECTOR& a, FXMVECTOR b) { a = XMVectorDivide(a, b); return a; }
+	inline XMVECTOR& operator*=(XMVECTOR& v, float s) { v = XMVectorScale(v, s); return v; }
+	inline XMVECTOR& operator/=(XMVECTOR& v, float s) { v = XMVectorScale(v, 1.0f / s); return v; }
+
+	inline XMMATRIX operator*(FXMMATRIX a, CXMMATRIX b) { return XMMatrixMultiply(a, b); }
+	inline XMMATRIX& operator*=(XMMATRIX& a, CXMMATRIX b) { a = XMMatrixMultiply(a, b); return a; }
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+
+// The packed formats from DirectXPackedVector.h that the compact vertex
+// formats use, for builds without the real headers (see DirectXMath.h
+// in this folder). Conversions round the same way DirectXMath does.
+
+#include "DirectXMath.h"
+
+namespace DirectX
+{
+	namespace PackedVector
+	{
+		using HALF = uint16_t;
+
+		struct XMHALF2
+		{
+			HALF x;
+			HALF y;
+		};
+
+		struct XMSHORTN2
+		{
+			int16_t x;
+			int16_t y;
+		};
+
+		struct XMSHORTN4
+		{
+			int16_t x;
+			int16_t y;
+			int16_t z;
+			int16_t w;
+		};
+
+		struct XMUSHORTN4
+		{
+			uint16_t x;
+			uint16_t y;
+			uint16_t z;
+			uint16_t w;
+		};
+
+		// Round to nearest even, with overflow going to infinity
+		inline HALF XMConvertFloatToHalf(float value)
+		{
+			uint32_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			uint32_t sign = (bits & 0x80000000u) >> 16;
+			bits &= 0x7FFFFFFFu;
+
+			uint32_t result;
+			if (bits >= 0x47800000u)
+			{
+				// Too large for a half: infinity, or NaN kept as NaN
+				result = 0x7C00u | (bits > 0x7F800000u ? (0x200u | ((bits >> 13) & 0x3FFu)) : 0u);
+			}
+			else if (bits <= 0x33000000u)
+			{
+				result = 0;
+			}
+			else if (bits < 0x38800000u)
+			{
+				// Too small to be normalized, so denormalized
+				uint32_t shift = 125u - (bits >> 23);
+				bits = 0x800000u | (bits & 0x7FFFFFu);
+				result = bits >> (shift + 1);
+				uint32_t sticky = (bits & ((1u << shift) - 1)) != 0;
+				result += (result | sticky) & ((bits >> shift) & 1u);
+			}
+			else
+			{
+				// Rebias the exponent
+				bits += 0xC8000000u;
+				result = ((bits + 0x0FFFu + ((bits >> 13) & 1u)) >> 13) & 0x7FFFu;
+			}
+			return (HALF)(result | sign);
+		}
+
+		inline float XMConvertHalfToFloat(HALF value)
+		{
+			uint32_t mantissa = value & 0x03FFu;
+			uint32_t exponent = value & 0x7C00u;
+			if (exponent == 0x7C00u)
+			{
+				exponent = 0x8Fu;
+			}
+			else if (exponent != 0)
+			{
+				exponent = (value >> 10) & 0x1Fu;
+			}
+			else if (mantissa != 0)
+			{
+				// Denormalized, so normalize it for the float
+				exponent = 1;
+				do
+				{
+					exponent--;
+					mantissa <<= 1;
+				} while ((mantissa & 0x0400u) == 0);
+				mantissa &= 0x03FFu;
+			}
+			else
+			{
+				exponent = (uint32_t)-112;
+			}
+
+			uint32_t bits = ((value & 0x8000u) << 16) | ((exponent + 112) << 23) | (mantissa << 13);
+			float result;
+			memcpy(&result, &bits, sizeof(result));
+			return result;
+		}
+
+		inline XMVECTOR XMLoadHalf2(const XMHALF2* source)
+		{
+			return XMVectorSet(XMConvertHalfToFloat(source->x), XMConvertHalfToFloat(source->y), 0, 0);
+		}
+
+		inline void XMStoreHalf2(XMHALF2* destination, FXMVECTOR v)
+		{
+			destination->x = XMConvertFloatToHalf(XMVectorGetX(v));
+			destination->y = XMConvertFloatToHalf(XMVectorGetY(v));
+		}
+
+		// -32768 decodes to -1, the same as -32767
+		inline XMVECTOR XMLoadShortN2(const XMSHORTN2* source)
+		{
+			XMVECTOR v = XMVectorSet(source->x, source->y, 0, 0);
+			return XMVectorMax(XMVectorScale(v, 1.0f / 32767.0f), XMVectorReplicate(-1.0f));
+		}
+
+		inline XMVECTOR XMLoadShortN4(const XMSHORTN4* source)
+		{
+			XMVECTOR v = XMVectorSet(source->x, source->y, source->z, source->w);
+			return XMVectorMax(XMVectorScale(v, 1.0f / 32767.0f), XMVectorReplicate(-1.0f));
+		}
+
+		inline void XMStoreShortN2(XMSHORTN2* destination, FXMVECTOR v)
+		{
+			XMVECTOR n = XMVectorClamp(v, XMVectorReplicate(-1.0f), XMVectorSplatOne());
+			n = XMVectorRound(XMVectorScale(n, 32767.0f));
+			destination->x = (int16_t)XMVectorGetX(n);
+			destination->y = (int16_t)XMVectorGetY(n);
+		}
+
+		inline void XMStoreShortN4(XMSHORTN4* destination, FXMVECTOR v)
+		{
+			XMVECTOR n = XMVectorClamp(v, XMVectorReplicate(-1.0f), XMVectorSplatOne());
+			n = XMVectorRound(XMVectorScale(n, 32767.0f));
+			destination->x = (int16_t)XMVectorGetX(n);
+			destination->y = (int16_t)XMVectorGetY(n);
+			destination->z = (int16_t)XMVectorGetZ(n);
+			destination->w = (int16_t)XMVectorGetW(n);
+		}
+
+		inline XMVECTOR XMLoadUShortN4(const XMUSHORTN4* source)
+		{
+			XMVECTOR v = XMVectorSet(source->x, source->y, source->z, source->w);
+			return XMVectorScale(v, 1.0f / 65535.0f);
+		}
+
+		inline void XMStoreUShortN4(XMUSHORTN4* destination, FXMVECTOR v)
+		{
+			XMVECTOR n = XMVectorRound(XMVectorScale(XMVectorSaturate(v), 65535.0f));
+			destination->x = (uint16_t)XMVectorGetX(n);
+			destination->y = (uint16_t)XMVectorGetY(n);
+			destination->z = (uint16_t)XMVectorGetZ(n);
+			destination->w = (uint16_t)XMVectorGetW(n);
+		}
+	}
+}
\ No newline at end of file
@@ -7,9 +7,44 @@ struct VertexInput
     float3 localPosition : POSITION; // XYZ position
     float3 normal : NORMAL; // Normal vector
     float2 uv : TEXCOORD; // UV texture coordinates
-    float3 tangent : TANGENT; // Tangent vector
+    float4 tangent : TANGENT; // Tangent vector (w is the handedness)
 };
 
+// Vertex stored in one of the compact formats (see CompactVertex.h)
+// - Quantized positions arrive as 0-1 fractions of the mesh bounds,
+//   which the dequantize matrix maps back into place
+// - Directions are octahedral encoded, UVs are half floats
+// - The tangent's handedness is in z of the tangent (exactly -1 or 1),
+//   or for quantized positions in w of the position (0 or 1). Each
+//   format leaves the other's at its default (z = 0, w = 1).
+struct CompactVertexInput
+{
+    float4 localPosition : POSITION;
+    float2 normal : NORMAL;
+    float2 uv : TEXCOORD;
+    float3 tangent : TANGENT;
+};
+
+// Unfolds an octahedral encoded direction back into a unit vector
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 direction = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float unfold = saturate(-direction.z);
+    direction.xy += (direction.xy >= 0.0f) ? -unfold : unfold;
+    return normalize(direction);
+}
+
+VertexInput DecodeCompactVertex(CompactVertexInput input)
+{
+    VertexInput output;
+    output.localPosition = input.localPosition.xyz;
+    output.normal = DecodeOctahedral(input.normal);
+    output.uv = input.uv;
+    bool mirrored = input.tangent.z < 0.0f || input.localPosition.w < 0.5f;
+    output.tangent = float4(DecodeOctahedral(input.tangent.xy), mirrored ? -1.0f : 1.0f);
+    return output;
+}
+
 // Data that gets sent from the vertex shader to the pixel shader
 struct VertexToPixel
 {
@@ -18,7 +53,7 @@ struct VertexToPixel
     float4 shadowPosition : SHADOW_POSITION;
     float3 worldNormal : NORMAL;
     float2 uv : TEXCOORD;
-    float3 worldTangent : TANGENT;
+    float4 worldTangent : TANGENT;
 };
 
 #endif
\ No newline at end of file
@@ -19,4 +19,5 @@ struct ShadowSettings
 	float projectionSize = 22.0f;
 
 	Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader = nullptr;
+	Microsoft::WRL::ComPtr<ID3D11VertexShader> compactVertexShader = nullptr;
 };
\ No newline at end of file
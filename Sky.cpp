@@ -35,6 +35,10 @@ Sky::~Sky() {}
 
 void Sky::Draw(Camera* camera)
 {
+	// The cube may still be loading
+	if (!mesh->IsReady())
+		return;
+
 	// Set rasterizer and depth states
 	Graphics::Context->RSSetState(rasterizerState.Get());
 	Graphics::Context->OMSetDepthStencilState(depthState.Get(), 0);
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+// A contiguous range of a mesh's index buffer whose triangles share
+// one object (or group) and one material
+struct Submesh
+{
+	unsigned int indexStart;
+	unsigned int indexCount;
+	std::string name;			// From the last "o" or "g" line (may be empty)
+	std::string materialName;	// From the last "usemtl" line (may be empty)
+};
\ No newline at end of file
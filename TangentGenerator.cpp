@@ -0,0 +1,448 @@
+#include "TangentGenerator.h"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <DirectXMath.h>
+
+using namespace DirectX;
+
+namespace
+{
+	// Below this many triangles per thread, starting threads costs more than it saves
+	const size_t minTrianglesPerThread = 16384;
+
+	// Which sides of a UV mirror seam have touched a vertex
+	const unsigned char positiveSide = 1;
+	const unsigned char negativeSide = 2;
+
+	// Splits [0, count) into one contiguous range per thread and runs
+	// work(begin, end) on each, returning once all of them are done
+	template<typename Work>
+	void RunParallel(size_t count, unsigned int threadCount, Work work)
+	{
+		if (threadCount <= 1)
+		{
+			work((size_t)0, count);
+			return;
+		}
+
+		std::vector<std::thread> workers;
+		workers.reserve(threadCount);
+		for (unsigned int i = 0; i < threadCount; i++)
+			workers.emplace_back(work, count * i / threadCount, count * (i + 1) / threadCount);
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	unsigned int PickThreadCount(size_t triangleCount, unsigned int threadCount)
+	{
+		if (threadCount != 0)
+			return threadCount;
+
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+		return (unsigned int)std::max<size_t>(1, std::min<size_t>(threadCount, triangleCount / minTrianglesPerThread));
+	}
+
+	// Summed tangents and bitangents of the triangles around a vertex
+	struct FrameSum
+	{
+		XMFLOAT3 tangent;
+		XMFLOAT3 bitangent;
+	};
+
+	void AddTo(FrameSum& sum, const float* frame)
+	{
+		sum.tangent.x += frame[0];
+		sum.tangent.y += frame[1];
+		sum.tangent.z += frame[2];
+		sum.bitangent.x += frame[3];
+		sum.bitangent.y += frame[4];
+		sum.bitangent.z += frame[5];
+	}
+
+	// Everything the triangle pass found, summed per vertex. When seams
+	// may be split, triangles whose uvs are mirrored (negative determinant)
+	// go in their own sums, so that needs no other pass over the triangles.
+	// Otherwise every triangle goes in the positive sums.
+	struct Accumulation
+	{
+		std::vector<FrameSum> positive;
+		std::vector<FrameSum> negative;		// Empty unless mirrored triangles are kept apart
+		std::vector<unsigned char> sides;	// Same
+		std::vector<signed char> orientations;	// Per triangle: 1, -1 if its uvs are mirrored, 0 if it was ignored
+		unsigned int degenerateTriangles;
+	};
+
+	// One component of the same corner of four triangles, one per lane
+	struct Corners
+	{
+		XMVECTOR x, y, z, u, v;
+	};
+
+	Corners LoadCorners(const Vertex* vertices, const unsigned int* triangles, int corner)
+	{
+		const Vertex& a = vertices[triangles[corner]];
+		const Vertex& b = vertices[triangles[corner + 3]];
+		const Vertex& c = vertices[triangles[corner + 6]];
+		const Vertex& d = vertices[triangles[corner + 9]];
+		return Corners{
+			XMVectorSet(a.Position.x, b.Position.x, c.Position.x, d.Position.x),
+			XMVectorSet(a.Position.y, b.Position.y, c.Position.y, d.Position.y),
+			XMVectorSet(a.Position.z, b.Position.z, c.Position.z, d.Position.z),
+			XMVectorSet(a.UV.x, b.UV.x, c.UV.x, d.UV.x),
+			XMVectorSet(a.UV.y, b.UV.y, c.UV.y, d.UV.y) };
+	}
+
+	// --------------------------------------------------------
+	// Calculates the tangent and bitangent of the triangles in
+	// [begin, end), four at a time with one per SIMD lane, and
+	// hands each to output(triangle, frame, determinant) in
+	// triangle order. Triangles with no uv area, or with results
+	// that aren't finite, are masked to a zero frame and
+	// determinant instead of branching.
+	// --------------------------------------------------------
+	template<typename Output>
+	void CalculateFrames(const Vertex* vertices, const unsigned int* indices, size_t begin, size_t end, Output&& output)
+	{
+		XMVECTOR largest = XMVectorReplicate(FLT_MAX);
+		XMVECTOR smallest = XMVectorReplicate(FLT_MIN);
+
+		size_t t = begin;
+		for (; t + 4 <= end; t += 4)
+		{
+			const unsigned int* triangles = indices + t * 3;
+			Corners c0 = LoadCorners(vertices, triangles, 0);
+			Corners c1 = LoadCorners(vertices, triangles, 1);
+			Corners c2 = LoadCorners(vertices, triangles, 2);
+
+			// Vectors relative to the first corner, in position and uv space
+			XMVECTOR x1 = XMVectorSubtract(c1.x, c0.x);
+			XMVECTOR y1 = XMVectorSubtract(c1.y, c0.y);
+			XMVECTOR z1 = XMVectorSubtract(c1.z, c0.z);
+			XMVECTOR x2 = XMVectorSubtract(c2.x, c0.x);
+			XMVECTOR y2 = XMVectorSubtract(c2.y, c0.y);
+			XMVECTOR z2 = XMVectorSubtract(c2.z, c0.z);
+			XMVECTOR s1 = XMVectorSubtract(c1.u, c0.u);
+			XMVECTOR t1 = XMVectorSubtract(c1.v, c0.v);
+			XMVECTOR s2 = XMVectorSubtract(c2.u, c0.u);
+			XMVECTOR t2 = XMVectorSubtract(c2.v, c0.v);
+
+			XMVECTOR determinant = XMVectorSubtract(XMVectorMultiply(s1, t2), XMVectorMultiply(s2, t1));
+			XMVECTOR r = XMVectorReciprocal(determinant);
+
+			XMVECTOR results[6] =
+			{
+				XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(t2, x1), XMVectorMultiply(t1, x2)), r),
+				XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(t2, y1), XMVectorMultiply(t1, y2)), r),
+				XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(t2, z1), XMVectorMultiply(t1, z2)), r),
+				XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(s1, x2), XMVectorMultiply(s2, x1)), r),
+				XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(s1, y2), XMVectorMultiply(s2, y1)), r),
+				XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(s1, z2), XMVectorMultiply(s2, z1)), r)
+			};
+
+			// Lanes with a usable determinant and only finite results
+			// (NaN fails every comparison, so it's caught here too)
+			XMVECTOR valid = XMVectorGreater(XMVectorAbs(determinant), smallest);
+			for (XMVECTOR& component : results)
+				valid = XMVectorAndInt(valid, XMVectorLessOrEqual(XMVectorAbs(component), largest));
+
+			XMFLOAT4 lanes[7];
+			for (int c = 0; c < 6; c++)
+				XMStoreFloat4(&lanes[c], XMVectorAndInt(results[c], valid));
+			XMStoreFloat4(&lanes[6], XMVectorAndInt(determinant, valid));
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				float frame[7];
+				for (int c = 0; c < 7; c++)
+					frame[c] = (&lanes[c].x)[lane];
+				output(t + lane, frame, frame[6]);
+			}
+		}
+
+		// Leftover triangles, with the same math one at a time
+		for (; t < end; t++)
+		{
+			const Vertex& v0 = vertices[indices[t * 3]];
+			const Vertex& v1 = vertices[indices[t * 3 + 1]];
+			const Vertex& v2 = vertices[indices[t * 3 + 2]];
+
+			float x1 = v1.Position.x - v0.Position.x;
+			float y1 = v1.Position.y - v0.Position.y;
+			float z1 = v1.Position.z - v0.Position.z;
+			float x2 = v2.Position.x - v0.Position.x;
+			float y2 = v2.Position.y - v0.Position.y;
+			float z2 = v2.Position.z - v0.Position.z;
+
+			float s1 = v1.UV.x - v0.UV.x;
+			float t1 = v1.UV.y - v0.UV.y;
+			float s2 = v2.UV.x - v0.UV.x;
+			float t2 = v2.UV.y - v0.UV.y;
+
+			float determinant = s1 * t2 - s2 * t1;
+			float r = 1.0f / determinant;
+			float frame[6] =
+			{
+				(t2 * x1 - t1 * x2) * r,
+				(t2 * y1 - t1 * y2) * r,
+				(t2 * z1 - t1 * z2) * r,
+				(s1 * x2 - s2 * x1) * r,
+				(s1 * y2 - s2 * y1) * r,
+				(s1 * z2 - s2 * z1) * r
+			};
+
+			bool valid = std::abs(determinant) > FLT_MIN;
+			for (float component : frame)
+				valid = valid && std::abs(component) <= FLT_MAX;
+
+			if (!valid)
+			{
+				for (float& component : frame)
+					component = 0.0f;
+				determinant = 0.0f;
+			}
+			output(t, frame, determinant);
+		}
+	}
+
+	// --------------------------------------------------------
+	// Sums the frames of the triangles around every vertex, so
+	// each vertex adds them up in triangle order whichever way
+	// the work is split:
+	// - One thread scatters each triangle's frame into its
+	//    corners as soon as it's calculated, with nothing
+	//    stored per triangle
+	// - More threads first calculate every triangle's frame
+	//    (split by triangle), then each gathers for its own
+	//    vertices from a list of the triangles around every
+	//    vertex (split by vertex). No two threads ever write to
+	//    the same vertex, so no locks or partial sums.
+	// Either way the sums match bit for bit.
+	// --------------------------------------------------------
+	Accumulation Accumulate(const Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, size_t triangleCount, unsigned int threadCount, bool keepMirroredApart)
+	{
+		Accumulation result = {};
+		result.orientations.resize(triangleCount);
+		result.positive.assign(vertexCount, FrameSum{});
+		if (keepMirroredApart)
+		{
+			result.negative.assign(vertexCount, FrameSum{});
+			result.sides.assign(vertexCount, 0);
+		}
+
+		auto orientationOf = [](float determinant) -> signed char
+		{
+			return determinant > 0.0f ? 1 : determinant < 0.0f ? -1 : 0;
+		};
+		auto add = [&](unsigned int vertex, const float* frame, signed char orientation)
+		{
+			if (!keepMirroredApart)
+			{
+				AddTo(result.positive[vertex], frame);
+			}
+			else if (orientation > 0)
+			{
+				AddTo(result.positive[vertex], frame);
+				result.sides[vertex] |= positiveSide;
+			}
+			else if (orientation < 0)
+			{
+				AddTo(result.negative[vertex], frame);
+				result.sides[vertex] |= negativeSide;
+			}
+		};
+
+		if (threadCount <= 1)
+		{
+			CalculateFrames(vertices, indices, 0, triangleCount, [&](size_t triangle, const float* frame, float determinant)
+				{
+					signed char orientation = orientationOf(determinant);
+					result.orientations[triangle] = orientation;
+					for (size_t i = triangle * 3; i < triangle * 3 + 3; i++)
+						add(indices[i], frame, orientation);
+				});
+		}
+		else
+		{
+			// Tangent (xyz) and bitangent (xyz) of every triangle, six floats each
+			std::vector<float> frames(triangleCount * 6);
+			RunParallel(triangleCount, threadCount, [&](size_t begin, size_t end)
+				{
+					CalculateFrames(vertices, indices, begin, end, [&](size_t triangle, const float* frame, float determinant)
+						{
+							std::copy(frame, frame + 6, &frames[triangle * 6]);
+							result.orientations[triangle] = orientationOf(determinant);
+						});
+				});
+
+			std::vector<unsigned int> adjacencyStart(vertexCount + 1, 0);
+			for (size_t i = 0; i < triangleCount * 3; i++)
+				adjacencyStart[indices[i] + 1]++;
+			for (unsigned int i = 0; i < vertexCount; i++)
+				adjacencyStart[i + 1] += adjacencyStart[i];
+
+			std::vector<unsigned int> adjacency(triangleCount * 3);
+			{
+				std::vector<unsigned int> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+				for (size_t i = 0; i < triangleCount * 3; i++)
+					adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+			}
+
+			RunParallel(vertexCount, threadCount, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+						for (unsigned int a = adjacencyStart[i]; a < adjacencyStart[i + 1]; a++)
+							add((unsigned int)i, &frames[(size_t)adjacency[a] * 6], result.orientations[adjacency[a]]);
+				});
+		}
+
+		result.degenerateTriangles = (unsigned int)std::count(result.orientations.begin(), result.orientations.end(), 0);
+		return result;
+	}
+
+	// --------------------------------------------------------
+	// Turns summed triangle frames into a vertex tangent: the
+	// tangent is orthogonalized against the normal (Gram-Schmidt)
+	// and w is -1 where the summed bitangent points the other way
+	// from the usual layout. The .obj import flips v, so for
+	// unmirrored uvs that's cross(normal, tangent), and the
+	// shader's cross(tangent, normal) * w matches the bitangent
+	// normal maps are authored for. If nothing usable is left (no valid
+	// triangles, or the tangent lies along the normal) any unit
+	// vector perpendicular to the normal is used instead.
+	// Returns false when it had to fall back.
+	// --------------------------------------------------------
+	bool BuildTangent(const XMFLOAT3& vertexNormal, const FrameSum& sum, XMFLOAT4& output)
+	{
+		XMVECTOR normal = XMLoadFloat3(&vertexNormal);
+		XMVECTOR summed = XMLoadFloat3(&sum.tangent);
+		XMVECTOR tangent = summed - normal * XMVector3Dot(normal, summed);
+
+		// Comparisons are written so NaN takes the fallback path
+		float length = XMVectorGetX(XMVector3LengthSq(tangent));
+		if (length > 1e-8f * XMVectorGetX(XMVector3LengthSq(summed)) && length <= FLT_MAX)
+		{
+			tangent = XMVector3Normalize(tangent);
+			float handedness = XMVectorGetX(XMVector3Dot(XMVector3Cross(normal, tangent), XMLoadFloat3(&sum.bitangent)));
+			XMStoreFloat4(&output, XMVectorSetW(tangent, handedness < 0.0f ? -1.0f : 1.0f));
+			return true;
+		}
+
+		float normalLength = XMVectorGetX(XMVector3LengthSq(normal));
+		if (normalLength > 0.0f && normalLength <= FLT_MAX)
+		{
+			// Cross with whichever axis is furthest from the normal
+			XMVECTOR axis = std::abs(vertexNormal.x) < 0.9f ? XMVectorSet(1, 0, 0, 0) : XMVectorSet(0, 1, 0, 0);
+			tangent = XMVector3Normalize(XMVector3Cross(normal, axis));
+		}
+		else
+		{
+			tangent = XMVectorSet(1, 0, 0, 0);
+		}
+		XMStoreFloat4(&output, XMVectorSetW(tangent, 1.0f));
+		return false;
+	}
+
+	FrameSum Combine(const FrameSum& a, const FrameSum& b)
+	{
+		return FrameSum{
+			XMFLOAT3(a.tangent.x + b.tangent.x, a.tangent.y + b.tangent.y, a.tangent.z + b.tangent.z),
+			XMFLOAT3(a.bitangent.x + b.bitangent.x, a.bitangent.y + b.bitangent.y, a.bitangent.z + b.bitangent.z) };
+	}
+}
+
+// --------------------------------------------------------
+// Author: Chris Cascioli (original scalar version)
+// Purpose: Calculates the tangents of the vertices in a mesh
+//
+// - Code originally adapted from: http://www.terathon.com/code/tangent.html
+//   - Updated version now found here: http://foundationsofgameenginedev.com/FGED2-sample.pdf
+//   - See listing 7.4 in section 7.5 (page 9 of the PDF)
+//
+// See Accumulate() above for how the work is split up
+// --------------------------------------------------------
+TangentGenerator::Stats TangentGenerator::Generate(Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, size_t indexCount, unsigned int threadCount)
+{
+	size_t triangleCount = indexCount / 3;
+	threadCount = PickThreadCount(triangleCount, threadCount);
+	Accumulation sums = Accumulate(vertices, vertexCount, indices, triangleCount, threadCount, false);
+
+	// Without splitting, both sides of a seam share one (averaged) frame
+	std::atomic<unsigned int> fallbackTangents = 0;
+	RunParallel(vertexCount, threadCount, [&](size_t begin, size_t end)
+		{
+			unsigned int fallbacks = 0;
+			for (size_t i = begin; i < end; i++)
+				fallbacks += !BuildTangent(vertices[i].Normal, sums.positive[i], vertices[i].Tangent);
+			fallbackTangents += fallbacks;
+		});
+
+	return Stats{ sums.degenerateTriangles, fallbackTangents, 0 };
+}
+
+// --------------------------------------------------------
+// Same as above, but a vertex used by both mirrored and
+// unmirrored triangles keeps the unmirrored frame and a copy
+// appended to the end gets the mirrored one. Only indices of
+// mirrored triangles are redirected to the copies, so the
+// triangle order (and every submesh range) is unchanged.
+// --------------------------------------------------------
+TangentGenerator::Stats TangentGenerator::Generate(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, bool splitMirrored, unsigned int threadCount)
+{
+	if (!splitMirrored)
+		return Generate(vertices.data(), (unsigned int)vertices.size(), indices.data(), indices.size(), threadCount);
+
+	unsigned int vertexCount = (unsigned int)vertices.size();
+	size_t triangleCount = indices.size() / 3;
+	threadCount = PickThreadCount(triangleCount, threadCount);
+	Accumulation sums = Accumulate(vertices.data(), vertexCount, indices.data(), triangleCount, threadCount, true);
+
+	// Copies are numbered in vertex order, so the result doesn't depend on threads
+	std::vector<unsigned int> copyOf(vertexCount, 0);
+	unsigned int splitCount = 0;
+	for (unsigned int i = 0; i < vertexCount; i++)
+		if (sums.sides[i] == (positiveSide | negativeSide))
+			copyOf[i] = vertexCount + splitCount++;
+	vertices.resize((size_t)vertexCount + splitCount);
+
+	std::atomic<unsigned int> fallbackTangents = 0;
+	RunParallel(vertexCount, threadCount, [&](size_t begin, size_t end)
+		{
+			unsigned int fallbacks = 0;
+			for (size_t i = begin; i < end; i++)
+			{
+				if (copyOf[i] == 0)
+				{
+					fallbacks += !BuildTangent(vertices[i].Normal, Combine(sums.positive[i], sums.negative[i]), vertices[i].Tangent);
+					continue;
+				}
+
+				Vertex& copy = vertices[copyOf[i]];
+				copy = vertices[i];
+				fallbacks += !BuildTangent(vertices[i].Normal, sums.positive[i], vertices[i].Tangent);
+				fallbacks += !BuildTangent(copy.Normal, sums.negative[i], copy.Tangent);
+			}
+			fallbackTangents += fallbacks;
+		});
+
+	if (splitCount > 0)
+	{
+		RunParallel(triangleCount, threadCount, [&](size_t begin, size_t end)
+			{
+				for (size_t t = begin; t < end; t++)
+				{
+					if (sums.orientations[t] >= 0)
+						continue;
+					for (size_t i = t * 3; i < t * 3 + 3; i++)
+						if (copyOf[indices[i]] != 0)
+							indices[i] = copyOf[indices[i]];
+				}
+			});
+	}
+
+	return Stats{ sums.degenerateTriangles, fallbackTangents, splitCount };
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+#include "Vertex.h"
+
+// Calculates per-vertex tangent frames for normal mapping
+namespace TangentGenerator
+{
+	// What had to be fixed up along the way
+	struct Stats
+	{
+		unsigned int degenerateTriangles;	// Zero UV area, or non-finite results (ignored)
+		unsigned int fallbackTangents;		// Vertices with no usable tangent (any perpendicular is used)
+		unsigned int mirrorSplits;			// Vertices duplicated along UV mirror seams
+	};
+
+	// Replaces the tangent of every vertex with the average of the
+	// tangents of the triangles around it, made orthogonal to the normal.
+	// W holds the handedness: the bitangent is cross(tangent, normal) * w.
+	// A thread count of 0 picks one based on the hardware and mesh size.
+	Stats Generate(Vertex* vertices, unsigned int vertexCount, const unsigned int* indices, size_t indexCount, unsigned int threadCount = 0);
+
+	// Same as above, but vertices shared by triangles with mirrored UVs
+	// (opposite handedness) can be split in two, so each side of the seam
+	// gets its own tangent frame. New vertices are appended to the end,
+	// and only the indices of the mirrored triangles change.
+	Stats Generate(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, bool splitMirrored, unsigned int threadCount = 0);
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "TestHarness.h"
+#include "CompactVertex.h"
+
+#include <cfloat>
+#include <random>
+#include <algorithm>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Compact and quantized vertices, round tripped against the
+// full Vertex they were made from
+// --------------------------------------------------------
+
+namespace
+{
+	const XMFLOAT3 BoundsMin(-5.0f, -0.5f, 0.0f);
+	const XMFLOAT3 BoundsMax(5.0f, 2.5f, 40.0f);
+
+	XMFLOAT3 RandomDirection(std::mt19937& random)
+	{
+		std::normal_distribution<float> normal;
+		XMFLOAT3 direction;
+		XMStoreFloat3(&direction, XMVector3Normalize(XMVectorSet(normal(random), normal(random), normal(random), 0)));
+		return direction;
+	}
+
+	std::vector<Vertex> RandomVertices(size_t count)
+	{
+		std::mt19937 random(9);
+		std::uniform_real_distribution<float> x(BoundsMin.x, BoundsMax.x);
+		std::uniform_real_distribution<float> y(BoundsMin.y, BoundsMax.y);
+		std::uniform_real_distribution<float> z(BoundsMin.z, BoundsMax.z);
+		std::uniform_real_distribution<float> uv(-2.0f, 2.0f);
+
+		std::vector<Vertex> vertices(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			Vertex& vertex = vertices[i];
+			vertex.Position = XMFLOAT3(x(random), y(random), z(random));
+			vertex.Normal = RandomDirection(random);
+			vertex.UV = XMFLOAT2(uv(random), uv(random));
+			XMFLOAT3 tangent = RandomDirection(random);
+			vertex.Tangent = XMFLOAT4(tangent.x, tangent.y, tangent.z, i % 3 == 0 ? -1.0f : 1.0f);
+		}
+
+		// The axes and the folds of the octahedron are where encoding
+		// is most likely to go wrong
+		const XMFLOAT3 awkward[] = { { 0, 0, 1 }, { 0, 0, -1 }, { 1, 0, 0 }, { -1, 0, 0 }, { 0, -1, 0 }, { 0.7071068f, 0, -0.7071068f } };
+		for (size_t i = 0; i < std::size(awkward) && i < count; i++)
+		{
+			vertices[i].Normal = awkward[i];
+			vertices[i].Tangent = XMFLOAT4(awkward[i].x, awkward[i].y, awkward[i].z, 1.0f);
+		}
+		return vertices;
+	}
+
+	// From the sine and cosine together, since acos alone loses most of
+	// its precision for the tiny angles being measured here
+	float AngleInDegrees(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		XMVECTOR first = XMLoadFloat3(&a);
+		XMVECTOR second = XMLoadFloat3(&b);
+		float sine = XMVectorGetX(XMVector3Length(XMVector3Cross(first, second)));
+		float cosine = XMVectorGetX(XMVector3Dot(first, second));
+		return XMConvertToDegrees(std::atan2(sine, cosine));
+	}
+
+	XMFLOAT3 TangentOf(const Vertex& vertex)
+	{
+		return XMFLOAT3(vertex.Tangent.x, vertex.Tangent.y, vertex.Tangent.z);
+	}
+
+	// Half floats keep 11 significant bits
+	bool WithinHalfPrecision(float original, float decoded)
+	{
+		return std::fabs(original - decoded) <= std::fabs(original) * (1.0f / 2048.0f) + 1e-7f;
+	}
+}
+
+TEST(StridesMatchTheStructs)
+{
+	CHECK_EQUAL((unsigned int)sizeof(Vertex), VertexCompression::GetStride(VertexFormat::Full));
+	CHECK_EQUAL(28u, VertexCompression::GetStride(VertexFormat::Compact));
+	CHECK_EQUAL(20u, VertexCompression::GetStride(VertexFormat::Quantized));
+}
+
+TEST(CompactVerticesRoundTrip)
+{
+	std::vector<Vertex> vertices = RandomVertices(200000);
+	std::vector<CompactVertex> compact(vertices.size());
+	VertexCompression::Compress(vertices.data(), vertices.size(), compact.data());
+
+	float worstNormal = 0.0f;
+	float worstTangent = 0.0f;
+	bool positionsExact = true;
+	bool uvsClose = true;
+	bool handednessKept = true;
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		Vertex decoded = VertexCompression::Decompress(compact[i]);
+		worstNormal = std::max(worstNormal, AngleInDegrees(vertices[i].Normal, decoded.Normal));
+		worstTangent = std::max(worstTangent, AngleInDegrees(TangentOf(vertices[i]), TangentOf(decoded)));
+		positionsExact &= memcmp(&vertices[i].Position, &decoded.Position, sizeof(XMFLOAT3)) == 0;
+		uvsClose &= WithinHalfPrecision(vertices[i].UV.x, decoded.UV.x) && WithinHalfPrecision(vertices[i].UV.y, decoded.UV.y);
+		handednessKept &= vertices[i].Tangent.w == decoded.Tangent.w;
+	}
+
+	CHECK_NEAR(0.0f, worstNormal, 0.04f);
+	CHECK_NEAR(0.0f, worstTangent, 0.04f);
+	CHECK(positionsExact);
+	CHECK(uvsClose);
+	CHECK(handednessKept);
+}
+
+TEST(QuantizedPositionsLandWithinHalfAStep)
+{
+	std::vector<Vertex> vertices = RandomVertices(200000);
+	vertices[0].Position = BoundsMin;
+	vertices[1].Position = BoundsMax;
+	std::vector<QuantizedVertex> quantized(vertices.size());
+	VertexCompression::Compress(vertices.data(), vertices.size(), BoundsMin, BoundsMax, quantized.data());
+
+	// Half a 16-bit step along each axis, plus a few float roundings at
+	// the size of the bounds (encoding and decoding both go through them)
+	XMVECTOR minimum = XMLoadFloat3(&BoundsMin);
+	XMVECTOR maximum = XMLoadFloat3(&BoundsMax);
+	XMVECTOR rounding = XMVectorScale(XMVectorMax(XMVectorAbs(minimum), XMVectorAbs(maximum)), 4.0f * FLT_EPSILON);
+	XMVECTOR halfStep = XMVectorAdd(XMVectorScale(XMVectorSubtract(maximum, minimum), 0.5f / 65535.0f), rounding);
+
+	// The tangent's handedness rides in the position's w
+	bool positionsClose = true;
+	float worstNormal = 0.0f;
+	float worstTangent = 0.0f;
+	bool handednessKept = true;
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		Vertex decoded = VertexCompression::Decompress(quantized[i], BoundsMin, BoundsMax);
+		XMVECTOR error = XMVectorAbs(XMVectorSubtract(XMLoadFloat3(&vertices[i].Position), XMLoadFloat3(&decoded.Position)));
+		positionsClose &= XMVector3LessOrEqual(error, halfStep);
+		worstNormal = std::max(worstNormal, AngleInDegrees(vertices[i].Normal, decoded.Normal));
+		worstTangent = std::max(worstTangent, AngleInDegrees(TangentOf(vertices[i]), TangentOf(decoded)));
+		handednessKept &= vertices[i].Tangent.w == decoded.Tangent.w;
+	}
+	CHECK(positionsClose);
+	CHECK_NEAR(0.0f, worstNormal, 0.04f);
+	CHECK_NEAR(0.0f, worstTangent, 0.04f);
+	CHECK(handednessKept);
+}
+
+TEST(DequantizeMatrixMatchesDecompress)
+{
+	std::vector<Vertex> vertices = RandomVertices(1000);
+	std::vector<QuantizedVertex> quantized(vertices.size());
+	VertexCompression::Compress(vertices.data(), vertices.size(), BoundsMin, BoundsMax, quantized.data());
+	XMMATRIX dequantize = VertexCompression::GetDequantizeMatrix(BoundsMin, BoundsMax);
+
+	// What the vertex shader does: the stored 0 - 1 fraction through the matrix
+	float worst = 0.0f;
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		XMVECTOR fraction = PackedVector::XMLoadUShortN4(&quantized[i].Position);
+		XMVECTOR shader = XMVector3TransformCoord(fraction, dequantize);
+		Vertex decoded = VertexCompression::Decompress(quantized[i], BoundsMin, BoundsMax);
+		worst = std::max(worst, XMVectorGetX(XMVector3Length(XMVectorSubtract(shader, XMLoadFloat3(&decoded.Position)))));
+	}
+	CHECK(worst < 1e-5f);
+}
+
+TEST(QuantizedTangentsMatchFullTangentsInWorldSpace)
+{
+	std::vector<Vertex> vertices = RandomVertices(20000);
+	std::vector<QuantizedVertex> quantized(vertices.size());
+	VertexCompression::Compress(vertices.data(), vertices.size(), BoundsMin, BoundsMax, quantized.data());
+
+	// The constants DrawEntity sends, for a turned and unevenly scaled
+	// entity: the full mesh gets identity for dequantize
+	XMMATRIX world = XMMatrixScaling(3.0f, 0.5f, 1.0f) * XMMatrixRotationRollPitchYaw(0.3f, 1.1f, -0.4f) * XMMatrixTranslation(2.0f, -1.0f, 7.0f);
+	XMMATRIX dequantize = VertexCompression::GetDequantizeMatrix(BoundsMin, BoundsMax);
+
+	// What TransformVertex does with them, for each format
+	float worstTangent = 0.0f;
+	float worstPosition = 0.0f;
+	float worstFolded = 0.0f;
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		XMFLOAT3 full;
+		XMStoreFloat3(&full, XMVector3TransformNormal(XMLoadFloat4(&vertices[i].Tangent), world));
+		XMVECTOR fullPosition = XMVector3TransformCoord(XMLoadFloat3(&vertices[i].Position), world);
+
+		Vertex decoded = VertexCompression::Decompress(quantized[i], BoundsMin, BoundsMax);
+		XMFLOAT3 compact;
+		XMStoreFloat3(&compact, XMVector3TransformNormal(XMLoadFloat4(&decoded.Tangent), world));
+		XMVECTOR localPosition = XMVector3TransformCoord(PackedVector::XMLoadUShortN4(&quantized[i].Position), dequantize);
+		XMVECTOR compactPosition = XMVector3TransformCoord(localPosition, world);
+
+		// Dequantizing folded into world, as it used to be
+		XMFLOAT3 folded;
+		XMStoreFloat3(&folded, XMVector3TransformNormal(XMLoadFloat4(&decoded.Tangent), dequantize * world));
+
+		worstTangent = std::max(worstTangent, AngleInDegrees(full, compact));
+		worstPosition = std::max(worstPosition, XMVectorGetX(XMVector3Length(XMVectorSubtract(fullPosition, compactPosition))));
+		worstFolded = std::max(worstFolded, AngleInDegrees(full, folded));
+	}
+
+	// Within the encoding's own error, turned by world, and positions
+	// within half a step of the longest axis scaled by 3
+	CHECK_NEAR(0.0f, worstTangent, 0.1f);
+	CHECK(worstPosition < 3.0f * 40.0f / 65535.0f);
+	CHECK(worstFolded > 10.0f);
+}
+
+TEST(FlatBoundsDontDivideByZero)
+{
+	Vertex vertex = {};
+	vertex.Position = XMFLOAT3(1.0f, 2.0f, 3.0f);
+	vertex.Normal = XMFLOAT3(0, 1, 0);
+	vertex.Tangent = XMFLOAT4(1, 0, 0, 1);
+
+	// Every position on one plane (y = 2)
+	XMFLOAT3 flatMin(0.0f, 2.0f, 0.0f);
+	XMFLOAT3 flatMax(4.0f, 2.0f, 4.0f);
+	QuantizedVertex quantized;
+	VertexCompression::Compress(&vertex, 1, flatMin, flatMax, &quantized);
+	Vertex decoded = VertexCompression::Decompress(quantized, flatMin, flatMax);
+	CHECK_NEAR(2.0f, decoded.Position.y, 0.0f);
+	CHECK_NEAR(1.0f, decoded.Position.x, 4.0f / 65535.0f);
+}
\ No newline at end of file
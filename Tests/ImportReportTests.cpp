@@ -0,0 +1,291 @@
+#include "TestHarness.h"
+#include "ImportReport.h"
+#include "MeshImporter.h"
+#include "MeshGenerator.h"
+
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+// --------------------------------------------------------
+// Import reports as JSON, read back with a small strict
+// parser: escaping, non-finite numbers, the counts from a
+// broken OBJ, and several reports in one file
+// --------------------------------------------------------
+
+namespace
+{
+	// Just enough JSON to read the reports back
+	struct Json
+	{
+		enum class Type { Null, Bool, Number, String, Array, Object };
+		Type type = Type::Null;
+		bool boolean = false;
+		double number = 0.0;
+		std::string text;
+		std::vector<Json> items;
+		std::vector<std::pair<std::string, Json>> members;
+
+		// The named member, or null if there isn't one
+		const Json& operator[](const char* name) const
+		{
+			static const Json missing;
+			for (const auto& [key, value] : members)
+				if (key == name)
+					return value;
+			return missing;
+		}
+	};
+
+	class JsonReader
+	{
+	public:
+		// Fails on anything that isn't exactly one valid value
+		static bool Parse(const std::string& text, Json& value)
+		{
+			JsonReader reader(text);
+			value = reader.Value();
+			reader.SkipSpace();
+			return reader.valid && reader.at == reader.end;
+		}
+
+	private:
+		const char* at;
+		const char* end;
+		bool valid = true;
+
+		explicit JsonReader(const std::string& text) : at(text.data()), end(text.data() + text.size()) {}
+
+		void SkipSpace()
+		{
+			while (at < end && (*at == ' ' || *at == '\t' || *at == '\n' || *at == '\r'))
+				at++;
+		}
+
+		bool Take(char c)
+		{
+			SkipSpace();
+			if (at < end && *at == c)
+			{
+				at++;
+				return true;
+			}
+			return false;
+		}
+
+		bool TakeWord(const char* word)
+		{
+			size_t length = strlen(word);
+			if ((size_t)(end - at) < length || strncmp(at, word, length) != 0)
+				return false;
+			at += length;
+			return true;
+		}
+
+		std::string String()
+		{
+			std::string text;
+			if (!Take('"'))
+			{
+				valid = false;
+				return text;
+			}
+			while (at < end && *at != '"')
+			{
+				char c = *at++;
+				if ((unsigned char)c < 0x20)
+					valid = false;
+				if (c != '\\')
+				{
+					text += c;
+					continue;
+				}
+				if (at == end)
+					break;
+				char escape = *at++;
+				const char* simple = strchr("\"\\/bfnrt", escape);
+				if (escape == 'u' && end - at >= 4)
+				{
+					unsigned int code = (unsigned int)strtoul(std::string(at, 4).c_str(), nullptr, 16);
+					valid &= code < 0x80; // Only ASCII is ever escaped
+					text += (char)code;
+					at += 4;
+				}
+				else if (simple && escape != 0)
+					text += "\"\\/\b\f\n\r\t"[simple - "\"\\/bfnrt"];
+				else
+					valid = false;
+			}
+			valid &= Take('"');
+			return text;
+		}
+
+		Json Value()
+		{
+			Json value;
+			SkipSpace();
+			if (at == end)
+				valid = false;
+			else if (*at == '"')
+			{
+				value.type = Json::Type::String;
+				value.text = String();
+			}
+			else if (Take('['))
+			{
+				value.type = Json::Type::Array;
+				if (!Take(']'))
+				{
+					do value.items.push_back(Value()); while (valid && Take(','));
+					valid &= Take(']');
+				}
+			}
+			else if (Take('{'))
+			{
+				value.type = Json::Type::Object;
+				if (!Take('}'))
+				{
+					do
+					{
+						std::string key = String();
+						valid &= Take(':');
+						value.members.push_back({ key, Value() });
+					} while (valid && Take(','));
+					valid &= Take('}');
+				}
+			}
+			else if (TakeWord("null"))
+				value.type = Json::Type::Null;
+			else if (TakeWord("true"))
+			{
+				value.type = Json::Type::Bool;
+				value.boolean = true;
+			}
+			else if (TakeWord("false"))
+				value.type = Json::Type::Bool;
+			else
+			{
+				char* numberEnd = nullptr;
+				value.type = Json::Type::Number;
+				value.number = strtod(at, &numberEnd);
+				valid &= numberEnd != at && (*at == '-' || (*at >= '0' && *at <= '9'));
+				at = numberEnd;
+			}
+			return value;
+		}
+	};
+
+	Json Parsed(const std::string& text)
+	{
+		Json value;
+		if (!JsonReader::Parse(text, value))
+			Test::Fail(__FILE__, __LINE__, "Not valid JSON:\n" + text);
+		return value;
+	}
+
+	std::string ReadFile(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		std::stringstream text;
+		text << file.rdbuf();
+		return text.str();
+	}
+
+	// One good triangle, one whose third corner is past the last position
+	// (it falls back to the first, which makes it degenerate too), one that
+	// repeats a corner, and a position nothing uses
+	std::string WriteBrokenObj()
+	{
+		std::string path = Test::GetOutputDirectory() + "/broken.obj";
+		FILE* file = fopen(path.c_str(), "wb");
+		fputs("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 5 5 5\nf 1 2 3\nf 1 2 9\nf 1 1 2\n", file);
+		fclose(file);
+		return path;
+	}
+}
+
+TEST(NamesAreEscaped)
+{
+	// Quotes, backslashes and control characters, as a path might hold
+	ImportReport report;
+	report.name = "C:\\Assets\\\"odd\"\tname\n\x01\x1f.obj";
+	std::string json = report.ToJson();
+
+	CHECK(json.find("C:\\\\Assets\\\\\\\"odd\\\"\\u0009name\\u000a\\u0001\\u001f.obj") != std::string::npos);
+	Json parsed = Parsed(json);
+	CHECK_EQUAL(report.name, parsed["name"].text);
+}
+
+TEST(NonFiniteValuesAreWrittenAsNull)
+{
+	ImportReport report;
+	report.acmr = std::numeric_limits<float>::quiet_NaN();
+	report.atvr = std::numeric_limits<float>::infinity();
+	report.source.originalAcmr = -std::numeric_limits<float>::infinity();
+	report.boundingBox = DirectX::BoundingBox(DirectX::XMFLOAT3(std::numeric_limits<float>::quiet_NaN(), 0.1f, 2.5f), DirectX::XMFLOAT3(1, 1, 1));
+	Json json = Parsed(report.ToJson());
+
+	CHECK(json["acmr"].type == Json::Type::Null);
+	CHECK(json["atvr"].type == Json::Type::Null);
+	CHECK(json["source"]["originalAcmr"].type == Json::Type::Null);
+	CHECK(json["boundsCenter"].items.size() == 3 && json["boundsCenter"].items[0].type == Json::Type::Null);
+
+	// Finite ones read back as the same float
+	CHECK_EQUAL(0.1f, (float)json["boundsCenter"].items[1].number);
+	CHECK_EQUAL(2.5f, (float)json["boundsCenter"].items[2].number);
+}
+
+TEST(BrokenObjCountsReachTheJson)
+{
+	MeshData data = MeshImporter::Import(WriteBrokenObj().c_str());
+	Json json = Parsed(data.report.ToJson());
+
+	const Json& source = json["source"];
+	CHECK_EQUAL(4.0, source["positionCount"].number);
+	CHECK_EQUAL(3.0, source["triangleCount"].number);
+	CHECK_EQUAL(1.0, source["invalidIndexCount"].number);
+	CHECK_EQUAL(1.0, source["unusedPositionCount"].number);
+	CHECK_EQUAL(2.0, json["degenerateTriangleCount"].number);
+	CHECK_EQUAL((double)data.report.degenerateTriangleCount, json["degenerateTriangleCount"].number);
+	CHECK(!json["fromCache"].boolean);
+}
+
+TEST(SeveralReportsShareOneFile)
+{
+	MeshData broken = MeshImporter::Import(WriteBrokenObj().c_str());
+
+	MeshGenerator::Size size = MeshGenerator::CubeSize();
+	std::vector<Vertex> vertices(size.vertexCount);
+	std::vector<unsigned int> indices(size.indexCount);
+	MeshGenerator::Cube(vertices, indices);
+	MeshData cube = MeshImporter::FromGenerated(std::move(vertices), std::move(indices));
+	cube.report.name = "Cube";
+
+	ImportReport odd;
+	odd.name = "quote \" and\nnewline";
+	odd.acmr = std::numeric_limits<float>::quiet_NaN();
+
+	std::string path = Test::GetOutputDirectory() + "/reports.json";
+	std::vector<const ImportReport*> reports = { &broken.report, &cube.report, &odd };
+	CHECK(ImportReport::WriteJson(path.c_str(), reports));
+
+	// An array of the same objects ToJson writes, in order
+	Json file = Parsed(ReadFile(path));
+	CHECK(file.type == Json::Type::Array);
+	CHECK_EQUAL(reports.size(), file.items.size());
+	for (size_t i = 0; i < reports.size() && i < file.items.size(); i++)
+	{
+		Json alone = Parsed(reports[i]->ToJson());
+		CHECK_EQUAL(reports[i]->name, file.items[i]["name"].text);
+		CHECK_EQUAL(alone.members.size(), file.items[i].members.size());
+		CHECK_EQUAL(alone["vertexCount"].number, file.items[i]["vertexCount"].number);
+		CHECK(alone["acmr"].type == file.items[i]["acmr"].type);
+	}
+
+	// No reports is still an array, and an unwritable path is refused
+	CHECK(ImportReport::WriteJson(path.c_str(), {}));
+	Json empty = Parsed(ReadFile(path));
+	CHECK(empty.type == Json::Type::Array && empty.items.empty());
+	CHECK(!ImportReport::WriteJson((Test::GetOutputDirectory() + "/missing/reports.json").c_str(), reports));
+}
\ No newline at end of file
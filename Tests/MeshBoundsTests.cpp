@@ -0,0 +1,207 @@
+#include "TestHarness.h"
+#include "MeshBounds.h"
+#include "MeshGenerator.h"
+#include "Transform.h"
+
+#include <cfloat>
+#include <cstring>
+#include <random>
+#include <algorithm>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Mesh bounds against a one-vertex-at-a-time reference, at
+// sizes that take the four-lane loop, the tail or both, and
+// world space bounds following an entity's transform
+// --------------------------------------------------------
+
+namespace
+{
+	// The box and sphere MeshBounds::Compute describes, the obvious way
+	void ReferenceBounds(const std::vector<Vertex>& vertices, BoundingBox& box, BoundingSphere& sphere)
+	{
+		if (vertices.empty())
+		{
+			box = BoundingBox(XMFLOAT3(0, 0, 0), XMFLOAT3(0, 0, 0));
+			sphere = BoundingSphere(XMFLOAT3(0, 0, 0), 0.0f);
+			return;
+		}
+
+		XMFLOAT3 minimum(FLT_MAX, FLT_MAX, FLT_MAX);
+		XMFLOAT3 maximum(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (const Vertex& vertex : vertices)
+		{
+			minimum.x = std::min(minimum.x, vertex.Position.x);
+			minimum.y = std::min(minimum.y, vertex.Position.y);
+			minimum.z = std::min(minimum.z, vertex.Position.z);
+			maximum.x = std::max(maximum.x, vertex.Position.x);
+			maximum.y = std::max(maximum.y, vertex.Position.y);
+			maximum.z = std::max(maximum.z, vertex.Position.z);
+		}
+		box.Center = XMFLOAT3((minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f);
+		box.Extents = XMFLOAT3((maximum.x - minimum.x) * 0.5f, (maximum.y - minimum.y) * 0.5f, (maximum.z - minimum.z) * 0.5f);
+
+		double furthest = 0.0;
+		for (const Vertex& vertex : vertices)
+		{
+			double x = vertex.Position.x - box.Center.x;
+			double y = vertex.Position.y - box.Center.y;
+			double z = vertex.Position.z - box.Center.z;
+			furthest = std::max(furthest, x * x + y * y + z * z);
+		}
+		sphere.Center = box.Center;
+		sphere.Radius = (float)std::sqrt(furthest);
+	}
+
+	std::vector<Vertex> RandomVertices(size_t count, unsigned int seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+		std::vector<Vertex> vertices(count);
+		for (Vertex& vertex : vertices)
+			vertex.Position = XMFLOAT3(position(random), position(random), position(random));
+		return vertices;
+	}
+
+	// Compute against the reference, exactly for the box (both take the same
+	// min and max) and to float rounding for the radius
+	void CheckMatchesReference(const std::vector<Vertex>& vertices)
+	{
+		BoundingBox box, expectedBox;
+		BoundingSphere sphere, expectedSphere;
+		MeshBounds::Compute(vertices.data(), (unsigned int)vertices.size(), box, sphere);
+		ReferenceBounds(vertices, expectedBox, expectedSphere);
+
+		CHECK(memcmp(&expectedBox, &box, sizeof(BoundingBox)) == 0);
+		CHECK(memcmp(&expectedSphere.Center, &sphere.Center, sizeof(XMFLOAT3)) == 0);
+		CHECK_NEAR(expectedSphere.Radius, sphere.Radius, expectedSphere.Radius * 1e-6f);
+	}
+
+	bool BoxContains(const BoundingBox& box, FXMVECTOR point, float tolerance)
+	{
+		XMVECTOR offset = XMVectorAbs(XMVectorSubtract(point, XMLoadFloat3(&box.Center)));
+		return XMVector3LessOrEqual(offset, XMVectorAdd(XMLoadFloat3(&box.Extents), XMVectorReplicate(tolerance)));
+	}
+
+	bool SphereContains(const BoundingSphere& sphere, FXMVECTOR point, float tolerance)
+	{
+		return XMVectorGetX(XMVector3Length(XMVectorSubtract(point, XMLoadFloat3(&sphere.Center)))) <= sphere.Radius + tolerance;
+	}
+}
+
+TEST(ComputeMatchesTheReferenceAtEverySize)
+{
+	// Nothing, the tail alone, the lanes alone, both, and a large set
+	// that isn't a multiple of four either
+	for (size_t count : { 0, 1, 3, 4, 5, 100003 })
+		CheckMatchesReference(RandomVertices(count, (unsigned int)count));
+}
+
+TEST(ComputeFindsTheExtremesInEveryLaneAndTheTail)
+{
+	// Each of the nine vertices in turn holds every extreme: lanes 0-3 of
+	// both groups of four, and the one left over
+	for (size_t far = 0; far < 9; far++)
+	{
+		std::vector<Vertex> vertices = RandomVertices(9, 7);
+		vertices[far].Position = XMFLOAT3(50.0f, -60.0f, 70.0f);
+		CheckMatchesReference(vertices);
+
+		vertices[far].Position = XMFLOAT3(-50.0f, 60.0f, -70.0f);
+		CheckMatchesReference(vertices);
+	}
+}
+
+TEST(ComputeSphereIsCenteredOnTheBox)
+{
+	// One vertex far off to the side: the sphere reaches it from the
+	// box's center rather than from the average position
+	std::vector<Vertex> vertices(5);
+	vertices[4].Position = XMFLOAT3(8.0f, 0.0f, 0.0f);
+	BoundingBox box;
+	BoundingSphere sphere;
+	MeshBounds::Compute(vertices.data(), (unsigned int)vertices.size(), box, sphere);
+
+	CHECK_EQUAL(4.0f, sphere.Center.x);
+	CHECK_EQUAL(4.0f, sphere.Radius);
+	CHECK_EQUAL(0.0f, MeshBounds::GetMin(box).x);
+	CHECK_EQUAL(8.0f, MeshBounds::GetMax(box).x);
+}
+
+TEST(WorldBoundsFollowAScaledRotatedParentedTransform)
+{
+	MeshGenerator::Size size = MeshGenerator::TorusSize();
+	std::vector<Vertex> vertices(size.vertexCount);
+	std::vector<unsigned int> indices(size.indexCount);
+	MeshGenerator::Torus(vertices, indices);
+	BoundingBox localBox;
+	BoundingSphere localSphere;
+	MeshBounds::Compute(vertices.data(), (unsigned int)vertices.size(), localBox, localSphere);
+
+	// Scaled evenly by its parent and unevenly by itself, turned by both
+	TransformStore store;
+	Transform parent(store);
+	parent.SetPosition(3.0f, 1.0f, -2.0f);
+	parent.SetRotation(0.4f, 0.9f, 0.0f);
+	parent.SetScale(2.0f, 2.0f, 2.0f);
+	Transform child(store);
+	child.SetParent(&parent);
+	child.SetPosition(0.0f, 1.0f, 0.0f);
+	child.SetRotation(0.0f, 0.3f, 1.2f);
+	child.SetScale(1.0f, 0.5f, 3.0f);
+
+	for (int step = 0; step < 2; step++)
+	{
+		store.UpdateWorldMatrices();
+
+		// What Entity::GetWorldBoundingBox and GetWorldBoundingSphere do
+		XMMATRIX world = XMLoadFloat4x4(&child.GetWorldMatrix());
+		BoundingBox worldBox;
+		BoundingSphere worldSphere;
+		localBox.Transform(worldBox, world);
+		localSphere.Transform(worldSphere, world);
+
+		// Every vertex the entity draws is inside both
+		bool inBox = true;
+		bool inSphere = true;
+		for (const Vertex& vertex : vertices)
+		{
+			XMVECTOR position = XMVector3Transform(XMLoadFloat3(&vertex.Position), world);
+			inBox &= BoxContains(worldBox, position, 1e-4f);
+			inSphere &= SphereContains(worldSphere, position, 1e-4f);
+		}
+		CHECK(inBox);
+		CHECK(inSphere);
+
+		// The sphere moves with the local center and grows by the largest
+		// scale along the chain (2 from the parent, 3 from the child)
+		XMFLOAT3 parentPosition = parent.GetPosition();
+		XMMATRIX expected =
+			XMMatrixScaling(1.0f, 0.5f, 3.0f) * XMMatrixRotationRollPitchYaw(0.0f, 0.3f, 1.2f) * XMMatrixTranslation(0.0f, 1.0f, 0.0f) *
+			XMMatrixScaling(2.0f, 2.0f, 2.0f) * XMMatrixRotationRollPitchYaw(0.4f, 0.9f, 0.0f) * XMMatrixTranslation(parentPosition.x, parentPosition.y, parentPosition.z);
+		XMVECTOR center = XMVector3Transform(XMLoadFloat3(&localSphere.Center), expected);
+		CHECK_NEAR(0.0f, XMVectorGetX(XMVector3Length(XMVectorSubtract(center, XMLoadFloat3(&worldSphere.Center)))), 1e-4f);
+		CHECK_NEAR(localSphere.Radius * 6.0f, worldSphere.Radius, 1e-4f);
+
+		// The box holds the local box's corners, and touches each side
+		XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+		XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+		XMFLOAT3 low = MeshBounds::GetMin(localBox);
+		XMFLOAT3 high = MeshBounds::GetMax(localBox);
+		for (int corner = 0; corner < 8; corner++)
+		{
+			XMVECTOR point = XMVectorSet(corner & 1 ? high.x : low.x, corner & 2 ? high.y : low.y, corner & 4 ? high.z : low.z, 1.0f);
+			point = XMVector3Transform(point, expected);
+			minimum = XMVectorMin(minimum, point);
+			maximum = XMVectorMax(maximum, point);
+		}
+		XMFLOAT3 worldMin = MeshBounds::GetMin(worldBox);
+		XMFLOAT3 worldMax = MeshBounds::GetMax(worldBox);
+		CHECK_NEAR(0.0f, XMVectorGetX(XMVector3Length(XMVectorSubtract(minimum, XMLoadFloat3(&worldMin)))), 1e-4f);
+		CHECK_NEAR(0.0f, XMVectorGetX(XMVector3Length(XMVectorSubtract(maximum, XMLoadFloat3(&worldMax)))), 1e-4f);
+
+		// Moving the parent takes both along on the next pass
+		parent.SetPosition(-5.0f, 4.0f, 9.0f);
+	}
+}
\ No newline at end of file
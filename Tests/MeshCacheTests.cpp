@@ -0,0 +1,159 @@
+#include "TestHarness.h"
+#include "MeshCache.h"
+#include "MeshImporter.h"
+
+#include <cstring>
+#include <filesystem>
+
+// --------------------------------------------------------
+// Cooked files: where they go, and when they're reused
+// --------------------------------------------------------
+
+TEST(CachePathCarriesTheImportFlags)
+{
+	CHECK_EQUAL(std::string("mesh.obj.0.cmesh"), MeshCache::GetCachePath("mesh.obj", 0));
+	CHECK_EQUAL(std::string("a/b.obj.1e.cmesh"), MeshCache::GetCachePath("a/b.obj", 0x1E));
+	CHECK_EQUAL(std::string("b.obj.ffffffff.cmesh"), MeshCache::GetCachePath("b.obj", 0xFFFFFFFF));
+
+	MeshImportSettings defaults;
+	MeshImportSettings streaming;
+	streaming.streaming = true;
+	CHECK(MeshCache::GetCachePath("x.obj", MeshCache::GetImportFlags(defaults)) !=
+		MeshCache::GetCachePath("x.obj", MeshCache::GetImportFlags(streaming)));
+}
+
+TEST(SwitchingSettingsKeepsEveryCook)
+{
+	std::string path = Test::CopyAsset("torus.obj");
+	MeshImportSettings defaults;
+	MeshImportSettings unoptimized;
+	unoptimized.optimize = false;
+	unoptimized.generateLods = false;
+
+	// Each setting cooks its own file on the first import...
+	CHECK(!MeshImporter::Import(path.c_str(), defaults).report.fromCache);
+	CHECK(!MeshImporter::Import(path.c_str(), unoptimized).report.fromCache);
+	CHECK(std::filesystem::exists(MeshCache::GetCachePath(path.c_str(), MeshCache::GetImportFlags(defaults))));
+	CHECK(std::filesystem::exists(MeshCache::GetCachePath(path.c_str(), MeshCache::GetImportFlags(unoptimized))));
+
+	// ...and alternating between them afterwards hits both
+	CHECK(MeshImporter::Import(path.c_str(), defaults).report.fromCache);
+	CHECK(MeshImporter::Import(path.c_str(), unoptimized).report.fromCache);
+	CHECK(MeshImporter::Import(path.c_str(), defaults).report.fromCache);
+}
+
+TEST(CacheHitsReportWhatTheCookMeasured)
+{
+	// The last face has no area
+	std::string path = Test::GetOutputDirectory() + "/flat.obj";
+	FILE* file = fopen(path.c_str(), "wb");
+	fputs("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 2 0 0\nf 1 2 3 4\nf 1 2 5\n", file);
+	fclose(file);
+
+	MeshData imported = MeshImporter::Import(path.c_str());
+	MeshData cached = MeshImporter::Import(path.c_str());
+	CHECK(cached.report.fromCache);
+	CHECK_EQUAL(1u, imported.report.degenerateTriangleCount);
+	CHECK_EQUAL(imported.report.degenerateTriangleCount, cached.report.degenerateTriangleCount);
+	CHECK_EQUAL(imported.report.acmr, cached.report.acmr);
+	CHECK_EQUAL(imported.report.atvr, cached.report.atvr);
+	CHECK_EQUAL(imported.vertexCacheStats.acmr, cached.vertexCacheStats.acmr);
+
+	// The numbers come from the file rather than being worked out again.
+	// With no submesh names, the measurements are the last thing in it.
+	std::string cachePath = MeshCache::GetCachePath(path.c_str(), MeshCache::GetImportFlags(MeshImportSettings()));
+	cached = MeshData();	// Unmaps the file
+	ImportReport::Measured planted = { 7, 2.5f, 1.25f, 0 };
+	file = fopen(cachePath.c_str(), "r+b");
+	fseek(file, -(long)sizeof(planted), SEEK_END);
+	fwrite(&planted, sizeof(planted), 1, file);
+	fclose(file);
+
+	MeshData reread = MeshImporter::Import(path.c_str());
+	CHECK(reread.report.fromCache);
+	CHECK_EQUAL(7u, reread.report.degenerateTriangleCount);
+	CHECK_EQUAL(2.5f, reread.report.acmr);
+	CHECK_EQUAL(1.25f, reread.vertexCacheStats.atvr);
+}
+
+TEST(EveryVertexFormatIsCookedReadyToUpload)
+{
+	std::string path = Test::CopyAsset("sphere.obj");
+	std::vector<std::string> cachePaths;
+	for (unsigned int format = 0; format < VertexFormatCount; format++)
+	{
+		MeshImportSettings settings;
+		settings.vertexFormat = (VertexFormat)format;
+		cachePaths.push_back(MeshCache::GetCachePath(path.c_str(), MeshCache::GetImportFlags(settings)));
+		CHECK(MeshCache::GetVertexFormat(MeshCache::GetImportFlags(settings)) == settings.vertexFormat);
+
+		MeshData imported = MeshImporter::Import(path.c_str(), settings);
+		MeshData cached = MeshImporter::Import(path.c_str(), settings);
+		CHECK(cached.report.fromCache);
+
+		// Uploaded straight from the mapping, with nothing converted
+		unsigned int stride = VertexCompression::GetStride(settings.vertexFormat);
+		const char* mapped = (const char*)cached.vertexData;
+		CHECK(cached.vertices.empty() && cached.compactVertices.empty() && cached.quantizedVertices.empty());
+		CHECK(mapped == (const char*)cached.cooked->GetVertices());
+		CHECK_EQUAL(imported.vertexCount, cached.vertexCount);
+		CHECK(memcmp(imported.vertexData, mapped, (size_t)stride * imported.vertexCount) == 0);
+		CHECK(memcmp(&imported.dequantizeMatrix, &cached.dequantizeMatrix, sizeof(DirectX::XMFLOAT4X4)) == 0);
+		CHECK_EQUAL(stride, cached.cooked->GetHeader().vertexStride);
+	}
+
+	// One cook per format, each the size of its own vertices
+	CHECK(cachePaths[0] != cachePaths[1] && cachePaths[1] != cachePaths[2]);
+	CHECK(std::filesystem::file_size(cachePaths[0]) > std::filesystem::file_size(cachePaths[1]));
+	CHECK(std::filesystem::file_size(cachePaths[1]) > std::filesystem::file_size(cachePaths[2]));
+}
+
+// Nine 16-bit indices end on an odd multiple of two bytes, and the
+// tables after them still have to be 4-byte aligned
+TEST(TablesStayAlignedAfterOddSizedBlocks)
+{
+	MeshImportSettings settings;
+	settings.vertexFormat = VertexFormat::Quantized;
+	uint32_t flags = MeshCache::GetImportFlags(settings);
+	const unsigned int stride = VertexCompression::GetStride(settings.vertexFormat);
+	const unsigned int vertexCount = 5;
+	std::vector<char> vertices(stride * vertexCount, 7);
+	std::vector<uint16_t> indices = { 0, 1, 2, 2, 1, 3, 3, 1, 4 };
+	std::vector<Submesh> submeshes = { { 0, 6, "first", "stone" }, { 6, 3, "second", "" } };
+	std::vector<MeshLod> lods = { { 0, 9, 0.0f } };
+	Meshlet meshlet = {};
+	meshlet.indexCount = 9;
+	meshlet.bounds = DirectX::BoundingSphere(DirectX::XMFLOAT3(1, 2, 3), 4);
+	meshlet.coneCutoff = 0.5f;
+	ImportReport::Source source = {};
+	source.weldedVertexCount = vertexCount;
+	ImportReport::Measured measured = { 1, 2.0f, 3.0f, 0 };
+
+	std::string path = Test::GetOutputDirectory() + "/odd.cmesh";
+	CHECK(MeshCache::Write(path, 42, flags, vertices.data(), stride, vertexCount, indices.data(), 2, (unsigned int)indices.size(),
+		submeshes, lods, { meshlet }, source, measured, DirectX::BoundingBox(), DirectX::BoundingSphere()));
+
+	// Each block starts on a multiple of eight
+	size_t vertexBytes = (stride * vertexCount + 7) / 8 * 8;
+	size_t expectedSize = sizeof(MeshCache::Header) + vertexBytes + 24 +
+		2 * sizeof(MeshCache::SubmeshEntry) + sizeof(MeshLod) + sizeof(Meshlet) +
+		sizeof(ImportReport::Source) + sizeof(ImportReport::Measured) + strlen("firststonesecond");
+	CHECK_EQUAL(expectedSize, (size_t)std::filesystem::file_size(path));
+
+	MeshCache::CookedMesh cooked;
+	CHECK(cooked.Open(path, 42, flags));
+	const char* start = (const char*)&cooked.GetHeader();
+	CHECK_EQUAL((ptrdiff_t)(sizeof(MeshCache::Header) + vertexBytes), (const char*)cooked.GetIndices() - start);
+	CHECK(memcmp(indices.data(), cooked.GetIndices(), indices.size() * 2) == 0);
+
+	CHECK_EQUAL((size_t)2, cooked.GetSubmeshes().size());
+	CHECK_EQUAL(std::string("stone"), cooked.GetSubmeshes()[0].materialName);
+	CHECK_EQUAL(6u, cooked.GetSubmeshes()[1].indexStart);
+	CHECK_EQUAL(std::string("second"), cooked.GetSubmeshes()[1].name);
+	CHECK_EQUAL(9u, cooked.GetLods()[0].indexCount);
+	CHECK_EQUAL((size_t)1, cooked.GetMeshlets().size());
+	CHECK_EQUAL(4.0f, cooked.GetMeshlets()[0].bounds.Radius);
+	CHECK_EQUAL(0.5f, cooked.GetMeshlets()[0].coneCutoff);
+	CHECK_EQUAL(3.0f, cooked.GetMeasured().atvr);
+	CHECK_EQUAL((uint64_t)vertexCount, cooked.GetSource().weldedVertexCount);
+}
\ No newline at end of file
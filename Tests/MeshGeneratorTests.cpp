@@ -0,0 +1,219 @@
+#include "TestHarness.h"
+#include "MeshGenerator.h"
+#include "TangentGenerator.h"
+
+#include <cmath>
+#include <limits>
+#include <functional>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Every generated shape filling exactly what its Size asked
+// for, facing outwards with no degenerate triangles, closed
+// shapes holding the volume they should, and tangents that
+// agree with what TangentGenerator works out from the uvs
+// --------------------------------------------------------
+
+namespace
+{
+	struct Shape
+	{
+		const char* name;
+		MeshGenerator::Size size;
+		std::function<void(std::span<Vertex>, std::span<unsigned int>)> generate;
+		double volume;	// Of the tessellated shape, or 0 if it isn't closed
+	};
+
+	const double Pi = 3.14159265358979;
+
+	// Area of a regular polygon with the given number of sides, around a unit circle
+	double PolygonArea(unsigned int sides)
+	{
+		return 0.5 * sides * std::sin(2.0 * Pi / sides);
+	}
+
+	std::vector<Shape> Shapes()
+	{
+		// The sphere, torus and helix are only compared to their smooth
+		// volume (see the check), the rest are exact
+		return {
+			{ "Cube", MeshGenerator::CubeSize(), [](auto v, auto i) { MeshGenerator::Cube(v, i); }, 8.0 },
+			{ "Cube x3", MeshGenerator::CubeSize(3), [](auto v, auto i) { MeshGenerator::Cube(v, i, 3, 0.5f); }, 1.0 },
+			{ "Sphere", MeshGenerator::SphereSize(), [](auto v, auto i) { MeshGenerator::Sphere(v, i); }, 4.0 / 3.0 * Pi },
+			{ "Sphere 48x24", MeshGenerator::SphereSize(48, 24), [](auto v, auto i) { MeshGenerator::Sphere(v, i, 48, 24, 2.0f); }, 32.0 / 3.0 * Pi },
+			{ "Cylinder", MeshGenerator::CylinderSize(), [](auto v, auto i) { MeshGenerator::Cylinder(v, i); }, PolygonArea(32) * 2.0 },
+			{ "Cylinder 5x3", MeshGenerator::CylinderSize(5, 3), [](auto v, auto i) { MeshGenerator::Cylinder(v, i, 5, 3, 0.5f, 4.0f); }, PolygonArea(5) * 0.25 * 4.0 },
+			{ "Torus", MeshGenerator::TorusSize(), [](auto v, auto i) { MeshGenerator::Torus(v, i); }, 2.0 * Pi * Pi * 0.7143 * 0.2857 * 0.2857 },
+			{ "Helix", MeshGenerator::HelixSize(), [](auto v, auto i) { MeshGenerator::Helix(v, i); },
+				Pi * 0.2 * 0.2 * std::sqrt(std::pow(2.0 * 2.0 * Pi * 0.8, 2.0) + 2.0 * 2.0) },
+			{ "Quad", MeshGenerator::QuadSize(), [](auto v, auto i) { MeshGenerator::Quad(v, i); }, 0.0 },
+			{ "Quad x4", MeshGenerator::QuadSize(4), [](auto v, auto i) { MeshGenerator::Quad(v, i, 4); }, 0.0 },
+			{ "DoubleSidedQuad", MeshGenerator::DoubleSidedQuadSize(), [](auto v, auto i) { MeshGenerator::DoubleSidedQuad(v, i); }, 0.0 },
+		};
+	}
+
+	// Shapes asked for below their minimum tessellation, which both
+	// functions should raise the same way
+	std::vector<Shape> MinimumShapes()
+	{
+		return {
+			{ "Cube", MeshGenerator::CubeSize(0), [](auto v, auto i) { MeshGenerator::Cube(v, i, 0); }, 0.0 },
+			{ "Sphere", MeshGenerator::SphereSize(1, 1), [](auto v, auto i) { MeshGenerator::Sphere(v, i, 1, 1); }, 0.0 },
+			{ "Cylinder", MeshGenerator::CylinderSize(1, 0), [](auto v, auto i) { MeshGenerator::Cylinder(v, i, 1, 0); }, 0.0 },
+			{ "Torus", MeshGenerator::TorusSize(1, 1), [](auto v, auto i) { MeshGenerator::Torus(v, i, 1, 1); }, 0.0 },
+			{ "Helix", MeshGenerator::HelixSize(0, 1), [](auto v, auto i) { MeshGenerator::Helix(v, i, 0, 1); }, 0.0 },
+			{ "Quad", MeshGenerator::QuadSize(0), [](auto v, auto i) { MeshGenerator::Quad(v, i, 0); }, 0.0 },
+			{ "DoubleSidedQuad", MeshGenerator::DoubleSidedQuadSize(0), [](auto v, auto i) { MeshGenerator::DoubleSidedQuad(v, i, 0); }, 0.0 },
+		};
+	}
+
+	struct Generated
+	{
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+	};
+
+	// Generated into arrays prefilled with values no shape would write
+	Generated Generate(const Shape& shape)
+	{
+		Vertex unwritten = {};
+		unwritten.Position.x = std::numeric_limits<float>::quiet_NaN();
+		Generated mesh;
+		mesh.vertices.assign(shape.size.vertexCount, unwritten);
+		mesh.indices.assign(shape.size.indexCount, UINT32_MAX);
+		shape.generate(mesh.vertices, mesh.indices);
+		return mesh;
+	}
+
+	XMVECTOR PositionOf(const Generated& mesh, size_t corner)
+	{
+		return XMLoadFloat3(&mesh.vertices[mesh.indices[corner]].Position);
+	}
+
+	// Clockwise from outside, so this points out of the shape
+	XMVECTOR FaceNormal(const Generated& mesh, size_t first)
+	{
+		XMVECTOR p0 = PositionOf(mesh, first);
+		return XMVector3Cross(PositionOf(mesh, first + 1) - p0, PositionOf(mesh, first + 2) - p0);
+	}
+
+	// Sum of the tetrahedra from the origin to each triangle, positive
+	// when they face outwards
+	double EnclosedVolume(const Generated& mesh)
+	{
+		double volume = 0.0;
+		for (size_t i = 0; i < mesh.indices.size(); i += 3)
+		{
+			XMFLOAT3 a, b, c;
+			XMStoreFloat3(&a, PositionOf(mesh, i));
+			XMStoreFloat3(&b, PositionOf(mesh, i + 1));
+			XMStoreFloat3(&c, PositionOf(mesh, i + 2));
+			volume += ((double)a.x * ((double)b.y * c.z - (double)b.z * c.y) +
+				(double)a.y * ((double)b.z * c.x - (double)b.x * c.z) +
+				(double)a.z * ((double)b.x * c.y - (double)b.y * c.x)) / 6.0;
+		}
+		return volume;
+	}
+}
+
+TEST(EveryShapeFillsItsSizeExactly)
+{
+	for (const std::vector<Shape>& shapes : { Shapes(), MinimumShapes() })
+	{
+		for (const Shape& shape : shapes)
+		{
+			Generated mesh = Generate(shape);
+			CHECK(shape.size.indexCount % 3 == 0);
+
+			// Every vertex written and used, and every index in range
+			bool written = true;
+			for (const Vertex& vertex : mesh.vertices)
+				written &= std::isfinite(vertex.Position.x);
+			std::vector<bool> used(mesh.vertices.size(), false);
+			bool inRange = true;
+			for (unsigned int index : mesh.indices)
+			{
+				inRange &= index < mesh.vertices.size();
+				if (index < mesh.vertices.size())
+					used[index] = true;
+			}
+			bool allUsed = std::find(used.begin(), used.end(), false) == used.end();
+			if (!written || !inRange || !allUsed)
+				Test::Fail(__FILE__, __LINE__, std::string(shape.name) + " doesn't fill its size exactly");
+
+			// One short of either is refused
+			std::vector<Vertex> vertices(shape.size.vertexCount);
+			std::vector<unsigned int> indices(shape.size.indexCount);
+			CHECK_THROWS(shape.generate(std::span(vertices).first(vertices.size() - 1), indices));
+			CHECK_THROWS(shape.generate(vertices, std::span(indices).first(indices.size() - 1)));
+		}
+	}
+}
+
+TEST(TrianglesFaceOutwardsAndEncloseTheirVolume)
+{
+	for (const Shape& shape : Shapes())
+	{
+		Generated mesh = Generate(shape);
+
+		// Compared to the triangle's size, so small shapes aren't let off
+		unsigned int degenerate = 0;
+		unsigned int inverted = 0;
+		for (size_t i = 0; i < mesh.indices.size(); i += 3)
+		{
+			XMVECTOR face = FaceNormal(mesh, i);
+			XMVECTOR p0 = PositionOf(mesh, i);
+			float longestSquared = std::max({
+				XMVectorGetX(XMVector3LengthSq(PositionOf(mesh, i + 1) - p0)),
+				XMVectorGetX(XMVector3LengthSq(PositionOf(mesh, i + 2) - p0)),
+				XMVectorGetX(XMVector3LengthSq(PositionOf(mesh, i + 2) - PositionOf(mesh, i + 1))) });
+			if (XMVectorGetX(XMVector3Length(face)) <= longestSquared * 1e-4f)
+				degenerate++;
+
+			XMVECTOR normals = XMVectorZero();
+			for (int c = 0; c < 3; c++)
+				normals += XMLoadFloat3(&mesh.vertices[mesh.indices[i + c]].Normal);
+			if (XMVectorGetX(XMVector3Dot(face, normals)) <= 0.0f)
+				inverted++;
+		}
+		if (degenerate > 0 || inverted > 0)
+			Test::Fail(__FILE__, __LINE__, std::string(shape.name) + ": " + std::to_string(degenerate) +
+				" degenerate and " + std::to_string(inverted) + " inverted triangles");
+
+		// Curved shapes lose a little volume to their flat facets
+		if (shape.volume > 0.0)
+		{
+			double volume = EnclosedVolume(mesh);
+			if (!(volume > shape.volume * 0.95 && volume < shape.volume * 1.0001))
+				Test::Fail(__FILE__, __LINE__, std::string(shape.name) + " encloses " + Test::Describe(volume) +
+					", expected about " + Test::Describe(shape.volume));
+		}
+	}
+}
+
+TEST(TangentHandednessMatchesTangentGenerator)
+{
+	for (const Shape& shape : Shapes())
+	{
+		Generated mesh = Generate(shape);
+		std::vector<Vertex> generated = mesh.vertices;
+		TangentGenerator::Stats stats = TangentGenerator::Generate(generated.data(), (unsigned int)generated.size(), mesh.indices.data(), mesh.indices.size(), 1);
+		CHECK_EQUAL(0u, stats.fallbackTangents);
+
+		// Same handedness everywhere, and tangents pointing the same way
+		unsigned int flipped = 0;
+		float worstDot = 1.0f;
+		for (size_t i = 0; i < generated.size(); i++)
+		{
+			if (generated[i].Tangent.w != mesh.vertices[i].Tangent.w)
+				flipped++;
+			XMVECTOR analytic = XMLoadFloat4(&mesh.vertices[i].Tangent);
+			XMVECTOR fromUvs = XMLoadFloat4(&generated[i].Tangent);
+			worstDot = std::min(worstDot, XMVectorGetX(XMVector3Dot(analytic, fromUvs)));
+		}
+		if (flipped > 0 || worstDot < 0.99f)
+			Test::Fail(__FILE__, __LINE__, std::string(shape.name) + ": " + std::to_string(flipped) +
+				" vertices with the other handedness, tangents as far apart as dot " + Test::Describe(worstDot));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "TestHarness.h"
+#include "MeshLoader.h"
+
+#include <thread>
+#include <chrono>
+#include <filesystem>
+
+// --------------------------------------------------------
+// Background imports with nothing but MemoryMeshUploader
+// behind the meshes: when they become ready, how failures
+// reach the main thread, and shutting down mid-queue
+// --------------------------------------------------------
+
+namespace
+{
+	// Separate files with the same contents, since a file can't be
+	// loaded twice at once
+	std::vector<std::string> CopiesOf(const char* fileName, unsigned int count)
+	{
+		std::string original = Test::CopyAsset(fileName);
+		std::vector<std::string> paths;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			std::filesystem::path copy = std::filesystem::path(original).parent_path() / ("copy" + std::to_string(i) + ".obj");
+			std::filesystem::copy_file(original, copy, std::filesystem::copy_options::overwrite_existing);
+			paths.push_back(copy.string());
+		}
+		return paths;
+	}
+}
+
+TEST(MeshesAreReadyOnlyOnceFinalized)
+{
+	std::string path = Test::CopyAsset("torus.obj");
+	MeshLoader loader(2);
+	CHECK_EQUAL(2u, loader.GetThreadCount());
+
+	std::shared_ptr<Mesh> mesh = loader.Load(path);
+	CHECK(mesh != nullptr);
+	CHECK(!mesh->IsReady());
+	CHECK_EQUAL((size_t)0, mesh->GetGpuBytes());
+	CHECK_EQUAL(1u, loader.GetPendingCount());
+
+	// Finished imports wait for the main thread, however long it takes
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	CHECK(!mesh->IsReady());
+
+	loader.FinalizeAll();
+	CHECK(mesh->IsReady());
+	CHECK_EQUAL(0u, loader.GetPendingCount());
+
+	// The same mesh the blocking constructor makes
+	Mesh blocking(path.c_str());
+	CHECK_EQUAL(blocking.GetVertexBufferCount(), mesh->GetVertexBufferCount());
+	CHECK_EQUAL(blocking.GetIndexBufferCount(), mesh->GetIndexBufferCount());
+	CHECK_EQUAL(blocking.GetGpuBytes(), mesh->GetGpuBytes());
+	CHECK_EQUAL(path, mesh->GetImportReport().name);
+}
+
+TEST(FinalizeReadyStopsAtItsLimit)
+{
+	std::vector<std::string> paths = CopiesOf("sphere.obj", 6);
+	MeshLoader loader(3);
+	std::vector<std::shared_ptr<Mesh>> meshes;
+	for (const std::string& path : paths)
+		meshes.push_back(loader.Load(path));
+
+	// One per call, as a frame with a budget would take them
+	unsigned int finalized = 0;
+	for (int attempt = 0; attempt < 10000 && finalized < meshes.size(); attempt++)
+	{
+		unsigned int count = loader.FinalizeReady(1);
+		CHECK(count <= 1);
+		finalized += count;
+		if (count == 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	CHECK_EQUAL((unsigned int)meshes.size(), finalized);
+	CHECK_EQUAL(0u, loader.FinalizeReady());
+	CHECK_EQUAL(0u, loader.GetPendingCount());
+
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		CHECK(meshes[i]->IsReady());
+		CHECK_EQUAL(paths[i], meshes[i]->GetImportReport().name);
+	}
+}
+
+TEST(FailedImportsThrowOnTheMainThread)
+{
+	std::string missing = Test::GetOutputDirectory() + "/missing.obj";
+	std::string path = Test::CopyAsset("cube.obj");
+
+	// One worker, so the failure is the first result
+	MeshLoader loader(1);
+	std::shared_ptr<Mesh> failed = loader.Load(missing);
+	std::shared_ptr<Mesh> loaded = loader.Load(path);
+	CHECK_THROWS(loader.FinalizeAll());
+	CHECK(!failed->IsReady());
+
+	// Results behind the failure are still there for the next call
+	loader.FinalizeAll();
+	CHECK(loaded->IsReady());
+	CHECK_EQUAL(0u, loader.GetPendingCount());
+}
+
+TEST(ShutdownDropsQueuedImports)
+{
+	std::vector<std::string> paths = CopiesOf("helix.obj", 12);
+	std::vector<std::shared_ptr<Mesh>> meshes;
+	{
+		MeshLoader loader(1);
+		for (const std::string& path : paths)
+			meshes.push_back(loader.Load(path));
+		CHECK(loader.GetPendingCount() > 0);
+	}
+
+	// Nothing was finalized, and the meshes outlive the loader safely
+	for (const std::shared_ptr<Mesh>& mesh : meshes)
+		CHECK(!mesh->IsReady());
+	meshes.clear();
+}
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "TestHarness.h"
+#include "MeshOptimizer.h"
+#include "MeshGenerator.h"
+
+#include <map>
+#include <array>
+#include <tuple>
+#include <algorithm>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// The vertex cache simulator on a strip worked out by hand,
+// and reordering that lowers the miss rate without adding,
+// losing or moving any triangle
+// --------------------------------------------------------
+
+namespace
+{
+	// A grid of columns x rows quads in the xz plane, indexed row by row
+	void MakeGrid(unsigned int columns, unsigned int rows, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		for (unsigned int z = 0; z <= rows; z++)
+		{
+			for (unsigned int x = 0; x <= columns; x++)
+			{
+				Vertex vertex = {};
+				vertex.Position = XMFLOAT3((float)x, 0.0f, (float)z);
+				vertex.Normal = XMFLOAT3(0, 1, 0);
+				vertex.UV = XMFLOAT2((float)x / columns, (float)z / rows);
+				vertices.push_back(vertex);
+			}
+		}
+		for (unsigned int z = 0; z < rows; z++)
+		{
+			for (unsigned int x = 0; x < columns; x++)
+			{
+				unsigned int corner = z * (columns + 1) + x;
+				unsigned int quad[6] = { corner, corner + columns + 1, corner + 1, corner + 1, corner + columns + 1, corner + columns + 2 };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+	}
+
+	void MakeHelix(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		MeshGenerator::Size size = MeshGenerator::HelixSize();
+		vertices.resize(size.vertexCount);
+		indices.resize(size.indexCount);
+		MeshGenerator::Helix(vertices, indices);
+	}
+
+	// Each triangle rotated to start at its lowest index (keeping its
+	// winding), counted, so two index lists can be compared as sets
+	std::map<std::array<unsigned int, 3>, int> Triangles(const unsigned int* indices, size_t indexCount)
+	{
+		std::map<std::array<unsigned int, 3>, int> triangles;
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			std::array<unsigned int, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles[triangle]++;
+		}
+		return triangles;
+	}
+
+	// The same, by position, for passes that renumber the vertices
+	using Corner = std::tuple<float, float, float>;
+	std::map<std::array<Corner, 3>, int> TrianglesByPosition(const std::vector<Vertex>& vertices, const unsigned int* indices, size_t indexCount)
+	{
+		std::map<std::array<Corner, 3>, int> triangles;
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			std::array<Corner, 3> triangle;
+			for (int c = 0; c < 3; c++)
+			{
+				const XMFLOAT3& p = vertices[indices[i + c]].Position;
+				triangle[c] = { p.x, p.y, p.z };
+			}
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles[triangle]++;
+		}
+		return triangles;
+	}
+}
+
+TEST(SimulatorMatchesAHandCountedStrip)
+{
+	// Five triangles along a strip, the last one reaching back to vertex 0.
+	// Vertex 6 is never used, so it doesn't count towards ATVR.
+	const unsigned int indices[] = { 0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5, 5, 4, 0 };
+
+	// A cache of 16 holds the whole strip: each vertex misses once
+	MeshOptimizer::CacheStats large = MeshOptimizer::SimulateVertexCache(indices, 15, 7, 16);
+	CHECK_NEAR(6.0f / 5.0f, large.acmr, 1e-6f);
+	CHECK_NEAR(1.0f, large.atvr, 1e-6f);
+
+	// A cache of 3 has pushed vertex 0 out (by 3, 4 and 5) when the last
+	// triangle comes back to it
+	MeshOptimizer::CacheStats small = MeshOptimizer::SimulateVertexCache(indices, 15, 7, 3);
+	CHECK_NEAR(7.0f / 5.0f, small.acmr, 1e-6f);
+	CHECK_NEAR(7.0f / 6.0f, small.atvr, 1e-6f);
+
+	// 16-bit indices count the same
+	const uint16_t shortIndices[] = { 0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5, 5, 4, 0 };
+	MeshOptimizer::CacheStats shortSmall = MeshOptimizer::SimulateVertexCache(shortIndices, 15, 7, 3);
+	CHECK_EQUAL(small.acmr, shortSmall.acmr);
+	CHECK_EQUAL(small.atvr, shortSmall.atvr);
+
+	// Nothing to draw
+	MeshOptimizer::CacheStats empty = MeshOptimizer::SimulateVertexCache(indices, 0, 7);
+	CHECK_EQUAL(0.0f, empty.acmr);
+	CHECK_EQUAL(0.0f, empty.atvr);
+}
+
+TEST(VertexCacheLowersTheMissRateOnAGrid)
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	MakeGrid(64, 64, vertices, indices);
+	auto before = Triangles(indices.data(), indices.size());
+	float acmr = MeshOptimizer::SimulateVertexCache(indices.data(), indices.size(), (unsigned int)vertices.size()).acmr;
+
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), (unsigned int)vertices.size());
+	float optimized = MeshOptimizer::SimulateVertexCache(indices.data(), indices.size(), (unsigned int)vertices.size()).acmr;
+
+	CHECK(optimized < acmr * 0.9f);
+	CHECK(before == Triangles(indices.data(), indices.size()));
+}
+
+TEST(VertexCacheLowersTheMissRateOnTheHelix)
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	MakeHelix(vertices, indices);
+	auto before = Triangles(indices.data(), indices.size());
+	float acmr = MeshOptimizer::SimulateVertexCache(indices.data(), indices.size(), (unsigned int)vertices.size()).acmr;
+
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), (unsigned int)vertices.size());
+	float optimized = MeshOptimizer::SimulateVertexCache(indices.data(), indices.size(), (unsigned int)vertices.size()).acmr;
+
+	CHECK(optimized < acmr * 0.9f);
+	CHECK(before == Triangles(indices.data(), indices.size()));
+}
+
+TEST(VertexFetchDropsUnusedVerticesInFirstUseOrder)
+{
+	// Each vertex is told apart by its x
+	std::vector<Vertex> vertices(6);
+	for (unsigned int i = 0; i < vertices.size(); i++)
+		vertices[i].Position = XMFLOAT3((float)i, 0, 0);
+
+	// Vertices 0 and 2 are never used
+	std::vector<unsigned int> indices = { 4, 1, 3, 3, 1, 5, 5, 1, 4 };
+	unsigned int used = MeshOptimizer::OptimizeVertexFetch(vertices.data(), (unsigned int)vertices.size(), indices.data(), indices.size());
+
+	CHECK_EQUAL(4u, used);
+	const float order[] = { 4, 1, 3, 5 };
+	for (unsigned int i = 0; i < used; i++)
+		CHECK_EQUAL(order[i], vertices[i].Position.x);
+	CHECK(indices == std::vector<unsigned int>({ 0, 1, 2, 2, 1, 3, 3, 1, 0 }));
+}
+
+TEST(OptimizeKeepsEachSubmeshsTriangles)
+{
+	// The helix, then a grid after it in the same buffers, with a few
+	// unused vertices at the end to be dropped
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	MakeHelix(vertices, indices);
+	Submesh helix = {};
+	helix.indexStart = 0;
+	helix.indexCount = (unsigned int)indices.size();
+
+	std::vector<Vertex> gridVertices;
+	std::vector<unsigned int> gridIndices;
+	MakeGrid(32, 32, gridVertices, gridIndices);
+	for (unsigned int& index : gridIndices)
+		index += (unsigned int)vertices.size();
+	for (Vertex& vertex : gridVertices)
+		vertex.Position.y = 10.0f;
+	vertices.insert(vertices.end(), gridVertices.begin(), gridVertices.end());
+	Submesh grid = {};
+	grid.indexStart = (unsigned int)indices.size();
+	grid.indexCount = (unsigned int)gridIndices.size();
+	indices.insert(indices.end(), gridIndices.begin(), gridIndices.end());
+	unsigned int usedCount = (unsigned int)vertices.size();
+	vertices.resize(vertices.size() + 5);
+
+	std::vector<Submesh> submeshes = { helix, grid };
+	std::vector<std::map<std::array<Corner, 3>, int>> before;
+	float acmr = MeshOptimizer::SimulateVertexCache(indices.data(), indices.size(), (unsigned int)vertices.size()).acmr;
+	for (const Submesh& submesh : submeshes)
+		before.push_back(TrianglesByPosition(vertices, indices.data() + submesh.indexStart, submesh.indexCount));
+
+	unsigned int vertexCount = MeshOptimizer::Optimize(vertices.data(), (unsigned int)vertices.size(), indices.data(), indices.size(), submeshes);
+	CHECK_EQUAL(usedCount, vertexCount);
+	vertices.resize(vertexCount);
+	CHECK(MeshOptimizer::SimulateVertexCache(indices.data(), indices.size(), vertexCount).acmr < acmr);
+
+	for (size_t s = 0; s < submeshes.size(); s++)
+		CHECK(before[s] == TrianglesByPosition(vertices, indices.data() + submeshes[s].indexStart, submeshes[s].indexCount));
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "TestHarness.h"
+#include "MeshImporter.h"
+#include "MemoryMeshUploader.h"
+#include "MeshLoader.h"
+#include "MeshRegistry.h"
+
+// --------------------------------------------------------
+// The whole CPU pipeline end to end, the way the game uses
+// it but with MemoryMeshUploader in place of Direct3D
+// --------------------------------------------------------
+
+namespace
+{
+	const char* BundledMeshes[] =
+	{
+		"cube.obj",
+		"cylinder.obj",
+		"helix.obj",
+		"quad.obj",
+		"QuadDoubleSided.obj",
+		"sphere.obj",
+		"torus.obj",
+	};
+
+	template<typename Index>
+	bool IndicesInRange(const std::vector<uint8_t>& bytes, unsigned int vertexCount)
+	{
+		const Index* indices = (const Index*)bytes.data();
+		for (size_t i = 0; i < bytes.size() / sizeof(Index); i++)
+			if (indices[i] >= vertexCount)
+				return false;
+		return true;
+	}
+}
+
+TEST(ImportsEveryBundledMeshInEveryFormat)
+{
+	for (const char* fileName : BundledMeshes)
+	{
+		std::string path = Test::CopyAsset(fileName);
+		for (unsigned int format = 0; format < VertexFormatCount; format++)
+		{
+			MeshImportSettings settings;
+			settings.vertexFormat = (VertexFormat)format;
+
+			// Once from the .obj, and once more from the cache it leaves
+			MemoryMeshUploader uploader;
+			MeshData imported = MeshImporter::Import(path.c_str(), settings);
+			MeshData cached = MeshImporter::Import(path.c_str(), settings);
+			CHECK(uploader.Upload(imported));
+			CHECK(uploader.Upload(cached));
+			CHECK(cached.report.fromCache);
+
+			const MemoryMeshUploader::Record& first = uploader.GetRecords()[0];
+			const MemoryMeshUploader::Record& second = uploader.GetRecords()[1];
+			CHECK_EQUAL(VertexCompression::GetStride(settings.vertexFormat), first.vertexStride);
+			CHECK_EQUAL((size_t)first.vertexStride * first.vertexCount, first.vertices.size());
+			CHECK_EQUAL((size_t)first.indexStride * first.indexCount, first.indices.size());
+			CHECK(first.vertexCount > 0);
+			CHECK_EQUAL(0u, first.indexCount % 3);
+			CHECK(first.indexStride == sizeof(uint16_t) ?
+				IndicesInRange<uint16_t>(first.indices, first.vertexCount) :
+				IndicesInRange<uint32_t>(first.indices, first.vertexCount));
+
+			// The cache must give back exactly what was uploaded the first time
+			CHECK(first.vertices == second.vertices);
+			CHECK(first.indices == second.indices);
+
+			CHECK_EQUAL(imported.lods.size(), (size_t)imported.report.lodCount);
+			CHECK_EQUAL(0u, imported.report.degenerateTriangleCount);
+			CHECK_EQUAL(imported.report.triangleCount, cached.report.triangleCount);
+		}
+	}
+}
+
+TEST(GeneratedMeshesUploadWithoutAFile)
+{
+	std::vector<Vertex> vertices = { {}, {}, {} };
+	vertices[0].Position = DirectX::XMFLOAT3(0, 0, 0);
+	vertices[1].Position = DirectX::XMFLOAT3(0, 1, 0);
+	vertices[2].Position = DirectX::XMFLOAT3(1, 0, 0);
+	unsigned int indices[] = { 0, 1, 2 };
+
+	MemoryMeshUploader uploader;
+	CHECK(uploader.Upload(MeshImporter::FromArrays(vertices.data(), indices, 3, 3)));
+	CHECK_EQUAL(3u, uploader.GetRecords()[0].vertexCount);
+	CHECK_EQUAL(sizeof(Vertex) * 3 + sizeof(uint16_t) * 3, uploader.GetTotalBytes());
+}
+
+TEST(LoaderAndRegistryRunWithoutAGraphicsDevice)
+{
+	std::string sphere = Test::CopyAsset("sphere.obj");
+	std::string torus = Test::CopyAsset("torus.obj");
+
+	MeshLoader loader(2);
+	MeshRegistry registry(loader);
+	std::shared_ptr<Mesh> first = registry.Get(sphere);
+	std::shared_ptr<Mesh> again = registry.Get(sphere);
+	std::shared_ptr<Mesh> other = registry.Get(torus);
+	CHECK(first == again);
+	CHECK(first != other);
+
+	loader.FinalizeAll();
+	CHECK(first->IsReady());
+	CHECK(other->IsReady());
+	CHECK(first->GetGpuBytes() > 0);
+	CHECK_EQUAL(0u, loader.GetPendingCount());
+
+	// Drawing has nothing to draw with here, but must still be safe to call
+	first->Draw();
+	first->DrawLod(first->GetLodCount());
+
+	MeshRegistry::Stats stats = registry.GetStats();
+	CHECK_EQUAL(2u, stats.meshes);
+	CHECK_EQUAL(0u, stats.loading);
+	CHECK_EQUAL(1u, stats.sharedRequests);
+}
\ No newline at end of file
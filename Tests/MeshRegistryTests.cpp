@@ -0,0 +1,128 @@
+#include "TestHarness.h"
+#include "MeshLoader.h"
+#include "MeshRegistry.h"
+
+#include <filesystem>
+
+// --------------------------------------------------------
+// Sharing, duplicate contents and eviction in MeshRegistry,
+// with imports on a real MeshLoader
+// --------------------------------------------------------
+
+namespace
+{
+	// A second file with the same bytes as the bundled mesh
+	std::string CopyUnderAnotherName(const std::string& path, const char* fileName)
+	{
+		std::filesystem::path copy = std::filesystem::path(path).parent_path() / fileName;
+		std::filesystem::copy_file(path, copy, std::filesystem::copy_options::overwrite_existing);
+		return copy.string();
+	}
+}
+
+TEST(GetLeavesMissingFilesToTheLoader)
+{
+	std::string missing = Test::GetOutputDirectory() + "/missing.obj";
+
+	MeshLoader loader(1);
+	MeshRegistry registry(loader);
+	std::shared_ptr<Mesh> mesh = registry.Get(missing);
+	CHECK(mesh != nullptr);
+	CHECK_THROWS(loader.FinalizeAll());
+	CHECK(!mesh->IsReady());
+
+	registry.Update();
+	CHECK_EQUAL(0u, registry.GetStats().duplicates);
+}
+
+TEST(SpellingsOfOnePathShareAMesh)
+{
+	std::string sphere = Test::CopyAsset("sphere.obj");
+	std::string spelledDifferently = (std::filesystem::path(sphere).parent_path() / "." / "sphere.obj").string();
+
+	MeshLoader loader(1);
+	MeshRegistry registry(loader);
+	std::shared_ptr<Mesh> first = registry.Get(sphere);
+	std::shared_ptr<Mesh> second = registry.Get(spelledDifferently);
+	CHECK(first == second);
+	CHECK_EQUAL(1u, registry.GetStats().sharedRequests);
+	loader.FinalizeAll();
+}
+
+TEST(CopiesAreMergedOnceImported)
+{
+	std::string sphere = Test::CopyAsset("sphere.obj");
+	std::string copy = CopyUnderAnotherName(sphere, "copy.obj");
+
+	MeshLoader loader(1);
+	MeshRegistry registry(loader);
+	std::shared_ptr<Mesh> original = registry.Get(sphere);
+	std::shared_ptr<Mesh> duplicate = registry.Get(copy);
+
+	// Nothing is known about the contents until the imports hash them
+	CHECK(original != duplicate);
+	CHECK_EQUAL(2u, registry.GetStats().meshes);
+
+	loader.FinalizeAll();
+	CHECK_EQUAL(original->GetImportReport().sourceHash, duplicate->GetImportReport().sourceHash);
+	CHECK(original->GetImportReport().sourceHash != 0);
+
+	registry.Update();
+	CHECK_EQUAL(1u, registry.GetStats().duplicates);
+	CHECK(registry.Get(copy) == original);
+
+	// The duplicate stays alive while it's held, then goes on the next update
+	CHECK_EQUAL(2u, registry.GetStats().meshes);
+	duplicate.reset();
+	registry.Update();
+	CHECK_EQUAL(1u, registry.GetStats().meshes);
+	CHECK(registry.Get(sphere) == original);
+	CHECK(registry.Get(copy) == original);
+}
+
+TEST(DifferentSettingsAreNotDuplicates)
+{
+	std::string sphere = Test::CopyAsset("sphere.obj");
+	std::string copy = CopyUnderAnotherName(sphere, "copy.obj");
+
+	MeshImportSettings compact;
+	compact.vertexFormat = VertexFormat::Compact;
+
+	MeshLoader loader(1);
+	MeshRegistry registry(loader);
+	std::shared_ptr<Mesh> full = registry.Get(sphere);
+	std::shared_ptr<Mesh> other = registry.Get(copy, compact);
+	loader.FinalizeAll();
+	registry.Update();
+
+	CHECK_EQUAL(0u, registry.GetStats().duplicates);
+	CHECK(registry.Get(copy, compact) == other);
+	CHECK(registry.Get(copy) != full);
+	loader.FinalizeAll();
+}
+
+TEST(EvictsOnlyUnreferencedMeshes)
+{
+	std::string sphere = Test::CopyAsset("sphere.obj");
+	std::string torus = Test::CopyAsset("torus.obj");
+
+	MeshLoader loader(1);
+	MeshRegistry registry(loader, 0);
+	std::shared_ptr<Mesh> held = registry.Get(sphere);
+	std::weak_ptr<Mesh> released = registry.Get(torus);
+	loader.FinalizeAll();
+
+	// Over a budget of nothing, but the held mesh must stay
+	registry.Update();
+	MeshRegistry::Stats stats = registry.GetStats();
+	CHECK_EQUAL(1u, stats.meshes);
+	CHECK_EQUAL(1u, stats.evictions);
+	CHECK(released.expired());
+	CHECK(registry.Get(sphere) == held);
+
+	// An evicted mesh is imported again when it's asked for
+	std::shared_ptr<Mesh> reloaded = registry.Get(torus);
+	loader.FinalizeAll();
+	CHECK(reloaded->IsReady());
+	CHECK(reloaded->GetImportReport().fromCache);
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "TestHarness.h"
+#include "MeshSimplifier.h"
+
+#include <set>
+#include <map>
+#include <cmath>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Level of detail chains, and the outlines of submeshes
+// staying where they were while their insides simplify
+// --------------------------------------------------------
+
+namespace
+{
+	// A grid of columns x rows quads in the xz plane, lifted into a
+	// gentle hill when curved (so collapses have a cost)
+	void MakeGrid(unsigned int columns, unsigned int rows, bool curved, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		for (unsigned int z = 0; z <= rows; z++)
+		{
+			for (unsigned int x = 0; x <= columns; x++)
+			{
+				Vertex vertex = {};
+				float height = curved ? 0.5f * std::sin(3.14159265f * x / columns) * std::sin(3.14159265f * z / rows) : 0.0f;
+				vertex.Position = XMFLOAT3((float)x, height, (float)z);
+				vertex.Normal = XMFLOAT3(0, 1, 0);
+				vertex.UV = XMFLOAT2((float)x / columns, (float)z / rows);
+				vertices.push_back(vertex);
+			}
+		}
+		for (unsigned int z = 0; z < rows; z++)
+		{
+			for (unsigned int x = 0; x < columns; x++)
+			{
+				unsigned int corner = z * (columns + 1) + x;
+				unsigned int quad[6] = { corner, corner + columns + 1, corner + 1, corner + 1, corner + columns + 1, corner + columns + 2 };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+	}
+
+	// Edges used by only one triangle (in one direction), as vertex pairs
+	std::set<std::pair<unsigned int, unsigned int>> OpenEdges(const unsigned int* indices, size_t indexCount)
+	{
+		std::map<std::pair<unsigned int, unsigned int>, int> uses;
+		for (size_t i = 0; i < indexCount; i += 3)
+			for (int c = 0; c < 3; c++)
+				uses[{ indices[i + c], indices[i + (c + 1) % 3] }]++;
+
+		std::set<std::pair<unsigned int, unsigned int>> open;
+		for (const auto& [edge, count] : uses)
+			if (uses.find({ edge.second, edge.first }) == uses.end())
+				open.insert(edge);
+		return open;
+	}
+
+	// The vertices along each open edge, so an outline can be compared
+	// after its edges were split differently
+	std::set<unsigned int> OutlineVertices(const unsigned int* indices, size_t indexCount)
+	{
+		std::set<unsigned int> vertices;
+		for (const auto& edge : OpenEdges(indices, indexCount))
+		{
+			vertices.insert(edge.first);
+			vertices.insert(edge.second);
+		}
+		return vertices;
+	}
+}
+
+TEST(FlatGridReachesTheTargetWithoutError)
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	MakeGrid(16, 16, false, vertices, indices);
+
+	std::vector<unsigned int> output;
+	size_t target = indices.size() / 4 / 3 * 3;
+	float error = MeshSimplifier::Simplify(vertices.data(), (unsigned int)vertices.size(), indices.data(), indices.size(), target, 1.0f, output);
+	CHECK(output.size() <= target);
+	CHECK(!output.empty());
+	CHECK_EQUAL(0u, (unsigned int)(output.size() % 3));
+	CHECK_NEAR(0.0, error, 1e-5);
+
+	// Only the inside simplifies; the border keeps every vertex it had
+	CHECK(OutlineVertices(indices.data(), indices.size()) == OutlineVertices(output.data(), output.size()));
+}
+
+TEST(ErrorLimitStopsSimplification)
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	MakeGrid(16, 16, true, vertices, indices);
+
+	std::vector<unsigned int> loose, strict;
+	MeshSimplifier::Simplify(vertices.data(), (unsigned int)vertices.size(), indices.data(), indices.size(), 0, 1.0f, loose);
+	float error = MeshSimplifier::Simplify(vertices.data(), (unsigned int)vertices.size(), indices.data(), indices.size(), 0, 1e-3f, strict);
+	CHECK(error <= 1e-3f);
+	CHECK(strict.size() > loose.size());
+	CHECK(strict.size() < indices.size());
+}
+
+TEST(LodChainShrinksWithGrowingError)
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	MakeGrid(32, 32, true, vertices, indices);
+	size_t fullIndexCount = indices.size();
+	std::vector<Submesh> submeshes = { { 0, (unsigned int)fullIndexCount, "", "" } };
+
+	std::vector<MeshLod> lods = MeshSimplifier::BuildLods(vertices.data(), (unsigned int)vertices.size(), indices, submeshes);
+	CHECK(lods.size() > 2);
+	CHECK_EQUAL(0u, lods[0].indexStart);
+	CHECK_EQUAL((unsigned int)fullIndexCount, lods[0].indexCount);
+	CHECK_EQUAL(0.0f, lods[0].error);
+	for (size_t i = 1; i < lods.size(); i++)
+	{
+		CHECK_EQUAL(lods[i - 1].indexStart + lods[i - 1].indexCount, lods[i].indexStart);
+		CHECK(lods[i].indexCount <= lods[i - 1].indexCount * 0.8f);
+		CHECK(lods[i].error >= lods[i - 1].error);
+	}
+	CHECK_EQUAL((size_t)lods.back().indexStart + lods.back().indexCount, indices.size());
+}
+
+TEST(SubmeshesKeepTheirOwnVerticesAndSharedEdge)
+{
+	// Two submeshes meeting along the middle row, sharing its vertices
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	MakeGrid(24, 24, true, vertices, indices);
+	unsigned int half = (unsigned int)indices.size() / 2;
+	std::vector<Submesh> submeshes = { { 0, half, "south", "" }, { half, half, "north", "" } };
+
+	std::vector<std::set<unsigned int>> used(2);
+	for (unsigned int s = 0; s < 2; s++)
+		used[s].insert(indices.begin() + submeshes[s].indexStart, indices.begin() + submeshes[s].indexStart + submeshes[s].indexCount);
+	std::vector<std::set<unsigned int>> outlines(2);
+	for (unsigned int s = 0; s < 2; s++)
+		outlines[s] = OutlineVertices(indices.data() + submeshes[s].indexStart, submeshes[s].indexCount);
+
+	std::vector<MeshLod> lods = MeshSimplifier::BuildLods(vertices.data(), (unsigned int)vertices.size(), indices, submeshes);
+	CHECK(lods.size() > 1);
+
+	// Each level is the south triangles, then the north ones. Where one
+	// ends is the first triangle using a vertex only the north has.
+	for (size_t l = 1; l < lods.size(); l++)
+	{
+		const unsigned int* level = indices.data() + lods[l].indexStart;
+		size_t split = 0;
+		while (split < lods[l].indexCount && used[0].count(level[split]) && used[0].count(level[split + 1]) && used[0].count(level[split + 2]))
+			split += 3;
+		CHECK(split > 0 && split < lods[l].indexCount);
+
+		for (size_t i = split; i < lods[l].indexCount; i++)
+			CHECK(used[1].count(level[i]) == 1);
+		CHECK(OutlineVertices(level, split) == outlines[0]);
+		CHECK(OutlineVertices(level + split, lods[l].indexCount - split) == outlines[1]);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "TestHarness.h"
+#include "MeshletBuilder.h"
+#include "MeshletCuller.h"
+#include "MeshGenerator.h"
+
+#include <set>
+#include <cmath>
+#include <random>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Meshlet limits and bounds, and culling that only ever
+// skips triangles that really can't be seen
+// --------------------------------------------------------
+
+namespace
+{
+	struct TestMesh
+	{
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+		std::vector<Submesh> submeshes;
+		std::vector<Meshlet> meshlets;
+	};
+
+	// A sphere and a torus after it in the same buffers, as two submeshes
+	TestMesh MakeMesh(unsigned int maxVertices = MeshletBuilder::MaxVertices, unsigned int maxTriangles = MeshletBuilder::MaxTriangles)
+	{
+		MeshGenerator::Size sphere = MeshGenerator::SphereSize(48, 24);
+		MeshGenerator::Size torus = MeshGenerator::TorusSize(40, 20);
+
+		TestMesh mesh;
+		mesh.vertices.resize(sphere.vertexCount + torus.vertexCount);
+		mesh.indices.resize(sphere.indexCount + torus.indexCount);
+		MeshGenerator::Sphere(std::span(mesh.vertices).first(sphere.vertexCount), std::span(mesh.indices).first(sphere.indexCount), 48, 24);
+		MeshGenerator::Torus(std::span(mesh.vertices).subspan(sphere.vertexCount), std::span(mesh.indices).subspan(sphere.indexCount), 40, 20);
+
+		// The torus sits beside the sphere, using its own vertices
+		for (unsigned int i = sphere.vertexCount; i < mesh.vertices.size(); i++)
+			mesh.vertices[i].Position.x += 3.0f;
+		for (unsigned int i = sphere.indexCount; i < mesh.indices.size(); i++)
+			mesh.indices[i] += sphere.vertexCount;
+
+		mesh.submeshes = { { 0, sphere.indexCount, "sphere", "" }, { sphere.indexCount, torus.indexCount, "torus", "" } };
+		mesh.meshlets = MeshletBuilder::Build(mesh.vertices.data(), (unsigned int)mesh.vertices.size(), mesh.indices.data(), mesh.submeshes, maxVertices, maxTriangles);
+		return mesh;
+	}
+
+	// Clockwise from the front, like the rasterizer
+	XMVECTOR TriangleNormal(const TestMesh& mesh, size_t firstIndex)
+	{
+		XMVECTOR p0 = XMLoadFloat3(&mesh.vertices[mesh.indices[firstIndex]].Position);
+		XMVECTOR p1 = XMLoadFloat3(&mesh.vertices[mesh.indices[firstIndex + 1]].Position);
+		XMVECTOR p2 = XMLoadFloat3(&mesh.vertices[mesh.indices[firstIndex + 2]].Position);
+		return XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+	}
+
+	// True when a triangle's front could be seen from the point
+	bool FacesPoint(const TestMesh& mesh, size_t firstIndex, FXMVECTOR point)
+	{
+		XMVECTOR p0 = XMLoadFloat3(&mesh.vertices[mesh.indices[firstIndex]].Position);
+		return XMVectorGetX(XMVector3Dot(TriangleNormal(mesh, firstIndex), XMVectorSubtract(point, p0))) > 0.0f;
+	}
+
+	XMMATRIX LookAt(FXMVECTOR eye, FXMVECTOR target)
+	{
+		return XMMatrixLookToLH(eye, XMVectorSubtract(target, eye), XMVectorSet(0, 1, 0, 0));
+	}
+}
+
+TEST(MeshletsTileEachSubmeshWithinTheLimits)
+{
+	const unsigned int limits[][2] = { { 64, 124 }, { 32, 16 }, { 3, 1 }, { 255, 512 } };
+	for (const auto& limit : limits)
+	{
+		TestMesh mesh = MakeMesh(limit[0], limit[1]);
+		CHECK(!mesh.meshlets.empty());
+
+		size_t submesh = 0;
+		unsigned int expectedStart = 0;
+		for (const Meshlet& meshlet : mesh.meshlets)
+		{
+			// Back to back, in order, and never reaching into the next submesh
+			if (meshlet.indexStart == mesh.submeshes[submesh].indexStart + mesh.submeshes[submesh].indexCount)
+				submesh++;
+			CHECK_EQUAL(expectedStart, meshlet.indexStart);
+			CHECK(meshlet.indexStart + meshlet.indexCount <= mesh.submeshes[submesh].indexStart + mesh.submeshes[submesh].indexCount);
+			expectedStart = meshlet.indexStart + meshlet.indexCount;
+
+			std::set<unsigned int> vertices(mesh.indices.begin() + meshlet.indexStart, mesh.indices.begin() + meshlet.indexStart + meshlet.indexCount);
+			CHECK(vertices.size() <= limit[0]);
+			CHECK(meshlet.indexCount > 0);
+			CHECK(meshlet.indexCount % 3 == 0);
+			CHECK(meshlet.indexCount / 3 <= limit[1]);
+		}
+		CHECK_EQUAL((unsigned int)mesh.indices.size(), expectedStart);
+	}
+
+	// One triangle per meshlet when that's all that fits
+	TestMesh single = MakeMesh(3, 1);
+	CHECK_EQUAL(single.indices.size() / 3, single.meshlets.size());
+}
+
+TEST(BoundsHoldEveryTriangle)
+{
+	TestMesh mesh = MakeMesh();
+	unsigned int usableCones = 0;
+	for (const Meshlet& meshlet : mesh.meshlets)
+	{
+		XMVECTOR center = XMLoadFloat3(&meshlet.bounds.Center);
+		for (unsigned int i = meshlet.indexStart; i < meshlet.indexStart + meshlet.indexCount; i++)
+		{
+			float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&mesh.vertices[mesh.indices[i]].Position), center)));
+			CHECK(distance <= meshlet.bounds.Radius * (1.0f + 1e-5f));
+		}
+
+		if (meshlet.coneCutoff >= 1.0f)
+			continue;
+		usableCones++;
+
+		// Every normal within the cone: at least cos(half angle) along the axis
+		float minimumDot = std::sqrt(1.0f - meshlet.coneCutoff * meshlet.coneCutoff);
+		for (unsigned int i = meshlet.indexStart; i < meshlet.indexStart + meshlet.indexCount; i += 3)
+		{
+			XMVECTOR normal = TriangleNormal(mesh, i);
+			if (XMVectorGetX(XMVector3LengthSq(normal)) == 0.0f)
+				continue;
+			float along = XMVectorGetX(XMVector3Dot(XMVector3Normalize(normal), XMLoadFloat3(&meshlet.coneAxis)));
+			CHECK(along >= minimumDot - 1e-5f);
+		}
+	}
+	CHECK(usableCones > mesh.meshlets.size() / 2);
+}
+
+TEST(ConeTestNeverRejectsAVisibleTriangle)
+{
+	TestMesh mesh = MakeMesh();
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> coordinate(-8.0f, 8.0f);
+
+	unsigned int rejected = 0;
+	for (int viewpoint = 0; viewpoint < 200; viewpoint++)
+	{
+		XMVECTOR eye = XMVectorSet(coordinate(random), coordinate(random), coordinate(random), 1.0f);
+		for (const Meshlet& meshlet : mesh.meshlets)
+		{
+			if (meshlet.coneCutoff >= 1.0f)
+				continue;
+
+			// The test MeshletCuller makes, straight from Meshlet's description
+			XMVECTOR toCenter = XMVectorSubtract(XMLoadFloat3(&meshlet.bounds.Center), eye);
+			float along = XMVectorGetX(XMVector3Dot(toCenter, XMLoadFloat3(&meshlet.coneAxis)));
+			if (along < meshlet.coneCutoff * XMVectorGetX(XMVector3Length(toCenter)) + meshlet.bounds.Radius)
+				continue;
+
+			rejected++;
+			for (unsigned int i = meshlet.indexStart; i < meshlet.indexStart + meshlet.indexCount; i += 3)
+				CHECK(!FacesPoint(mesh, i, eye));
+		}
+	}
+	CHECK(rejected > 0);
+}
+
+TEST(CullerKeepsEverythingOnScreenAndFacingTheCamera)
+{
+	TestMesh mesh = MakeMesh();
+	XMVECTOR eye = XMVectorSet(-0.5f, 0.5f, -3.5f, 1.0f);
+	XMMATRIX view = LookAt(eye, XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 1.0f, 0.1f, 100.0f);
+
+	std::vector<IndexRange> ranges;
+	MeshletCuller::Stats stats = MeshletCuller::Cull(mesh.meshlets, XMMatrixIdentity(), view, projection, true, ranges);
+	CHECK_EQUAL((unsigned int)mesh.meshlets.size(), stats.meshlets);
+	CHECK_EQUAL(stats.meshlets, stats.visibleMeshlets + stats.frustumCulled + stats.backfaceCulled);
+	CHECK_EQUAL((unsigned int)mesh.indices.size() / 3, stats.triangles);
+	CHECK(stats.backfaceCulled > 0);
+	CHECK(stats.frustumCulled > 0);
+
+	// Ranges are sorted, merged where they touch, and add up to the visible triangles
+	std::vector<bool> drawn(mesh.indices.size() / 3, false);
+	unsigned int drawnTriangles = 0;
+	for (size_t r = 0; r < ranges.size(); r++)
+	{
+		if (r > 0)
+			CHECK(ranges[r - 1].indexStart + ranges[r - 1].indexCount < ranges[r].indexStart);
+		for (unsigned int i = ranges[r].indexStart; i < ranges[r].indexStart + ranges[r].indexCount; i += 3)
+			drawn[i / 3] = true;
+		drawnTriangles += ranges[r].indexCount / 3;
+	}
+	CHECK_EQUAL(stats.visibleTriangles, drawnTriangles);
+
+	// Every triangle left out is facing away or entirely off screen
+	XMMATRIX viewProjection = XMMatrixMultiply(view, projection);
+	for (size_t t = 0; t < drawn.size(); t++)
+	{
+		if (drawn[t] || !FacesPoint(mesh, t * 3, eye))
+			continue;
+
+		bool outsideOnePlane = false;
+		for (int axis = 0; axis < 3 && !outsideOnePlane; axis++)
+		{
+			bool allBelow = true, allAbove = true;
+			for (int c = 0; c < 3; c++)
+			{
+				XMFLOAT4 clip;
+				XMStoreFloat4(&clip, XMVector4Transform(XMVectorSetW(XMLoadFloat3(&mesh.vertices[mesh.indices[t * 3 + c]].Position), 1.0f), viewProjection));
+				float value = axis == 0 ? clip.x : axis == 1 ? clip.y : clip.z;
+				float low = axis == 2 ? 0.0f : -clip.w;
+				allBelow = allBelow && value < low;
+				allAbove = allAbove && value > clip.w;
+			}
+			outsideOnePlane = allBelow || allAbove;
+		}
+		CHECK(outsideOnePlane);
+	}
+}
+
+TEST(CullerSkipsConeTestsWhenMirroredOrDisabled)
+{
+	TestMesh mesh = MakeMesh();
+	XMMATRIX view = LookAt(XMVectorSet(1.5f, 0.0f, -10.0f, 1.0f), XMVectorSet(1.5f, 0.0f, 0.0f, 1.0f));
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, 0.1f, 100.0f);
+	std::vector<IndexRange> ranges;
+
+	MeshletCuller::Stats normal = MeshletCuller::Cull(mesh.meshlets, XMMatrixIdentity(), view, projection, true, ranges);
+	CHECK(normal.backfaceCulled > 0);
+
+	MeshletCuller::Stats disabled = MeshletCuller::Cull(mesh.meshlets, XMMatrixIdentity(), view, projection, false, ranges);
+	CHECK_EQUAL(0u, disabled.backfaceCulled);
+	CHECK_EQUAL(normal.visibleMeshlets + normal.backfaceCulled, disabled.visibleMeshlets);
+
+	// Mirroring turns the rasterizer's idea of front faces around
+	MeshletCuller::Stats mirrored = MeshletCuller::Cull(mesh.meshlets, XMMatrixScaling(-1.0f, 1.0f, 1.0f), view, projection, true, ranges);
+	CHECK_EQUAL(0u, mirrored.backfaceCulled);
+}
+
+TEST(CullerWorksInTheMeshsLocalSpace)
+{
+	// Moving the mesh and the camera together changes nothing
+	TestMesh mesh = MakeMesh();
+	XMVECTOR eye = XMVectorSet(0.0f, 2.0f, -5.0f, 1.0f);
+	XMMATRIX view = LookAt(eye, XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+	XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 1.0f, 0.1f, 100.0f);
+	std::vector<IndexRange> local, moved;
+	MeshletCuller::Stats localStats = MeshletCuller::Cull(mesh.meshlets, XMMatrixIdentity(), view, projection, true, local);
+
+	XMMATRIX world = XMMatrixMultiply(XMMatrixScaling(2.0f, 2.0f, 2.0f), XMMatrixTranslation(10.0f, -3.0f, 7.0f));
+	XMMATRIX movedView = LookAt(XMVector3TransformCoord(eye, world), XMVectorSet(10.0f, -3.0f, 7.0f, 1.0f));
+	MeshletCuller::Stats movedStats = MeshletCuller::Cull(mesh.meshlets, world, movedView, projection, true, moved);
+
+	CHECK_EQUAL(localStats.visibleMeshlets, movedStats.visibleMeshlets);
+	CHECK_EQUAL(localStats.backfaceCulled, movedStats.backfaceCulled);
+	CHECK_EQUAL(local.size(), moved.size());
+}
\ No newline at end of file
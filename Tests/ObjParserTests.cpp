@@ -0,0 +1,467 @@
+#include "TestHarness.h"
+#include "ObjParser.h"
+#include "MeshSink.h"
+#include "MeshImporter.h"
+#include "SyntheticObj.h"
+
+#include <cfloat>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+// --------------------------------------------------------
+// The hand-written number scanners, checked against the C
+// runtime on the same text
+// --------------------------------------------------------
+
+namespace
+{
+	// Scans one number from the text, checking that the cursor ends up
+	// exactly where the number stopped
+	float Float(const char* text, size_t expectedLength)
+	{
+		const char* cursor = text;
+		float value = ObjParser::ScanFloat(cursor, text + strlen(text));
+		CHECK_EQUAL(expectedLength, (size_t)(cursor - text));
+		return value;
+	}
+
+	int Int(const char* text)
+	{
+		const char* cursor = text;
+		return ObjParser::ScanInt(cursor, text + strlen(text));
+	}
+
+	bool SameBits(float a, float b)
+	{
+		return memcmp(&a, &b, sizeof(float)) == 0;
+	}
+}
+
+TEST(ScanFloatMatchesStrtof)
+{
+	const char* numbers[] =
+	{
+		"0", "1", "-1", "+2.5", "0.500000", "-0.000001", "123456.789",
+		"3.14159265358979323846", ".25", "-.75", "5.", "1e3", "1E-3",
+		"-2.5e+2", "6.02214076e23", "1.17549435e-38", "3.40282346e38",
+		"0.1", "0.2", "0.3", "0.7", "-0.866025", "1234567890123456789012",
+		"0.000000000000000000000000000001",
+	};
+
+	for (const char* text : numbers)
+	{
+		float expected = strtof(text, 0);
+		float scanned = Float(text, strlen(text));
+		if (!SameBits(expected, scanned))
+			Test::Fail(__FILE__, __LINE__, std::string(text) + " scanned as " + Test::Describe(scanned));
+	}
+}
+
+TEST(ScanFloatKeepsZeroWithHugeExponents)
+{
+	float zero = Float("0e999", 5);
+	CHECK(SameBits(0.0f, zero));
+	CHECK(SameBits(-0.0f, Float("-0.000e99999", 12)));
+	CHECK(SameBits(0.0f, Float("0.0E-999", 8)));
+}
+
+TEST(ScanFloatSaturatesOutOfRangeExponents)
+{
+	CHECK_EQUAL(INFINITY, Float("1e999", 5));
+	CHECK_EQUAL(-INFINITY, Float("-7.5e4000000000", 15));
+	CHECK(SameBits(0.0f, Float("1e-999", 6)));
+	CHECK(SameBits(-0.0f, Float("-1e-4000000000", 14)));
+}
+
+TEST(ScanFloatStopsAtTheEndOfTheNumber)
+{
+	const char text[] = "  \t-1.5 2.25/";
+	const char* cursor = text;
+	const char* end = text + strlen(text);
+	CHECK_EQUAL(-1.5f, ObjParser::ScanFloat(cursor, end));
+	CHECK_EQUAL(' ', *cursor);
+	CHECK_EQUAL(2.25f, ObjParser::ScanFloat(cursor, end));
+	CHECK_EQUAL('/', *cursor);
+
+	// The end pointer may cut a number short
+	const char cut[] = "12345";
+	cursor = cut;
+	CHECK_EQUAL(123.0f, ObjParser::ScanFloat(cursor, cut + 3));
+	CHECK(cursor == cut + 3);
+}
+
+TEST(ScanIntReadsSignsAndStops)
+{
+	CHECK_EQUAL(0, Int("0"));
+	CHECK_EQUAL(42, Int("  42/7"));
+	CHECK_EQUAL(-3, Int("-3//"));
+	CHECK_EQUAL(17, Int("+17"));
+	CHECK_EQUAL(INT_MAX, Int("2147483647"));
+	CHECK_EQUAL(-INT_MAX, Int("-2147483647"));
+
+	const char text[] = "12/34";
+	const char* cursor = text;
+	CHECK_EQUAL(12, ObjParser::ScanInt(cursor, text + 5));
+	CHECK_EQUAL('/', *cursor);
+}
+
+TEST(ScanIntSaturatesInsteadOfOverflowing)
+{
+	CHECK_EQUAL(INT_MAX, Int("2147483648"));
+	CHECK_EQUAL(INT_MAX, Int("99999999999999999999999999999"));
+	CHECK_EQUAL(-INT_MAX, Int("-2147483648"));
+	CHECK_EQUAL(-INT_MAX, Int("-99999999999999999999999999999"));
+
+	// All of the digits are consumed, however many there are
+	const char text[] = "123456789012345678901234567890 5";
+	const char* cursor = text;
+	ObjParser::ScanInt(cursor, text + strlen(text));
+	CHECK_EQUAL(5, ObjParser::ScanInt(cursor, text + strlen(text)));
+}
+
+TEST(OverflowingFaceIndicesAreReportedOutOfRange)
+{
+	const char text[] =
+		"v 0 0 0\n"
+		"v 1 0 0\n"
+		"v 0 1 0\n"
+		"f 1 2 99999999999999999999\n"
+		"f 1 2 -99999999999999999999\n";
+
+	for (unsigned int threads : { 1u, 2u })
+	{
+		ObjParser::ObjData data;
+		ObjParser::ParseParallel(text, text + strlen(text), data, threads);
+		CHECK_EQUAL((size_t)6, data.triangles.size());
+
+		ObjParser::SourceCounter counter;
+		for (const ObjParser::FaceCorner& corner : data.triangles)
+			counter.AddCorner(data, corner);
+		CHECK_EQUAL(2u, counter.Finish(data).invalidIndexCount);
+	}
+}
+
+// --------------------------------------------------------
+// Faces: every corner form, polygons of any size, relative
+// indices, and chunked parses matching serial ones
+// --------------------------------------------------------
+
+namespace
+{
+	ObjParser::ObjData ParseText(const std::string& text, unsigned int threadCount = 1)
+	{
+		ObjParser::ObjData data;
+		ObjParser::ParseParallel(text.data(), text.data() + text.size(), data, threadCount);
+		return data;
+	}
+
+	bool SameCorner(const ObjParser::FaceCorner& a, const ObjParser::FaceCorner& b)
+	{
+		return a.position == b.position && a.uv == b.uv && a.normal == b.normal;
+	}
+
+	bool SameData(const ObjParser::ObjData& a, const ObjParser::ObjData& b)
+	{
+		if (a.positions.size() != b.positions.size() ||
+			a.normals.size() != b.normals.size() ||
+			a.uvs.size() != b.uvs.size() ||
+			a.triangles.size() != b.triangles.size() ||
+			a.markers.size() != b.markers.size())
+			return false;
+
+		for (size_t i = 0; i < a.triangles.size(); i++)
+			if (!SameCorner(a.triangles[i], b.triangles[i]))
+				return false;
+		for (size_t i = 0; i < a.markers.size(); i++)
+			if (a.markers[i].corner != b.markers[i].corner || a.markers[i].type != b.markers[i].type || a.markers[i].name != b.markers[i].name)
+				return false;
+
+		return
+			memcmp(a.positions.data(), b.positions.data(), a.positions.size() * sizeof(DirectX::XMFLOAT3)) == 0 &&
+			memcmp(a.normals.data(), b.normals.data(), a.normals.size() * sizeof(DirectX::XMFLOAT3)) == 0 &&
+			memcmp(a.uvs.data(), b.uvs.data(), a.uvs.size() * sizeof(DirectX::XMFLOAT2)) == 0;
+	}
+
+	const char* Attributes =
+		"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0.5 1.5 0\n"
+		"vt 0 0\nvt 1 0\nvt 1 1\n"
+		"vn 0 0 1\nvn 0 0 -1\n";
+}
+
+TEST(AllFourCornerFormsParse)
+{
+	ObjParser::ObjData data = ParseText(std::string(Attributes) +
+		"f 1 2 3\n"
+		"f 1/1 2/2 3/3\n"
+		"f 1//2 2//2 3//1\n"
+		"f 1/3/2 2/2/1 3/1/2\n");
+	CHECK_EQUAL((size_t)12, data.triangles.size());
+
+	const ObjParser::FaceCorner expected[12] =
+	{
+		{ 1, 0, 0 }, { 2, 0, 0 }, { 3, 0, 0 },
+		{ 1, 1, 0 }, { 2, 2, 0 }, { 3, 3, 0 },
+		{ 1, 0, 2 }, { 2, 0, 2 }, { 3, 0, 1 },
+		{ 1, 3, 2 }, { 2, 2, 1 }, { 3, 1, 2 },
+	};
+	for (size_t i = 0; i < 12 && i < data.triangles.size(); i++)
+		CHECK(SameCorner(expected[i], data.triangles[i]));
+}
+
+TEST(PolygonsFanAroundTheirFirstCorner)
+{
+	ObjParser::ObjData data = ParseText(std::string(Attributes) +
+		"f 1 2 3 4 5\n"
+		"f 1/1/1 2/2/1 3/3/1 4/1/1\n"
+		"f 1 2\n");
+
+	// A pentagon, then a quad; the two-corner face isn't a polygon at all
+	const int positions[] = { 1, 2, 3, 1, 3, 4, 1, 4, 5, 1, 2, 3, 1, 3, 4 };
+	CHECK_EQUAL((size_t)15, data.triangles.size());
+	for (size_t i = 0; i < 15 && i < data.triangles.size(); i++)
+		CHECK_EQUAL(positions[i], data.triangles[i].position);
+	CHECK_EQUAL(1, data.triangles[14].uv);
+	CHECK_EQUAL(1, data.triangles[14].normal);
+}
+
+TEST(RelativeIndicesCountBackFromTheirOwnLine)
+{
+	ObjParser::ObjData data = ParseText(
+		"v 0 0 0\nv 1 0 0\nv 1 1 0\n"
+		"vt 0 0\n"
+		"vn 0 0 1\n"
+		"f -3/-1/-1 -2/-1/-1 -1/-1/-1\n"
+		"v 0 1 0\n"
+		"vt 1 1\n"
+		"f -4 -2/-1 -1//1\n"
+		"f -4 2 -1\n");
+
+	const int positions[] = { 1, 2, 3, 1, 3, 4, 1, 2, 4 };
+	CHECK_EQUAL((size_t)9, data.triangles.size());
+	for (size_t i = 0; i < 9 && i < data.triangles.size(); i++)
+		CHECK_EQUAL(positions[i], data.triangles[i].position);
+	CHECK_EQUAL(1, data.triangles[0].uv);
+	CHECK_EQUAL(1, data.triangles[0].normal);
+	CHECK_EQUAL(2, data.triangles[4].uv);
+	CHECK_EQUAL(1, data.triangles[5].normal);
+}
+
+TEST(ChunkedParsesMatchTheSerialParse)
+{
+	// Every face form, polygons and relative indices, with attributes
+	// interleaved through the file so chunks start mid-stream
+	std::string text;
+	char line[256];
+	for (int i = 0; i < 3000; i++)
+	{
+		text.append(line, snprintf(line, sizeof(line), "v %d.25 %d -%d.5\nvt 0.%d 0.5\nvn 0 1 0\n", i, i % 7, i % 11, i % 10));
+		if (i % 500 == 0)
+			text.append(line, snprintf(line, sizeof(line), "o part%d\nusemtl material%d\n", i, i % 3));
+		if (i < 5)
+			continue;
+
+		switch (i % 5)
+		{
+		case 0: text.append(line, snprintf(line, sizeof(line), "f %d %d %d %d %d\n", i - 4, i - 3, i - 2, i - 1, i)); break;
+		case 1: text.append(line, snprintf(line, sizeof(line), "f %d/%d %d/%d %d/%d\n", i - 2, i - 2, i - 1, i - 1, i, i)); break;
+		case 2: text.append(line, snprintf(line, sizeof(line), "f %d//%d %d//%d %d//%d %d//%d\n", i - 3, i, i - 2, i, i - 1, i, i, i)); break;
+		case 3: text.append("f -3/-3/-3 -2/-2/-2 -1/-1/-1\n"); break;
+		case 4: text.append("f -5/-1 -4/-2 -3/-3 -2/-4 -1/-5 -6/-6\n"); break;
+		}
+	}
+
+	ObjParser::ObjData serial;
+	ObjParser::Parse(text.data(), text.data() + text.size(), serial);
+	CHECK(serial.triangles.size() > 10000);
+	for (unsigned int threads = 2; threads <= 7; threads++)
+	{
+		if (!SameData(serial, ParseText(text, threads)))
+			Test::Fail(__FILE__, __LINE__, "A " + std::to_string(threads) + "-way parse differs from the serial one");
+	}
+}
+
+TEST(BundledMeshesParseTheSameEveryWay)
+{
+	for (const char* fileName : { "cube.obj", "cylinder.obj", "helix.obj", "quad.obj", "QuadDoubleSided.obj", "sphere.obj", "torus.obj" })
+	{
+		std::string path = Test::CopyAsset(fileName);
+		FILE* file = fopen(path.c_str(), "rb");
+		std::string text(std::filesystem::file_size(path), '\0');
+		CHECK_EQUAL(text.size(), fread(text.data(), 1, text.size(), file));
+		fclose(file);
+
+		ObjParser::ObjData serial = ParseText(text);
+		CHECK(!serial.triangles.empty());
+		CHECK(SameData(serial, ParseText(text, 4)));
+
+		// Streaming welds on index triples, so its triangles are the same
+		// corners in the same order, just numbered differently
+		VectorMeshSink sink;
+		std::vector<ObjParser::Marker> markers;
+		ObjParser::SourceStats source = {};
+		ObjParser::ParseStreaming(text.data(), text.data() + text.size(), sink, markers, source);
+		CHECK_EQUAL(serial.triangles.size(), sink.indices.size());
+		CHECK_EQUAL((uint64_t)serial.triangles.size() / 3, source.triangleCount);
+		CHECK_EQUAL(0u, source.invalidIndexCount);
+	}
+}
+
+// --------------------------------------------------------
+// Submeshes: one per run of triangles with the same object
+// and material, whichever of o, g and usemtl changed
+// --------------------------------------------------------
+
+namespace
+{
+	// Three parts with their own positions: x in [0, 4) for "left" in red,
+	// [10, 14) for "left" in blue and [20, 24) for the group "right"
+	const char* PartsText =
+		"mtllib parts.mtl\n"
+		"o ignored\n"
+		"o left\n"
+		"usemtl red\n"
+		"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+		"f 1 2 3 4\n"
+		"usemtl blue\n"
+		"v 10 0 0\nv 11 0 0\nv 11 1 0\nv 10 1 0\n"
+		"f 5 6 7\n"
+		"f 5 7 8\n"
+		"f 5 6 8\n"
+		"g right\n"
+		"v 20 0 0\nv 21 0 0\nv 21 1 0\n"
+		"f -3 -2 -1\n"
+		"usemtl unused\n"
+		"o trailing\n";
+
+	void CheckParts(const std::vector<Submesh>& submeshes)
+	{
+		CHECK_EQUAL((size_t)3, submeshes.size());
+		if (submeshes.size() != 3)
+			return;
+
+		CHECK_EQUAL(0u, submeshes[0].indexStart);
+		CHECK_EQUAL(6u, submeshes[0].indexCount);
+		CHECK_EQUAL(std::string("left"), submeshes[0].name);
+		CHECK_EQUAL(std::string("red"), submeshes[0].materialName);
+
+		CHECK_EQUAL(6u, submeshes[1].indexStart);
+		CHECK_EQUAL(9u, submeshes[1].indexCount);
+		CHECK_EQUAL(std::string("left"), submeshes[1].name);
+		CHECK_EQUAL(std::string("blue"), submeshes[1].materialName);
+
+		CHECK_EQUAL(15u, submeshes[2].indexStart);
+		CHECK_EQUAL(3u, submeshes[2].indexCount);
+		CHECK_EQUAL(std::string("right"), submeshes[2].name);
+		CHECK_EQUAL(std::string("blue"), submeshes[2].materialName);
+	}
+}
+
+TEST(MarkersSplitSubmeshesWhereTheyTakeEffect)
+{
+	std::string text = PartsText;
+	for (unsigned int threads = 1; threads <= 4; threads++)
+	{
+		ObjParser::ObjData data = ParseText(text, threads);
+		CHECK_EQUAL((size_t)18, data.triangles.size());
+		CheckParts(ObjParser::BuildSubmeshes(data.markers, data.triangles.size()));
+	}
+
+	VectorMeshSink sink;
+	std::vector<ObjParser::Marker> markers;
+	ObjParser::SourceStats source = {};
+	ObjParser::ParseStreaming(text.data(), text.data() + text.size(), sink, markers, source);
+	CheckParts(ObjParser::BuildSubmeshes(markers, sink.indices.size()));
+}
+
+TEST(FilesWithoutMarkersAreOneUnnamedSubmesh)
+{
+	std::vector<Submesh> submeshes = ObjParser::BuildSubmeshes({}, 30);
+	CHECK_EQUAL((size_t)1, submeshes.size());
+	CHECK_EQUAL(0u, submeshes[0].indexStart);
+	CHECK_EQUAL(30u, submeshes[0].indexCount);
+	CHECK(submeshes[0].name.empty() && submeshes[0].materialName.empty());
+
+	// Even with no triangles at all
+	submeshes = ObjParser::BuildSubmeshes({ { 0, ObjParser::MarkerType::Object, "empty" } }, 0);
+	CHECK_EQUAL((size_t)1, submeshes.size());
+	CHECK_EQUAL(0u, submeshes[0].indexCount);
+}
+
+TEST(ImportedSubmeshesKeepTheirTriangles)
+{
+	std::string path = Test::GetOutputDirectory() + "/parts.obj";
+	FILE* file = fopen(path.c_str(), "wb");
+	fputs(PartsText, file);
+	fclose(file);
+
+	const float firstX[3] = { 0.0f, 10.0f, 20.0f };
+	for (bool streaming : { false, true })
+	{
+		MeshImportSettings settings;
+		settings.streaming = streaming;
+
+		// From the .obj, then from the cooked file
+		for (int pass = 0; pass < 2; pass++)
+		{
+			MeshData data = MeshImporter::Import(path.c_str(), settings);
+			CHECK_EQUAL(pass == 1, data.report.fromCache);
+			CheckParts(data.submeshes);
+
+			// Optimizing may reorder triangles within a submesh, never across
+			for (size_t s = 0; s < data.submeshes.size() && s < 3; s++)
+			{
+				const Submesh& submesh = data.submeshes[s];
+				for (unsigned int i = submesh.indexStart; i < submesh.indexStart + submesh.indexCount; i++)
+				{
+					unsigned int index = data.indexStride == sizeof(uint16_t) ?
+						((const uint16_t*)data.indexData)[i] :
+						((const uint32_t*)data.indexData)[i];
+					float x = ((const Vertex*)data.vertexData)[index].Position.x;
+					CHECK(x >= firstX[s] && x < firstX[s] + 4.0f);
+				}
+			}
+		}
+	}
+}
+
+// --------------------------------------------------------
+// Streaming memory: the peak stays within a small factor of
+// the mesh it produces, which comes out the same as the
+// regular import
+// --------------------------------------------------------
+
+TEST(StreamingPeakStaysNearTheFinalMesh)
+{
+	// About 160k unique vertices and 320k triangles
+	std::string path = Test::GetOutputDirectory() + "/grid.obj";
+	uint64_t triangles = SyntheticObj::WriteGrid(path, 400, 400);
+
+	// Only the parse is being compared, so skip the slow steps after it
+	MeshImportSettings settings;
+	settings.generateLods = false;
+	settings.buildMeshlets = false;
+	MeshData regular = MeshImporter::Import(path.c_str(), settings);
+	settings.streaming = true;
+	MeshData streamed = MeshImporter::Import(path.c_str(), settings);
+	CHECK(!streamed.report.fromCache && !regular.report.fromCache);
+
+	// What the sink ends up holding, before any later processing. The
+	// rest of the peak is the attributes read from the file (32 bytes
+	// per grid point here) and the welder's table and keys.
+	const ObjParser::StreamStats& stats = streamed.streamStats;
+	CHECK_EQUAL((size_t)triangles * 3, stats.indexCount);
+	size_t finalBytes = stats.vertexCount * sizeof(Vertex) + stats.indexCount * sizeof(unsigned int);
+	CHECK(stats.peakBytes >= finalBytes);
+	CHECK(stats.peakBytes <= finalBytes * 2);
+	CHECK_EQUAL(stats.peakBytes, stats.attributeBytes + stats.welderBytes + stats.sinkBytes);
+
+	// Welding on index triples finds the same vertices as welding on
+	// values here, since every grid point has its own v, vt and vn
+	CHECK_EQUAL(regular.vertexCount, streamed.vertexCount);
+	CHECK_EQUAL(regular.indexCount, streamed.indexCount);
+	CHECK_EQUAL(regular.indexStride, streamed.indexStride);
+	CHECK(memcmp(regular.vertexData, streamed.vertexData, (size_t)regular.vertexCount * sizeof(Vertex)) == 0);
+	CHECK(memcmp(regular.indexData, streamed.indexData, (size_t)regular.indexCount * regular.indexStride) == 0);
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "SyntheticObj.h"
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+// --------------------------------------------------------
+// Formats a line at a time into a large buffer and writes
+// it out in blocks, so writing a file of millions of faces
+// isn't slower than the parsers reading it back.
+// --------------------------------------------------------
+uint64_t SyntheticObj::WriteGrid(const std::string& filePath, unsigned int columns, unsigned int rows)
+{
+	FILE* file = fopen(filePath.c_str(), "wb");
+	if (!file)
+		throw std::runtime_error("Couldn't create " + filePath);
+
+	static const size_t BufferSize = 1 << 20;
+	std::string buffer;
+	buffer.reserve(BufferSize + 256);
+	auto flush = [&]()
+	{
+		fwrite(buffer.data(), 1, buffer.size(), file);
+		buffer.clear();
+	};
+
+	char line[256];
+	buffer += "# Synthetic grid\n";
+	for (unsigned int z = 0; z <= rows; z++)
+	{
+		for (unsigned int x = 0; x <= columns; x++)
+		{
+			float u = (float)x / columns;
+			float v = (float)z / rows;
+			float height = 0.05f * std::sin(u * 25.0f) * std::cos(v * 17.0f);
+			buffer.append(line, snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", u * 2.0f - 1.0f, height, v * 2.0f - 1.0f));
+			buffer.append(line, snprintf(line, sizeof(line), "vt %.6f %.6f\n", u, 1.0f - v));
+			buffer.append(line, snprintf(line, sizeof(line), "vn %.6f %.6f %.6f\n", 0.0f, 1.0f, 0.0f));
+			if (buffer.size() >= BufferSize)
+				flush();
+		}
+	}
+
+	for (unsigned int z = 0; z < rows; z++)
+	{
+		for (unsigned int x = 0; x < columns; x++)
+		{
+			// 1-based, clockwise when seen from above (+y)
+			uint64_t a = (uint64_t)z * (columns + 1) + x + 1;
+			uint64_t b = a + 1;
+			uint64_t c = a + columns + 2;
+			uint64_t d = a + columns + 1;
+			buffer.append(line, snprintf(line, sizeof(line),
+				"f %llu/%llu/%llu %llu/%llu/%llu %llu/%llu/%llu %llu/%llu/%llu\n",
+				(unsigned long long)a, (unsigned long long)a, (unsigned long long)a,
+				(unsigned long long)d, (unsigned long long)d, (unsigned long long)d,
+				(unsigned long long)c, (unsigned long long)c, (unsigned long long)c,
+				(unsigned long long)b, (unsigned long long)b, (unsigned long long)b));
+			if (buffer.size() >= BufferSize)
+				flush();
+		}
+	}
+
+	flush();
+	bool written = ferror(file) == 0;
+	fclose(file);
+	if (!written)
+		throw std::runtime_error("Couldn't write " + filePath);
+	return (uint64_t)columns * rows * 2;
+}
\ No newline at end of file
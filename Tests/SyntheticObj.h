@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Writes .obj files for the tests and benchmarks that need more geometry
+// than the bundled meshes have
+namespace SyntheticObj
+{
+	// A wavy grid of columns x rows quads facing up, with a position, uv
+	// and normal per grid point, written as v/vt/vn quad faces. Returns
+	// how many triangles it splits into (two per quad).
+	uint64_t WriteGrid(const std::string& filePath, unsigned int columns, unsigned int rows);
+}
\ No newline at end of file
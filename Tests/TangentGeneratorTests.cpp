@@ -0,0 +1,305 @@
+#include "TestHarness.h"
+#include "TangentGenerator.h"
+
+#include <cmath>
+#include <cfloat>
+#include <random>
+#include <cstring>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// The SIMD, multithreaded tangent generator against the
+// original one-triangle-at-a-time loop (in doubles), and
+// its output staying the same for any thread count
+// --------------------------------------------------------
+
+namespace
+{
+	struct TestMesh
+	{
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+	};
+
+	// A wavy grid with the exact normal of the surface at every point
+	TestMesh MakeGrid(unsigned int columns, unsigned int rows)
+	{
+		TestMesh mesh;
+		for (unsigned int z = 0; z <= rows; z++)
+		{
+			for (unsigned int x = 0; x <= columns; x++)
+			{
+				float px = x * 0.25f;
+				float pz = z * 0.25f;
+				float height = 0.3f * std::sin(px * 1.3f) * std::cos(pz * 0.7f);
+				float dx = 0.3f * 1.3f * std::cos(px * 1.3f) * std::cos(pz * 0.7f);
+				float dz = -0.3f * 0.7f * std::sin(px * 1.3f) * std::sin(pz * 0.7f);
+
+				Vertex vertex = {};
+				vertex.Position = XMFLOAT3(px, height, pz);
+				XMStoreFloat3(&vertex.Normal, XMVector3Normalize(XMVectorSet(-dx, 1.0f, -dz, 0)));
+				vertex.UV = XMFLOAT2((float)x / columns, 1.0f - (float)z / rows);
+				mesh.vertices.push_back(vertex);
+			}
+		}
+		for (unsigned int z = 0; z < rows; z++)
+		{
+			for (unsigned int x = 0; x < columns; x++)
+			{
+				unsigned int corner = z * (columns + 1) + x;
+				unsigned int quad[6] = { corner, corner + columns + 1, corner + 1, corner + 1, corner + columns + 1, corner + columns + 2 };
+				mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+			}
+		}
+		return mesh;
+	}
+
+	// Random triangles over shared vertices, including mirrored uvs and a
+	// triangle count that leaves some for the one-at-a-time path
+	TestMesh MakeRandom(unsigned int vertexCount, unsigned int triangleCount)
+	{
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+		std::uniform_int_distribution<unsigned int> index(0, vertexCount - 1);
+
+		TestMesh mesh;
+		mesh.vertices.resize(vertexCount);
+		for (Vertex& vertex : mesh.vertices)
+		{
+			vertex.Position = XMFLOAT3(coordinate(random), coordinate(random), coordinate(random));
+			XMStoreFloat3(&vertex.Normal, XMVector3Normalize(XMVectorSet(coordinate(random), coordinate(random), coordinate(random), 0)));
+			vertex.UV = XMFLOAT2(coordinate(random), coordinate(random));
+		}
+		for (unsigned int i = 0; i < triangleCount * 3; i++)
+			mesh.indices.push_back(index(random));
+		return mesh;
+	}
+
+	struct Reference
+	{
+		double tangent[3];
+		double projectedLength;	// Of the summed tangent once the normal is taken out
+		double summedLength;
+		float w;
+	};
+
+	// The loop Mesh used to run, plus the bitangent sums for handedness
+	std::vector<Reference> ReferenceTangents(const TestMesh& mesh)
+	{
+		std::vector<double> sums(mesh.vertices.size() * 6, 0.0);
+		for (size_t i = 0; i < mesh.indices.size(); i += 3)
+		{
+			const Vertex& v1 = mesh.vertices[mesh.indices[i]];
+			const Vertex& v2 = mesh.vertices[mesh.indices[i + 1]];
+			const Vertex& v3 = mesh.vertices[mesh.indices[i + 2]];
+
+			double x1 = (double)v2.Position.x - v1.Position.x;
+			double y1 = (double)v2.Position.y - v1.Position.y;
+			double z1 = (double)v2.Position.z - v1.Position.z;
+			double x2 = (double)v3.Position.x - v1.Position.x;
+			double y2 = (double)v3.Position.y - v1.Position.y;
+			double z2 = (double)v3.Position.z - v1.Position.z;
+			double s1 = (double)v2.UV.x - v1.UV.x;
+			double t1 = (double)v2.UV.y - v1.UV.y;
+			double s2 = (double)v3.UV.x - v1.UV.x;
+			double t2 = (double)v3.UV.y - v1.UV.y;
+
+			double determinant = s1 * t2 - s2 * t1;
+			if (determinant == 0.0)
+				continue;
+			double r = 1.0 / determinant;
+			double frame[6] =
+			{
+				(t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r, (t2 * z1 - t1 * z2) * r,
+				(s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r, (s1 * z2 - s2 * z1) * r
+			};
+			for (size_t corner = i; corner < i + 3; corner++)
+				for (int c = 0; c < 6; c++)
+					sums[mesh.indices[corner] * 6 + c] += frame[c];
+		}
+
+		std::vector<Reference> references(mesh.vertices.size());
+		for (size_t i = 0; i < mesh.vertices.size(); i++)
+		{
+			const double* sum = &sums[i * 6];
+			const XMFLOAT3& n = mesh.vertices[i].Normal;
+			double dot = n.x * sum[0] + n.y * sum[1] + n.z * sum[2];
+			double t[3] = { sum[0] - n.x * dot, sum[1] - n.y * dot, sum[2] - n.z * dot };
+			double length = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+
+			Reference& reference = references[i];
+			reference.projectedLength = length;
+			reference.summedLength = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+			for (int c = 0; c < 3; c++)
+				reference.tangent[c] = length > 0.0 ? t[c] / length : 0.0;
+
+			// cross(normal, tangent) against the summed bitangent
+			double cross[3] =
+			{
+				n.y * reference.tangent[2] - n.z * reference.tangent[1],
+				n.z * reference.tangent[0] - n.x * reference.tangent[2],
+				n.x * reference.tangent[1] - n.y * reference.tangent[0]
+			};
+			reference.w = cross[0] * sum[3] + cross[1] * sum[4] + cross[2] * sum[5] < 0.0 ? -1.0f : 1.0f;
+		}
+		return references;
+	}
+
+	// Vertices whose tangent is well defined, where float and double must agree
+	unsigned int CompareWithReference(const TestMesh& mesh, const std::vector<Vertex>& generated)
+	{
+		std::vector<Reference> references = ReferenceTangents(mesh);
+		unsigned int compared = 0;
+		for (size_t i = 0; i < references.size(); i++)
+		{
+			const Reference& reference = references[i];
+			if (reference.projectedLength <= 1e-2 * reference.summedLength)
+				continue;
+
+			const XMFLOAT4& tangent = generated[i].Tangent;
+			CHECK_NEAR(reference.tangent[0], tangent.x, 1e-4);
+			CHECK_NEAR(reference.tangent[1], tangent.y, 1e-4);
+			CHECK_NEAR(reference.tangent[2], tangent.z, 1e-4);
+			CHECK_EQUAL(reference.w, tangent.w);
+			compared++;
+		}
+		return compared;
+	}
+
+	bool SameTangents(const std::vector<Vertex>& a, const std::vector<Vertex>& b)
+	{
+		if (a.size() != b.size())
+			return false;
+		for (size_t i = 0; i < a.size(); i++)
+			if (memcmp(&a[i].Tangent, &b[i].Tangent, sizeof(XMFLOAT4)) != 0)
+				return false;
+		return true;
+	}
+}
+
+TEST(GridMatchesTheScalarReference)
+{
+	TestMesh mesh = MakeGrid(37, 23);
+	std::vector<Vertex> vertices = mesh.vertices;
+	TangentGenerator::Stats stats = TangentGenerator::Generate(vertices.data(), (unsigned int)vertices.size(), mesh.indices.data(), mesh.indices.size(), 1);
+
+	CHECK_EQUAL(0u, stats.degenerateTriangles);
+	CHECK_EQUAL(0u, stats.fallbackTangents);
+	CHECK_EQUAL(vertices.size(), (size_t)CompareWithReference(mesh, vertices));
+
+	// u runs along +x, and the flipped v makes every frame right handed
+	CHECK_NEAR(1.0, vertices[0].Tangent.x, 0.2);
+	CHECK_EQUAL(1.0f, vertices[0].Tangent.w);
+}
+
+TEST(RandomMeshMatchesTheScalarReference)
+{
+	TestMesh mesh = MakeRandom(500, 1001);
+	std::vector<Vertex> vertices = mesh.vertices;
+	TangentGenerator::Generate(vertices.data(), (unsigned int)vertices.size(), mesh.indices.data(), mesh.indices.size(), 1);
+
+	// Most random vertices have a usable sum; the rest are skipped
+	unsigned int compared = CompareWithReference(mesh, vertices);
+	CHECK(compared > 400);
+}
+
+TEST(ThreadCountDoesNotChangeTheResult)
+{
+	TestMesh mesh = MakeRandom(3000, 20003);
+	std::vector<Vertex> single = mesh.vertices;
+	TangentGenerator::Stats singleStats = TangentGenerator::Generate(single.data(), (unsigned int)single.size(), mesh.indices.data(), mesh.indices.size(), 1);
+
+	for (unsigned int threads : { 2u, 3u, 8u })
+	{
+		std::vector<Vertex> threaded = mesh.vertices;
+		TangentGenerator::Stats stats = TangentGenerator::Generate(threaded.data(), (unsigned int)threaded.size(), mesh.indices.data(), mesh.indices.size(), threads);
+		CHECK(SameTangents(single, threaded));
+		CHECK_EQUAL(singleStats.degenerateTriangles, stats.degenerateTriangles);
+		CHECK_EQUAL(singleStats.fallbackTangents, stats.fallbackTangents);
+	}
+
+	// Splitting numbers its copies the same way for any thread count too
+	std::vector<Vertex> splitVertices = mesh.vertices;
+	std::vector<unsigned int> splitIndices = mesh.indices;
+	TangentGenerator::Generate(splitVertices, splitIndices, true, 1);
+	for (unsigned int threads : { 2u, 5u })
+	{
+		std::vector<Vertex> vertices = mesh.vertices;
+		std::vector<unsigned int> indices = mesh.indices;
+		TangentGenerator::Generate(vertices, indices, true, threads);
+		CHECK(SameTangents(splitVertices, vertices));
+		CHECK(splitIndices == indices);
+	}
+}
+
+TEST(TrianglesWithoutUvAreaAreIgnored)
+{
+	TestMesh mesh = MakeGrid(4, 4);
+
+	// One extra triangle with a single uv at every corner, on vertices of its own
+	unsigned int first = (unsigned int)mesh.vertices.size();
+	for (int i = 0; i < 3; i++)
+	{
+		Vertex vertex = {};
+		vertex.Position = XMFLOAT3((float)i, 1.0f, (float)(i * i));
+		vertex.Normal = XMFLOAT3(0, 1, 0);
+		vertex.UV = XMFLOAT2(0.5f, 0.5f);
+		mesh.vertices.push_back(vertex);
+		mesh.indices.push_back(first + i);
+	}
+
+	std::vector<Vertex> vertices = mesh.vertices;
+	TangentGenerator::Stats stats = TangentGenerator::Generate(vertices.data(), (unsigned int)vertices.size(), mesh.indices.data(), mesh.indices.size(), 1);
+	CHECK_EQUAL(1u, stats.degenerateTriangles);
+	CHECK_EQUAL(3u, stats.fallbackTangents);
+
+	// Its vertices still get a unit tangent perpendicular to the normal
+	for (unsigned int i = first; i < first + 3; i++)
+	{
+		XMVECTOR tangent = XMLoadFloat4(&vertices[i].Tangent);
+		CHECK_NEAR(1.0, XMVectorGetX(XMVector3Length(tangent)), 1e-6);
+		CHECK_NEAR(0.0, XMVectorGetX(XMVector3Dot(tangent, XMLoadFloat3(&vertices[i].Normal))), 1e-6);
+	}
+	CHECK_EQUAL(vertices.size() - 3, (size_t)CompareWithReference(mesh, vertices));
+}
+
+TEST(MirroredUvsSplitTheSharedEdge)
+{
+	// Two triangles sharing the edge 1-2, the second with u mirrored
+	TestMesh mesh;
+	const XMFLOAT3 positions[4] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 0, 1 }, { 2, 0, 0 } };
+	const XMFLOAT2 uvs[4] = { { 0, 1 }, { 1, 1 }, { 1, 0 }, { 0, 1 } };
+	for (int i = 0; i < 4; i++)
+	{
+		Vertex vertex = {};
+		vertex.Position = positions[i];
+		vertex.Normal = XMFLOAT3(0, 1, 0);
+		vertex.UV = uvs[i];
+		mesh.vertices.push_back(vertex);
+	}
+	mesh.indices = { 0, 2, 1, 1, 2, 3 };
+
+	// Without splitting, the edge averages two opposite tangents into nothing
+	std::vector<Vertex> shared = mesh.vertices;
+	std::vector<unsigned int> sharedIndices = mesh.indices;
+	TangentGenerator::Stats sharedStats = TangentGenerator::Generate(shared, sharedIndices, false, 1);
+	CHECK_EQUAL(0u, sharedStats.mirrorSplits);
+	CHECK_EQUAL(2u, sharedStats.fallbackTangents);
+
+	std::vector<Vertex> vertices = mesh.vertices;
+	std::vector<unsigned int> indices = mesh.indices;
+	TangentGenerator::Stats stats = TangentGenerator::Generate(vertices, indices, true, 1);
+	CHECK_EQUAL(2u, stats.mirrorSplits);
+	CHECK_EQUAL(0u, stats.fallbackTangents);
+	CHECK_EQUAL((size_t)6, vertices.size());
+
+	// Only the mirrored triangle moves to the copies, numbered in vertex order
+	std::vector<unsigned int> expected = { 0, 2, 1, 4, 5, 3 };
+	CHECK(indices == expected);
+	CHECK_EQUAL(vertices[0].Tangent.w, vertices[1].Tangent.w);
+	CHECK_EQUAL(-vertices[1].Tangent.w, vertices[4].Tangent.w);
+	CHECK_EQUAL(-vertices[2].Tangent.w, vertices[5].Tangent.w);
+	CHECK_NEAR(-vertices[1].Tangent.x, vertices[4].Tangent.x, 1e-6);
+	CHECK_EQUAL(vertices[3].Tangent.w, vertices[4].Tangent.w);
+}
\ No newline at end of file
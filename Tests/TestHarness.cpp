@@ -0,0 +1,95 @@
+#include "TestHarness.h"
+
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+
+namespace
+{
+	struct Entry
+	{
+		const char* name;
+		Test::Function function;
+	};
+
+	// Filled in by static Registration objects, so it has to exist
+	// before the first of them runs
+	std::vector<Entry>& GetTests()
+	{
+		static std::vector<Entry> tests;
+		return tests;
+	}
+
+	const char* runningTest = "";
+	unsigned int failures = 0;
+}
+
+Test::Registration::Registration(const char* name, Function function)
+{
+	GetTests().push_back({ name, function });
+}
+
+void Test::Fail(const char* file, int line, const std::string& message)
+{
+	printf("%s:%d: %s failed: %s\n", file, line, runningTest, message.c_str());
+	failures++;
+}
+
+std::string Test::GetOutputDirectory()
+{
+	std::filesystem::path directory = std::filesystem::path(TEST_OUTPUT_DIRECTORY) / runningTest;
+	std::filesystem::create_directories(directory);
+	return directory.string();
+}
+
+std::string Test::CopyAsset(const char* fileName)
+{
+	std::filesystem::path source = std::filesystem::path(ASSET_DIRECTORY) / fileName;
+	std::filesystem::path copy = std::filesystem::path(GetOutputDirectory()) / fileName;
+	std::filesystem::copy_file(source, copy, std::filesystem::copy_options::overwrite_existing);
+	return copy.string();
+}
+
+// --------------------------------------------------------
+// Runs every test, or only those named as arguments. Each
+// one starts with an empty output folder, and an exception
+// escaping a test counts as a failure of that test.
+// --------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	unsigned int run = 0;
+	for (const Entry& test : GetTests())
+	{
+		bool selected = argc < 2;
+		for (int i = 1; i < argc; i++)
+			selected |= strcmp(argv[i], test.name) == 0;
+		if (!selected)
+			continue;
+
+		runningTest = test.name;
+		std::error_code error;
+		std::filesystem::remove_all(std::filesystem::path(TEST_OUTPUT_DIRECTORY) / test.name, error);
+
+		unsigned int failuresBefore = failures;
+		try
+		{
+			test.function();
+		}
+		catch (const std::exception& exception)
+		{
+			Test::Fail(__FILE__, __LINE__, std::string("unexpected exception: ") + exception.what());
+		}
+		catch (...)
+		{
+			Test::Fail(__FILE__, __LINE__, "unexpected exception");
+		}
+
+		printf("%s %s\n", failures == failuresBefore ? "[ pass ]" : "[ FAIL ]", test.name);
+		run++;
+	}
+
+	printf("%u tests, %u failed checks\n", run, failures);
+	return failures == 0 && run > 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <sstream>
+
+// --------------------------------------------------------
+// Just enough of a test framework for the pipeline tests,
+// with nothing to install. Each test file defines TEST()
+// blocks, and TestHarness.cpp supplies a main() that runs
+// them all (or the ones named on the command line), prints
+// every failed CHECK and exits non-zero if there were any.
+// --------------------------------------------------------
+#define TEST(name) \
+	static void name(); \
+	static Test::Registration name##Registration(#name, name); \
+	static void name()
+
+#define CHECK(condition) \
+	do { if (!(condition)) Test::Fail(__FILE__, __LINE__, "CHECK(" #condition ")"); } while (0)
+
+#define CHECK_EQUAL(expected, actual) \
+	do { \
+		auto&& checkExpected = (expected); \
+		auto&& checkActual = (actual); \
+		if (!(checkExpected == checkActual)) \
+			Test::Fail(__FILE__, __LINE__, "CHECK_EQUAL(" #expected ", " #actual "): expected " + \
+				Test::Describe(checkExpected) + ", got " + Test::Describe(checkActual)); \
+	} while (0)
+
+#define CHECK_NEAR(expected, actual, tolerance) \
+	do { \
+		double checkExpected = (double)(expected); \
+		double checkActual = (double)(actual); \
+		if (!(std::fabs(checkExpected - checkActual) <= (double)(tolerance))) \
+			Test::Fail(__FILE__, __LINE__, "CHECK_NEAR(" #expected ", " #actual "): expected " + \
+				Test::Describe(checkExpected) + ", got " + Test::Describe(checkActual)); \
+	} while (0)
+
+// Throws any exception at all
+#define CHECK_THROWS(expression) \
+	do { \
+		bool checkThrew = false; \
+		try { (void)(expression); } catch (...) { checkThrew = true; } \
+		if (!checkThrew) \
+			Test::Fail(__FILE__, __LINE__, "CHECK_THROWS(" #expression "): nothing was thrown"); \
+	} while (0)
+
+namespace Test
+{
+	using Function = void (*)();
+
+	// Adds a test to the list main() runs, in definition order
+	struct Registration
+	{
+		Registration(const char* name, Function function);
+	};
+
+	// Counts a failure against the running test and prints where it was
+	void Fail(const char* file, int line, const std::string& message);
+
+	// An empty folder for whatever the running test writes (caches,
+	// generated .obj files), under the build directory
+	std::string GetOutputDirectory();
+
+	// A mesh from Assets/Meshes, copied into the output folder first so
+	// importing it doesn't leave a cache next to the original
+	std::string CopyAsset(const char* fileName);
+
+	template<typename T>
+	std::string Describe(const T& value)
+	{
+		std::ostringstream text;
+		text.precision(9);
+		text << value;
+		return text.str();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,644 @@
+#include "TestHarness.h"
+#include "TransformStore.h"
+
+#include <map>
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+using namespace DirectX;
+
+// --------------------------------------------------------
+// Hierarchies in the store, checked against world matrices
+// rebuilt from scratch, and updates that only touch what
+// changed. Orientations, checked against DirectXMath's own
+// pitch, yaw and roll conversions, and inverse transposes
+// against a general inverse in float and in double.
+// --------------------------------------------------------
+
+namespace
+{
+	// What the store should hold for one transform, kept the simple way
+	struct ReferenceTransform
+	{
+		XMFLOAT3 position = XMFLOAT3(0, 0, 0);
+		XMFLOAT3 rotation = XMFLOAT3(0, 0, 0);
+		XMFLOAT3 scale = XMFLOAT3(1, 1, 1);
+		unsigned int parent = TransformStore::None;
+	};
+
+	using Reference = std::map<unsigned int, ReferenceTransform>;
+
+	// Every ancestor's matrix multiplied in again, every time
+	XMMATRIX ReferenceWorld(const Reference& reference, unsigned int id)
+	{
+		const ReferenceTransform& transform = reference.at(id);
+		XMMATRIX world =
+			XMMatrixScaling(transform.scale.x, transform.scale.y, transform.scale.z) *
+			XMMatrixRotationRollPitchYaw(transform.rotation.x, transform.rotation.y, transform.rotation.z) *
+			XMMatrixTranslation(transform.position.x, transform.position.y, transform.position.z);
+		return transform.parent == TransformStore::None ? world : world * ReferenceWorld(reference, transform.parent);
+	}
+
+	bool IsInSubtree(const Reference& reference, unsigned int id, unsigned int root)
+	{
+		for (; id != TransformStore::None; id = reference.at(id).parent)
+		{
+			if (id == root)
+				return true;
+		}
+		return false;
+	}
+
+	// Largest difference in any element, relative to the largest element
+	float MatrixError(const XMFLOAT4X4& actual, FXMMATRIX expected)
+	{
+		XMFLOAT4X4 reference;
+		XMStoreFloat4x4(&reference, expected);
+		float error = 0.0f;
+		float size = 1.0f;
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				error = std::max(error, std::fabs(actual.m[row][column] - reference.m[row][column]));
+				size = std::max(size, std::fabs(reference.m[row][column]));
+			}
+		}
+		return error / size;
+	}
+
+	float VectorError(const XMFLOAT3& actual, FXMVECTOR expected)
+	{
+		return XMVectorGetX(XMVector3Length(XMLoadFloat3(&actual) - expected));
+	}
+
+	// How far apart two rotations are: q and -q are the same one
+	float RotationError(const XMFLOAT4& actual, FXMVECTOR expected)
+	{
+		return 1.0f - std::fabs(XMVectorGetX(XMVector4Dot(XMLoadFloat4(&actual), expected)));
+	}
+
+	// Row-vector matrices in double, for references that don't round
+	// the way the store does
+	struct Matrix
+	{
+		double m[4][4];
+
+		Matrix operator*(const Matrix& other) const
+		{
+			Matrix result = {};
+			for (int row = 0; row < 4; row++)
+				for (int column = 0; column < 4; column++)
+					for (int i = 0; i < 4; i++)
+						result.m[row][column] += m[row][i] * other.m[i][column];
+			return result;
+		}
+	};
+
+	// Scale * rotation * translation, rotating the way
+	// XMMatrixRotationRollPitchYaw does
+	Matrix ReferenceLocal(const ReferenceTransform& transform)
+	{
+		double sp = std::sin((double)transform.rotation.x), cp = std::cos((double)transform.rotation.x);
+		double sy = std::sin((double)transform.rotation.y), cy = std::cos((double)transform.rotation.y);
+		double sr = std::sin((double)transform.rotation.z), cr = std::cos((double)transform.rotation.z);
+		double rotation[3][3] = {
+			{ cr * cy + sr * sp * sy, sr * cp, sr * sp * cy - cr * sy },
+			{ cr * sp * sy - sr * cy, cr * cp, sr * sy + cr * sp * cy },
+			{ cp * sy, -sp, cp * cy } };
+		double scale[3] = { transform.scale.x, transform.scale.y, transform.scale.z };
+
+		Matrix local = {};
+		for (int row = 0; row < 3; row++)
+			for (int column = 0; column < 3; column++)
+				local.m[row][column] = rotation[row][column] * scale[row];
+		local.m[3][0] = transform.position.x;
+		local.m[3][1] = transform.position.y;
+		local.m[3][2] = transform.position.z;
+		local.m[3][3] = 1.0;
+		return local;
+	}
+
+	// Gauss-Jordan with partial pivoting, then transposed
+	Matrix InverseTranspose(Matrix matrix)
+	{
+		Matrix inverse = {};
+		for (int i = 0; i < 4; i++)
+			inverse.m[i][i] = 1.0;
+		for (int column = 0; column < 4; column++)
+		{
+			int pivot = column;
+			for (int row = column + 1; row < 4; row++)
+			{
+				if (std::fabs(matrix.m[row][column]) > std::fabs(matrix.m[pivot][column]))
+					pivot = row;
+			}
+			std::swap(matrix.m[pivot], matrix.m[column]);
+			std::swap(inverse.m[pivot], inverse.m[column]);
+
+			double divisor = matrix.m[column][column];
+			for (int i = 0; i < 4; i++)
+			{
+				matrix.m[column][i] /= divisor;
+				inverse.m[column][i] /= divisor;
+			}
+			for (int row = 0; row < 4; row++)
+			{
+				double factor = matrix.m[row][column];
+				if (row == column || factor == 0.0)
+					continue;
+				for (int i = 0; i < 4; i++)
+				{
+					matrix.m[row][i] -= factor * matrix.m[column][i];
+					inverse.m[row][i] -= factor * inverse.m[column][i];
+				}
+			}
+		}
+
+		Matrix result;
+		for (int row = 0; row < 4; row++)
+			for (int column = 0; column < 4; column++)
+				result.m[row][column] = inverse.m[column][row];
+		return result;
+	}
+
+	// Like MatrixError, against a double reference
+	double MatrixError(const XMFLOAT4X4& actual, const Matrix& expected)
+	{
+		double error = 0.0;
+		double size = 0.0;
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				error = std::max(error, std::fabs(actual.m[row][column] - expected.m[row][column]));
+				size = std::max(size, std::fabs(expected.m[row][column]));
+			}
+		}
+		return error / size;
+	}
+
+	// Against the transpose of XMMatrixInverse of the current world matrix
+	float InverseTransposeError(TransformStore& store, unsigned int id)
+	{
+		XMMATRIX general = XMMatrixTranspose(XMMatrixInverse(0, XMLoadFloat4x4(&store.GetWorldMatrix(id))));
+		return MatrixError(store.GetWorldInverseTransposeMatrix(id), general);
+	}
+
+	// Builds root, then children of the root, then children of those,
+	// parents first
+	std::vector<unsigned int> MakeTree(TransformStore& store, unsigned int childrenEach, unsigned int levels)
+	{
+		std::vector<unsigned int> ids = { store.Allocate() };
+		std::vector<unsigned int> level = ids;
+		for (unsigned int depth = 1; depth < levels; depth++)
+		{
+			std::vector<unsigned int> next;
+			for (unsigned int parent : level)
+			{
+				for (unsigned int i = 0; i < childrenEach; i++)
+				{
+					unsigned int id = store.Allocate();
+					store.SetParent(id, parent);
+					next.push_back(id);
+				}
+			}
+			ids.insert(ids.end(), next.begin(), next.end());
+			level = next;
+		}
+		return ids;
+	}
+}
+
+// Random edits, reparenting and frees, read back both lazily (one
+// transform at a time, between updates) and after batched updates
+TEST(DirtyPropagationMatchesNaiveReference)
+{
+	TransformStore store;
+	Reference reference;
+	std::vector<unsigned int> ids;
+
+	std::mt19937 random(22);
+	std::uniform_int_distribution<int> operation(0, 9);
+	std::uniform_real_distribution<float> position(-5.0f, 5.0f);
+	std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+	std::uniform_real_distribution<float> scale(0.8f, 1.25f);
+	auto pick = [&]() { return ids[std::uniform_int_distribution<size_t>(0, ids.size() - 1)(random)]; };
+
+	float worstLazy = 0.0f;
+	float worstBatched = 0.0f;
+	unsigned int rejected = 0;
+	for (int step = 0; step < 20000; step++)
+	{
+		int choice = ids.size() < 8 ? 0 : operation(random);
+		if (choice == 0 && ids.size() < 300)
+		{
+			unsigned int id = store.Allocate();
+			CHECK(reference.count(id) == 0);
+			reference[id] = ReferenceTransform();
+			ids.push_back(id);
+		}
+		else if (choice == 1)
+		{
+			// Children move up to the freed transform's parent
+			unsigned int id = pick();
+			store.Free(id);
+			for (auto& [other, transform] : reference)
+			{
+				if (transform.parent == id)
+					transform.parent = reference[id].parent;
+			}
+			reference.erase(id);
+			ids.erase(std::find(ids.begin(), ids.end(), id));
+		}
+		else if (choice == 2)
+		{
+			unsigned int id = pick();
+			unsigned int parent = random() % 8 == 0 ? TransformStore::None : pick();
+			if (parent != TransformStore::None && IsInSubtree(reference, parent, id))
+			{
+				CHECK_THROWS(store.SetParent(id, parent));
+				rejected++;
+			}
+			else
+			{
+				store.SetParent(id, parent);
+				reference[id].parent = parent;
+			}
+		}
+		else if (choice == 3 || choice == 4)
+		{
+			unsigned int id = pick();
+			XMFLOAT3 value(position(random), position(random), position(random));
+			store.SetPosition(id, value);
+			reference[id].position = value;
+		}
+		else if (choice == 5)
+		{
+			unsigned int id = pick();
+			XMFLOAT3 value(angle(random), angle(random), angle(random));
+			store.SetRotation(id, value);
+			reference[id].rotation = value;
+		}
+		else if (choice == 6)
+		{
+			// Non-uniform as often as not
+			unsigned int id = pick();
+			float x = scale(random);
+			XMFLOAT3 value = random() % 2 ? XMFLOAT3(x, x, x) : XMFLOAT3(x, scale(random), scale(random));
+			store.SetScale(id, value);
+			reference[id].scale = value;
+		}
+		else if (choice >= 7)
+		{
+			unsigned int id = pick();
+			worstLazy = std::max(worstLazy, MatrixError(store.GetWorldMatrix(id), ReferenceWorld(reference, id)));
+		}
+
+		if (step % 500 == 499)
+		{
+			store.UpdateWorldMatrices();
+			CHECK_EQUAL(0u, store.UpdateWorldMatrices());
+			CHECK_EQUAL((unsigned int)ids.size(), store.GetCount());
+			for (unsigned int id : ids)
+			{
+				CHECK_EQUAL(reference[id].parent, store.GetParent(id));
+				worstBatched = std::max(worstBatched, MatrixError(store.GetWorldMatrix(id), ReferenceWorld(reference, id)));
+			}
+		}
+	}
+
+	CHECK(rejected > 0);
+	CHECK(worstLazy < 1e-5f);
+	CHECK(worstBatched < 1e-5f);
+}
+
+TEST(SetParentRejectsCycles)
+{
+	TransformStore store;
+	unsigned int a = store.Allocate();
+	unsigned int b = store.Allocate();
+	unsigned int c = store.Allocate();
+	store.SetParent(b, a);
+	store.SetParent(c, b);
+	store.SetPosition(a, XMFLOAT3(1, 0, 0));
+	store.SetPosition(b, XMFLOAT3(0, 2, 0));
+	store.SetPosition(c, XMFLOAT3(0, 0, 3));
+
+	CHECK_THROWS(store.SetParent(a, a));
+	CHECK_THROWS(store.SetParent(a, b));
+	CHECK_THROWS(store.SetParent(a, c));
+	CHECK_THROWS(store.SetParent(b, c));
+
+	// Nothing changed
+	CHECK_EQUAL(TransformStore::None, store.GetParent(a));
+	CHECK_EQUAL(a, store.GetParent(b));
+	CHECK_EQUAL(b, store.GetParent(c));
+	const XMFLOAT4X4& world = store.GetWorldMatrix(c);
+	CHECK_EQUAL(1.0f, world._41);
+	CHECK_EQUAL(2.0f, world._42);
+	CHECK_EQUAL(3.0f, world._43);
+
+	// Turning it around works once the chain is broken
+	store.SetParent(c, TransformStore::None);
+	store.SetParent(a, c);
+	CHECK_EQUAL(c, store.GetParent(a));
+	CHECK_EQUAL(3.0f, store.GetWorldMatrix(b)._43);
+}
+
+// Sixteen trees of four, built parents first so each fills one group
+TEST(UpdateRebuildsOnlyChangedSubtrees)
+{
+	TransformStore store;
+	std::vector<std::vector<unsigned int>> trees;
+	for (int i = 0; i < 16; i++)
+	{
+		trees.push_back(MakeTree(store, 3, 2));
+		store.SetPosition(trees.back()[0], XMFLOAT3((float)i, 0, 0));
+	}
+	CHECK_EQUAL(16u, store.UpdateWorldMatrices());
+	CHECK_EQUAL(0u, store.UpdateWorldMatrices());
+
+	// A root takes its children along, and nothing else
+	store.SetPosition(trees[5][0], XMFLOAT3(0, 7, 0));
+	CHECK_EQUAL(1u, store.UpdateWorldMatrices());
+	for (unsigned int id : trees[5])
+		CHECK_EQUAL(7.0f, store.GetWorldMatrix(id)._42);
+	CHECK_EQUAL(0.0f, store.GetWorldMatrix(trees[6][1])._42);
+
+	// A leaf and a second tree
+	store.SetScale(trees[2][3], XMFLOAT3(2, 2, 2));
+	store.SetRotation(trees[11][0], XMFLOAT3(0, 1, 0));
+	CHECK_EQUAL(2u, store.UpdateWorldMatrices());
+
+	// Reading one transform first rebuilds what it needs, and the
+	// update still picks up the rest
+	store.SetPosition(trees[3][0], XMFLOAT3(0, 0, 1));
+	store.SetPosition(trees[9][0], XMFLOAT3(0, 0, 1));
+	CHECK_EQUAL(1.0f, store.GetWorldMatrix(trees[3][2])._43);
+	CHECK_EQUAL(1u, store.UpdateWorldMatrices());
+	CHECK_EQUAL(1.0f, store.GetWorldMatrix(trees[9][2])._43);
+}
+
+// Deep enough that subtrees span several groups and words of dirty bits
+TEST(ReparentingMovesWholeSubtrees)
+{
+	TransformStore store;
+	std::vector<unsigned int> tree = MakeTree(store, 4, 4);
+	unsigned int other = store.Allocate();
+	store.SetPosition(other, XMFLOAT3(0, 100, 0));
+	store.UpdateWorldMatrices();
+
+	// The first child of the root has 20 descendants
+	unsigned int moved = tree[1];
+	store.SetParent(moved, other);
+	store.UpdateWorldMatrices();
+	for (unsigned int id : tree)
+	{
+		bool below = id == moved;
+		for (unsigned int ancestor = store.GetParent(id); ancestor != TransformStore::None; ancestor = store.GetParent(ancestor))
+			below |= ancestor == moved;
+		CHECK_EQUAL(below ? 100.0f : 0.0f, store.GetWorldMatrix(id)._42);
+	}
+
+	// Freeing the old root leaves its other children as roots
+	store.Free(tree[0]);
+	CHECK_EQUAL(TransformStore::None, store.GetParent(tree[2]));
+	CHECK_EQUAL(tree[2], store.GetParent(tree[9]));
+	CHECK_EQUAL(moved, store.GetParent(tree[5]));
+}
+
+// The cached axes are the rows of the rotation matrix
+TEST(AxesMatchRollPitchYawMatrix)
+{
+	TransformStore store;
+	unsigned int id = store.Allocate();
+	std::mt19937 random(23);
+	std::uniform_real_distribution<float> angle(-XM_2PI, XM_2PI);
+
+	float worstAxis = 0.0f;
+	float worstOrientation = 0.0f;
+	for (int i = 0; i < 10000; i++)
+	{
+		XMFLOAT3 pitchYawRoll(angle(random), angle(random), angle(random));
+		if (i % 4 == 0)
+			pitchYawRoll.x = i % 8 == 0 ? XM_PIDIV2 : -XM_PIDIV2;
+		store.SetRotation(id, pitchYawRoll);
+
+		XMMATRIX rotation = XMMatrixRotationRollPitchYaw(pitchYawRoll.x, pitchYawRoll.y, pitchYawRoll.z);
+		worstAxis = std::max(worstAxis, VectorError(store.GetRight(id), rotation.r[0]));
+		worstAxis = std::max(worstAxis, VectorError(store.GetUp(id), rotation.r[1]));
+		worstAxis = std::max(worstAxis, VectorError(store.GetForward(id), rotation.r[2]));
+		worstOrientation = std::max(worstOrientation, RotationError(store.GetOrientation(id),
+			XMQuaternionRotationRollPitchYaw(pitchYawRoll.x, pitchYawRoll.y, pitchYawRoll.z)));
+
+		// Stored exactly as given
+		XMFLOAT3 stored = store.GetRotation(id);
+		CHECK(stored.x == pitchYawRoll.x && stored.y == pitchYawRoll.y && stored.z == pitchYawRoll.z);
+	}
+	CHECK(worstAxis < 2e-6f);
+	CHECK(worstOrientation < 1e-6f);
+
+	// No rotation leaves the axes alone
+	store.SetRotation(id, XMFLOAT3(0, 0, 0));
+	CHECK_EQUAL(1.0f, store.GetRight(id).x);
+	CHECK_EQUAL(1.0f, store.GetUp(id).y);
+	CHECK_EQUAL(1.0f, store.GetForward(id).z);
+}
+
+// A quaternion in, pitch, yaw and roll out, and back to the same rotation
+TEST(OrientationRoundTripsThroughEuler)
+{
+	TransformStore store;
+	unsigned int id = store.Allocate();
+	std::mt19937 random(24);
+	std::normal_distribution<float> component;
+
+	float worst = 0.0f;
+	for (int i = 0; i < 10000; i++)
+	{
+		// Not normalized, since SetOrientation does that
+		XMFLOAT4 quaternion(component(random), component(random), component(random), component(random));
+		store.SetOrientation(id, quaternion);
+		XMVECTOR expected = XMQuaternionNormalize(XMLoadFloat4(&quaternion));
+		CHECK(RotationError(store.GetOrientation(id), expected) < 1e-6f);
+
+		XMFLOAT3 angles = store.GetRotation(id);
+		CHECK(angles.x >= -XM_PIDIV2 && angles.x <= XM_PIDIV2);
+		worst = std::max(worst, RotationError(store.GetOrientation(id),
+			XMQuaternionRotationRollPitchYaw(angles.x, angles.y, angles.z)));
+
+		// And the angles give the same quaternion through SetRotation
+		XMFLOAT4 before = store.GetOrientation(id);
+		store.SetRotation(id, angles);
+		CHECK(RotationError(store.GetOrientation(id), XMLoadFloat4(&before)) < 1e-5f);
+	}
+	CHECK(worst < 1e-5f);
+
+	// Angles already in range come back as they went in
+	std::uniform_real_distribution<float> pitch(-1.5f, 1.5f);
+	std::uniform_real_distribution<float> turn(-3.1f, 3.1f);
+	float worstAngle = 0.0f;
+	for (int i = 0; i < 10000; i++)
+	{
+		XMFLOAT3 pitchYawRoll(pitch(random), turn(random), turn(random));
+		XMFLOAT4 quaternion;
+		XMStoreFloat4(&quaternion, XMQuaternionRotationRollPitchYaw(pitchYawRoll.x, pitchYawRoll.y, pitchYawRoll.z));
+		store.SetOrientation(id, quaternion);
+		XMFLOAT3 angles = store.GetRotation(id);
+		worstAngle = std::max({ worstAngle,
+			std::fabs(angles.x - pitchYawRoll.x), std::fabs(angles.y - pitchYawRoll.y), std::fabs(angles.z - pitchYawRoll.z) });
+	}
+	CHECK(worstAngle < 2e-5f);
+}
+
+// Straight up or down, yaw and roll turn about the same axis, so only
+// their combination is known; the rotation must still come back intact
+TEST(OrientationRoundTripsAtGimbalLock)
+{
+	TransformStore store;
+	unsigned int id = store.Allocate();
+	float worstAxis = 0.0f;
+	float worstOrientation = 0.0f;
+	for (float pitch : { XM_PIDIV2, -XM_PIDIV2 })
+	{
+		for (float yaw = -3.0f; yaw <= 3.0f; yaw += 0.25f)
+		{
+			for (float roll = -3.0f; roll <= 3.0f; roll += 0.25f)
+			{
+				XMFLOAT4 quaternion;
+				XMStoreFloat4(&quaternion, XMQuaternionRotationRollPitchYaw(pitch, yaw, roll));
+				store.SetOrientation(id, quaternion);
+
+				XMFLOAT3 angles = store.GetRotation(id);
+				CHECK_NEAR(pitch, angles.x, 1e-3);
+				XMMATRIX rotation = XMMatrixRotationRollPitchYaw(angles.x, angles.y, angles.z);
+				XMMATRIX expected = XMMatrixRotationRollPitchYaw(pitch, yaw, roll);
+				for (int row = 0; row < 3; row++)
+					worstAxis = std::max(worstAxis, XMVectorGetX(XMVector3Length(rotation.r[row] - expected.r[row])));
+				worstOrientation = std::max(worstOrientation, RotationError(quaternion,
+					XMQuaternionRotationRollPitchYaw(angles.x, angles.y, angles.z)));
+			}
+		}
+	}
+	CHECK(worstAxis < 1e-5f);
+	CHECK(worstOrientation < 1e-6f);
+}
+
+// Three-level chains where each level is uniformly scaled, scaled
+// differently on each axis, or almost flat along one axis
+TEST(InverseTransposeMatchesGeneralInverse)
+{
+	TransformStore store;
+	std::mt19937 random(24);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+	std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+	enum Kind { Uniform, NonUniform, NearlyFlat, KindCount };
+	double worstAnalytic[KindCount] = {};
+	double worstGeneral[KindCount] = {};
+	for (int chain = 0; chain < 3000; chain++)
+	{
+		// The chain's kind is its least uniform level
+		Kind kind = Uniform;
+		unsigned int parent = TransformStore::None;
+		Matrix reference;
+		for (int level = 0; level < 3; level++)
+		{
+			Kind levelKind = (Kind)(random() % KindCount);
+			kind = std::max(kind, levelKind);
+
+			ReferenceTransform transform;
+			transform.position = XMFLOAT3(position(random), position(random), position(random));
+			transform.rotation = XMFLOAT3(angle(random), angle(random), angle(random));
+			float x = scale(random);
+			transform.scale = XMFLOAT3(x, x, x);
+			if (levelKind == NonUniform)
+				transform.scale = XMFLOAT3(x, scale(random), scale(random));
+			else if (levelKind == NearlyFlat)
+				(&transform.scale.x)[random() % 3] = random() % 2 ? 1e-3f : 1e-4f;
+
+			unsigned int id = store.Allocate();
+			store.SetParent(id, parent);
+			store.SetPosition(id, transform.position);
+			store.SetRotation(id, transform.rotation);
+			store.SetScale(id, transform.scale);
+			reference = level == 0 ? ReferenceLocal(transform) : ReferenceLocal(transform) * reference;
+			parent = id;
+		}
+
+		// Only the last level's matrices are compared, since they've
+		// been through the whole chain
+		Matrix expected = InverseTranspose(reference);
+		XMMATRIX general = XMMatrixTranspose(XMMatrixInverse(0, XMLoadFloat4x4(&store.GetWorldMatrix(parent))));
+		XMFLOAT4X4 generalStored;
+		XMStoreFloat4x4(&generalStored, general);
+		worstAnalytic[kind] = std::max(worstAnalytic[kind], MatrixError(store.GetWorldInverseTransposeMatrix(parent), expected));
+		worstGeneral[kind] = std::max(worstGeneral[kind], MatrixError(generalStored, expected));
+	}
+
+	// About as close as a float general inverse, and much closer when
+	// nearly flat, where the general one loses the determinant entirely
+	CHECK(worstAnalytic[Uniform] < 5e-6);
+	CHECK(worstAnalytic[NonUniform] < 5e-6);
+	CHECK(worstAnalytic[NearlyFlat] < 1e-3);
+	CHECK(worstAnalytic[Uniform] < 2.0 * worstGeneral[Uniform]);
+	CHECK(worstAnalytic[NonUniform] < 2.0 * worstGeneral[NonUniform]);
+	CHECK(worstAnalytic[NearlyFlat] * 100.0 < worstGeneral[NearlyFlat]);
+}
+
+// Uniformly scaled transforms keep the inverse transpose they work out
+// on request, so it has to be dropped whenever the world matrix changes
+TEST(InverseTransposeFollowsChanges)
+{
+	TransformStore store;
+	std::vector<unsigned int> tree = MakeTree(store, 2, 3);
+	for (unsigned int i = 0; i < tree.size(); i++)
+	{
+		store.SetPosition(tree[i], XMFLOAT3((float)i, 1, 2));
+		store.SetRotation(tree[i], XMFLOAT3(0.1f * i, 0.2f, 0.3f));
+		store.SetScale(tree[i], XMFLOAT3(1.5f, 1.5f, 1.5f));
+	}
+	auto worst = [&]()
+	{
+		float error = 0.0f;
+		for (unsigned int id : tree)
+			error = std::max(error, InverseTransposeError(store, id));
+		return error;
+	};
+
+	// Asking again reuses what the first request worked out
+	CHECK(worst() < 1e-5f);
+	CHECK(worst() < 1e-5f);
+
+	// Moving the root changes every world matrix below it
+	store.SetPosition(tree[0], XMFLOAT3(-4, 5, 6));
+	CHECK(worst() < 1e-5f);
+	store.SetRotation(tree[1], XMFLOAT3(1, 0, 0));
+	store.UpdateWorldMatrices();
+	CHECK(worst() < 1e-5f);
+
+	// A non-uniform child under a uniform parent uses the parent's
+	store.SetScale(tree[2], XMFLOAT3(1, 2, 3));
+	CHECK(!store.HasUniformScale(tree[5]));
+	CHECK(store.HasUniformScale(tree[3]));
+	CHECK(worst() < 1e-5f);
+	store.SetScale(tree[0], XMFLOAT3(0.5f, 0.5f, 0.5f));
+	CHECK(worst() < 1e-5f);
+
+	// And back to uniform
+	store.SetScale(tree[2], XMFLOAT3(2, 2, 2));
+	CHECK(store.HasUniformScale(tree[5]));
+	CHECK(worst() < 1e-5f);
+
+	// Moving and freeing slots takes the cached matrices along
+	store.SetParent(tree[1], tree[6]);
+	CHECK(worst() < 1e-5f);
+	store.Free(tree[2]);
+	tree.erase(tree.begin() + 2);
+	CHECK(worst() < 1e-5f);
+	unsigned int added = store.Allocate();
+	CHECK(InverseTransposeError(store, added) == 0.0f);
+}
\ No newline at end of file
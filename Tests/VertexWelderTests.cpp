@@ -0,0 +1,190 @@
+#include "TestHarness.h"
+#include "VertexWelder.h"
+
+#include <map>
+#include <cmath>
+#include <tuple>
+
+// --------------------------------------------------------
+// Each weld mode's idea of "the same vertex", and the hash
+// table staying correct through probing and growth
+// --------------------------------------------------------
+
+namespace
+{
+	Vertex MakeVertex(float x, float y, float z, float u = 0.0f, float v = 0.0f)
+	{
+		Vertex vertex = {};
+		vertex.Position = DirectX::XMFLOAT3(x, y, z);
+		vertex.Normal = DirectX::XMFLOAT3(0, 1, 0);
+		vertex.UV = DirectX::XMFLOAT2(u, v);
+		return vertex;
+	}
+}
+
+TEST(ExactModeWeldsBitwiseIdenticalVertices)
+{
+	VertexWelder welder(WeldMode::Exact, 4);
+	bool isNew = false;
+
+	CHECK_EQUAL(0u, welder.Weld(MakeVertex(1, 2, 3), &isNew));
+	CHECK(isNew);
+	CHECK_EQUAL(1u, welder.Weld(MakeVertex(1, 2, 3, 0.5f), &isNew));
+	CHECK(isNew);
+	CHECK_EQUAL(0u, welder.Weld(MakeVertex(1, 2, 3), &isNew));
+	CHECK(!isNew);
+
+	// The tangent isn't part of the key
+	Vertex tangent = MakeVertex(1, 2, 3);
+	tangent.Tangent = DirectX::XMFLOAT4(1, 0, 0, -1);
+	CHECK_EQUAL(0u, welder.Weld(tangent));
+
+	// Bits, not values: 0 and -0 compare equal but don't weld, and
+	// neither does the next representable float
+	CHECK_EQUAL(2u, welder.Weld(MakeVertex(0.0f, 0, 0)));
+	CHECK_EQUAL(3u, welder.Weld(MakeVertex(-0.0f, 0, 0)));
+	CHECK_EQUAL(4u, welder.Weld(MakeVertex(std::nextafter(1.0f, 2.0f), 2, 3)));
+	CHECK_EQUAL(5u, welder.GetUniqueCount());
+}
+
+TEST(QuantizedModeWeldsWithinACell)
+{
+	VertexWelder welder(WeldMode::Quantized, 4, 0.01f);
+
+	CHECK_EQUAL(0u, welder.Weld(MakeVertex(1.0f, 0, 0)));
+	CHECK_EQUAL(0u, welder.Weld(MakeVertex(1.004f, 0, 0)));
+	CHECK_EQUAL(0u, welder.Weld(MakeVertex(0.996f, 0, 0)));
+	CHECK_EQUAL(1u, welder.Weld(MakeVertex(1.02f, 0, 0)));
+	CHECK_EQUAL(2u, welder.Weld(MakeVertex(1.0f, 0, 0, 0.5f)));
+
+	// Cells are centered on multiples of epsilon, so -0 and 0 share one
+	CHECK_EQUAL(3u, welder.Weld(MakeVertex(0.0f, 0, 0)));
+	CHECK_EQUAL(3u, welder.Weld(MakeVertex(-0.0f, 0, 0)));
+	CHECK_EQUAL(3u, welder.Weld(MakeVertex(-0.004f, 0, 0)));
+	CHECK_EQUAL(4u, welder.GetUniqueCount());
+}
+
+// Zero would snap everything into one cell, and a negative, infinite
+// or denormal epsilon means nothing sensible either
+TEST(QuantizedModeWithoutAUsableEpsilonWeldsExactly)
+{
+	for (float epsilon : { 0.0f, -0.01f, INFINITY, NAN, 1e-45f })
+	{
+		VertexWelder welder(WeldMode::Quantized, 4, epsilon);
+		CHECK(welder.GetMode() == WeldMode::Exact);
+		CHECK_EQUAL(0u, welder.Weld(MakeVertex(1.0f, 0, 0)));
+		CHECK_EQUAL(1u, welder.Weld(MakeVertex(1.004f, 0, 0)));
+		CHECK_EQUAL(2u, welder.Weld(MakeVertex(-5.0f, 3, 0)));
+		CHECK_EQUAL(0u, welder.Weld(MakeVertex(1.0f, 0, 0)));
+	}
+}
+
+// Far past the range of the cell index, infinite or NaN: each side
+// saturates into its own last cell, and NaNs only weld with NaNs
+TEST(QuantizedModeHandlesValuesOutsideTheGrid)
+{
+	VertexWelder welder(WeldMode::Quantized, 4, 0.01f);
+	CHECK(welder.GetMode() == WeldMode::Quantized);
+
+	CHECK_EQUAL(0u, welder.Weld(MakeVertex(1e30f, 0, 0)));
+	CHECK_EQUAL(0u, welder.Weld(MakeVertex(INFINITY, 0, 0)));
+	CHECK_EQUAL(0u, welder.Weld(MakeVertex(1e8f, 0, 0)));
+	CHECK_EQUAL(1u, welder.Weld(MakeVertex(-1e30f, 0, 0)));
+	CHECK_EQUAL(1u, welder.Weld(MakeVertex(-INFINITY, 0, 0)));
+	CHECK_EQUAL(2u, welder.Weld(MakeVertex(NAN, 0, 0)));
+	CHECK_EQUAL(2u, welder.Weld(MakeVertex(-NAN, 0, 0)));
+	CHECK_EQUAL(3u, welder.Weld(MakeVertex(0, 0, 0, NAN, 0)));
+
+	// Ordinary values still get cells of their own
+	CHECK_EQUAL(4u, welder.Weld(MakeVertex(0, 0, 0)));
+	CHECK_EQUAL(5u, welder.Weld(MakeVertex(1e6f, 0, 0)));
+	CHECK_EQUAL(6u, welder.Weld(MakeVertex(-1e6f, 0, 0)));
+	CHECK_EQUAL(7u, welder.GetUniqueCount());
+}
+
+TEST(IndexTripleModeWeldsOnFaceCornerIndices)
+{
+	VertexWelder welder(WeldMode::IndexTriple, 4);
+	CHECK(welder.GetMode() == WeldMode::IndexTriple);
+
+	CHECK_EQUAL(0u, welder.Weld(1, 1, 1));
+	CHECK_EQUAL(1u, welder.Weld(1, 2, 1));
+	CHECK_EQUAL(2u, welder.Weld(1, 0, 1));
+	CHECK_EQUAL(3u, welder.Weld(1, 1, 0));
+	CHECK_EQUAL(1u, welder.Weld(1, 2, 1));
+
+	// The order of the indices matters
+	CHECK_EQUAL(4u, welder.Weld(2, 1, 1));
+	CHECK_EQUAL(5u, welder.Weld(1, 1, 2));
+	CHECK_EQUAL(0u, welder.Weld(1, 1, 1));
+}
+
+TEST(ProbingFindsEveryKeyAsTheTableGrows)
+{
+	// Reserved far too small, so the table grows many times and long
+	// probe runs (keys sharing a starting slot) are common early on
+	VertexWelder welder(WeldMode::IndexTriple, 0);
+	size_t firstMemory = welder.GetMemoryUsage();
+
+	std::map<std::tuple<int, int, int>, unsigned int> expected;
+	for (int i = 0; i < 50000; i++)
+	{
+		int position = i % 997 + 1;
+		int uv = i / 997 + 1;
+		int normal = (i * 7) % 13 + 1;
+		bool isNew = false;
+		unsigned int index = welder.Weld(position, uv, normal, &isNew);
+
+		auto found = expected.find({ position, uv, normal });
+		if (found == expected.end())
+		{
+			CHECK(isNew);
+			CHECK_EQUAL((unsigned int)expected.size(), index);
+			expected[{ position, uv, normal }] = index;
+		}
+		else
+		{
+			CHECK(!isNew);
+			CHECK_EQUAL(found->second, index);
+		}
+	}
+	CHECK_EQUAL((unsigned int)expected.size(), welder.GetUniqueCount());
+	CHECK(welder.GetMemoryUsage() > firstMemory);
+
+	// Indices handed out before the table grew still hold
+	for (const auto& [key, index] : expected)
+		CHECK_EQUAL(index, welder.Weld(std::get<0>(key), std::get<1>(key), std::get<2>(key)));
+	CHECK_EQUAL((unsigned int)expected.size(), welder.GetUniqueCount());
+}
+
+TEST(ExactModeSurvivesGrowthWithManyVertices)
+{
+	VertexWelder welder(WeldMode::Exact, 16);
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (unsigned int i = 0; i < 20000; i++)
+		{
+			bool isNew = false;
+			unsigned int index = welder.Weld(MakeVertex((float)(i % 200), (float)(i / 200), 0), &isNew);
+			CHECK_EQUAL(i, index);
+			CHECK_EQUAL(pass == 0, isNew);
+		}
+	}
+	CHECK_EQUAL(20000u, welder.GetUniqueCount());
+}
+
+TEST(ClearForgetsVerticesButKeepsMemory)
+{
+	VertexWelder welder(WeldMode::IndexTriple, 1000);
+	for (int i = 1; i <= 1000; i++)
+		welder.Weld(i, i, i);
+	size_t memory = welder.GetMemoryUsage();
+
+	welder.Clear();
+	CHECK_EQUAL(0u, welder.GetUniqueCount());
+	CHECK_EQUAL(memory, welder.GetMemoryUsage());
+
+	bool isNew = false;
+	CHECK_EQUAL(0u, welder.Weld(500, 500, 500, &isNew));
+	CHECK(isNew);
+}
\ No newline at end of file
@@ -1,61 +1,58 @@
 #include "Transform.h"
 
+#include <stdexcept>
+
 using namespace DirectX;
 
 Transform::Transform()
+	: Transform(TransformStore::GetDefault())
 {
-	position = XMFLOAT3();
-	rotation = XMFLOAT3();
-	scale = XMFLOAT3(1.0f, 1.0f, 1.0f);
-
-	dirty = false;
+}
 
-	// Quickly fill out matrices with identity values
-	XMStoreFloat4x4(&world, XMMatrixIdentity());
-	XMStoreFloat4x4(&worldInverseTranspose, XMMatrixIdentity());
+Transform::Transform(TransformStore& store)
+{
+	this->store = &store;
+	id = store.Allocate();
 }
 
-Transform::~Transform() {}
+Transform::~Transform()
+{
+	store->Free(id);
+}
 
 Transform::Transform(const Transform& other)
+	: Transform(*other.store)
 {
-	position = other.position;
-	rotation = other.rotation;
-	scale = other.scale;
-
-	dirty = other.dirty;
-
-	world = other.world;
-	worldInverseTranspose = other.worldInverseTranspose;
+	*this = other;
 }
 
+// Copies the values, but keeps this transform's own slot and parent
 Transform& Transform::operator=(const Transform& other)
 {
-	position = other.position;
-	rotation = other.rotation;
-	scale = other.scale;
-
-	dirty = other.dirty;
-
-	world = other.world;
-	worldInverseTranspose = other.worldInverseTranspose;
-
+	SetPosition(other.store->GetPosition(other.id));
+	SetRotation(other.store->GetRotation(other.id));
+	SetScale(other.store->GetScale(other.id));
 	return *this;
 }
 
 XMFLOAT3 Transform::GetPosition()
 {
-	return position;
+	return store->GetPosition(id);
 }
 
 XMFLOAT3 Transform::GetRotation()
 {
-	return rotation;
+	return store->GetRotation(id);
+}
+
+XMFLOAT4 Transform::GetOrientation()
+{
+	return store->GetOrientation(id);
 }
 
 XMFLOAT3 Transform::GetScale()
 {
-	return scale;
+	return store->GetScale(id);
 }
 
 void Transform::SetPosition(float x, float y, float z)
@@ -65,8 +62,7 @@ void Transform::SetPosition(float x, float y, float z)
 
 void Transform::SetPosition(XMFLOAT3 position)
 {
-	this->position = position;
-	dirty = true; // Mark dirty to recalculate matrix when actually needed
+	store->SetPosition(id, position); // Marks dirty to recalculate matrix when actually needed
 }
 
 void Transform::SetRotation(float pitch, float yaw, float roll)
@@ -76,8 +72,12 @@ void Transform::SetRotation(float pitch, float yaw, float roll)
 
 void Transform::SetRotation(XMFLOAT3 pitchYawRoll)
 {
-	this->rotation = pitchYawRoll;
-	dirty = true; // Mark dirty to recalculate matrix when actually needed
+	store->SetRotation(id, pitchYawRoll);
+}
+
+void Transform::SetOrientation(XMFLOAT4 quaternion)
+{
+	store->SetOrientation(id, quaternion);
 }
 
 void Transform::SetScale(float x, float y, float z)
@@ -87,72 +87,46 @@ void Transform::SetScale(float x, float y, float z)
 
 void Transform::SetScale(XMFLOAT3 scale)
 {
-	this->scale = scale;
-	dirty = true; // Mark dirty to recalculate matrix when actually needed
+	store->SetScale(id, scale);
+}
+
+void Transform::SetParent(Transform* parent)
+{
+	if (parent != 0 && parent->store != store)
+		throw std::invalid_argument("A transform's parent must be in the same store");
+	store->SetParent(id, parent == 0 ? TransformStore::None : parent->id);
 }
 
 // Returns the calculated world matrix
-XMFLOAT4X4 Transform::GetWorldMatrix()
+const XMFLOAT4X4& Transform::GetWorldMatrix()
 {
-	UpdateWorldMatrices();
-	return world;
+	return store->GetWorldMatrix(id);
 }
 
 // Returns the calculated world inverse transpose matrix
-XMFLOAT4X4 Transform::GetWorldInverseTransposeMatrix()
+const XMFLOAT4X4& Transform::GetWorldInverseTransposeMatrix()
 {
-	UpdateWorldMatrices();
-	return worldInverseTranspose;
+	return store->GetWorldInverseTransposeMatrix(id);
 }
 
-// Recalculates both the world and worldInverseTranspose matrices
-void Transform::UpdateWorldMatrices()
+bool Transform::HasUniformScale()
 {
-	if (!dirty)
-		return;
-	dirty = false;
-
-	XMMATRIX mTranslation = XMMatrixTranslation(position.x, position.y, position.z);
-	XMMATRIX mRotation = XMMatrixRotationRollPitchYaw(rotation.x, rotation.y, rotation.z);
-	XMMATRIX mScale = XMMatrixScaling(scale.x, scale.y, scale.z);
-
-	// Apply in this order for most predictable results
-	XMMATRIX mWorld = mScale * mRotation * mTranslation;
-
-	// Store calculated matrix
-	XMStoreFloat4x4(&world, mWorld);
-	XMStoreFloat4x4(&worldInverseTranspose,
-		XMMatrixInverse(0, XMMatrixTranspose(mWorld)));
+	return store->HasUniformScale(id);
 }
 
 XMFLOAT3 Transform::GetRight()
 {
-	XMFLOAT3 dir = XMFLOAT3(1.0f, 0.0f, 0.0f);
-	XMVECTOR vDir = XMLoadFloat3(&dir);
-	XMVECTOR qRotation = XMQuaternionRotationRollPitchYaw(rotation.x, rotation.y, rotation.z);
-	vDir = XMVector3Rotate(vDir, qRotation);
-	XMStoreFloat3(&dir, vDir);
-	return dir;
+	return store->GetRight(id);
 }
 
 XMFLOAT3 Transform::GetUp()
 {
-	XMFLOAT3 dir = XMFLOAT3(0.0f, 1.0f, 0.0f);
-	XMVECTOR vDir = XMLoadFloat3(&dir);
-	XMVECTOR qRotation = XMQuaternionRotationRollPitchYaw(rotation.x, rotation.y, rotation.z);
-	vDir = XMVector3Rotate(vDir, qRotation);
-	XMStoreFloat3(&dir, vDir);
-	return dir;
+	return store->GetUp(id);
 }
 
 XMFLOAT3 Transform::GetForward()
 {
-	XMFLOAT3 dir = XMFLOAT3(0.0f, 0.0f, 1.0f);
-	XMVECTOR vDir = XMLoadFloat3(&dir);
-	XMVECTOR qRotation = XMQuaternionRotationRollPitchYaw(rotation.x, rotation.y, rotation.z);
-	vDir = XMVector3Rotate(vDir, qRotation);
-	XMStoreFloat3(&dir, vDir);
-	return dir;
+	return store->GetForward(id);
 }
 
 // Moves without taking orientation into account
@@ -165,10 +139,11 @@ void Transform::MoveAbsolute(float x, float y, float z)
 void Transform::MoveAbsolute(XMFLOAT3 offset)
 {
 	// Add with SIMD
+	XMFLOAT3 position = store->GetPosition(id);
 	XMVECTOR vPosition = XMLoadFloat3(&position);
 	XMVECTOR vOffset = XMLoadFloat3(&offset);
 	XMStoreFloat3(&position, vPosition + vOffset);
-	dirty = true;
+	store->SetPosition(id, position);
 }
 
 // Moves relative to local forward
@@ -180,15 +155,19 @@ void Transform::MoveRelative(float x, float y, float z)
 // Moves relative to local forward
 void Transform::MoveRelative(DirectX::XMFLOAT3 offset)
 {
-	// Calculate with SIMD
-	XMVECTOR vOffset = XMLoadFloat3(&offset);
-	XMVECTOR qRotation = XMQuaternionRotationRollPitchYaw(rotation.x, rotation.y, rotation.z);
-	// Rotate the offset vector by the rotation quaternion
-	vOffset = XMVector3Rotate(vOffset, qRotation);
+	// Rotating the offset is a sum of the cached axes, with SIMD
+	XMFLOAT3 right = store->GetRight(id);
+	XMFLOAT3 up = store->GetUp(id);
+	XMFLOAT3 forward = store->GetForward(id);
+	XMVECTOR vOffset =
+		XMVectorScale(XMLoadFloat3(&right), offset.x) +
+		XMVectorScale(XMLoadFloat3(&up), offset.y) +
+		XMVectorScale(XMLoadFloat3(&forward), offset.z);
 
+	XMFLOAT3 position = store->GetPosition(id);
 	XMVECTOR vPosition = XMLoadFloat3(&position);
 	XMStoreFloat3(&position, vPosition + vOffset);
-	dirty = true;
+	store->SetPosition(id, position);
 }
 
 void Transform::Rotate(float pitch, float yaw, float roll)
@@ -199,10 +178,11 @@ void Transform::Rotate(float pitch, float yaw, float roll)
 void Transform::Rotate(XMFLOAT3 pitchYawRoll)
 {
 	// Add with SIMD
+	XMFLOAT3 rotation = store->GetRotation(id);
 	XMVECTOR vRotation = XMLoadFloat3(&rotation);
 	XMVECTOR vOffset = XMLoadFloat3(&pitchYawRoll);
 	XMStoreFloat3(&rotation, vRotation + vOffset);
-	dirty = true;
+	store->SetRotation(id, rotation);
 }
 
 void Transform::Scale(float x, float y, float z)
@@ -213,8 +193,9 @@ void Transform::Scale(float x, float y, float z)
 void Transform::Scale(XMFLOAT3 scale)
 {
 	// Multiply with SIMD
-	XMVECTOR vScale = XMLoadFloat3(&(this->scale));
+	XMFLOAT3 current = store->GetScale(id);
+	XMVECTOR vScale = XMLoadFloat3(&current);
 	XMVECTOR vMult = XMLoadFloat3(&scale);
-	XMStoreFloat3(&(this->scale), vScale * vMult);
-	dirty = true;
+	XMStoreFloat3(&current, vScale * vMult);
+	store->SetScale(id, current);
 }
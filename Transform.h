@@ -1,31 +1,46 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include "TransformStore.h"
 
-// Stores and converts position/rotation/scale data into a single matrix
+// Stores and converts position/rotation/scale data into a single matrix.
+// The data itself lives in a TransformStore, which rebuilds the matrices
+// of every changed transform in one batch per frame; this is a handle to
+// one transform there. Copies get one of their own, with no parent.
 class Transform
 {
 public:
 	Transform();
+	explicit Transform(TransformStore& store);
 	~Transform();
 	Transform(const Transform&);
 	Transform& operator=(const Transform&);
 
 	DirectX::XMFLOAT3 GetPosition();
 	DirectX::XMFLOAT3 GetRotation();
+	DirectX::XMFLOAT4 GetOrientation();
 	DirectX::XMFLOAT3 GetScale();
 
 	void SetPosition(float x, float y, float z);
 	void SetPosition(DirectX::XMFLOAT3 position);
 	void SetRotation(float pitch, float yaw, float roll);
 	void SetRotation(DirectX::XMFLOAT3 pitchYawRoll);
+	void SetOrientation(DirectX::XMFLOAT4 quaternion);
 	void SetScale(float x, float y, float z);
 	void SetScale(DirectX::XMFLOAT3 scale);
 
-	// Returns the calculated world matrix
-	DirectX::XMFLOAT4X4 GetWorldMatrix();
-	// Returns the calculated world inverse transpose matrix
-	DirectX::XMFLOAT4X4 GetWorldInverseTransposeMatrix();
+	// Attaches this to a parent transform from the same store, or
+	// detaches it with null. Position, rotation and scale are relative to
+	// the parent from then on, and the world matrix includes the parent's.
+	void SetParent(Transform* parent);
+
+	// Returns the calculated world matrix, straight from the store (valid
+	// until a transform is created, destroyed or given a new parent)
+	const DirectX::XMFLOAT4X4& GetWorldMatrix();
+	// Returns the calculated world inverse transpose matrix, like above
+	const DirectX::XMFLOAT4X4& GetWorldInverseTransposeMatrix();
+	// When true, the world matrix can transform normals instead
+	bool HasUniformScale();
 
 	DirectX::XMFLOAT3 GetRight();
 	DirectX::XMFLOAT3 GetUp();
@@ -47,17 +62,11 @@ public:
 	void Scale(DirectX::XMFLOAT3 scale);
 
 private:
-	DirectX::XMFLOAT3 position;
-	DirectX::XMFLOAT3 rotation; // In the form of pitch, yaw, roll
-	DirectX::XMFLOAT3 scale;
-
-	/* Gets set to true when a value is modified. When GetWorldMatrix
-	 * is next called, it will recalculate the matrix */
-	bool dirty;
-
-	DirectX::XMFLOAT4X4 world;
-	DirectX::XMFLOAT4X4 worldInverseTranspose;
-
-	// Recalculates both the world and worldInverseTranspose matrices
-	void UpdateWorldMatrices();
+	/* Position, rotation (as a quaternion, plus the pitch, yaw and roll
+	 * it came from), the rotated axes, scale and both matrices
+	 * are all in the store. Modifying a value marks it (and its
+	 * children) dirty, and the matrices are rebuilt by the next batched update, or by
+	 * GetWorldMatrix if that comes first */
+	TransformStore* store;
+	unsigned int id;
 };
\ No newline at end of file
@@ -0,0 +1,608 @@
+#include "TransformStore.h"
+
+#include <bit>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace DirectX;
+
+namespace
+{
+	// Four consecutive floats as one vector (one per SIMD lane)
+	XMVECTOR LoadLanes(const std::vector<float>& values, unsigned int first)
+	{
+		return XMLoadFloat4((const XMFLOAT4*)&values[first]);
+	}
+
+	// Inverse transpose of a world matrix whose 3x3 part is a rotation
+	// with some scale on each row, as any chain of uniformly scaled
+	// transforms makes: every row over its squared length, with the
+	// translation's part along that row in the last column
+	XMMATRIX InverseTransposeFromRows(const XMFLOAT4X4& world)
+	{
+		XMMATRIX matrix = XMLoadFloat4x4(&world);
+		XMMATRIX result;
+		for (int row = 0; row < 3; row++)
+		{
+			XMVECTOR axis = matrix.r[row] * XMVectorReciprocal(XMVector3LengthSq(matrix.r[row]));
+			result.r[row] = XMVectorSetW(axis, -XMVectorGetX(XMVector3Dot(matrix.r[3], axis)));
+		}
+		result.r[3] = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+		return result;
+	}
+}
+
+TransformStore::TransformStore()
+{
+	count = 0;
+}
+
+TransformStore::~TransformStore() {}
+
+TransformStore& TransformStore::GetDefault()
+{
+	static TransformStore store;
+	return store;
+}
+
+unsigned int TransformStore::Allocate()
+{
+	if (freeSlots.empty())
+	{
+		// Grow by a whole group of empty roots, handing out the lowest slot first
+		unsigned int first = GetCapacity();
+		unsigned int capacity = first + GroupSize;
+		for (std::vector<float>* values : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ,
+			&orientationX, &orientationY, &orientationZ, &rightY, &rightZ, &upX, &upZ, &forwardX, &forwardY })
+			values->resize(capacity, 0.0f);
+		for (std::vector<float>* values : { &scaleX, &scaleY, &scaleZ, &orientationW, &rightX, &upY, &forwardZ })
+			values->resize(capacity, 1.0f);
+
+		XMFLOAT4X4 identity;
+		XMStoreFloat4x4(&identity, XMMatrixIdentity());
+		world.resize(capacity, identity);
+		worldInverseTranspose.resize(capacity, identity);
+		parent.resize(capacity, None);
+		depth.resize(capacity, 0);
+		idOfSlot.resize(capacity, None);
+		uniformScale.resize(capacity, 1);
+		inverseTransposeCurrent.resize(capacity, 1);
+		dirty.resize((capacity + 63) / 64, 0);
+		dirtyWords.resize((dirty.size() + 63) / 64, 0);
+
+		for (unsigned int slot = capacity; slot > first; slot--)
+			freeSlots.push_back(slot - 1);
+	}
+
+	unsigned int slot = freeSlots.back();
+	freeSlots.pop_back();
+
+	unsigned int id = (unsigned int)slotOfId.size();
+	if (freeIds.empty())
+	{
+		slotOfId.push_back(slot);
+	}
+	else
+	{
+		id = freeIds.back();
+		freeIds.pop_back();
+		slotOfId[id] = slot;
+	}
+	idOfSlot[slot] = id;
+
+	count++;
+	return id;
+}
+
+void TransformStore::Free(unsigned int id)
+{
+	unsigned int slot = slotOfId[id];
+
+	// Children move up a level, which keeps the order depth first
+	unsigned int end = SubtreeEnd(slot);
+	for (unsigned int descendant = slot + 1; descendant < end; descendant++)
+	{
+		depth[descendant]--;
+		if (parent[descendant] == slot)
+			parent[descendant] = parent[slot];
+	}
+	SetDirty(slot + 1, end);
+
+	// Then this one leaves as an empty root
+	if (parent[slot] != None)
+	{
+		Attach(slot, None);
+		slot = slotOfId[id];
+	}
+
+	// Back to the values Allocate() promises, with matching matrices
+	positionX[slot] = positionY[slot] = positionZ[slot] = 0.0f;
+	rotationX[slot] = rotationY[slot] = rotationZ[slot] = 0.0f;
+	StoreOrientation(slot, XMQuaternionIdentity());
+	scaleX[slot] = scaleY[slot] = scaleZ[slot] = 1.0f;
+	XMStoreFloat4x4(&world[slot], XMMatrixIdentity());
+	XMStoreFloat4x4(&worldInverseTranspose[slot], XMMatrixIdentity());
+	uniformScale[slot] = 1;
+	inverseTransposeCurrent[slot] = 1;
+	ClearDirty(slot, slot + 1);
+
+	idOfSlot[slot] = None;
+	slotOfId[id] = None;
+	freeSlots.push_back(slot);
+	freeIds.push_back(id);
+	count--;
+}
+
+void TransformStore::SetParent(unsigned int id, unsigned int parentId)
+{
+	unsigned int slot = slotOfId[id];
+	unsigned int parentSlot = parentId == None ? None : slotOfId[parentId];
+	if (parent[slot] != parentSlot)
+		Attach(slot, parentSlot);
+}
+
+unsigned int TransformStore::GetParent(unsigned int id) const
+{
+	unsigned int parentSlot = parent[slotOfId[id]];
+	return parentSlot == None ? None : idOfSlot[parentSlot];
+}
+
+XMFLOAT3 TransformStore::GetPosition(unsigned int id) const
+{
+	unsigned int slot = slotOfId[id];
+	return XMFLOAT3(positionX[slot], positionY[slot], positionZ[slot]);
+}
+
+XMFLOAT3 TransformStore::GetRotation(unsigned int id) const
+{
+	unsigned int slot = slotOfId[id];
+	return XMFLOAT3(rotationX[slot], rotationY[slot], rotationZ[slot]);
+}
+
+XMFLOAT4 TransformStore::GetOrientation(unsigned int id) const
+{
+	unsigned int slot = slotOfId[id];
+	return XMFLOAT4(orientationX[slot], orientationY[slot], orientationZ[slot], orientationW[slot]);
+}
+
+XMFLOAT3 TransformStore::GetScale(unsigned int id) const
+{
+	unsigned int slot = slotOfId[id];
+	return XMFLOAT3(scaleX[slot], scaleY[slot], scaleZ[slot]);
+}
+
+void TransformStore::SetPosition(unsigned int id, XMFLOAT3 position)
+{
+	unsigned int slot = slotOfId[id];
+	positionX[slot] = position.x;
+	positionY[slot] = position.y;
+	positionZ[slot] = position.z;
+	MarkDirty(slot);
+}
+
+void TransformStore::SetRotation(unsigned int id, XMFLOAT3 pitchYawRoll)
+{
+	unsigned int slot = slotOfId[id];
+	rotationX[slot] = pitchYawRoll.x;
+	rotationY[slot] = pitchYawRoll.y;
+	rotationZ[slot] = pitchYawRoll.z;
+	StoreOrientation(slot, XMQuaternionRotationRollPitchYaw(pitchYawRoll.x, pitchYawRoll.y, pitchYawRoll.z));
+	MarkDirty(slot);
+}
+
+void TransformStore::SetOrientation(unsigned int id, XMFLOAT4 quaternion)
+{
+	unsigned int slot = slotOfId[id];
+	StoreOrientation(slot, XMQuaternionNormalize(XMLoadFloat4(&quaternion)));
+
+	// With roll, then pitch, then yaw, forward ends up at
+	// (cos p sin y, -sin p, cos p cos y)
+	float x = forwardX[slot], y = forwardY[slot], z = forwardZ[slot];
+	float pitch = std::atan2(-y, std::sqrt(x * x + z * z));
+	float yaw = std::atan2(x, z);
+
+	// Undoing yaw and then pitch leaves right rotated by roll alone.
+	// Straight up or down, where yaw is only rounding noise, roll
+	// takes up whatever turn is left.
+	float sinPitch = std::sin(pitch), cosPitch = std::cos(pitch);
+	float sinYaw = std::sin(yaw), cosYaw = std::cos(yaw);
+	x = rightX[slot];
+	y = rightY[slot];
+	z = rightZ[slot];
+	float roll = std::atan2(
+		y * cosPitch + (x * sinYaw + z * cosYaw) * sinPitch,
+		x * cosYaw - z * sinYaw);
+
+	rotationX[slot] = pitch;
+	rotationY[slot] = yaw;
+	rotationZ[slot] = roll;
+	MarkDirty(slot);
+}
+
+void TransformStore::SetScale(unsigned int id, XMFLOAT3 scale)
+{
+	unsigned int slot = slotOfId[id];
+	scaleX[slot] = scale.x;
+	scaleY[slot] = scale.y;
+	scaleZ[slot] = scale.z;
+	MarkDirty(slot);
+}
+
+const XMFLOAT4X4& TransformStore::GetWorldMatrix(unsigned int id)
+{
+	unsigned int slot = slotOfId[id];
+	if (IsDirty(slot))
+		UpdateGroups(slot + 1);
+	return world[slot];
+}
+
+const XMFLOAT4X4& TransformStore::GetWorldInverseTransposeMatrix(unsigned int id)
+{
+	unsigned int slot = slotOfId[id];
+	if (IsDirty(slot))
+		UpdateGroups(slot + 1);
+	return InverseTranspose(slot);
+}
+
+bool TransformStore::HasUniformScale(unsigned int id)
+{
+	unsigned int slot = slotOfId[id];
+	if (IsDirty(slot))
+		UpdateGroups(slot + 1);
+	return uniformScale[slot] != 0;
+}
+
+unsigned int TransformStore::UpdateWorldMatrices()
+{
+	return UpdateGroups(GetCapacity());
+}
+
+unsigned int TransformStore::GetCount() const
+{
+	return count;
+}
+
+unsigned int TransformStore::GetCapacity() const
+{
+	return (unsigned int)positionX.size();
+}
+
+XMFLOAT3 TransformStore::GetRight(unsigned int id) const
+{
+	unsigned int slot = slotOfId[id];
+	return XMFLOAT3(rightX[slot], rightY[slot], rightZ[slot]);
+}
+
+XMFLOAT3 TransformStore::GetUp(unsigned int id) const
+{
+	unsigned int slot = slotOfId[id];
+	return XMFLOAT3(upX[slot], upY[slot], upZ[slot]);
+}
+
+XMFLOAT3 TransformStore::GetForward(unsigned int id) const
+{
+	unsigned int slot = slotOfId[id];
+	return XMFLOAT3(forwardX[slot], forwardY[slot], forwardZ[slot]);
+}
+
+void TransformStore::StoreOrientation(unsigned int slot, FXMVECTOR quaternion)
+{
+	XMFLOAT4 q;
+	XMStoreFloat4(&q, quaternion);
+	orientationX[slot] = q.x;
+	orientationY[slot] = q.y;
+	orientationZ[slot] = q.z;
+	orientationW[slot] = q.w;
+
+	// Rows of XMMatrixRotationQuaternion, which are where the
+	// quaternion takes each axis
+	rightX[slot] = 1.0f - 2.0f * (q.y * q.y + q.z * q.z);
+	rightY[slot] = 2.0f * (q.x * q.y + q.z * q.w);
+	rightZ[slot] = 2.0f * (q.x * q.z - q.y * q.w);
+	upX[slot] = 2.0f * (q.x * q.y - q.z * q.w);
+	upY[slot] = 1.0f - 2.0f * (q.x * q.x + q.z * q.z);
+	upZ[slot] = 2.0f * (q.y * q.z + q.x * q.w);
+	forwardX[slot] = 2.0f * (q.x * q.z + q.y * q.w);
+	forwardY[slot] = 2.0f * (q.y * q.z - q.x * q.w);
+	forwardZ[slot] = 1.0f - 2.0f * (q.x * q.x + q.y * q.y);
+}
+
+unsigned int TransformStore::SubtreeEnd(unsigned int slot) const
+{
+	unsigned int end = slot + 1;
+	while (end < GetCapacity() && depth[end] > depth[slot])
+		end++;
+	return end;
+}
+
+void TransformStore::Attach(unsigned int slot, unsigned int parentSlot)
+{
+	unsigned int end = SubtreeEnd(slot);
+	unsigned int size = end - slot;
+
+	// Children go last under their parent, and roots go right after the
+	// whole tree they're leaving
+	unsigned int insertAt = end;
+	unsigned int newDepth = 0;
+	if (parentSlot == None)
+	{
+		while (insertAt < GetCapacity() && depth[insertAt] > 0)
+			insertAt++;
+	}
+	else
+	{
+		if (parentSlot >= slot && parentSlot < end)
+			throw std::invalid_argument("A transform can't be attached to itself or one of its descendants");
+		newDepth = depth[parentSlot] + 1;
+
+		// Already just past the end of the parent's subtree (as when
+		// building parents first) saves scanning every slot in it
+		unsigned int previous = slot - 1; // None for slot 0
+		while (previous != None && depth[previous] > depth[parentSlot])
+			previous = parent[previous];
+		bool alreadyLast = previous == parentSlot && depth[slot] <= depth[parentSlot];
+		insertAt = alreadyLast ? slot : SubtreeEnd(parentSlot);
+	}
+
+	// Moving the subtree is a rotation of it and whatever is in between
+	if (insertAt > end)
+	{
+		RotateSlots(slot, end, insertAt);
+		if (parentSlot != None && parentSlot >= end)
+			parentSlot -= size;
+		slot = insertAt - size;
+	}
+	else if (insertAt < slot)
+	{
+		RotateSlots(insertAt, slot, end);
+		slot = insertAt;
+	}
+
+	unsigned int oldDepth = depth[slot];
+	for (unsigned int descendant = slot; descendant < slot + size; descendant++)
+		depth[descendant] = depth[descendant] - oldDepth + newDepth;
+	parent[slot] = parentSlot;
+	SetDirty(slot, slot + size);
+}
+
+void TransformStore::RotateSlots(unsigned int first, unsigned int middle, unsigned int last)
+{
+	auto rotate = [&](auto& values)
+	{
+		std::rotate(values.begin() + first, values.begin() + middle, values.begin() + last);
+	};
+	for (std::vector<float>* values : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ,
+		&orientationX, &orientationY, &orientationZ, &orientationW, &scaleX, &scaleY, &scaleZ,
+		&rightX, &rightY, &rightZ, &upX, &upY, &upZ, &forwardX, &forwardY, &forwardZ })
+		rotate(*values);
+	rotate(world);
+	rotate(worldInverseTranspose);
+	rotate(parent);
+	rotate(depth);
+	rotate(idOfSlot);
+	rotate(uniformScale);
+	rotate(inverseTransposeCurrent);
+
+	// Dirty bits move with their slots
+	std::vector<bool> wasDirty(last - first);
+	for (unsigned int slot = first; slot < last; slot++)
+		wasDirty[slot - first] = IsDirty(slot);
+	std::rotate(wasDirty.begin(), wasDirty.begin() + (middle - first), wasDirty.end());
+	ClearDirty(first, last);
+	for (unsigned int slot = first; slot < last; slot++)
+	{
+		if (wasDirty[slot - first])
+			SetDirty(slot, slot + 1);
+	}
+
+	// Where a slot in the range went (anything else stays put)
+	auto moved = [&](unsigned int slot)
+	{
+		if (slot < first || slot >= last)
+			return slot;
+		return slot < middle ? slot + (last - middle) : slot - (middle - first);
+	};
+
+	for (unsigned int slot = first; slot < last; slot++)
+	{
+		if (idOfSlot[slot] != None)
+			slotOfId[idOfSlot[slot]] = slot;
+	}
+
+	// Only slots before the next root can have a parent in the range,
+	// since every tree after that starts at its own root
+	unsigned int end = last;
+	while (end < GetCapacity() && depth[end] > 0)
+		end++;
+	for (unsigned int slot = first; slot < end; slot++)
+		parent[slot] = moved(parent[slot]);
+
+	for (unsigned int& slot : freeSlots)
+		slot = moved(slot);
+}
+
+bool TransformStore::IsDirty(unsigned int slot) const
+{
+	return (dirty[slot / 64] >> (slot % 64)) & 1;
+}
+
+void TransformStore::MarkDirty(unsigned int slot)
+{
+	// Already dirty means the subtree is too
+	if (!IsDirty(slot))
+		SetDirty(slot, SubtreeEnd(slot));
+}
+
+void TransformStore::SetDirty(unsigned int first, unsigned int last)
+{
+	// A word at a time, flagging each word touched
+	while (first < last)
+	{
+		unsigned int word = first / 64;
+		unsigned int bits = std::min(64 - first % 64, last - first);
+		uint64_t mask = (bits == 64 ? ~0ull : (1ull << bits) - 1) << (first % 64);
+		dirty[word] |= mask;
+		dirtyWords[word / 64] |= 1ull << (word % 64);
+		first += bits;
+	}
+}
+
+void TransformStore::ClearDirty(unsigned int first, unsigned int last)
+{
+	while (first < last)
+	{
+		unsigned int word = first / 64;
+		unsigned int bits = std::min(64 - first % 64, last - first);
+		uint64_t mask = (bits == 64 ? ~0ull : (1ull << bits) - 1) << (first % 64);
+		dirty[word] &= ~mask;
+		if (dirty[word] == 0)
+			dirtyWords[word / 64] &= ~(1ull << (word % 64));
+		first += bits;
+	}
+}
+
+unsigned int TransformStore::UpdateGroups(unsigned int last)
+{
+	// Visit each group of four with any dirty bits, in slot order, so
+	// parents are always rebuilt before their children
+	unsigned int groups = 0;
+	for (size_t summary = 0; summary < dirtyWords.size(); summary++)
+	{
+		while (dirtyWords[summary] != 0)
+		{
+			size_t word = summary * 64 + std::countr_zero(dirtyWords[summary]);
+			unsigned int bit = (unsigned int)std::countr_zero(dirty[word]);
+			unsigned int first = (unsigned int)word * 64 + bit - bit % GroupSize;
+			if (first >= last)
+				return groups;
+
+			RebuildGroup(first);
+			groups++;
+		}
+	}
+	return groups;
+}
+
+// --------------------------------------------------------
+// Builds scale * rotation * translation for four slots at
+// once. Each vector holds one matrix element for all four
+// slots, so the multiplies happen once per group, and the
+// results are transposed back into one matrix per slot at
+// the end. The rotation rows are the cached right, up and
+// forward vectors, so there's no trig here at all.
+//
+// The inverse transpose of scale * rotation * translation
+// is the rotation with each row divided by its scale (and
+// the translation moved into the last column), so it's built
+// the same way instead of with a general 4x4 inverse. With
+// uniform scale it's skipped, and only worked out (once) if
+// something asks for it.
+//
+// Children then multiply in their parent's world matrix,
+// which is already up to date: parents come first, either in
+// an earlier group or an earlier lane of this one.
+// --------------------------------------------------------
+void TransformStore::RebuildGroup(unsigned int first)
+{
+	XMVECTOR scaleXs = LoadLanes(scaleX, first);
+	XMVECTOR scaleYs = LoadLanes(scaleY, first);
+	XMVECTOR scaleZs = LoadLanes(scaleZ, first);
+
+	// Element [row][column] of every slot's world matrix, one slot per lane
+	XMMATRIX elements[4];
+	elements[0].r[0] = LoadLanes(rightX, first) * scaleXs;
+	elements[0].r[1] = LoadLanes(rightY, first) * scaleXs;
+	elements[0].r[2] = LoadLanes(rightZ, first) * scaleXs;
+	elements[0].r[3] = XMVectorZero();
+	elements[1].r[0] = LoadLanes(upX, first) * scaleYs;
+	elements[1].r[1] = LoadLanes(upY, first) * scaleYs;
+	elements[1].r[2] = LoadLanes(upZ, first) * scaleYs;
+	elements[1].r[3] = XMVectorZero();
+	elements[2].r[0] = LoadLanes(forwardX, first) * scaleZs;
+	elements[2].r[1] = LoadLanes(forwardY, first) * scaleZs;
+	elements[2].r[2] = LoadLanes(forwardZ, first) * scaleZs;
+	elements[2].r[3] = XMVectorZero();
+	elements[3].r[0] = LoadLanes(positionX, first);
+	elements[3].r[1] = LoadLanes(positionY, first);
+	elements[3].r[2] = LoadLanes(positionZ, first);
+	elements[3].r[3] = XMVectorSplatOne();
+
+	// The inverse transpose's elements: each rotation row over its scale,
+	// with the translation along that row in the last column
+	const std::vector<float>* axes[3][3] = {
+		{ &rightX, &rightY, &rightZ },
+		{ &upX, &upY, &upZ },
+		{ &forwardX, &forwardY, &forwardZ } };
+	XMVECTOR inverseScales[3] = { XMVectorReciprocal(scaleXs), XMVectorReciprocal(scaleYs), XMVectorReciprocal(scaleZs) };
+	XMMATRIX inverseElements[4];
+	for (int row = 0; row < 3; row++)
+	{
+		XMVECTOR axisX = LoadLanes(*axes[row][0], first);
+		XMVECTOR axisY = LoadLanes(*axes[row][1], first);
+		XMVECTOR axisZ = LoadLanes(*axes[row][2], first);
+		XMVECTOR along = axisX * elements[3].r[0] + axisY * elements[3].r[1] + axisZ * elements[3].r[2];
+		inverseElements[row].r[0] = axisX * inverseScales[row];
+		inverseElements[row].r[1] = axisY * inverseScales[row];
+		inverseElements[row].r[2] = axisZ * inverseScales[row];
+		inverseElements[row].r[3] = -along * inverseScales[row];
+	}
+	inverseElements[3].r[0] = XMVectorZero();
+	inverseElements[3].r[1] = XMVectorZero();
+	inverseElements[3].r[2] = XMVectorZero();
+	inverseElements[3].r[3] = XMVectorSplatOne();
+
+	// Transposing a row's elements gives that row for each slot
+	XMMATRIX rows[4];
+	XMMATRIX inverseRows[4];
+	for (int row = 0; row < 4; row++)
+	{
+		rows[row] = XMMatrixTranspose(elements[row]);
+		inverseRows[row] = XMMatrixTranspose(inverseElements[row]);
+	}
+
+	for (unsigned int lane = 0; lane < GroupSize; lane++)
+	{
+		unsigned int slot = first + lane;
+		unsigned int parentSlot = parent[slot];
+		XMMATRIX matrix;
+		for (int row = 0; row < 4; row++)
+			matrix.r[row] = rows[row].r[lane];
+		if (parentSlot != None)
+			matrix = XMMatrixMultiply(matrix, XMLoadFloat4x4(&world[parentSlot]));
+		XMStoreFloat4x4(&world[slot], matrix);
+
+		// Uniform scale all the way up leaves normals pointing where the
+		// world matrix itself takes them, so they don't need their own
+		uniformScale[slot] =
+			scaleX[slot] == scaleY[slot] && scaleY[slot] == scaleZ[slot] &&
+			(parentSlot == None || uniformScale[parentSlot]);
+		inverseTransposeCurrent[slot] = !uniformScale[slot];
+		if (uniformScale[slot])
+			continue;
+
+		// The inverse transpose of a product is the product of the inverse
+		// transposes, in the same order
+		XMMATRIX inverse;
+		for (int row = 0; row < 4; row++)
+			inverse.r[row] = inverseRows[row].r[lane];
+		if (parentSlot != None)
+			inverse = XMMatrixMultiply(inverse, XMLoadFloat4x4(&InverseTranspose(parentSlot)));
+		XMStoreFloat4x4(&worldInverseTranspose[slot], inverse);
+	}
+
+	// All four are up to date now, dirty or not
+	ClearDirty(first, first + GroupSize);
+}
+
+const XMFLOAT4X4& TransformStore::InverseTranspose(unsigned int slot)
+{
+	// Kept until the next rebuild, so siblings under a uniformly scaled
+	// parent (and repeated requests) share one
+	if (!inverseTransposeCurrent[slot])
+	{
+		XMStoreFloat4x4(&worldInverseTranspose[slot], InverseTransposeFromRows(world[slot]));
+		inverseTransposeCurrent[slot] = 1;
+	}
+	return worldInverseTranspose[slot];
+}
\ No newline at end of file
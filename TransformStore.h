@@ -0,0 +1,176 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include <DirectXMath.h>
+
+// --------------------------------------------------------
+// Storage for every Transform's data, kept as a structure of
+// arrays (one array per component) instead of one object per
+// transform. Changes only set a bit, and UpdateWorldMatrices()
+// rebuilds every changed matrix in one pass over contiguous
+// memory, four transforms at a time in SIMD lanes.
+//
+// Orientation is kept as a quaternion, along with the right,
+// up and forward vectors it produces, so the trig happens once
+// when a rotation changes instead of every time something asks
+// for a direction or a matrix.
+//
+// Transforms can have parents. Slots are kept in depth-first
+// order (every parent before its children, and each subtree
+// in one contiguous run), so a single pass in slot order sees
+// each parent's new world matrix before its children need it,
+// and changing a transform only has to mark its own run of
+// slots dirty. Attaching moves a subtree to the end of its
+// new parent's run, so transforms are identified by ids that
+// stay the same while their slots move.
+//
+// Slots are handed out in groups of four, so each group lines
+// up with one set of SIMD lanes.
+// --------------------------------------------------------
+class TransformStore
+{
+public:
+	TransformStore();
+	~TransformStore();
+	TransformStore(const TransformStore&) = delete;
+	TransformStore& operator=(const TransformStore&) = delete;
+
+	// No parent, or no transform
+	static constexpr unsigned int None = UINT_MAX;
+
+	// The store every Transform uses unless it's given another one
+	static TransformStore& GetDefault();
+
+	// A transform with no parent, no translation or rotation and a
+	// scale of one. Returns its id.
+	unsigned int Allocate();
+	// The transform's children move up to its parent, keeping their
+	// own position, rotation and scale
+	void Free(unsigned int id);
+
+	// Attaches a transform to a parent, or detaches it with None. Its
+	// position, rotation and scale are relative to the parent from then
+	// on, and its world matrix is its own matrix times the parent's.
+	// Throws std::invalid_argument if the parent is in its own subtree.
+	// Moving the subtree costs up to a pass over the slots between its
+	// old and new place, and nothing at all when it's already last under
+	// the new parent (as when building hierarchies parents first).
+	void SetParent(unsigned int id, unsigned int parentId);
+	unsigned int GetParent(unsigned int id) const;
+
+	// Relative to the parent, if there is one
+	DirectX::XMFLOAT3 GetPosition(unsigned int id) const;
+	DirectX::XMFLOAT3 GetRotation(unsigned int id) const; // Pitch, yaw, roll
+	DirectX::XMFLOAT4 GetOrientation(unsigned int id) const; // Quaternion
+	DirectX::XMFLOAT3 GetScale(unsigned int id) const;
+	void SetPosition(unsigned int id, DirectX::XMFLOAT3 position);
+	// Pitch, yaw and roll are kept exactly as given (so adding to them
+	// behaves the same as always), and converted to the orientation here
+	void SetRotation(unsigned int id, DirectX::XMFLOAT3 pitchYawRoll);
+	// Normalizes the quaternion and works out matching pitch, yaw and roll
+	void SetOrientation(unsigned int id, DirectX::XMFLOAT4 quaternion);
+	void SetScale(unsigned int id, DirectX::XMFLOAT3 scale);
+
+	// The local axes after rotation (relative to the parent, if any),
+	// cached whenever the orientation changes
+	DirectX::XMFLOAT3 GetRight(unsigned int id) const;
+	DirectX::XMFLOAT3 GetUp(unsigned int id) const;
+	DirectX::XMFLOAT3 GetForward(unsigned int id) const;
+
+	// Up to date even between batched updates (a dirty transform first
+	// rebuilds every dirty group up to its own, which covers all of its
+	// ancestors). The references are only valid until the next change
+	// to the store's layout (Allocate, Free or SetParent).
+	const DirectX::XMFLOAT4X4& GetWorldMatrix(unsigned int id);
+	const DirectX::XMFLOAT4X4& GetWorldInverseTransposeMatrix(unsigned int id);
+
+	// True when the transform and all of its ancestors scale every axis
+	// the same. The world matrix then turns normals the right way too (they
+	// only need renormalizing), so updates skip the inverse transpose and
+	// GetWorldInverseTransposeMatrix works it out the first time it's
+	// asked for after each rebuild.
+	bool HasUniformScale(unsigned int id);
+
+	// Rebuilds the matrices of every transform changed since the last
+	// update (and everything below them), returning how many groups of
+	// four that took
+	unsigned int UpdateWorldMatrices();
+
+	// Transforms in use, and slots allocated (in use or free)
+	unsigned int GetCount() const;
+	unsigned int GetCapacity() const;
+
+private:
+	static const unsigned int GroupSize = 4;
+
+	// One past the last slot in the subtree starting at slot
+	unsigned int SubtreeEnd(unsigned int slot) const;
+
+	// Stores a unit quaternion and the axes it rotates to
+	void StoreOrientation(unsigned int slot, DirectX::FXMVECTOR quaternion);
+
+	// Moves a subtree under parentSlot (or out to a root with None)
+	void Attach(unsigned int slot, unsigned int parentSlot);
+	// std::rotate on every per-slot array, fixing up everything that
+	// refers to slots in the range
+	void RotateSlots(unsigned int first, unsigned int middle, unsigned int last);
+
+	bool IsDirty(unsigned int slot) const;
+	// Marks a slot and its whole subtree
+	void MarkDirty(unsigned int slot);
+	void SetDirty(unsigned int first, unsigned int last);
+	void ClearDirty(unsigned int first, unsigned int last);
+
+	// Rebuilds dirty groups in slot order, stopping at the first group
+	// starting at or after last
+	unsigned int UpdateGroups(unsigned int last);
+	// Rebuilds the four slots starting at first (a multiple of four)
+	void RebuildGroup(unsigned int first);
+	// The slot's inverse transpose, first worked out from its world
+	// matrix if the last rebuild skipped it
+	const DirectX::XMFLOAT4X4& InverseTranspose(unsigned int slot);
+
+	// Pitch, yaw and roll are kept in the rotation arrays, and the
+	// quaternion they match in the orientation arrays
+	std::vector<float> positionX, positionY, positionZ;
+	std::vector<float> rotationX, rotationY, rotationZ;
+	std::vector<float> orientationX, orientationY, orientationZ, orientationW;
+	std::vector<float> scaleX, scaleY, scaleZ;
+
+	// Rows of the rotation matrix, from the orientation
+	std::vector<float> rightX, rightY, rightZ;
+	std::vector<float> upX, upY, upZ;
+	std::vector<float> forwardX, forwardY, forwardZ;
+
+	std::vector<DirectX::XMFLOAT4X4> world;
+	std::vector<DirectX::XMFLOAT4X4> worldInverseTranspose;
+
+	// Per slot: the parent's slot (or None) and the number of ancestors.
+	// A subtree is its root plus the following slots that are deeper.
+	std::vector<unsigned int> parent;
+	std::vector<unsigned int> depth;
+
+	// Ids and slots map both ways (None for free ones)
+	std::vector<unsigned int> idOfSlot;
+	std::vector<unsigned int> slotOfId;
+
+	// Per slot, set by each rebuild (see HasUniformScale), and whether
+	// the inverse transpose matches the world matrix (cleared by rebuilds
+	// that skip it)
+	std::vector<uint8_t> uniformScale;
+	std::vector<uint8_t> inverseTransposeCurrent;
+
+	// One bit per slot, set when it or an ancestor changes after its
+	// matrices were built, and one bit per word of those with any set,
+	// so an update only visits what changed. A dirty slot's whole
+	// subtree is always dirty too.
+	std::vector<uint64_t> dirty;
+	std::vector<uint64_t> dirtyWords;
+
+	// Free slots are always empty roots
+	std::vector<unsigned int> freeSlots;
+	std::vector<unsigned int> freeIds;
+	unsigned int count;
+};
\ No newline at end of file
@@ -12,5 +12,5 @@ struct Vertex
 	DirectX::XMFLOAT3 Position;	// The local position of the vertex
 	DirectX::XMFLOAT3 Normal;	// The normal vector of the vertex
 	DirectX::XMFLOAT2 UV;		// The UV texture coordinates of the vertex
-	DirectX::XMFLOAT3 Tangent;	// The tangent vector of the vertex
+	DirectX::XMFLOAT4 Tangent;	// The tangent vector of the vertex (w is the bitangent's sign)
 };
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef __VERTEX_TRANSFORM__
+#define __VERTEX_TRANSFORM__
+
+#include "ShaderIncludes.hlsli"
+
+cbuffer ExternalData : register(b0)
+{
+    matrix world;
+    matrix worldInvTranspose;
+    matrix view;
+    matrix projection;
+	
+    matrix lightView;
+    matrix lightProjection;
+
+    matrix dequantize;
+}
+
+// Shared by every vertex format's entry point, once the input is decoded
+VertexToPixel TransformVertex(VertexInput input)
+{
+	// Set up output struct
+	VertexToPixel output;
+
+	// Quantized positions are scaled back into local space first, on their
+	// own: folded into world it would skew the tangents too
+	float3 localPosition = mul(dequantize, float4(input.localPosition, 1.0f)).xyz;
+
+	// Here we're essentially passing the input position directly through to the next
+	// stage (rasterizer), though it needs to be a 4-component vector now.  
+	// - To be considered within the bounds of the screen, the X and Y components 
+	//   must be between -1 and 1.  
+	// - The Z component must be between 0 and 1.  
+	// - Each of these components is then automatically divided by the W component
+    matrix wvp = mul(projection, mul(view, world));
+	output.screenPosition = mul(wvp, float4(localPosition, 1.0f));
+	
+	// World position is obtained by using only the world part of the wvp matrix
+    output.worldPosition = mul(world, float4(localPosition, 1.0f)).xyz;
+	
+	// Transform where the pixel would be relative to the light WVP matrix
+    matrix shadowWVP = mul(lightProjection, mul(lightView, world));
+    output.shadowPosition = mul(shadowWVP, float4(localPosition, 1.0f));
+	
+	/* Input normals need to be transformed by the world inverse transpose matrix,
+	 * otherwise, translation or non-uniform scaling would break the normals */
+    output.worldNormal = mul((float3x3)worldInvTranspose, input.normal);
+	
+    output.uv = input.uv;
+	
+    output.worldTangent = float4(mul((float3x3)world, input.tangent.xyz), input.tangent.w);
+
+	// Whatever we return will progress to the next stage we're using (the pixel shader for now)
+	return output;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "VertexWelder.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	// Largest table a 32-bit slot mask can address. At half full it
+	// holds 2^30 unique vertices, far beyond anything a mesh needs.
+	const uint32_t maxTableSize = 1u << 31;
+
+	// Smallest power of two that keeps the table at most half full.
+	// The count is only a reservation hint, so a larger one is capped
+	// rather than doubling past 2^31 (and wrapping to zero) forever.
+	uint32_t TableSizeFor(size_t count)
+	{
+		uint32_t size = 16;
+		while (size < maxTableSize && size < count * 2)
+			size <<= 1;
+		return size;
+	}
+
+	// Mixes every word of the key into a well-distributed 32-bit hash
+	uint32_t HashKey(const uint32_t* key, unsigned int words)
+	{
+		uint64_t hash = 0x9E3779B97F4A7C15ull;
+		for (unsigned int i = 0; i < words; i++)
+		{
+			hash ^= key[i];
+			hash *= 0xFF51AFD7ED558CCDull;
+			hash ^= hash >> 32;
+		}
+		return (uint32_t)hash;
+	}
+
+	uint32_t FloatBits(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	// The nearest grid cell, with everything past the largest float
+	// below 2^31 (infinities included) in the last cell on that side.
+	// That leaves INT32_MIN for NaN, so NaNs weld only with each other.
+	uint32_t CellOf(float value, float inverseEpsilon)
+	{
+		const float limit = 2147483520.0f;
+		float cell = std::floor(value * inverseEpsilon + 0.5f);
+		if (std::isnan(cell))
+			return (uint32_t)INT32_MIN;
+		return (uint32_t)(int32_t)std::clamp(cell, -limit, limit);
+	}
+}
+
+VertexWelder::VertexWelder(WeldMode mode, size_t expectedVertexCount, float epsilon)
+{
+	// A zero epsilon would put every vertex in one cell
+	bool usableEpsilon = epsilon > 0.0f && std::isfinite(epsilon) && std::isfinite(1.0f / epsilon);
+	this->mode = mode == WeldMode::Quantized && !usableEpsilon ? WeldMode::Exact : mode;
+	inverseEpsilon = usableEpsilon ? 1.0f / epsilon : 0.0f;
+	keyWords = mode == WeldMode::IndexTriple ? tripleKeyWords : vertexKeyWords;
+
+	uint32_t tableSize = TableSizeFor(expectedVertexCount);
+	slots.assign(tableSize, 0);
+	slotMask = tableSize - 1;
+
+	keys.reserve(std::min<size_t>(expectedVertexCount, tableSize / 2) * keyWords);
+	uniqueCount = 0;
+}
+
+VertexWelder::~VertexWelder() {}
+
+unsigned int VertexWelder::Weld(const Vertex& vertex, bool* isNew)
+{
+	const float values[vertexKeyWords] = {
+		vertex.Position.x, vertex.Position.y, vertex.Position.z,
+		vertex.Normal.x, vertex.Normal.y, vertex.Normal.z,
+		vertex.UV.x, vertex.UV.y
+	};
+
+	uint32_t key[vertexKeyWords];
+	if (mode == WeldMode::Quantized)
+	{
+		// Snap to the epsilon grid. Values that straddle a cell
+		// boundary can still end up in neighboring cells.
+		for (unsigned int i = 0; i < vertexKeyWords; i++)
+			key[i] = CellOf(values[i], inverseEpsilon);
+	}
+	else
+	{
+		for (unsigned int i = 0; i < vertexKeyWords; i++)
+			key[i] = FloatBits(values[i]);
+	}
+
+	return Insert(key, isNew);
+}
+
+unsigned int VertexWelder::Weld(int position, int uv, int normal, bool* isNew)
+{
+	const uint32_t key[tripleKeyWords] = { (uint32_t)position, (uint32_t)uv, (uint32_t)normal };
+	return Insert(key, isNew);
+}
+
+// --------------------------------------------------------
+// Linear probing: walk from the hashed slot until either a
+// matching key or an empty slot is found
+// --------------------------------------------------------
+unsigned int VertexWelder::Insert(const uint32_t* key, bool* isNew)
+{
+	uint32_t slot = HashKey(key, keyWords) & slotMask;
+	while (slots[slot] != 0)
+	{
+		unsigned int index = slots[slot] - 1;
+		if (memcmp(&keys[(size_t)index * keyWords], key, keyWords * sizeof(uint32_t)) == 0)
+		{
+			if (isNew)
+				*isNew = false;
+			return index;
+		}
+		slot = (slot + 1) & slotMask;
+	}
+
+	// Not found, so this is a new unique vertex
+	unsigned int index = uniqueCount++;
+	slots[slot] = index + 1;
+	keys.insert(keys.end(), key, key + keyWords);
+
+	// Keep the load factor at or below one half
+	if ((size_t)uniqueCount * 2 > slots.size())
+		Grow();
+
+	if (isNew)
+		*isNew = true;
+	return index;
+}
+
+// Doubles the table and re-inserts every stored key
+void VertexWelder::Grow()
+{
+	if (slots.size() >= maxTableSize)
+		throw std::length_error("Too many unique vertices for the weld table");
+
+	slots.assign(slots.size() * 2, 0);
+	slotMask = (uint32_t)slots.size() - 1;
+
+	for (unsigned int index = 0; index < uniqueCount; index++)
+	{
+		uint32_t slot = HashKey(&keys[(size_t)index * keyWords], keyWords) & slotMask;
+		while (slots[slot] != 0)
+			slot = (slot + 1) & slotMask;
+		slots[slot] = index + 1;
+	}
+}
+
+WeldMode VertexWelder::GetMode() const
+{
+	return mode;
+}
+
+unsigned int VertexWelder::GetUniqueCount() const
+{
+	return uniqueCount;
+}
+
+size_t VertexWelder::GetMemoryUsage() const
+{
+	return (slots.capacity() + keys.capacity()) * sizeof(uint32_t);
+}
+
+void VertexWelder::Clear()
+{
+	std::fill(slots.begin(), slots.end(), 0);
+	keys.clear();
+	uniqueCount = 0;
+}
\ No newline at end of file
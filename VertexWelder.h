@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Vertex.h"
+
+// How two vertices are decided to be "the same"
+enum class WeldMode
+{
+	Exact,		// Position, normal and UV are bitwise identical
+	Quantized,	// Position, normal and UV land in the same epsilon-sized cell
+	IndexTriple	// Same OBJ position/uv/normal indices (v/vt/vn)
+};
+
+// Removes duplicate vertices using a flat open-addressing hash table,
+// handing back the index of the first matching vertex it has seen.
+// New vertices are numbered in the order they are first welded.
+class VertexWelder
+{
+public:
+	// The table is reserved up front for the expected number of unique
+	// vertices (it still grows if that guess is exceeded, up to 2^30
+	// vertices, past which Weld throws std::length_error). Epsilon is
+	// only used by WeldMode::Quantized, and an epsilon that isn't a
+	// positive finite number falls back to WeldMode::Exact.
+	VertexWelder(WeldMode mode, size_t expectedVertexCount, float epsilon = 0.0f);
+	~VertexWelder();
+	VertexWelder(const VertexWelder&) = delete;
+	VertexWelder& operator=(const VertexWelder&) = delete;
+
+	// Exact/Quantized modes: welds on position, normal and UV (not the tangent)
+	unsigned int Weld(const Vertex& vertex, bool* isNew = nullptr);
+	// IndexTriple mode: welds on the indices of a single face corner
+	unsigned int Weld(int position, int uv, int normal, bool* isNew = nullptr);
+
+	WeldMode GetMode() const;
+	unsigned int GetUniqueCount() const;
+	// Bytes currently held by the table and stored keys
+	size_t GetMemoryUsage() const;
+
+	// Forgets every vertex, keeping the allocated memory
+	void Clear();
+
+private:
+	// Number of 32-bit words in a key for each mode
+	static const unsigned int vertexKeyWords = 8;
+	static const unsigned int tripleKeyWords = 3;
+
+	unsigned int Insert(const uint32_t* key, bool* isNew);
+	void Grow();
+
+	WeldMode mode;
+	float inverseEpsilon;
+	unsigned int keyWords;
+
+	// Slot values are a unique index + 1, so 0 marks an empty slot
+	std::vector<uint32_t> slots;
+	uint32_t slotMask;
+
+	// Keys of every unique vertex, back to back, in index order
+	std::vector<uint32_t> keys;
+	unsigned int uniqueCount;
+};
\ No newline at end of file